@@ -394,3 +394,241 @@ function(SOUFFLE_POSITIVE_FUNCTOR_TEST TEST_NAME)
         souffle_run_test_helper(TEST_NAME ${TEST_NAME} COMPILED FUNCTORS ${ARGN})
         souffle_run_test_helper(TEST_NAME ${TEST_NAME} COMPILED_SPLITTED FUNCTORS ${ARGN})
 endfunction()
+
+# Run a souffle test twice in the same directory, both as interpreted and as
+# compiled: the first run stops after saving STOP_AFTER checkpoints, and the
+# second run resumes from the last of them. Together, the runs must produce
+# the outputs of an uninterrupted run.
+#PARAM_SUFFIX - distinguishes several checkpoint tests of the same test directory
+#PARAM_STOP_AFTER - the number of checkpoints after which the first run stops
+#PARAM_CHECKPOINT_PARAMS - further options of both runs, e.g. the intervals of the checkpoints
+function(SOUFFLE_CHECKPOINT_TEST)
+    cmake_parse_arguments(
+        PARAM
+        ""
+        "TEST_NAME;CATEGORY;SUFFIX;STOP_AFTER" #Single valued options
+        "CHECKPOINT_PARAMS" # Multi-valued options
+        ${ARGV}
+    )
+
+    foreach(EXEC_STYLE "interpreted" "compiled")
+        if (EXEC_STYLE STREQUAL "compiled")
+            set(EXTRA_FLAGS "-c")
+            set(SHORT_EXEC_STYLE "_c")
+        else()
+            set(EXTRA_FLAGS)
+            set(SHORT_EXEC_STYLE "")
+        endif()
+
+        set(INPUT_DIR "${CMAKE_CURRENT_SOURCE_DIR}/${PARAM_TEST_NAME}")
+        set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/${PARAM_TEST_NAME}_${PARAM_SUFFIX}_${EXEC_STYLE}")
+        set(QUALIFIED_TEST_NAME ${PARAM_CATEGORY}/${PARAM_TEST_NAME}_${PARAM_SUFFIX}${SHORT_EXEC_STYLE})
+        set(FIXTURE_NAME ${QUALIFIED_TEST_NAME}_fixture)
+        set(TEST_LABELS "${PARAM_CATEGORY};${EXEC_STYLE};positive;integration")
+
+        souffle_setup_integration_test_dir(TEST_NAME ${PARAM_TEST_NAME}
+                                           QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                           DATA_CHECK_DIR ${INPUT_DIR}
+                                           OUTPUT_DIR ${OUTPUT_DIR}
+                                           FIXTURE_NAME ${FIXTURE_NAME}
+                                           TEST_LABELS ${TEST_LABELS})
+
+        # the checkpoints are saved in the output directory
+        set(SOUFFLE_PARAMS ${EXTRA_FLAGS} "--checkpoint=." ${PARAM_CHECKPOINT_PARAMS}
+                           "-D" "." "-F" "${INPUT_DIR}/facts")
+        if (OPENMP_FOUND)
+          list(APPEND SOUFFLE_PARAMS "-j8")
+        endif()
+
+        add_test(NAME ${QUALIFIED_TEST_NAME}_stop_souffle
+          COMMAND
+          $<TARGET_FILE:souffle>
+            ${SOUFFLE_PARAMS}
+            "--checkpoint-stop=${PARAM_STOP_AFTER}"
+            "${INPUT_DIR}/${PARAM_TEST_NAME}.dl"
+          COMMAND_EXPAND_LISTS)
+
+        set_tests_properties(${QUALIFIED_TEST_NAME}_stop_souffle PROPERTIES
+          WORKING_DIRECTORY "${OUTPUT_DIR}"
+          LABELS "${TEST_LABELS}"
+          FIXTURES_SETUP ${FIXTURE_NAME}_stop_souffle
+          FIXTURES_REQUIRED ${FIXTURE_NAME}_setup)
+
+        souffle_run_integration_test(TEST_NAME ${PARAM_TEST_NAME}
+                                     QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                     INPUT_DIR ${INPUT_DIR}
+                                     OUTPUT_DIR ${OUTPUT_DIR}
+                                     FIXTURE_NAME ${FIXTURE_NAME}
+                                     SOUFFLE_PARAMS ${SOUFFLE_PARAMS}
+                                     TEST_LABELS ${TEST_LABELS})
+
+        # the second run resumes from the checkpoint of the first
+        set_tests_properties(${QUALIFIED_TEST_NAME}_run_souffle PROPERTIES
+          FIXTURES_REQUIRED "${FIXTURE_NAME}_setup;${FIXTURE_NAME}_stop_souffle")
+
+        souffle_compare_std_outputs(TEST_NAME ${PARAM_TEST_NAME}
+                                    QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                    OUTPUT_DIR ${OUTPUT_DIR}
+                                    RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                                    TEST_LABELS ${TEST_LABELS})
+
+        souffle_compare_csv(QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                            INPUT_DIR ${INPUT_DIR}
+                            OUTPUT_DIR ${OUTPUT_DIR}
+                            RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                            TEST_LABELS ${TEST_LABELS})
+    endforeach()
+endfunction()
+
+# Run a souffle test on a cluster of interpreter processes on this host, which
+# must produce the outputs of the single process of souffle_positive_test.
+#PARAM_WORKERS - the number of worker processes
+function(SOUFFLE_CLUSTER_TEST)
+    cmake_parse_arguments(
+        PARAM
+        ""
+        "TEST_NAME;CATEGORY;WORKERS" #Single valued options
+        "" # Multi-valued options
+        ${ARGV}
+    )
+
+    set(INPUT_DIR "${CMAKE_CURRENT_SOURCE_DIR}/${PARAM_TEST_NAME}")
+    set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/${PARAM_TEST_NAME}_cluster${PARAM_WORKERS}_interpreted")
+    set(QUALIFIED_TEST_NAME ${PARAM_CATEGORY}/${PARAM_TEST_NAME}_cluster${PARAM_WORKERS})
+    set(FIXTURE_NAME ${QUALIFIED_TEST_NAME}_fixture)
+    set(TEST_LABELS "${PARAM_CATEGORY};interpreted;positive;integration")
+
+    souffle_setup_integration_test_dir(TEST_NAME ${PARAM_TEST_NAME}
+                                       QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                       DATA_CHECK_DIR ${INPUT_DIR}
+                                       OUTPUT_DIR ${OUTPUT_DIR}
+                                       FIXTURE_NAME ${FIXTURE_NAME}
+                                       TEST_LABELS ${TEST_LABELS})
+
+    set(SOUFFLE_PARAMS "-D" "." "-F" "${INPUT_DIR}/facts")
+    if (OPENMP_FOUND)
+      list(APPEND SOUFFLE_PARAMS "-j8")
+    endif()
+
+    # the workers listen on unix sockets in the output directory
+    add_test(NAME ${QUALIFIED_TEST_NAME}_run_souffle
+      COMMAND
+      ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/cmake/run_cluster.py
+        --workers ${PARAM_WORKERS}
+        --out ${PARAM_TEST_NAME}.out
+        --err ${PARAM_TEST_NAME}.err
+        $<TARGET_FILE:souffle>
+        ${SOUFFLE_PARAMS}
+        "${INPUT_DIR}/${PARAM_TEST_NAME}.dl"
+      COMMAND_EXPAND_LISTS)
+
+    set_tests_properties(${QUALIFIED_TEST_NAME}_run_souffle PROPERTIES
+      WORKING_DIRECTORY "${OUTPUT_DIR}"
+      LABELS "${TEST_LABELS}"
+      FIXTURES_SETUP ${FIXTURE_NAME}_run_souffle
+      FIXTURES_REQUIRED ${FIXTURE_NAME}_setup)
+
+    souffle_compare_std_outputs(TEST_NAME ${PARAM_TEST_NAME}
+                                QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                OUTPUT_DIR ${OUTPUT_DIR}
+                                RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                                TEST_LABELS ${TEST_LABELS})
+
+    souffle_compare_csv(QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                        INPUT_DIR ${INPUT_DIR}
+                        OUTPUT_DIR ${OUTPUT_DIR}
+                        RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                        TEST_LABELS ${TEST_LABELS})
+endfunction()
+
+# Run a souffle test as an interpreted query server answering the requests of
+# <test_name>.in, on its standard input or, with sessions, on a unix socket.
+#PARAM_SESSIONS - the number of concurrent sessions on the socket, none for the standard input
+#PARAM_SOUFFLE_ARGS - additional arguments of souffle
+function(SOUFFLE_QUERY_SERVER_TEST)
+    cmake_parse_arguments(
+        PARAM
+        ""
+        "TEST_NAME;CATEGORY;SESSIONS" #Single valued options
+        "SOUFFLE_ARGS" # Multi-valued options
+        ${ARGV}
+    )
+
+    if (NOT PARAM_SESSIONS)
+        set(PARAM_SESSIONS 0)
+    endif()
+
+    set(INPUT_DIR "${CMAKE_CURRENT_SOURCE_DIR}/${PARAM_TEST_NAME}")
+    set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/${PARAM_TEST_NAME}_interpreted")
+    set(QUALIFIED_TEST_NAME ${PARAM_CATEGORY}/${PARAM_TEST_NAME})
+    set(FIXTURE_NAME ${QUALIFIED_TEST_NAME}_fixture)
+    set(TEST_LABELS "${PARAM_CATEGORY};interpreted;positive;integration")
+
+    souffle_setup_integration_test_dir(TEST_NAME ${PARAM_TEST_NAME}
+                                       QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                       DATA_CHECK_DIR ${INPUT_DIR}
+                                       OUTPUT_DIR ${OUTPUT_DIR}
+                                       FIXTURE_NAME ${FIXTURE_NAME}
+                                       TEST_LABELS ${TEST_LABELS})
+
+    set(SOUFFLE_PARAMS "-D" "." "-F" "${INPUT_DIR}/facts" ${PARAM_SOUFFLE_ARGS})
+    if (OPENMP_FOUND)
+      list(APPEND SOUFFLE_PARAMS "-j8")
+    endif()
+
+    add_test(NAME ${QUALIFIED_TEST_NAME}_run_souffle
+      COMMAND
+      ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/cmake/run_query_server.py
+        --sessions ${PARAM_SESSIONS}
+        --in "${INPUT_DIR}/${PARAM_TEST_NAME}.in"
+        --out ${PARAM_TEST_NAME}.out
+        --err ${PARAM_TEST_NAME}.err
+        $<TARGET_FILE:souffle>
+        ${SOUFFLE_PARAMS}
+        "${INPUT_DIR}/${PARAM_TEST_NAME}.dl"
+      COMMAND_EXPAND_LISTS)
+
+    set_tests_properties(${QUALIFIED_TEST_NAME}_run_souffle PROPERTIES
+      WORKING_DIRECTORY "${OUTPUT_DIR}"
+      LABELS "${TEST_LABELS}"
+      FIXTURES_SETUP ${FIXTURE_NAME}_run_souffle
+      FIXTURES_REQUIRED ${FIXTURE_NAME}_setup)
+
+    souffle_compare_std_outputs(TEST_NAME ${PARAM_TEST_NAME}
+                                QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                                OUTPUT_DIR ${OUTPUT_DIR}
+                                RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                                TEST_LABELS ${TEST_LABELS})
+
+    souffle_compare_csv(QUALIFIED_TEST_NAME ${QUALIFIED_TEST_NAME}
+                        INPUT_DIR ${INPUT_DIR}
+                        OUTPUT_DIR ${OUTPUT_DIR}
+                        RUN_AFTER_FIXTURE ${FIXTURE_NAME}_run_souffle
+                        TEST_LABELS ${TEST_LABELS})
+endfunction()
+
+# Check that the transformed RAM program of a souffle test has a line matching
+# each regular expression of <test_name>.ram, to make sure that a
+# transformation fires for the test.
+function(SOUFFLE_TRANSFORMED_RAM_TEST TEST_NAME CATEGORY)
+    set(INPUT_DIR "${CMAKE_CURRENT_SOURCE_DIR}/${TEST_NAME}")
+    set(QUALIFIED_TEST_NAME ${CATEGORY}/${TEST_NAME}_transformed_ram)
+
+    set(SOUFFLE_PARAMS)
+    if (MSVC)
+      list(APPEND SOUFFLE_PARAMS "--preprocessor" "cl -nologo -TC -E")
+    endif()
+
+    add_test(NAME ${QUALIFIED_TEST_NAME}
+      COMMAND
+      ${Python3_EXECUTABLE} ${PROJECT_SOURCE_DIR}/cmake/check_transformed_ram.py
+        --expect "${INPUT_DIR}/${TEST_NAME}.ram"
+        $<TARGET_FILE:souffle>
+        ${SOUFFLE_PARAMS}
+        "${INPUT_DIR}/${TEST_NAME}.dl"
+      COMMAND_EXPAND_LISTS)
+
+    set_tests_properties(${QUALIFIED_TEST_NAME} PROPERTIES
+      WORKING_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}"
+      LABELS "${CATEGORY};interpreted;positive;integration")
+endfunction()
@@ -0,0 +1,42 @@
+# Souffle - A Datalog Compiler
+# Copyright (c) 2026, The Souffle Developers. All rights reserved
+# Licensed under the Universal Permissive License v 1.0 as shown at:
+# - https://opensource.org/licenses/UPL
+# - <souffle root>/licenses/SOUFFLE-UPL.txt
+
+# Run souffle with --show=transformed-ram and check that the transformed RAM
+# program has a line matching each regular expression of a file, one per line.
+# Such checks make sure that a transformation fires, where the outputs of a
+# program are the same either way.
+
+import os
+import argparse
+import pathlib
+import re
+import subprocess
+
+parser = argparse.ArgumentParser(description="Check the transformed RAM program of souffle")
+parser.add_argument('--expect', dest='expect_file', required=True)
+parser.add_argument('command', type=lambda p: pathlib.Path(p).absolute())
+parser.add_argument('arguments', nargs=argparse.REMAINDER)
+
+args = parser.parse_args()
+
+status = subprocess.run([args.command, "--show=transformed-ram"] + args.arguments,
+                        stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+if status.returncode != 0:
+    os.sys.stderr.write(status.stderr)
+    os.sys.exit(status.returncode)
+
+program = status.stdout.splitlines()
+with open(args.expect_file, "r") as f:
+    patterns = [line.rstrip("\n") for line in f if line.strip()]
+
+missing = [pattern for pattern in patterns
+           if not any(re.search(pattern, line) for line in program)]
+if missing:
+    os.sys.stderr.write("No line of the transformed RAM program matches:\n")
+    for pattern in missing:
+        os.sys.stderr.write("  " + pattern + "\n")
+    os.sys.stderr.write(status.stdout)
+    os.sys.exit(1)
@@ -0,0 +1,65 @@
+# Souffle - A Datalog Compiler
+# Copyright (c) 2026, The Souffle Developers. All rights reserved
+# Licensed under the Universal Permissive License v 1.0 as shown at:
+# - https://opensource.org/licenses/UPL
+# - <souffle root>/licenses/SOUFFLE-UPL.txt
+
+# Run a program on a cluster of worker processes connected by unix sockets in
+# the working directory. The standard streams of the first worker, which
+# writes all outputs, are redirected like those of redirect.py.
+
+import os
+import argparse
+import pathlib
+import subprocess
+
+parser = argparse.ArgumentParser(description="Run a cluster of souffle workers")
+parser.add_argument('--workers', type=int, required=True)
+parser.add_argument('--out', dest='out_file', required=True)
+parser.add_argument('--err', dest='err_file', required=True)
+parser.add_argument('--timeout', type=int, default=600)
+parser.add_argument('command', type=lambda p: pathlib.Path(p).absolute())
+parser.add_argument('arguments', nargs=argparse.REMAINDER)
+
+args = parser.parse_args()
+
+endpoints = ",".join("unix:worker{}.socket".format(rank) for rank in range(args.workers))
+
+workers = []
+for rank in range(args.workers):
+    if rank == 0:
+        stdout = open(args.out_file, "w")
+        stderr = open(args.err_file, "w")
+    else:
+        stdout = open("worker{}.out".format(rank), "w")
+        stderr = open("worker{}.err".format(rank), "w")
+    command = [args.command, "--cluster={}".format(endpoints), "--cluster-rank={}".format(rank)]
+    process = subprocess.Popen(command + args.arguments, stdout=stdout, stderr=stderr)
+    workers.append((process, stdout, stderr))
+
+status = 0
+for rank, (process, stdout, stderr) in enumerate(workers):
+    try:
+        returncode = process.wait(timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        for other, _, _ in workers:
+            other.kill()
+        returncode = process.wait()
+        os.sys.stderr.write("worker {} timed out\n".format(rank))
+    stdout.close()
+    stderr.close()
+    if returncode != 0:
+        status = returncode
+        with open(stderr.name, "r") as f:
+            os.sys.stderr.write("worker {} failed:\n{}".format(rank, f.read()))
+
+# the other workers must not print anything
+for rank in range(1, args.workers):
+    for stream in ("out", "err"):
+        name = "worker{}.{}".format(rank, stream)
+        if os.path.getsize(name) > 0:
+            with open(name, "r") as f:
+                os.sys.stderr.write("unexpected output of worker {}:\n{}".format(rank, f.read()))
+            status = status or 1
+
+os.sys.exit(status)
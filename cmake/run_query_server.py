@@ -0,0 +1,133 @@
+# Souffle - A Datalog Compiler
+# Copyright (c) 2026, The Souffle Developers. All rights reserved
+# Licensed under the Universal Permissive License v 1.0 as shown at:
+# - https://opensource.org/licenses/UPL
+# - <souffle root>/licenses/SOUFFLE-UPL.txt
+
+# Run a program as a query server and send it the requests of a file, one per
+# line. Without sessions, the requests are the standard input of the server and
+# its standard output is written to --out. Otherwise the server listens on a
+# unix socket in the working directory, replacing a stale socket left there,
+# and the sessions send all requests concurrently. Every session must receive
+# the same responses, which are written to --out after their requests. A last
+# session shuts the server down, which must then remove its socket.
+
+import os
+import argparse
+import pathlib
+import socket
+import subprocess
+import threading
+import time
+
+parser = argparse.ArgumentParser(description="Run a souffle query server")
+parser.add_argument('--sessions', type=int, default=0)
+parser.add_argument('--in', dest='in_file', required=True)
+parser.add_argument('--out', dest='out_file', required=True)
+parser.add_argument('--err', dest='err_file', required=True)
+parser.add_argument('--timeout', type=int, default=600)
+parser.add_argument('command', type=lambda p: pathlib.Path(p).absolute())
+parser.add_argument('arguments', nargs=argparse.REMAINDER)
+
+args = parser.parse_args()
+
+
+def fail(message):
+    os.sys.stderr.write(message + "\n")
+    with open(args.err_file, "r") as f:
+        os.sys.stderr.write(f.read())
+    os.sys.exit(1)
+
+
+if args.sessions == 0:
+    with open(args.in_file) as stdin, open(args.out_file, "w") as stdout, open(args.err_file, "w") as stderr:
+        command = [args.command, "--serve=-"] + args.arguments
+        status = subprocess.run(command, stdin=stdin, stdout=stdout, stderr=stderr, timeout=args.timeout)
+    if status.returncode != 0:
+        fail("server failed")
+    os.sys.exit(0)
+
+with open(args.in_file) as f:
+    requests = [line.rstrip("\n") for line in f if line.strip()]
+
+path = "server.socket"
+if os.path.exists(path):
+    os.unlink(path)
+stale = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+stale.bind(path)
+stale.close()
+
+stderr = open(args.err_file, "w")
+server = subprocess.Popen([args.command, "--serve=unix:" + path] + args.arguments,
+                          stdout=stderr, stderr=stderr)
+
+
+def connect():
+    deadline = time.time() + args.timeout
+    while True:
+        session = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            session.connect(path)
+            return session
+        except (ConnectionRefusedError, FileNotFoundError):
+            session.close()
+            if server.poll() is not None or time.time() > deadline:
+                server.kill()
+                stderr.close()
+                fail("server did not accept sessions")
+            time.sleep(0.1)
+
+
+def exchange(stream, request):
+    """Send a request and return the request and its response"""
+    stream.write(request + "\n")
+    stream.flush()
+    transcript = "> " + request + "\n"
+    while True:
+        line = stream.readline()
+        if not line:
+            return transcript + "(closed)\n"
+        transcript += line
+        if line.startswith("ok") or line.startswith("error"):
+            return transcript
+
+
+# all sessions are open before any sends a request
+sessions = [connect() for _ in range(args.sessions)]
+transcripts = [None] * args.sessions
+
+
+def run_session(index):
+    stream = sessions[index].makefile("rw")
+    transcripts[index] = "".join(exchange(stream, request) for request in requests)
+    sessions[index].close()
+
+
+threads = [threading.Thread(target=run_session, args=(i,)) for i in range(args.sessions)]
+for thread in threads:
+    thread.start()
+for thread in threads:
+    thread.join()
+
+last = connect()
+stopped = exchange(last.makefile("rw"), "shutdown")
+last.close()
+try:
+    returncode = server.wait(timeout=args.timeout)
+except subprocess.TimeoutExpired:
+    server.kill()
+    returncode = server.wait()
+stderr.close()
+
+with open(args.out_file, "w") as f:
+    f.write(transcripts[0])
+
+if returncode != 0:
+    fail("server failed")
+if stopped != "> shutdown\nok\n":
+    fail("unexpected response to shutdown:\n" + stopped)
+for index, transcript in enumerate(transcripts):
+    if transcript != transcripts[0]:
+        fail("session {} received different responses:\n{}".format(index, transcript))
+if os.path.exists(path):
+    fail("server did not remove its socket")
@@ -83,6 +83,7 @@
 #include "ram/transform/HoistConditions.h"
 #include "ram/transform/IfConversion.h"
 #include "ram/transform/IfExistsConversion.h"
+#include "ram/transform/InputPushdown.h"
 #include "ram/transform/Loop.h"
 #include "ram/transform/MakeIndex.h"
 #include "ram/transform/Parallel.h"
@@ -90,10 +91,12 @@
 #include "ram/transform/ReorderFilterBreak.h"
 #include "ram/transform/ReportIndex.h"
 #include "ram/transform/Sequence.h"
+#include "ram/transform/SubproofScan.h"
 #include "ram/transform/Transformer.h"
 #include "ram/transform/TupleId.h"
 #include "reports/DebugReport.h"
 #include "reports/ErrorReport.h"
+#include "souffle/QueryServer.h"
 #include "souffle/RamTypes.h"
 #ifndef _MSC_VER
 #include "souffle/profile/Tui.h"
@@ -105,10 +108,13 @@
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include "souffle/utility/SubProcess.h"
+#include "synthesiser/CompileCache.h"
 #include "synthesiser/GenDb.h"
 #include "synthesiser/Synthesiser.h"
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
@@ -116,7 +122,9 @@
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <optional>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -177,12 +185,17 @@ namespace souffle {
 /**
  * Compiles the given source file to a binary file.
  */
-void compileToBinary(
-        Global& glb, const std::string& command, std::vector<fs::path>& sourceFilenames, fs::path binary) {
+void compileToBinary(Global& glb, const std::string& command, std::vector<fs::path>& sourceFilenames,
+        fs::path binary, const synthesiser::CompileCache* cache) {
     std::vector<std::string> argv;
 
     argv.push_back(command);
 
+    if (cache != nullptr) {
+        argv.push_back("--cache-dir");
+        argv.push_back(cache->getObjectDir().string());
+    }
+
     if (glb.config().has("swig")) {
         argv.push_back("-s");
         argv.push_back(glb.config().get("swig"));
@@ -192,6 +205,11 @@ void compileToBinary(
         argv.push_back("-v");
     }
 
+    if (glb.config().has("pgo-train")) {
+        argv.push_back("--pgo-train");
+        argv.push_back(glb.config().get("pgo-train"));
+    }
+
     for (auto&& path : glb.config().getMany("library-dir")) {
         // The first entry may be blank
         if (path.empty()) {
@@ -446,6 +464,15 @@ static WarnSet process_warn_opts(const Global& glb) {
     return warns;
 }
 
+/** Check that the value of an option is an integer between min and max, without overflowing */
+static bool isCountInRange(const std::string& value, std::size_t min,
+        std::size_t max = std::numeric_limits<std::size_t>::max()) {
+    std::size_t count = 0;
+    const char* end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, count);
+    return ec == std::errc() && ptr == end && min <= count && count <= max;
+}
+
 Own<ast::transform::PipelineTransformer> astTransformationPipeline(Global& glb) {
     // clang-format off
     // Equivalence pipeline
@@ -551,16 +578,41 @@ Own<ram::transform::Transformer> ramTransformerSequence(Global& glb) {
             mk<ExpandFilterTransformer>(), mk<HoistConditionsTransformer>(),
             mk<CollapseFiltersTransformer>(), mk<EliminateDuplicatesTransformer>(),
             mk<ReorderConditionsTransformer>(), mk<LoopTransformer>(mk<ReorderFilterBreak>()),
+            mk<ConditionalTransformer>(
+                    [&]() -> bool {
+                        return glb.config().has("provenance") && glb.config().has("provenance-compact");
+                    },
+                    mk<SubproofScanTransformer>()),
             mk<ConditionalTransformer>(
                     // job count of 0 means all cores are used.
                     [&]() -> bool { return std::stoi(glb.config().get("jobs")) != 1; },
                     mk<ParallelTransformer>()),
+            mk<ConditionalTransformer>(
+                    [&]() -> bool { return !glb.config().has("provenance"); },
+                    mk<InputPushdownTransformer>()),
             mk<ReportIndexTransformer>());
     // clang-format on
 
     return ramTransform;
 }
 
+/** Print the cost of the passes over a translation unit, the most expensive first */
+static void printPassStatistics(std::ostream& os, const std::string& title,
+        const std::map<std::string, detail::PassStatistics>& statistics, bool withChanges) {
+    std::vector<std::pair<std::string, detail::PassStatistics>> passes(statistics.begin(), statistics.end());
+    std::stable_sort(passes.begin(), passes.end(),
+            [](const auto& a, const auto& b) { return a.second.seconds > b.second.seconds; });
+    os << title << ":" << std::endl;
+    for (const auto& [name, pass] : passes) {
+        os << std::fixed << std::setprecision(6) << std::setw(12) << pass.seconds << "s "
+           << std::setw(8) << pass.runs << " runs ";
+        if (withChanges) {
+            os << std::setw(8) << pass.changes << " changes ";
+        }
+        os << name << std::endl;
+    }
+}
+
 bool interpretTranslationUnit(Global& glb, ram::TranslationUnit& ramTranslationUnit) {
     try {
         std::thread profiler;
@@ -581,6 +633,10 @@ bool interpretTranslationUnit(Global& glb, ram::TranslationUnit& ramTranslationU
         if (profiler.joinable()) {
             profiler.join();
         }
+        // an evaluation stopped at a checkpoint is resumed by a later run
+        if (interpreter->stoppedAtCheckpoint()) {
+            return true;
+        }
         if (glb.config().has("provenance")) {
 #ifdef _MSC_VER
             throw("No explain/explore provenance on Windows\n.");
@@ -594,6 +650,10 @@ bool interpretTranslationUnit(Global& glb, ram::TranslationUnit& ramTranslationU
             }
 #endif
         }
+        if (glb.config().has("serve")) {
+            interpreter::ProgInterface interface(*interpreter);
+            QueryServer(interface).serve(glb.config().get("serve"));
+        }
         return true;
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
@@ -653,11 +713,33 @@ std::vector<MainOption> getMainOptions() {
     // clang-format off
   std::vector<MainOption> options{
       {"", 0, "", "", false, ""},
+      {"async-io", nextOptChar++, "", "", false,
+          "Load the inputs of the synthesised program in the background from the start of the "
+          "evaluation, and write its outputs while later strata are evaluated."},
       {"auto-schedule", 'a', "FILE", "", false,
           "Use profile auto-schedule <FILE> for auto-scheduling."},
+      {"checkpoint", nextOptChar++, "DIR", "", false,
+          "Save the relations and tables to <DIR> after each stratum, and resume from the last checkpoint "
+          "of <DIR> if there is one. The checkpoint is removed once the evaluation completes."},
+      {"checkpoint-iterations", nextOptChar++, "N", "", false,
+          "Also save a checkpoint every <N> iterations of a fixpoint loop."},
+      {"checkpoint-stop", nextOptChar++, "N", "", false,
+          "Stop the evaluation after saving <N> checkpoints, as if it was interrupted, to test resuming."},
+      {"checkpoint-strata", nextOptChar++, "N", "", false,
+          "Save a checkpoint after every <N> strata instead of after each stratum."},
+      {"cluster", nextOptChar++, "ENDPOINTS", "", false,
+          "Evaluate the program together with other souffle processes. <ENDPOINTS> lists the "
+          "endpoints of all workers, separated by commas, as unix:PATH or tcp:HOST:PORT."},
+      {"cluster-rank", nextOptChar++, "N", "", false,
+          "The position of this worker in the endpoints of --cluster."},
+      {"compact-tables", nextOptChar++, "", "", false,
+          "Free the symbols and records that no relation reaches anymore after each stratum."},
       {"compile", 'c', "", "", false,
           "Generate C++ source code, compile to a binary executable, then run this "
           "executable."},
+      {"compile-cache", nextOptChar++, "DIR", "", false,
+          "Cache compiled programs in <DIR>. A program is only synthesised and compiled "
+          "again if the program, its options, or the version of souffle changed."},
       {"compile-many", 'C', "", "", false,
           "Generate C++ source code in multiple files, compile to a binary executable, then "
           "run this "
@@ -707,6 +789,8 @@ std::vector<MainOption> getMainOptions() {
       {"magic-transform-exclude", nextOptChar++, "RELATIONS", "", false,
           "Disable magic set transformation changes on the given relations. Overrides "
           "`magic-transform`. Implies `inline-exclude` for the given relations."},
+      {"memoise", nextOptChar++, "", "", false,
+          "Cache the results of match, contains and stateless functors at each call site."},
       {"no-preprocessor", nextOptChar++, "", "", false,
           "Do not use a C preprocessor."},
       {"no-warn", 'w', "", "", false,
@@ -715,6 +799,9 @@ std::vector<MainOption> getMainOptions() {
           "Specify directory for output files. If <DIR> is `-` then stdout is used."},
       {"parse-errors", nextOptChar++, "", "", false,
           "Show parsing errors, if any, then exit."},
+      {"pgo-train", nextOptChar++, "DIR", "", false,
+          "Compile with profile-guided and link-time optimisation, training the program on "
+          "the facts in <DIR>."},
       {"pragma", 'P', "OPTIONS", "", true,
           "Set pragma options."},
       {"preprocessor", nextOptChar++, "CMD", "", false,
@@ -723,8 +810,18 @@ std::vector<MainOption> getMainOptions() {
           "Enable profiling, and write profile data to <FILE>."},
       {"profile-frequency", nextOptChar++, "", "", false,
           "Enable the frequency counter in the profiler."},
+      {"profile-trace", nextOptChar++, "FILE", "", false,
+          "Record a per-thread timeline of strata, rules, iterations and IO, and write it to <FILE>. "
+          "A .json file receives the Chrome trace format, any other file folded stacks for flame graphs."},
       {"provenance", 't', "[ none | explain | explore ]", "", false,
           "Enable provenance instrumentation and interaction."},
+      {"provenance-compact", nextOptChar++, "", "", false,
+          "Pack the rule and level numbers of provenance into one attribute, and explain tuples by "
+          "scanning relations where provenance would need indexes of its own."},
+      {"serve", nextOptChar++, "ENDPOINT", "", false,
+          "Answer lookups, range queries and subroutine calls over the output relations after the "
+          "evaluation, on <ENDPOINT>: - for the standard input and output, or unix:<PATH> for a local "
+          "socket."},
       {"show", nextOptChar++, "[ <see-list> ]", "", true,
           "Print selected program information.\n"
           "Modes:\n"
@@ -738,9 +835,23 @@ std::vector<MainOption> getMainOptions() {
               "\ttransformed-ast\n"
               "\ttransformed-ram\n"
               "\ttype-analysis"},
+      {"spill-budget", nextOptChar++, "MB", "", false,
+          "Keep up to <MB> megabytes of spilled relations in memory, in compact form, before "
+          "writing them to disk."},
+      {"spill-dir", nextOptChar++, "DIR", "", false,
+          "Spill relations that are not needed by the next stratum to files in <DIR> and "
+          "restore them before they are used again."},
+      {"statistics-sample", nextOptChar++, "N", "", false,
+          "Estimate the statistics of --emit-statistics from a block sample of about N "
+          "tuples per relation instead of a full scan."},
       {"swig", 's', "LANG", "", false,
           "Generate SWIG interface for given language. The values <LANG> accepts is java and "
           "python. "},
+      {"transformer-times", nextOptChar++, "", "", false,
+          "Print the time spent in each AST and RAM transformer and analysis."},
+      {"vectorise", nextOptChar++, "", "", false,
+          "Let the interpreter filter the tuples of scans that only insert into another "
+          "relation a batch at a time."},
       {"verbose", 'v', "", "", false,
           "Verbose output."},
       {"version", nextOptChar++, "", "", false,
@@ -865,6 +976,101 @@ int main(Global& glb, const char* souffle_executable) {
                 throw std::runtime_error("must be profiling to use emit-statistics");
         }
 
+        if (glb.config().has("profile-trace") && !glb.config().has("profile")) {
+            throw std::runtime_error("must be profiling to use profile-trace");
+        }
+
+        if (glb.config().has("cluster")) {
+            if (glb.config().has("compile") || glb.config().has("compile-many") ||
+                    glb.config().has("dl-program") || glb.config().has("generate") ||
+                    glb.config().has("generate-many") || glb.config().has("swig")) {
+                throw std::runtime_error("cluster requires the interpreter");
+            }
+            if (glb.config().has("provenance")) {
+                throw std::runtime_error("cluster cannot be used with provenance");
+            }
+            if (glb.config().has("checkpoint")) {
+                throw std::runtime_error("cluster cannot be used with checkpoint");
+            }
+            const std::size_t numWorkers = splitString(glb.config().get("cluster"), ',').size();
+            if (!glb.config().has("cluster-rank") ||
+                    !isCountInRange(glb.config().get("cluster-rank"), 0, numWorkers - 1)) {
+                throw std::runtime_error(
+                        "--cluster-rank must be set to a position in the cluster endpoints.");
+            }
+        } else if (glb.config().has("cluster-rank")) {
+            throw std::runtime_error("cluster-rank requires cluster");
+        }
+
+        if (glb.config().has("async-io") && !glb.config().has("compile") &&
+                !glb.config().has("compile-many") && !glb.config().has("dl-program") &&
+                !glb.config().has("generate") && !glb.config().has("generate-many") &&
+                !glb.config().has("swig")) {
+            throw std::runtime_error("async-io requires the synthesiser");
+        }
+
+        if (glb.config().has("compile-cache") && !glb.config().has("compile") &&
+                !glb.config().has("compile-many") && !glb.config().has("dl-program")) {
+            throw std::runtime_error("compile-cache requires one of compile, compile-many or dl-program");
+        }
+
+        if (glb.config().has("spill-budget")) {
+            if (!glb.config().has("spill-dir")) {
+                throw std::runtime_error("spill-budget requires spill-dir");
+            }
+            // the budget is given in megabytes, but counted in bytes
+            if (!isCountInRange(glb.config().get("spill-budget"), 0,
+                        std::numeric_limits<std::size_t>::max() >> 20)) {
+                throw std::runtime_error("--spill-budget may only be set to a non-negative integer.");
+            }
+        }
+
+        if (glb.config().has("pgo-train")) {
+            if (!glb.config().has("compile") && !glb.config().has("compile-many") &&
+                    !glb.config().has("dl-program")) {
+                throw std::runtime_error("pgo-train requires one of compile, compile-many or dl-program");
+            }
+            if (glb.config().has("swig")) {
+                throw std::runtime_error("pgo-train cannot be used with swig");
+            }
+            if (!existDir(glb.config().get("pgo-train"))) {
+                throw std::runtime_error(
+                        "training directory `" + glb.config().get("pgo-train") + "` does not exist");
+            }
+        }
+
+        if (glb.config().has("checkpoint") && !existDir(glb.config().get("checkpoint"))) {
+            throw std::runtime_error(
+                    "checkpoint directory `" + glb.config().get("checkpoint") + "` does not exist");
+        }
+
+        for (const char* option : {"checkpoint-iterations", "checkpoint-stop", "checkpoint-strata"}) {
+            if (!glb.config().has(option)) {
+                continue;
+            }
+            if (!glb.config().has("checkpoint")) {
+                throw std::runtime_error(std::string(option) + " requires checkpoint");
+            }
+            if (!isCountInRange(glb.config().get(option), 1)) {
+                throw std::runtime_error(
+                        "--" + std::string(option) + " may only be set to an integer greater than 0.");
+            }
+        }
+
+        if (glb.config().has("spill-dir") && !existDir(glb.config().get("spill-dir"))) {
+            throw std::runtime_error(
+                    "spill directory `" + glb.config().get("spill-dir") + "` does not exist");
+        }
+
+        if (glb.config().has("statistics-sample")) {
+            if (!glb.config().has("emit-statistics")) {
+                throw std::runtime_error("statistics-sample requires emit-statistics");
+            }
+            if (!isCountInRange(glb.config().get("statistics-sample"), 1)) {
+                throw std::runtime_error("--statistics-sample may only be set to an integer greater than 0.");
+            }
+        }
+
     } catch (std::exception& e) {
         std::cerr << e.what() << std::endl;
         exit(EXIT_FAILURE);
@@ -1004,6 +1210,12 @@ int main(Global& glb, const char* souffle_executable) {
     // Apply all the transformations
     pipeline->apply(*astTranslationUnit);
 
+    if (glb.config().has("transformer-times")) {
+        printPassStatistics(
+                std::cerr, "AST transformers", astTranslationUnit->getTransformerStatistics(), true);
+        printPassStatistics(std::cerr, "AST analyses", astTranslationUnit->getAnalysisStatistics(), false);
+    }
+
     // Output the transformed datalog (support alias opt name of 'datalog')
     if (hasShowOpt("transformed-ast", "transformed-datalog")) {
         std::cout << astTranslationUnit->getProgram() << std::endl;
@@ -1061,6 +1273,12 @@ int main(Global& glb, const char* souffle_executable) {
         ramTransform->apply(*ramTranslationUnit);
     }
 
+    if (glb.config().has("transformer-times")) {
+        printPassStatistics(
+                std::cerr, "RAM transformers", ramTranslationUnit->getTransformerStatistics(), true);
+        printPassStatistics(std::cerr, "RAM analyses", ramTranslationUnit->getAnalysisStatistics(), false);
+    }
+
     if (ramTranslationUnit->getErrorReport().getNumIssues() != 0) {
         std::cerr << ramTranslationUnit->getErrorReport();
     }
@@ -1116,36 +1334,72 @@ int main(Global& glb, const char* souffle_executable) {
             std::string baseIdentifier = identifier(simpleName(baseFilename));
 
             std::string binaryFilename = baseFilename;
+#if defined(_MSC_VER)
+            const std::string executableExtension = ".exe";
+#else
+            const std::string executableExtension;
+#endif
+
+            /* Fail if a souffle-compile executable is not found */
+            std::optional<std::string> souffle_compile;
+            if (must_compile) {
+                souffle_compile = findTool("souffle-compile.py", souffleExecutable, ".");
+                if (!souffle_compile) throw std::runtime_error("failed to locate souffle-compile.py");
+            }
 
-            bool withSharedLibrary;
-            auto synthesisStart = std::chrono::high_resolution_clock::now();
-            const bool emitToStdOut = glb.config().has("generate", "-");
-            const bool emitMultipleFiles =
-                    glb.config().has("generate-many") || glb.config().has("compile-many");
+            // Look up the program in the compile cache. The binary of a cached program is
+            // taken as is unless the C++ sources were requested as well.
+            Own<synthesiser::CompileCache> cache;
+            bool cached = false;
+            bool withSharedLibrary = false;
+            if (must_compile && glb.config().has("compile-cache") && !glb.config().has("swig")) {
+                cache = mk<synthesiser::CompileCache>(glb.config().get("compile-cache"),
+                        synthesiser::CompileCache::computeKey(
+                                ramTranslationUnit->getProgram(), glb.config(), *souffle_compile));
+                if (!generate_mode && !generate_many_mode) {
+                    cached = cache->fetch(binaryFilename + executableExtension, withSharedLibrary);
+                }
+                if (glb.config().has("verbose")) {
+                    std::cout << "Compile cache " << (cached ? "hit" : "lookup") << ": " << cache->getKey()
+                              << "\n";
+                }
+            }
 
-            synthesiser::GenDb db;
-            synthesiser->generateCode(db, baseIdentifier, withSharedLibrary);
             std::vector<fs::path> srcFiles;
+            if (!cached) {
+                auto synthesisStart = std::chrono::high_resolution_clock::now();
+                const bool emitToStdOut = glb.config().has("generate", "-");
+                const bool emitMultipleFiles =
+                        glb.config().has("generate-many") || glb.config().has("compile-many");
+
+                synthesiser::GenDb db;
+                synthesiser->generateCode(db, baseIdentifier, withSharedLibrary);
+
+                if (emitToStdOut) {
+                    db.emitSingleFile(std::cout);
+                } else if (emitMultipleFiles) {
+                    fs::path directory = glb.config().has("generate-many")
+                                                 ? fs::path(glb.config().get("generate-many"))
+                                                 : fs::temp_directory_path() / baseIdentifier;
+                    std::string mainClass = db.emitMultipleFilesInDir(directory, srcFiles);
+                    binaryFilename = (directory / fs::path(mainClass)).string();
+                } else {
+                    std::string sourceFilename = baseFilename + ".cpp";
+                    std::ofstream os{sourceFilename};
+                    db.emitSingleFile(os);
+                    os.close();
+                    srcFiles.push_back(fs::path(sourceFilename));
+                }
+                if (glb.config().has("verbose")) {
+                    auto synthesisEnd = std::chrono::high_resolution_clock::now();
+                    std::cout << "Synthesis time: "
+                              << std::chrono::duration<double>(synthesisEnd - synthesisStart).count()
+                              << "sec\n";
+                }
 
-            if (emitToStdOut) {
-                db.emitSingleFile(std::cout);
-            } else if (emitMultipleFiles) {
-                fs::path directory = glb.config().has("generate-many")
-                                             ? fs::path(glb.config().get("generate-many"))
-                                             : fs::temp_directory_path() / baseIdentifier;
-                std::string mainClass = db.emitMultipleFilesInDir(directory, srcFiles);
-                binaryFilename = (directory / fs::path(mainClass)).string();
-            } else {
-                std::string sourceFilename = baseFilename + ".cpp";
-                std::ofstream os{sourceFilename};
-                db.emitSingleFile(os);
-                os.close();
-                srcFiles.push_back(fs::path(sourceFilename));
-            }
-            if (glb.config().has("verbose")) {
-                auto synthesisEnd = std::chrono::high_resolution_clock::now();
-                std::cout << "Synthesis time: "
-                          << std::chrono::duration<double>(synthesisEnd - synthesisStart).count() << "sec\n";
+                if (must_compile && cache && (generate_mode || generate_many_mode)) {
+                    cached = cache->fetch(binaryFilename + executableExtension, withSharedLibrary);
+                }
             }
 
             if (withSharedLibrary) {
@@ -1157,28 +1411,24 @@ int main(Global& glb, const char* souffle_executable) {
                 }
             }
 
-            if (must_compile) {
-                /* Fail if a souffle-compile executable is not found */
-                const auto souffle_compile = findTool("souffle-compile.py", souffleExecutable, ".");
-                if (!souffle_compile) throw std::runtime_error("failed to locate souffle-compile.py");
-
+            if (must_compile && !cached) {
                 auto t_bgn = std::chrono::high_resolution_clock::now();
                 fs::path output(binaryFilename);
-                compileToBinary(glb, *souffle_compile, srcFiles, output);
+                compileToBinary(glb, *souffle_compile, srcFiles, output, cache.get());
                 auto t_end = std::chrono::high_resolution_clock::now();
 
                 if (glb.config().has("verbose")) {
                     std::cout << "Compilation time: " << std::chrono::duration<double>(t_end - t_bgn).count()
                               << "sec\n";
                 }
+                if (cache) {
+                    cache->store(binaryFilename + executableExtension, withSharedLibrary);
+                }
             }
 
             // run compiled C++ program if requested.
             if (must_execute) {
-#if defined(_MSC_VER)
-                binaryFilename += ".exe";
-#endif
-                executeBinaryAndExit(glb, binaryFilename);
+                executeBinaryAndExit(glb, binaryFilename + executableExtension);
             }
         }
     } catch (std::exception& e) {
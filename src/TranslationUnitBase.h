@@ -22,6 +22,8 @@
 #include "souffle/utility/DynamicCasting.h"
 #include "souffle/utility/Types.h"
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstring>
 #include <map>
 #include <memory>
@@ -30,6 +32,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace souffle::detail {
 
@@ -67,6 +70,13 @@ inline std::ostream& operator<<(std::ostream& os, const AnalysisBase& rhs) {
     return os;
 }
 
+/** @brief The accumulated cost of an analysis or a transformer */
+struct PassStatistics {
+    std::size_t runs = 0;
+    std::size_t changes = 0;
+    double seconds = 0;
+};
+
 /**
  * @brief A translation context for a program.
  *
@@ -89,13 +99,25 @@ struct TranslationUnitBase {
     A& getAnalysis() const {
         static_assert(std::is_same_v<char const* const, decltype(A::name)>,
                 "`name` member must be a static literal");
+        assert(!analysesLocked && "analyses are not thread-safe and cannot be used while locked");
+        // record that the analysis being computed depends on this one
+        if (!runningAnalyses.empty()) {
+            dependencies[A::name].insert(runningAnalyses.back());
+        }
         auto it = analyses.find(A::name);
         if (it == analyses.end()) {
             it = analyses.insert({A::name, mk<A>()}).first;
 
             auto& analysis = *it->second;
             assert((std::strcmp(analysis.getName(), A::name) == 0) && "must be same pointer");
+            runningAnalyses.push_back(A::name);
+            auto start = std::chrono::steady_clock::now();
             analysis.run(static_cast<Impl const&>(*this));
+            auto end = std::chrono::steady_clock::now();
+            runningAnalyses.pop_back();
+            auto& statistics = analysisStatistics[A::name];
+            statistics.runs++;
+            statistics.seconds += std::chrono::duration<double>(end - start).count();
             logAnalysis(analysis);
         }
 
@@ -114,6 +136,67 @@ struct TranslationUnitBase {
     /** @brief Invalidate all alive analyses of the translation unit */
     void invalidateAnalyses() {
         analyses.clear();
+        dependencies.clear();
+    }
+
+    /**
+     * @brief Invalidate the alive analyses of the translation unit except the preserved ones
+     *
+     * A preserved analysis is invalidated nonetheless if it used an invalidated analysis.
+     */
+    void invalidateAnalyses(const std::set<std::string>& preserved) {
+        std::vector<std::string> pending;
+        for (const auto& [name, analysis] : analyses) {
+            if (preserved.count(name) == 0) {
+                pending.push_back(name);
+            }
+        }
+        while (!pending.empty()) {
+            const std::string name = pending.back();
+            pending.pop_back();
+            if (analyses.erase(name) == 0) {
+                continue;
+            }
+            auto it = dependencies.find(name);
+            if (it != dependencies.end()) {
+                pending.insert(pending.end(), it->second.begin(), it->second.end());
+                dependencies.erase(it);
+            }
+        }
+    }
+
+    /**
+     * @brief Forbid or allow the use of analyses
+     *
+     * Analyses are locked while they must not be used, such as while clauses
+     * are transformed in parallel, which is checked by assertions.
+     */
+    void setAnalysesLocked(bool locked) {
+        analysesLocked = locked;
+    }
+
+    /** @brief Record a run of a transformer of the translation unit */
+    void recordTransformer(const std::string& name, double seconds, bool changed) {
+        auto& statistics = transformerStatistics[name];
+        statistics.runs++;
+        statistics.changes += changed ? 1 : 0;
+        statistics.seconds += seconds;
+        transformerChanges += changed ? 1 : 0;
+    }
+
+    /** @brief Get the number of runs of transformers that changed the program */
+    std::size_t getTransformerChanges() const {
+        return transformerChanges;
+    }
+
+    /** @brief Get the accumulated cost of the analyses, by name */
+    const std::map<std::string, PassStatistics>& getAnalysisStatistics() const {
+        return analysisStatistics;
+    }
+
+    /** @brief Get the accumulated cost of the transformers, by name */
+    const std::map<std::string, PassStatistics>& getTransformerStatistics() const {
+        return transformerStatistics;
     }
 
     /** @brief Get the global configuration */
@@ -127,7 +210,7 @@ struct TranslationUnitBase {
     }
 
     /** @brief Obtain error report */
-    ErrorReport& getErrorReport() {
+    ErrorReport& getErrorReport() const {
         return errorReport;
     }
 
@@ -145,6 +228,19 @@ protected:
     //       Using `std::string` appears to suppress the issue (bug?).
     mutable std::map<std::string, Own<Analysis>> analyses;
 
+    /* The analyses that used each analysis when they were computed */
+    mutable std::map<std::string, std::set<std::string>> dependencies;
+
+    /* The analyses being computed, innermost last */
+    mutable std::vector<std::string> runningAnalyses;
+
+    mutable std::map<std::string, PassStatistics> analysisStatistics;
+    std::map<std::string, PassStatistics> transformerStatistics;
+    std::size_t transformerChanges = 0;
+
+    /* Whether the use of analyses is forbidden */
+    bool analysesLocked = false;
+
     Global& glb;
 
     /* RAM program */
@@ -18,10 +18,10 @@
 
 namespace souffle::ast {
 
-FunctorDeclaration::FunctorDeclaration(
-        std::string name, VecOwn<Attribute> params, Own<Attribute> returnType, bool stateful, SrcLocation loc)
+FunctorDeclaration::FunctorDeclaration(std::string name, VecOwn<Attribute> params, Own<Attribute> returnType,
+        bool stateful, bool batch, SrcLocation loc)
         : Node(NK_FunctorDeclaration, std::move(loc)), name(std::move(name)), params(std::move(params)),
-          returnType(std::move(returnType)), stateful(stateful) {
+          returnType(std::move(returnType)), stateful(stateful), batch(batch) {
     assert(this->name.length() > 0 && "functor name is empty");
     assert(allValidPtrs(this->params));
     assert(this->returnType != nullptr);
@@ -33,16 +33,19 @@ void FunctorDeclaration::print(std::ostream& out) const {
     if (stateful) {
         out << " stateful";
     }
+    if (batch) {
+        out << " batch";
+    }
 }
 
 bool FunctorDeclaration::equal(const Node& node) const {
     const auto& other = asAssert<FunctorDeclaration>(node);
     return name == other.name && params == other.params && returnType == other.returnType &&
-           stateful == other.stateful;
+           stateful == other.stateful && batch == other.batch;
 }
 
 FunctorDeclaration* FunctorDeclaration::cloning() const {
-    return new FunctorDeclaration(name, clone(params), clone(returnType), stateful, getSrcLoc());
+    return new FunctorDeclaration(name, clone(params), clone(returnType), stateful, batch, getSrcLoc());
 }
 
 bool FunctorDeclaration::classof(const Node* n) {
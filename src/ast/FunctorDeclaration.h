@@ -32,12 +32,17 @@ namespace souffle::ast {
  *
  * Example:
  *    .functor foo(x:number, y:number):number
+ *
+ * A batch functor is called with the arguments of many calls at once, as an
+ * array of rows of RamDomain values, and stores a result per row:
+ *    void foo(std::size_t count, const RamDomain* args, RamDomain* results)
+ * A stateful batch functor receives the symbol and record tables first.
  */
 
 class FunctorDeclaration : public Node {
 public:
     FunctorDeclaration(std::string name, VecOwn<Attribute> params, Own<Attribute> returnType, bool stateful,
-            SrcLocation loc = {});
+            bool batch, SrcLocation loc = {});
 
     /** Return name */
     const std::string& getName() const {
@@ -64,6 +69,11 @@ public:
         return stateful;
     }
 
+    /** Check whether functor is called with batches of arguments */
+    bool isBatch() const {
+        return batch;
+    }
+
     static bool classof(const Node*);
 
 protected:
@@ -86,6 +96,9 @@ private:
 
     /** Stateful flag */
     const bool stateful;
+
+    /** Batch flag */
+    const bool batch;
 };
 
 }  // namespace souffle::ast
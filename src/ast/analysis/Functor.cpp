@@ -41,6 +41,10 @@ bool FunctorAnalysis::isStatefulFunctor(const UserDefinedAggregator& aggregator)
     return getFunctorDeclaration(aggregator).isStateful();
 }
 
+bool FunctorAnalysis::isBatchFunctor(const UserDefinedFunctor& functor) const {
+    return getFunctorDeclaration(functor).isBatch();
+}
+
 QualifiedName const& FunctorAnalysis::getFunctorReturnType(const UserDefinedFunctor& functor) const {
     return getFunctorDeclaration(functor).getReturnType().getTypeName();
 }
@@ -52,6 +52,7 @@ public:
     QualifiedName const& getFunctorReturnType(const UserDefinedFunctor& functor) const;
     bool isStatefulFunctor(const UserDefinedFunctor& functor) const;
     bool isStatefulFunctor(const UserDefinedAggregator& aggregator) const;
+    bool isBatchFunctor(const UserDefinedFunctor& functor) const;
     const FunctorDeclaration& getFunctorDeclaration(const UserDefinedFunctor& functor) const;
     const FunctorDeclaration& getFunctorDeclaration(const UserDefinedAggregator& aggregator) const;
 
@@ -37,6 +37,10 @@ void RelationScheduleAnalysisStep::print(std::ostream& os) const {
     for (const Relation* compRel : computed()) {
         os << compRel->getQualifiedName() << ", ";
     }
+    os << "\nused: ";
+    for (const Relation* usedRel : used()) {
+        os << usedRel->getQualifiedName() << ", ";
+    }
     os << "\nexpired: ";
     for (const Relation* compRel : expired()) {
         os << compRel->getQualifiedName() << ", ";
@@ -62,8 +66,16 @@ void RelationScheduleAnalysis::run(const TranslationUnit& translationUnit) {
     for (std::size_t i = 0; i < numSCCs; i++) {
         const auto scc = topsortSCCGraphAnalysis->order()[i];
         const RelationSet computedRelations = sccGraph->getInternalRelations(scc);
-        relationSchedule.emplace_back(
-                computedRelations, relationExpirySchedule[i], sccGraph->isRecursive(scc));
+        RelationSet usedRelations;
+        for (const Relation* r : computedRelations) {
+            for (const Relation* predecessor : precedenceGraph->graph().predecessors(r)) {
+                if (computedRelations.count(predecessor) == 0) {
+                    usedRelations.insert(predecessor);
+                }
+            }
+        }
+        relationSchedule.emplace_back(computedRelations, std::move(usedRelations), relationExpirySchedule[i],
+                sccGraph->isRecursive(scc));
     }
 
     topsortSCCGraphAnalysis = nullptr;
@@ -33,20 +33,25 @@
 namespace souffle::ast::analysis {
 
 /**
- * A single step in a relation schedule, consisting of the relations computed in the step
- * and the relations that are no longer required at that step.
+ * A single step in a relation schedule, consisting of the relations computed in the step,
+ * the relations of earlier steps read in the step, and the relations that are no longer
+ * required at that step.
  */
 class RelationScheduleAnalysisStep {
 public:
-    RelationScheduleAnalysisStep(
-            RelationSet computedRelations, RelationSet expiredRelations, const bool isRecursive)
-            : computedRelations(std::move(computedRelations)), expiredRelations(std::move(expiredRelations)),
-              isRecursive(isRecursive) {}
+    RelationScheduleAnalysisStep(RelationSet computedRelations, RelationSet usedRelations,
+            RelationSet expiredRelations, const bool isRecursive)
+            : computedRelations(std::move(computedRelations)), usedRelations(std::move(usedRelations)),
+              expiredRelations(std::move(expiredRelations)), isRecursive(isRecursive) {}
 
     const RelationSet& computed() const {
         return computedRelations;
     }
 
+    const RelationSet& used() const {
+        return usedRelations;
+    }
+
     const RelationSet& expired() const {
         return expiredRelations;
     }
@@ -65,6 +70,7 @@ public:
 
 private:
     RelationSet computedRelations;
+    RelationSet usedRelations;
     RelationSet expiredRelations;
     const bool isRecursive;
 };
@@ -25,6 +25,7 @@
 #include "ast/analysis/ClauseNormalisation.h"
 #include "ast/transform/MagicSet.h"
 #include "ast/transform/MinimiseProgram.h"
+#include "ast/transform/NameUnnamedVariables.h"
 #include "ast/transform/RemoveRedundantRelations.h"
 #include "ast/transform/RemoveRelationCopies.h"
 #include "ast/transform/ResolveAliases.h"
@@ -156,6 +157,29 @@ TEST(Transformers, ResolveAliasesWithTermsInAtoms) {
             toString(*program.getClauses(qn("p"))[0]));
 }
 
+TEST(Transformers, NameUnnamedVariablesPerClause) {
+    Global glb;
+    ErrorReport errorReport;
+    DebugReport debugReport(glb);
+    Own<TranslationUnit> tu = ParserDriver::parseTranslationUnit(glb,
+            R"(
+                .decl p(a:number,b:number)
+                p(x,x) :- p(x,_), p(_,x).
+                p(x,x) :- p(_,x).
+            )",
+            errorReport, debugReport);
+
+    Program& program = tu->getProgram();
+
+    // the unnamed variables are numbered apart in each clause
+    EXPECT_TRUE(mk<NameUnnamedVariablesTransformer>()->apply(*tu));
+    EXPECT_EQ("p(x,x) :- \n   p(x,+underscore_0),\n   p(+underscore_1,x).",
+            toString(*program.getClauses(qn("p"))[0]));
+    EXPECT_EQ("p(x,x) :- \n   p(+underscore_0,x).", toString(*program.getClauses(qn("p"))[1]));
+
+    EXPECT_FALSE(mk<NameUnnamedVariablesTransformer>()->apply(*tu));
+}
+
 /**
  * Test that copies of relations are removed by RemoveRelationCopiesTransformer
  *
@@ -0,0 +1,92 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ClauseTransformer.cpp
+ *
+ ***********************************************************************/
+
+#include "ast/transform/ClauseTransformer.h"
+#include "Global.h"
+#include "ast/Program.h"
+#include "ast/analysis/Functor.h"
+#include "ast/analysis/IOType.h"
+#include "ast/analysis/PrecedenceGraph.h"
+#include "ast/analysis/RedundantRelations.h"
+#include "ast/analysis/RelationSchedule.h"
+#include "ast/analysis/SCCGraph.h"
+#include "ast/analysis/TopologicallySortedSCCGraph.h"
+#include "ast/analysis/typesystem/SumTypeBranches.h"
+#include "ast/analysis/typesystem/TypeEnvironment.h"
+#include "souffle/utility/StringUtil.h"
+#include <cstddef>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace souffle::ast::transform {
+
+std::set<std::string> ClauseTransformer::getPreservedAnalyses() const {
+    return {analysis::PrecedenceGraphAnalysis::name, analysis::SCCGraphAnalysis::name,
+            analysis::TopologicallySortedSCCGraphAnalysis::name, analysis::RelationScheduleAnalysis::name,
+            analysis::IOTypeAnalysis::name, analysis::RedundantRelationsAnalysis::name,
+            analysis::TypeEnvironmentAnalysis::name, analysis::SumTypeBranchesAnalysis::name,
+            analysis::FunctorAnalysis::name};
+}
+
+bool ClauseTransformer::transform(TranslationUnit& translationUnit) {
+    Program& program = translationUnit.getProgram();
+
+    // the clauses of a relation declared twice are collected once
+    std::vector<Clause*> clauses;
+    std::set<const Clause*> collected;
+    for (const Relation* rel : program.getRelations()) {
+        if (isTransformed(*rel)) {
+            for (Clause* clause : program.getClauses(*rel)) {
+                if (collected.insert(clause).second) {
+                    clauses.push_back(clause);
+                }
+            }
+        }
+    }
+
+    // transform the clauses, collecting the replacements
+    VecOwn<Clause> replacements(clauses.size());
+    std::vector<char> changed(clauses.size(), 0);
+    const auto size = static_cast<std::ptrdiff_t>(clauses.size());
+    // analyses are not thread-safe, and a clause transformation may not use them
+    translationUnit.setAnalysesLocked(true);
+#ifdef _OPENMP
+    const std::string& jobs = translationUnit.global().config().get("jobs");
+    const int threads = !jobs.empty() && isNumber(jobs.c_str()) ? std::stoi(jobs) : 1;
+#pragma omp parallel for schedule(dynamic, 16) num_threads(threads > 0 ? threads : omp_get_max_threads())
+#endif
+    for (std::ptrdiff_t i = 0; i < size; ++i) {
+        changed[i] = transformClause(*clauses[i], replacements[i]) ? 1 : 0;
+    }
+    translationUnit.setAnalysesLocked(false);
+
+    // replace the clauses in their original order
+    bool result = false;
+    for (std::size_t i = 0; i < clauses.size(); ++i) {
+        result |= changed[i] != 0;
+        if (replacements[i]) {
+            program.removeClause(*clauses[i]);
+            program.addClause(std::move(replacements[i]));
+        }
+    }
+    return result;
+}
+
+}  // namespace souffle::ast::transform
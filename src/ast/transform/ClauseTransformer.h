@@ -0,0 +1,62 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ClauseTransformer.h
+ *
+ * Defines the interface for transformation passes that rewrite each
+ * clause on its own.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ast/Clause.h"
+#include "ast/Relation.h"
+#include "ast/TranslationUnit.h"
+#include "ast/transform/Transformer.h"
+#include "souffle/utility/Types.h"
+#include <set>
+#include <string>
+
+namespace souffle::ast::transform {
+
+/**
+ * A transformer that rewrites each clause independently of the others.
+ *
+ * The clauses are transformed in parallel, with as many threads as the
+ * jobs option permits. A clause transformation may not use analyses nor
+ * any state shared with other clauses, and may not change the relations
+ * that the clause refers to, so that the analyses of relations and types
+ * are preserved.
+ */
+class ClauseTransformer : public Transformer {
+public:
+    std::set<std::string> getPreservedAnalyses() const override;
+
+protected:
+    /**
+     * Transform a clause, in place or by setting a replacement.
+     *
+     * @param clause the clause to be transformed
+     * @param replacement set to the clause replacing the given one, if any
+     * @return whether the clause was changed
+     */
+    virtual bool transformClause(Clause& clause, Own<Clause>& replacement) const = 0;
+
+    /** Whether the clauses of a relation are transformed */
+    virtual bool isTransformed(const Relation& /* relation */) const {
+        return true;
+    }
+
+private:
+    bool transform(TranslationUnit& translationUnit) override;
+};
+
+}  // namespace souffle::ast::transform
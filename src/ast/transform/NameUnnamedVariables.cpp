@@ -16,27 +16,24 @@
 #include "ast/Clause.h"
 #include "ast/Negation.h"
 #include "ast/Node.h"
-#include "ast/Program.h"
-#include "ast/Relation.h"
-#include "ast/TranslationUnit.h"
 #include "ast/UnnamedVariable.h"
 #include "ast/Variable.h"
 #include "ast/utility/Utils.h"
 #include <cstddef>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <vector>
 
 namespace souffle::ast::transform {
 
-bool NameUnnamedVariablesTransformer::transform(TranslationUnit& translationUnit) {
-    bool changed = false;
-    static constexpr const char* boundPrefix = "+underscore";
-    static std::size_t underscoreCount = 0;
+bool NameUnnamedVariablesTransformer::transformClause(Clause& clause, Own<Clause>& /* replacement */) const {
+    static constexpr const char* boundPrefix = "+underscore_";
 
     struct nameVariables : public NodeMapper {
         mutable bool changed = false;
-        nameVariables() = default;
+        mutable std::size_t underscoreCount;
+        nameVariables(std::size_t underscoreCount) : underscoreCount(underscoreCount) {}
 
         Own<Node> operator()(Own<Node> node) const override {
             if (isA<Negation>(node)) {
@@ -45,7 +42,7 @@ bool NameUnnamedVariablesTransformer::transform(TranslationUnit& translationUnit
             if (isA<UnnamedVariable>(node)) {
                 changed = true;
                 std::stringstream name;
-                name << boundPrefix << "_" << underscoreCount++;
+                name << boundPrefix << underscoreCount++;
                 return mk<ast::Variable>(name.str());
             }
             node->apply(*this);
@@ -53,16 +50,10 @@ bool NameUnnamedVariablesTransformer::transform(TranslationUnit& translationUnit
         }
     };
 
-    Program& program = translationUnit.getProgram();
-    for (Relation* rel : program.getRelations()) {
-        for (auto&& clause : program.getClauses(*rel)) {
-            nameVariables update;
-            clause->apply(update);
-            changed |= update.changed;
-        }
-    }
-
-    return changed;
+    // number the variables of each clause apart, so that clauses can be named concurrently
+    nameVariables update(getFreshVariableIndex(clause, boundPrefix));
+    clause.apply(update);
+    return update.changed;
 }
 
 }  // namespace souffle::ast::transform
@@ -18,8 +18,9 @@
 
 #pragma once
 
-#include "ast/TranslationUnit.h"
-#include "ast/transform/Transformer.h"
+#include "ast/Clause.h"
+#include "ast/transform/ClauseTransformer.h"
+#include "souffle/utility/Types.h"
 #include <string>
 
 namespace souffle::ast::transform {
@@ -29,7 +30,7 @@ namespace souffle::ast::transform {
  * with singletons.
  * E.g.: a() :- b(_). -> a() :- b(x).
  */
-class NameUnnamedVariablesTransformer : public Transformer {
+class NameUnnamedVariablesTransformer : public ClauseTransformer {
 public:
     std::string getName() const override {
         return "NameUnnamedVariablesTransformer";
@@ -40,7 +41,7 @@ private:
         return new NameUnnamedVariablesTransformer();
     }
 
-    bool transform(TranslationUnit& translationUnit) override;
+    bool transformClause(Clause& clause, Own<Clause>& replacement) const override;
 };
 
 }  // namespace souffle::ast::transform
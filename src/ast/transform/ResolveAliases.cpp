@@ -544,7 +544,7 @@ Own<Clause> ResolveAliasesTransformer::removeComplexTermsInAtoms(const Clause& c
     using substitution_map = std::vector<std::pair<Own<Argument>, Own<ast::Variable>>>;
     substitution_map termToVar;
 
-    static int varCounter = 0;
+    std::size_t varCounter = getFreshVariableIndex(*res, " _tmp_");
     for (const Argument* arg : terms) {
         // create a new mapping for this term
         auto term = clone(arg);
@@ -592,61 +592,47 @@ Own<Clause> ResolveAliasesTransformer::removeComplexTermsInAtoms(const Clause& c
     return res;
 }
 
-bool ResolveAliasesTransformer::transform(TranslationUnit& translationUnit) {
-    bool changed = false;
-    Program& program = translationUnit.getProgram();
-
-    // get all clauses
-    std::vector<Clause*> clauses;
-    visit(program, [&](const Relation& rel) {
-        const auto& qualifiers = rel.getQualifiers();
-        // Don't resolve clauses of inlined relations
-        if (qualifiers.count(RelationQualifier::INLINE) == 0) {
-            for (auto&& clause : program.getClauses(rel)) {
-                clauses.push_back(clause);
-            }
-        }
-    });
+bool ResolveAliasesTransformer::isTransformed(const Relation& relation) const {
+    // Don't resolve clauses of inlined relations
+    return relation.getQualifiers().count(RelationQualifier::INLINE) == 0;
+}
 
-    // clean all clauses
-    for (Clause* const clause : clauses) {
-        // Name unnamed variables in record and branch inits (souffle-lang/souffle#2482)
-        // This is fine as long as this transformer runs after the semantics checker
-        changed |= nameUnnamedInit(*clause);
-
-        // Repeat resolution until fixpoint.
-        //
-        // We must repeat the resolution when a variable appearing as an atom
-        // argument is replaced by a record or an adt. Because the record (or
-        // adt) arguments become grounded and gives opportunity to resolve
-        // additionnal equalities.
-        Own<Clause> modified;
-        while (true) {
-            Clause* init = modified ? modified.get() : clause;
-
-            // get rid of aliases
-            Own<Clause> noAlias = resolveAliases(*init);
-
-            // clean up equalities
-            Own<Clause> cleaned = removeTrivialEquality(*noAlias);
-
-            // restore simple terms in atoms
-            Own<Clause> normalised = removeComplexTermsInAtoms(*cleaned);
-
-            if (*normalised == *init) {
-                // reached fixpoint
-                if (modified) {
-                    // original clause modified
-                    changed = true;
-                    program.removeClause(*clause);
-                    program.addClause(std::move(normalised));
-                }
-                break;
+bool ResolveAliasesTransformer::transformClause(Clause& clause, Own<Clause>& replacement) const {
+    // Name unnamed variables in record and branch inits (souffle-lang/souffle#2482)
+    // This is fine as long as this transformer runs after the semantics checker
+    bool changed = nameUnnamedInit(clause);
+
+    // Repeat resolution until fixpoint.
+    //
+    // We must repeat the resolution when a variable appearing as an atom
+    // argument is replaced by a record or an adt. Because the record (or
+    // adt) arguments become grounded and gives opportunity to resolve
+    // additionnal equalities.
+    Own<Clause> modified;
+    while (true) {
+        Clause* init = modified ? modified.get() : &clause;
+
+        // get rid of aliases
+        Own<Clause> noAlias = resolveAliases(*init);
+
+        // clean up equalities
+        Own<Clause> cleaned = removeTrivialEquality(*noAlias);
+
+        // restore simple terms in atoms
+        Own<Clause> normalised = removeComplexTermsInAtoms(*cleaned);
+
+        if (*normalised == *init) {
+            // reached fixpoint
+            if (modified) {
+                // original clause modified
+                changed = true;
+                replacement = std::move(normalised);
             }
+            break;
+        }
 
-            modified = std::move(normalised);
-        };
-    }
+        modified = std::move(normalised);
+    };
 
     return changed;
 }
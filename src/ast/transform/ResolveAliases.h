@@ -15,8 +15,8 @@
 #pragma once
 
 #include "ast/Clause.h"
-#include "ast/TranslationUnit.h"
-#include "ast/transform/Transformer.h"
+#include "ast/Relation.h"
+#include "ast/transform/ClauseTransformer.h"
 #include "souffle/utility/ContainerUtil.h"
 #include <memory>
 #include <string>
@@ -28,7 +28,7 @@ namespace souffle::ast::transform {
  * e.g. resolve: a(r) , r = [x,y]       => a(x,y)
  * e.g. resolve: a(x) , !b(y) , y = x   => a(x) , !b(x)
  */
-class ResolveAliasesTransformer : public Transformer {
+class ResolveAliasesTransformer : public ClauseTransformer {
 public:
     std::string getName() const override {
         return "ResolveAliasesTransformer";
@@ -71,7 +71,9 @@ private:
         return new ResolveAliasesTransformer();
     }
 
-    bool transform(TranslationUnit& translationUnit) override;
+    bool isTransformed(const Relation& relation) const override;
+
+    bool transformClause(Clause& clause, Own<Clause>& replacement) const override;
 };
 
 }  // namespace souffle::ast::transform
@@ -75,6 +75,7 @@
 #include "reports/ErrorReport.h"
 #include "souffle/BinaryConstraintOps.h"
 #include "souffle/TypeAttribute.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/FunctionalUtil.h"
 #include "souffle/utility/MiscUtil.h"
@@ -671,6 +672,11 @@ void SemanticCheckerImpl::checkLatticeDeclaration(const Lattice& lattice) {
         if (!isA<UserDefinedFunctor>(lattice.getLub())) {
             report.addError(
                     tfm::format("Lattice operator Lub must be a user-defined functor"), lattice.getSrcLoc());
+        } else if (auto const* udfd = getFunctorDeclaration(
+                           program, as<UserDefinedFunctor>(lattice.getLub())->getName());
+                   udfd != nullptr && udfd->isBatch()) {
+            report.addError(
+                    tfm::format("Lattice operator Lub cannot be a batch functor"), lattice.getSrcLoc());
         }
     } else {
         report.addError(tfm::format("Lattice %s<> does not define Lub", name), lattice.getSrcLoc());
@@ -814,6 +820,15 @@ void SemanticCheckerImpl::checkRelation(const Relation& relation) {
                 relation.getSrcLoc());
     }
 
+    // compact provenance leaves a fixed number of bits for the rule number
+    if (tu.global().config().has("provenance") && tu.global().config().has("provenance-compact") &&
+            program.getClauses(relation).size() > static_cast<std::size_t>(provenance::compactRuleMask)) {
+        report.addError("Relation " + toString(relation.getQualifiedName()) + " has more than " +
+                                std::to_string(provenance::compactRuleMask) +
+                                " rules, which compact provenance cannot number",
+                relation.getSrcLoc());
+    }
+
     // if the relation is a delta_debug, make sure if has no clause
     if (relation.getIsDeltaDebug().has_value()) {
         if (!program.getClauses(relation).empty() || ioTypes.isInput(&relation)) {
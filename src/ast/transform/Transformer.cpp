@@ -16,16 +16,34 @@
 
 #include "ast/transform/Transformer.h"
 #include "ast/TranslationUnit.h"
+#include "ast/transform/Meta.h"
 #include "reports/ErrorReport.h"
+#include "souffle/utility/DynamicCasting.h"
+#include <cassert>
+#include <chrono>
+#include <cstddef>
 
 namespace souffle::ast::transform {
 
 bool Transformer::apply(TranslationUnit& translationUnit) {
     // invoke the transformation
+    [[maybe_unused]] const std::size_t changesBefore = translationUnit.getTransformerChanges();
+    auto start = std::chrono::steady_clock::now();
     bool changed = transform(translationUnit);
-
-    if (changed) {
-        translationUnit.invalidateAnalyses();
+    auto end = std::chrono::steady_clock::now();
+
+    // The subtransformers of a meta-transformer account for themselves: a meta-transformer changes the
+    // program only by applying subtransformers, which invalidate the analyses they do not preserve. A
+    // meta-transformer changing the program on its own would leave stale analyses behind.
+    assert((!changed || !isA<MetaTransformer>(this) ||
+                   translationUnit.getTransformerChanges() > changesBefore) &&
+            "meta-transformer changed the program other than through its subtransformers");
+    if (!isA<MetaTransformer>(this)) {
+        if (changed) {
+            translationUnit.invalidateAnalyses(getPreservedAnalyses());
+        }
+        translationUnit.recordTransformer(
+                getName(), std::chrono::duration<double>(end - start).count(), changed);
     }
 
     /* Abort evaluation of the program if errors were encountered */
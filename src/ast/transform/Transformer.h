@@ -18,6 +18,7 @@
 
 #include "ast/TranslationUnit.h"
 #include "souffle/utility/Types.h"
+#include <set>
 #include <string>
 
 namespace souffle::ast::transform {
@@ -33,6 +34,14 @@ public:
 
     virtual std::string getName() const = 0;
 
+    /**
+     * The names of the analyses that remain valid when the transformer
+     * changes the program. By default, no analysis is preserved.
+     */
+    virtual std::set<std::string> getPreservedAnalyses() const {
+        return {};
+    }
+
     /**
      * Transformers can be disabled by command line
      * with --disable-transformer. Default behaviour
@@ -104,6 +104,23 @@ public:
                     report.addError("Functors which are not stateful cannot use UDTs", param->getSrcLoc());
                 }
             }
+
+            // Batches are passed as RamDomain values, which only stateful functors can decode to symbols
+            if (decl->isBatch() && !decl->isStateful()) {
+                auto isSymbol = [this](QualifiedName const& tName) {
+                    return getTypeAttribute(typeEnv.getType(tName)) == TypeAttribute::Symbol;
+                };
+                if (isSymbol(decl->getReturnType().getTypeName())) {
+                    report.addError("Batch functors which are not stateful cannot use symbols",
+                            decl->getReturnType().getSrcLoc());
+                }
+                for (auto const& param : decl->getParams()) {
+                    if (isSymbol(param->getTypeName())) {
+                        report.addError("Batch functors which are not stateful cannot use symbols",
+                                param->getSrcLoc());
+                    }
+                }
+            }
         }
     }
 
@@ -691,6 +708,11 @@ void TypeCheckerImpl::visit_(type_identity<IntrinsicAggregator>, const Intrinsic
 void TypeCheckerImpl::visit_(type_identity<UserDefinedAggregator>, const UserDefinedAggregator& aggregator) {
     // TODO
     /*const TypeSet& resultTypes =*/typeAnalysis.getTypes(&aggregator);
+
+    auto const* udfd = getFunctorDeclaration(program, aggregator.getBaseOperatorName());
+    if (udfd != nullptr && udfd->isBatch()) {
+        report.addError("Batch functors cannot be used as aggregators", aggregator.getSrcLoc());
+    }
 }
 
 void TypeCheckerImpl::visit_(type_identity<Negation>, const Negation& neg) {
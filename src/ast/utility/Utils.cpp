@@ -32,6 +32,7 @@
 #include "ast/QualifiedName.h"
 #include "ast/Relation.h"
 #include "ast/TranslationUnit.h"
+#include "ast/Variable.h"
 #include "ast/analysis/Functor.h"
 #include "ast/analysis/typesystem/Type.h"
 #include "ast/analysis/typesystem/TypeSystem.h"
@@ -46,6 +47,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <string>
 
 namespace souffle::ast {
 
@@ -145,6 +147,17 @@ bool isRule(const Clause& clause) {
     return (clause.getHead() != nullptr) && !isFact(clause);
 }
 
+std::size_t getFreshVariableIndex(const Clause& clause, const std::string& prefix) {
+    std::size_t next = 0;
+    visit(clause, [&](const Variable& var) {
+        const std::string& name = var.getName();
+        if (name.size() > prefix.size() && isPrefix(prefix, name) && isNumber(name.c_str() + prefix.size())) {
+            next = std::max(next, static_cast<std::size_t>(std::stoull(name.substr(prefix.size()))) + 1);
+        }
+    });
+    return next;
+}
+
 bool isProposition(const Atom* atom) {
     return atom->getArguments().empty();
 }
@@ -130,6 +130,16 @@ bool isFact(const Clause& clause);
  */
 bool isRule(const Clause& clause);
 
+/**
+ * Returns an index from which the variables named prefix + index are fresh
+ * in the given clause, i.e. one past the largest index of such a variable.
+ *
+ * @param clause the clause
+ * @param prefix the prefix of the names
+ * @return the first fresh index
+ */
+std::size_t getFreshVariableIndex(const Clause& clause, const std::string& prefix);
+
 /**
  * Returns whether the given atom is a propositon
  * @return true iff the atom has no arguments
@@ -34,6 +34,8 @@
 #include "ram/Scan.h"
 #include "ram/SignedConstant.h"
 #include "ram/UndefValue.h"
+#include "ram/utility/Utils.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/StringUtil.h"
 
 namespace souffle::ast2ram::provenance {
@@ -54,8 +56,9 @@ Own<ram::Operation> ClauseTranslator::addNegatedDeltaAtom(
     for (const auto* arg : args) {
         values.push_back(context.translateValue(*valueIndex, arg));
     }
-    values.push_back(mk<ram::UndefValue>());
-    values.push_back(mk<ram::UndefValue>());
+    for (std::size_t i = 0; i < context.getProvenanceArity(); i++) {
+        values.push_back(mk<ram::UndefValue>());
+    }
 
     return mk<ram::Filter>(
             mk<ram::Negation>(mk<ram::ExistenceCheck>(name, std::move(values))), std::move(op));
@@ -70,11 +73,8 @@ Own<ram::Operation> ClauseTranslator::addNegatedAtom(
         values.push_back(context.translateValue(*valueIndex, arg));
     }
 
-    // undefined value for rule number
-    values.push_back(mk<ram::UndefValue>());
-
-    // height
-    values.push_back(getLevelNumber(clause));
+    // undefined value for rule number, and the height
+    addAnnotation(values, mk<ram::UndefValue>(), getLevelNumber(clause));
 
     return mk<ram::Filter>(mk<ram::Negation>(mk<ram::ProvenanceExistenceCheck>(
                                    getConcreteRelationName(atom->getQualifiedName()), std::move(values))),
@@ -88,6 +88,14 @@ void ClauseTranslator::indexAtoms(const ast::Clause& clause) {
         std::size_t scanLevel = addOperatorLevel(atom);
         indexNodeArguments(scanLevel, atom->getArguments());
 
+        if (isCompact()) {
+            // Add the annotation holding both numbers
+            std::string annotationVarName = "@provenance_num_" + std::to_string(atomIdx);
+            valueIndex->addVarReference(annotationVarName, scanLevel, atom->getArity());
+            atomIdx++;
+            continue;
+        }
+
         // Add rule num variable
         std::string ruleNumVarName = "@rule_num_" + std::to_string(atomIdx);
         valueIndex->addVarReference(ruleNumVarName, scanLevel, atom->getArity());
@@ -100,16 +108,83 @@ void ClauseTranslator::indexAtoms(const ast::Clause& clause) {
     }
 }
 
-Own<ram::Expression> ClauseTranslator::getLevelNumber(const ast::Clause& clause) const {
-    auto getLevelVariable = [&](std::size_t atomIdx) { return "@level_num_" + std::to_string(atomIdx); };
+bool ClauseTranslator::isCompact() const {
+    return context.getProvenanceArity() == 1;
+}
+
+Own<ram::Expression> ClauseTranslator::getRuleNumber(std::size_t atomIdx) const {
+    if (!isCompact()) {
+        auto ruleNumVar = mk<ast::Variable>("@rule_num_" + std::to_string(atomIdx));
+        return context.translateValue(*valueIndex, ruleNumVar.get());
+    }
+
+    auto annotationVar = mk<ast::Variable>("@provenance_num_" + std::to_string(atomIdx));
+    VecOwn<ram::Expression> args;
+    args.push_back(context.translateValue(*valueIndex, annotationVar.get()));
+    args.push_back(mk<ram::SignedConstant>(souffle::provenance::compactRuleMask));
+    return mk<ram::IntrinsicOperator>(FunctorOp::BAND, std::move(args));
+}
+
+Own<ram::Expression> ClauseTranslator::getAtomLevelNumber(std::size_t atomIdx) const {
+    if (!isCompact()) {
+        auto levelNumVar = mk<ast::Variable>("@level_num_" + std::to_string(atomIdx));
+        return context.translateValue(*valueIndex, levelNumVar.get());
+    }
+
+    auto annotationVar = mk<ast::Variable>("@provenance_num_" + std::to_string(atomIdx));
+    VecOwn<ram::Expression> args;
+    args.push_back(context.translateValue(*valueIndex, annotationVar.get()));
+    args.push_back(mk<ram::SignedConstant>(souffle::provenance::compactRuleBits));
+    return mk<ram::IntrinsicOperator>(FunctorOp::BSHIFT_R, std::move(args));
+}
+
+void ClauseTranslator::addAnnotation(
+        VecOwn<ram::Expression>& values, Own<ram::Expression> ruleNum, Own<ram::Expression> levelNum) const {
+    if (!isCompact()) {
+        values.push_back(std::move(ruleNum));
+        values.push_back(std::move(levelNum));
+        return;
+    }
+
+    // an undefined height leaves the whole annotation undefined
+    if (isUndefValue(levelNum.get())) {
+        values.push_back(mk<ram::UndefValue>());
+        return;
+    }
+
+    // an undefined rule number bounds the annotation from above, as for existence checks
+    if (isUndefValue(ruleNum.get())) {
+        ruleNum = mk<ram::SignedConstant>(souffle::provenance::compactRuleMask);
+    }
+
+    const auto* ruleConst = as<ram::SignedConstant>(ruleNum.get());
+    const auto* levelConst = as<ram::SignedConstant>(levelNum.get());
+    if (ruleConst != nullptr && levelConst != nullptr) {
+        values.push_back(mk<ram::SignedConstant>(
+                souffle::provenance::packAnnotation(ruleConst->getValue(), levelConst->getValue())));
+        return;
+    }
 
+    // levels beyond the packed range stay at the greatest one
+    VecOwn<ram::Expression> minArgs;
+    minArgs.push_back(std::move(levelNum));
+    minArgs.push_back(mk<ram::SignedConstant>(souffle::provenance::compactMaxLevel));
+    VecOwn<ram::Expression> shiftArgs;
+    shiftArgs.push_back(mk<ram::IntrinsicOperator>(FunctorOp::MIN, std::move(minArgs)));
+    shiftArgs.push_back(mk<ram::SignedConstant>(souffle::provenance::compactRuleBits));
+    VecOwn<ram::Expression> orArgs;
+    orArgs.push_back(mk<ram::IntrinsicOperator>(FunctorOp::BSHIFT_L, std::move(shiftArgs)));
+    orArgs.push_back(std::move(ruleNum));
+    values.push_back(mk<ram::IntrinsicOperator>(FunctorOp::BOR, std::move(orArgs)));
+}
+
+Own<ram::Expression> ClauseTranslator::getLevelNumber(const ast::Clause& clause) const {
     const auto& bodyAtoms = getAtomOrdering(clause);
     if (bodyAtoms.empty()) return mk<ram::SignedConstant>(0);
 
     VecOwn<ram::Expression> values;
     for (std::size_t i = 0; i < bodyAtoms.size(); i++) {
-        auto levelVar = mk<ast::Variable>(getLevelVariable(i));
-        values.push_back(context.translateValue(*valueIndex, levelVar.get()));
+        values.push_back(getAtomLevelNumber(i));
     }
     assert(!values.empty() && "unexpected empty value set");
 
@@ -158,11 +233,9 @@ Own<ram::Operation> ClauseTranslator::createInsertion(const ast::Clause& clause)
 
     // add rule number + level number
     if (isFact(clause)) {
-        values.push_back(mk<ram::SignedConstant>(0));
-        values.push_back(mk<ram::SignedConstant>(0));
+        addAnnotation(values, mk<ram::SignedConstant>(0), mk<ram::SignedConstant>(0));
     } else {
-        values.push_back(mk<ram::SignedConstant>(context.getClauseNum(&clause)));
-        values.push_back(getLevelNumber(clause));
+        addAnnotation(values, mk<ram::SignedConstant>(context.getClauseNum(&clause)), getLevelNumber(clause));
     }
 
     // Relations with functional dependency constraints
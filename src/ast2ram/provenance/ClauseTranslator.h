@@ -46,6 +46,19 @@ protected:
     Own<ram::Operation> addAtomScan(Own<ram::Operation> op, const ast::Atom* atom, const ast::Clause& clause,
             std::size_t curLevel) const override;
 
+    /** Whether rule and level numbers are packed into a single annotation */
+    bool isCompact() const;
+
+    /** Rule number of the tuple bound to the atom at the given position of the atom ordering */
+    Own<ram::Expression> getRuleNumber(std::size_t atomIdx) const;
+
+    /** Level number of the tuple bound to the atom at the given position of the atom ordering */
+    Own<ram::Expression> getAtomLevelNumber(std::size_t atomIdx) const;
+
+    /** Append the annotation of the given rule and level numbers, where either may be undefined */
+    void addAnnotation(VecOwn<ram::Expression>& values, Own<ram::Expression> ruleNum,
+            Own<ram::Expression> levelNum) const;
+
 private:
     Own<ram::Expression> getLevelNumber(const ast::Clause& clause) const;
 };
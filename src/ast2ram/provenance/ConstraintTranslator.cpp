@@ -41,8 +41,9 @@ Own<ram::Condition> ConstraintTranslator::visit_(type_identity<ast::Negation>, c
     }
 
     // add rule + level number
-    values.push_back(mk<ram::UndefValue>());
-    values.push_back(mk<ram::UndefValue>());
+    for (std::size_t i = 0; i < context.getProvenanceArity(); i++) {
+        values.push_back(mk<ram::UndefValue>());
+    }
 
     return mk<ram::Negation>(
             mk<ram::ExistenceCheck>(getConcreteRelationName(atom->getQualifiedName()), std::move(values)));
@@ -51,12 +51,9 @@ Own<ram::Operation> SubproofGenerator::addNegatedAtom(
         values.push_back(context.translateValue(*valueIndex, arg));
     }
 
-    // Undefined value for rule number
-    values.push_back(mk<ram::UndefValue>());
-
-    // Height annotation for provenanceNotExists
+    // Undefined value for rule number, and height annotation for provenanceNotExists
     // TODO (azreika): should height explicitly be here?
-    values.push_back(mk<ram::UndefValue>());
+    addAnnotation(values, mk<ram::UndefValue>(), mk<ram::UndefValue>());
 
     return mk<ram::Filter>(mk<ram::Negation>(mk<ram::ProvenanceExistenceCheck>(
                                    getConcreteRelationName(atom->getQualifiedName()), std::move(values))),
@@ -146,8 +143,7 @@ Own<ram::Operation> SubproofGenerator::addBodyLiteralConstraints(
                 levelNumber++;
                 assert(levelNumber < getAtomOrdering(clause).size());
             }
-            auto varRepr = mk<ast::Variable>("@level_num_" + std::to_string(levelNumber));
-            auto valLHS = context.translateValue(*valueIndex, varRepr.get());
+            auto valLHS = getAtomLevelNumber(levelNumber);
 
             // add the constraint
             auto constraint = mk<ram::Constraint>(
@@ -180,19 +176,13 @@ Own<ram::Operation> SubproofGenerator::generateReturnInstantiatedValues(const as
             for (const auto* arg : atom->getArguments()) {
                 values.push_back(context.translateValue(*valueIndex, arg));
             }
-            // TODO (azreika): put helper methods for these variables
             std::size_t levelNumber = 0;
             while (getAtomOrdering(clause).at(levelNumber) != atom) {
                 levelNumber++;
                 assert(levelNumber < getAtomOrdering(clause).size());
             }
-            auto levelVarRepr = mk<ast::Variable>("@level_num_" + std::to_string(levelNumber));
-            auto ruleNumRepr = mk<ast::Variable>("@rule_num_" + std::to_string(levelNumber));
-            auto level = context.translateValue(*valueIndex, levelVarRepr.get());
-            auto ruleNum = context.translateValue(*valueIndex, ruleNumRepr.get());
-
-            values.push_back(std::move(ruleNum));
-            values.push_back(std::move(level));
+            values.push_back(getRuleNumber(levelNumber));
+            values.push_back(getAtomLevelNumber(levelNumber));
         } else if (const auto* neg = as<ast::Negation>(lit)) {
             for (ast::Argument* arg : neg->getAtom()->getArguments()) {
                 values.push_back(context.translateValue(*valueIndex, arg));
@@ -248,12 +238,7 @@ Own<ram::Operation> SubproofGenerator::generateReturnInstantiatedValues(const as
                 levelNumber++;
                 assert(levelNumber < getAtomOrdering(clause).size());
             }
-            auto levelVarRepr = mk<ast::Variable>("@level_num_" + std::to_string(levelNumber));
-            auto ruleNumRepr = mk<ast::Variable>("@rule_num_" + std::to_string(levelNumber));
-            auto level = context.translateValue(*valueIndex, levelVarRepr.get());
-            auto ruleNum = context.translateValue(*valueIndex, ruleNumRepr.get());
-
-            values.push_back(std::move(level));
+            values.push_back(getAtomLevelNumber(levelNumber));
             values.push_back(mk<ram::SubroutineArgument>(levelIndex));
         }
     }
@@ -47,6 +47,7 @@
 #include "ram/TupleElement.h"
 #include "ram/UndefValue.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/StringUtil.h"
 #include <sstream>
 
@@ -81,14 +82,20 @@ Own<ram::Relation> UnitTranslator::createRamRelation(const ast::Relation* baseRe
     std::vector<std::string> attributeTypeQualifiers = relation->getAttributeTypes();
 
     // Add in provenance information
-    attributeNames.push_back("@rule_number");
-    attributeTypeQualifiers.push_back("i:number");
+    std::size_t provenanceArity = context->getProvenanceArity();
+    if (provenanceArity == 1) {
+        attributeNames.push_back(souffle::provenance::compactAnnotationName);
+        attributeTypeQualifiers.push_back("i:number");
+    } else {
+        attributeNames.push_back("@rule_number");
+        attributeTypeQualifiers.push_back("i:number");
 
-    attributeNames.push_back("@level_number");
-    attributeTypeQualifiers.push_back("i:number");
+        attributeNames.push_back("@level_number");
+        attributeTypeQualifiers.push_back("i:number");
+    }
 
-    return mk<ram::Relation>(ramRelationName, arity + 2, auxiliaryArity + 2, attributeNames,
-            attributeTypeQualifiers, representation);
+    return mk<ram::Relation>(ramRelationName, arity + provenanceArity, auxiliaryArity + provenanceArity,
+            attributeNames, attributeTypeQualifiers, representation);
 }
 
 std::string UnitTranslator::getInfoRelationName(const ast::Clause* clause) const {
@@ -145,7 +152,7 @@ VecOwn<ram::Relation> UnitTranslator::createRamRelations(const std::vector<std::
 
 void UnitTranslator::addAuxiliaryArity(
         const ast::Relation* /* relation */, std::map<std::string, std::string>& directives) const {
-    directives.insert(std::make_pair("auxArity", "2"));
+    directives.insert(std::make_pair("auxArity", std::to_string(context->getProvenanceArity())));
 }
 
 Own<ram::Statement> UnitTranslator::generateClearExpiredRelations(
@@ -180,7 +187,7 @@ Own<ram::Statement> UnitTranslator::generateMergeRelations(
     VecOwn<ram::Expression> values;
 
     // Predicate - insert all values
-    for (std::size_t i = 0; i < rel->getArity() + 2; i++) {
+    for (std::size_t i = 0; i < rel->getArity() + context->getProvenanceArity(); i++) {
         values.push_back(mk<ram::TupleElement>(0, i));
     }
 
@@ -333,8 +340,9 @@ Own<ram::ExistenceCheck> UnitTranslator::makeRamAtomExistenceCheck(const ast::At
     }
 
     // Fill up query with nullptrs for the provenance columns
-    query.push_back(mk<ram::UndefValue>());
-    query.push_back(mk<ram::UndefValue>());
+    for (std::size_t i = 0; i < context->getProvenanceArity(); i++) {
+        query.push_back(mk<ram::UndefValue>());
+    }
 
     // Create existence checks to check if the tuple exists or not
     return mk<ram::ExistenceCheck>(relName, std::move(query));
@@ -73,6 +73,7 @@
 #include "reports/ErrorReport.h"
 #include "souffle/BinaryConstraintOps.h"
 #include "souffle/TypeAttribute.h"
+#include "souffle/utility/json11.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/FunctionalUtil.h"
 #include "souffle/utility/MiscUtil.h"
@@ -87,6 +88,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -183,6 +185,7 @@ Own<ram::Statement> UnitTranslator::generateStratum(std::size_t scc) const {
         assert(sccRelations.size() == 1 && "only one relation should exist in non-recursive stratum");
         const auto* rel = *sccRelations.begin();
         appendStmt(current, generateNonRecursiveRelation(*rel));
+        appendStmt(current, generateExchangeRelation(rel, getConcreteRelationName(rel->getQualifiedName())));
 
         // lub auxiliary arities using the @lub relation
         if (rel->getAuxiliaryArity() > 0) {
@@ -483,6 +486,12 @@ Own<ram::Statement> UnitTranslator::generateStratumPreamble(const ast::RelationS
         appendStmt(preamble, generateNonRecursiveDelete(*rel));
     }
 
+    // Distribute the tuples of the non-recursive rules before priming
+    for (const ast::Relation* rel : scc) {
+        appendStmt(preamble,
+                generateExchangeRelation(rel, getConcreteRelationName(rel->getQualifiedName())));
+    }
+
     // Generate code for priming relation
     for (const ast::Relation* rel : scc) {
         std::string deltaRelation = getDeltaRelationName(rel->getQualifiedName());
@@ -769,10 +778,15 @@ Own<ram::Statement> UnitTranslator::generateRecursiveStratum(
             mk<ram::IntrinsicOperator>(FunctorOp::UADD, std::move(inc)), false);
     // Add in the main fixpoint loop
     auto loopBody = generateStratumLoopBody(scc);
+    VecOwn<ram::Statement> exchanges;
+    for (const ast::Relation* rel : scc) {
+        appendStmt(exchanges, generateExchangeRelation(rel, getNewRelationName(rel->getQualifiedName())));
+    }
     auto exitSequence = generateStratumExitSequence(scc);
     auto updateSequence = generateStratumTableUpdates(scc);
-    auto fixpointLoop = mk<ram::Loop>(mk<ram::Sequence>(std::move(loopBody), std::move(joinSizeSequence),
-            std::move(exitSequence), std::move(updateSequence), std::move(increment_counter)));
+    auto fixpointLoop = mk<ram::Loop>(mk<ram::Sequence>(std::move(loopBody),
+            mk<ram::Sequence>(std::move(exchanges)), std::move(joinSizeSequence), std::move(exitSequence),
+            std::move(updateSequence), std::move(increment_counter)));
 
     appendStmt(result, mk<ram::Assign>(mk<ram::Variable>(loop_counter), mk<ram::UnsignedConstant>(1), true));
     appendStmt(result, std::move(fixpointLoop));
@@ -836,6 +850,92 @@ Own<ram::Statement> UnitTranslator::generateStoreRelation(const ast::Relation* r
     return mk<ram::Sequence>(std::move(storeStmts));
 }
 
+Own<ram::Statement> UnitTranslator::generateSpillRelation(const ast::Relation* relation, bool spill) const {
+    std::vector<std::string> attributeTypes;
+    for (const auto* attribute : relation->getAttributes()) {
+        attributeTypes.push_back(context->getAttributeTypeQualifier(attribute->getTypeName()));
+    }
+    json11::Json relJson =
+            json11::Json::object{{"arity", static_cast<long long>(relation->getArity())},
+                    {"types", json11::Json::array(attributeTypes.begin(), attributeTypes.end())}};
+
+    std::string ramRelationName = getConcreteRelationName(relation->getQualifiedName());
+    std::map<std::string, std::string> directives;
+    directives.insert(std::make_pair("IO", "spill"));
+    directives.insert(std::make_pair("operation", spill ? "spill" : "restore"));
+    directives.insert(std::make_pair("name", ramRelationName));
+    directives.insert(std::make_pair("spill-dir", glb->config().get("spill-dir")));
+    json11::Json types = json11::Json::object{{"relation", relJson}};
+    directives.insert(std::make_pair("types", types.dump()));
+    if (glb->config().has("spill-budget")) {
+        std::size_t budget = std::stoull(glb->config().get("spill-budget")) << 20;
+        directives.insert(std::make_pair("budget", std::to_string(budget)));
+    }
+    addAuxiliaryArity(relation, directives);
+    return mk<ram::IO>(ramRelationName, directives);
+}
+
+Own<ram::Statement> UnitTranslator::generateExchangeRelation(
+        const ast::Relation* relation, const std::string& ramRelationName) const {
+    if (!glb->config().has("cluster") || relation->getArity() == 0 || relation->getAuxiliaryArity() > 0 ||
+            context->hasSubsumptiveClause(relation->getQualifiedName())) {
+        return mk<ram::Sequence>();
+    }
+    // workers would choose different tuples for the same key
+    if (!relation->getFunctionalDependencies().empty()) {
+        return mk<ram::Sequence>();
+    }
+    // record ordinals are local to each worker, relations holding records are computed by all workers
+    for (const auto* attribute : relation->getAttributes()) {
+        char kind = context->getAttributeTypeQualifier(attribute->getTypeName())[0];
+        if (kind == 'r' || kind == '+') {
+            return mk<ram::Sequence>();
+        }
+    }
+    std::map<std::string, std::string> directives;
+    directives.insert(std::make_pair("IO", "cluster"));
+    directives.insert(std::make_pair("operation", "exchange"));
+    directives.insert(std::make_pair("name", ramRelationName));
+    // received tuples of @new that the main relation already holds are dropped
+    const std::string mainRelation = getConcreteRelationName(relation->getQualifiedName());
+    if (ramRelationName != mainRelation) {
+        directives.insert(std::make_pair("known", mainRelation));
+    }
+    return mk<ram::IO>(ramRelationName, directives);
+}
+
+std::pair<std::vector<ast::RelationSet>, std::vector<ast::RelationSet>> UnitTranslator::computeSpillSchedule(
+        const std::vector<std::size_t>& sccOrdering) const {
+    const std::size_t numSteps = sccOrdering.size();
+    std::vector<ast::RelationSet> spilled(numSteps);
+    std::vector<ast::RelationSet> restored(numSteps);
+
+    // the steps each relation is computed or read in, in order
+    std::map<const ast::Relation*, std::vector<std::size_t>> accesses;
+    for (std::size_t i = 0; i < numSteps; i++) {
+        for (const auto* rel : context->getRelationsInSCC(sccOrdering.at(i))) {
+            accesses[rel].push_back(i);
+        }
+        for (const auto* rel : context->getUsedRelations(i)) {
+            accesses[rel].push_back(i);
+        }
+    }
+
+    // a relation not needed by the next stratum is spilled until the stratum reading it again
+    for (const auto& [rel, steps] : accesses) {
+        if (rel->getArity() == 0) {
+            continue;
+        }
+        for (std::size_t j = 1; j < steps.size(); j++) {
+            if (steps[j] > steps[j - 1] + 1) {
+                spilled[steps[j - 1]].insert(rel);
+                restored[steps[j]].insert(rel);
+            }
+        }
+    }
+    return {std::move(spilled), std::move(restored)};
+}
+
 Own<ram::Relation> UnitTranslator::createRamRelation(const ast::Relation* baseRelation,
         std::string ramRelationName, RelationRepresentation representation) const {
     auto arity = baseRelation->getArity();
@@ -916,14 +1016,34 @@ Own<ram::Sequence> UnitTranslator::generateProgram(const ast::TranslationUnit& t
             translationUnit.getAnalysis<ast::analysis::TopologicallySortedSCCGraphAnalysis>().order();
     VecOwn<ram::Statement> res;
 
+    // Relations moved out of memory after and back into memory before each stratum
+    std::vector<ast::RelationSet> spilled(sccOrdering.size());
+    std::vector<ast::RelationSet> restored(sccOrdering.size());
+    if (glb->config().has("spill-dir")) {
+        std::tie(spilled, restored) = computeSpillSchedule(sccOrdering);
+    }
+
     // Create subroutines for each SCC according to topological order
     for (std::size_t i = 0; i < sccOrdering.size(); i++) {
+        VecOwn<ram::Statement> current;
+
+        // Restore spilled relations read in this stratum
+        for (const auto* relation : restored.at(i)) {
+            appendStmt(current, generateSpillRelation(relation, false));
+        }
+
         // Generate the main stratum code
-        auto stratum = generateStratum(sccOrdering.at(i));
+        appendStmt(current, generateStratum(sccOrdering.at(i)));
+
+        // Spill relations not needed by the next stratum
+        for (const auto* relation : spilled.at(i)) {
+            appendStmt(current, generateSpillRelation(relation, true));
+        }
 
         // Clear expired relations
         const auto& expiredRelations = context->getExpiredRelations(i);
-        stratum = mk<ram::Sequence>(std::move(stratum), generateClearExpiredRelations(expiredRelations));
+        appendStmt(current, generateClearExpiredRelations(expiredRelations));
+        auto stratum = mk<ram::Sequence>(std::move(current));
 
         // Add the subroutine
         const ast::Relation* rel = *context->getRelationsInSCC(sccOrdering.at(i)).begin();
@@ -22,6 +22,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace souffle {
@@ -88,6 +89,15 @@ protected:
     Own<ram::Statement> generateStratumExitSequence(const ast::RelationSet& scc) const;
     Own<ram::Statement> generateStratumLubSequence(const ast::Relation& rel, bool inRecursiveLoop) const;
 
+    /** Exchange of derived tuples between the workers of a distributed evaluation */
+    Own<ram::Statement> generateExchangeRelation(
+            const ast::Relation* relation, const std::string& ramRelationName) const;
+
+    /** Spilling of relations to disk */
+    Own<ram::Statement> generateSpillRelation(const ast::Relation* relation, bool spill) const;
+    std::pair<std::vector<ast::RelationSet>, std::vector<ast::RelationSet>> computeSpillSchedule(
+            const std::vector<std::size_t>& sccOrdering) const;
+
     /** Other helper generations */
     virtual Own<ram::Statement> generateClearExpiredRelations(const ast::RelationSet& expiredRelations) const;
     Own<ram::Statement> generateClearRelation(const ast::Relation* relation) const;
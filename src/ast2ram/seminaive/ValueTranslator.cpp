@@ -104,8 +104,8 @@ Own<ram::Expression> ValueTranslator::visit_(
     }
     auto returnType = context.getFunctorReturnTypeAttribute(udf);
     auto paramTypes = context.getFunctorParamTypeAtributes(udf);
-    return mk<ram::UserDefinedOperator>(
-            udf.getName(), paramTypes, returnType, context.isStatefulFunctor(udf), std::move(values));
+    return mk<ram::UserDefinedOperator>(udf.getName(), paramTypes, returnType, context.isStatefulFunctor(udf),
+            std::move(values), context.isBatchFunctor(udf));
 }
 
 Own<ram::Expression> ValueTranslator::visit_(type_identity<ast::Counter>, const ast::Counter&) {
@@ -124,6 +124,11 @@ std::size_t TranslatorContext::getClauseNum(const ast::Clause* clause) const {
     return clauseNums.at(clause);
 }
 
+std::size_t TranslatorContext::getProvenanceArity() const {
+    // compact provenance packs the rule and level numbers into one annotation
+    return global->config().has("provenance-compact") ? 1 : 2;
+}
+
 std::string TranslatorContext::getAttributeTypeQualifier(const ast::QualifiedName& name) const {
     return getTypeQualifier(typeEnv->getType(name));
 }
@@ -135,8 +140,8 @@ Own<ram::AbstractOperator> TranslatorContext::getLatticeTypeLubFunctor(
         const auto typeAttributes = getFunctorParamTypeAtributes(*lub);
         const auto returnAttribute = getFunctorReturnTypeAttribute(*lub);
         bool stateful = isStatefulFunctor(*lub);
-        return mk<ram::UserDefinedOperator>(
-                lub->getName(), typeAttributes, returnAttribute, stateful, std::move(args));
+        return mk<ram::UserDefinedOperator>(lub->getName(), typeAttributes, returnAttribute, stateful,
+                std::move(args), isBatchFunctor(*lub));
     } else if (const auto* lub = as<ast::IntrinsicFunctor>(lattice->getLub())) {
         assert(false && lub && "intrinsic functors not yet supported in lattice");
         // return mk<ram::IntrinsicOperator>(getOverloadedFunctorOp(lub->getBaseFunctionOp()),
@@ -235,6 +240,10 @@ ast::RelationSet TranslatorContext::getExpiredRelations(std::size_t scc) const {
     return relationSchedule->schedule().at(scc).expired();
 }
 
+ast::RelationSet TranslatorContext::getUsedRelations(std::size_t scc) const {
+    return relationSchedule->schedule().at(scc).used();
+}
+
 bool TranslatorContext::hasSubsumptiveClause(const ast::QualifiedName& name) const {
     for (const auto* clause : getProgram()->getClauses(name)) {
         if (isA<ast::SubsumptiveClause>(clause)) {
@@ -262,6 +271,10 @@ bool TranslatorContext::isStatefulFunctor(const ast::UserDefinedFunctor& udf) co
     return functorAnalysis->isStatefulFunctor(udf);
 }
 
+bool TranslatorContext::isBatchFunctor(const ast::UserDefinedFunctor& udf) const {
+    return functorAnalysis->isBatchFunctor(udf);
+}
+
 TypeAttribute TranslatorContext::getFunctorReturnTypeAttribute(const ast::UserDefinedAggregator& uda) const {
     return typeAnalysis->getAggregatorReturnTypeAttribute(uda);
 }
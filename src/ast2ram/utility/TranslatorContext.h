@@ -110,10 +110,14 @@ public:
     bool isRecursiveClause(const ast::Clause* clause) const;
     std::size_t getClauseNum(const ast::Clause* clause) const;
 
+    /** Provenance methods */
+    std::size_t getProvenanceArity() const;
+
     /** SCC methods */
     std::size_t getNumberOfSCCs() const;
     bool isRecursiveSCC(std::size_t scc) const;
     ast::RelationSet getExpiredRelations(std::size_t scc) const;
+    ast::RelationSet getUsedRelations(std::size_t scc) const;
     ast::RelationSet getRelationsInSCC(std::size_t scc) const;
     ast::RelationSet getInputRelationsInSCC(std::size_t scc) const;
     ast::RelationSet getOutputRelationsInSCC(std::size_t scc) const;
@@ -127,6 +131,7 @@ public:
     TypeAttribute getFunctorParamTypeAtribute(const ast::Functor& functor, std::size_t idx) const;
     std::vector<TypeAttribute> getFunctorParamTypeAtributes(const ast::UserDefinedFunctor& udf) const;
     bool isStatefulFunctor(const ast::UserDefinedFunctor& functor) const;
+    bool isBatchFunctor(const ast::UserDefinedFunctor& functor) const;
 
     /** Functor methods */
     TypeAttribute getFunctorReturnTypeAttribute(const ast::UserDefinedAggregator& aggregator) const;
@@ -67,10 +67,27 @@ protected:
      */
     std::size_t num_jobs;
 
+    /**
+     * endpoint of the query server, if any
+     */
+    std::string serve_endpoint;
+
+    /**
+     * checkpointing flag
+     */
+    bool checkpointing;
+
+    /**
+     * checkpoint directory
+     */
+    std::string checkpoint_dir;
+
 public:
     // all argument constructor
-    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, std::size_t nj)
-            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj) {}
+    CmdOptions(const char* s, const char* id, const char* od, bool pe, const char* pfn, std::size_t nj,
+            bool ce = false, const char* cd = "")
+            : src(s), input_dir(id), output_dir(od), profiling(pe), profile_name(pfn), num_jobs(nj),
+              checkpointing(ce), checkpoint_dir(cd) {}
 
     /**
      * get source code name
@@ -114,6 +131,20 @@ public:
         return num_jobs;
     }
 
+    /**
+     * get the endpoint of the query server, or an empty string for none
+     */
+    const std::string& getServeEndpoint() const {
+        return serve_endpoint;
+    }
+
+    /**
+     * get the checkpoint directory
+     */
+    const std::string& getCheckpointDir() const {
+        return checkpoint_dir;
+    }
+
     /**
      * Parses the given command line parameters, handles -h help requests or errors
      * and returns whether the parsing was successful or not.
@@ -132,6 +163,7 @@ public:
         // long options
         option longOptions[] = {{"facts", true, nullptr, 'F'}, {"output", true, nullptr, 'D'},
                 {"profile", true, nullptr, 'p'}, {"jobs", true, nullptr, 'j'}, {"index", true, nullptr, 'i'},
+                {"serve", true, nullptr, 'S'}, {"checkpoint", true, nullptr, 'C'},
                 // the terminal option -- needs to be null
                 {nullptr, false, nullptr, 0}};
 
@@ -139,7 +171,7 @@ public:
         bool ok = true;
 
         int c; /* command-line arguments processing */
-        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:", longOptions, nullptr)) != EOF) {
+        while ((c = getopt_long(argc, argv, "D:F:hp:j:i:S:C:", longOptions, nullptr)) != EOF) {
             switch (c) {
                 /* Fact directories */
                 case 'F':
@@ -182,6 +214,19 @@ public:
                     std::cerr << "\nWarning: OpenMP was not enabled in compilation\n\n";
 #endif
                     break;
+                case 'S': serve_endpoint = optarg; break;
+                case 'C':
+                    if (!checkpointing) {
+                        std::cerr << "\nError: checkpoints were not enabled in compilation\n\n";
+                        printHelpPage(exec_name);
+                        exit(EXIT_FAILURE);
+                    }
+                    if (!existDir(optarg)) {
+                        printf("Checkpoint directory %s does not exists!\n", optarg);
+                        ok = false;
+                    }
+                    checkpoint_dir = optarg;
+                    break;
                 default: printHelpPage(exec_name); return false;
             }
         }
@@ -212,6 +257,10 @@ private:
             std::cerr << "    -p <file>, --profile=<file>  -- Specify filename for profiling\n";
             std::cerr << "                                    (default: " << profile_name << ")\n";
         }
+        if (checkpointing) {
+            std::cerr << "    -C <DIR>, --checkpoint=<DIR> -- Specify directory for checkpoints\n";
+            std::cerr << "                                    (default: " << checkpoint_dir << ")\n";
+        }
 #ifdef _OPENMP
         std::cerr << "    -j <NUM>, --jobs=<NUM>       -- Specify number of threads\n";
         if (num_jobs > 0) {
@@ -220,6 +269,8 @@ private:
             std::cerr << "                                    (default: auto)\n";
         }
 #endif
+        std::cerr << "    -S <END>, --serve=<END>      -- Answer queries after the evaluation on an\n";
+        std::cerr << "                                    endpoint: - or unix:<PATH>\n";
         std::cerr << "    -h                           -- prints this help page.\n";
         std::cerr << "--------------------------------------------------------------------\n";
 #ifdef SOUFFLE_GENERATOR_VERSION
@@ -26,6 +26,7 @@
 #include "souffle/datastructure/ConcurrentCache.h"
 #include "souffle/datastructure/EqRel.h"
 #include "souffle/datastructure/Info.h"
+#include "souffle/datastructure/MemoTable.h"
 #include "souffle/datastructure/Nullaries.h"
 #include "souffle/datastructure/RecordTableImpl.h"
 #include "souffle/datastructure/SymbolTableImpl.h"
@@ -33,6 +34,12 @@
 #include "souffle/io/IOSystem.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/utility/EvaluatorUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include "souffle/utility/RegexDfa.h"
+#include "souffle/utility/span.h"
+#include <functional>
+#include <type_traits>
+#include <vector>
 
 #if defined(_OPENMP)
 #include <omp.h>
@@ -46,6 +53,13 @@ inline souffle::SouffleProgram* getInstance(const char* p) {
 }
 }
 
+/** Whether a relation type visits the tuples between bounds through its indexes */
+template <class RelType, class = void>
+struct has_range_search : std::false_type {};
+
+template <class RelType>
+struct has_range_search<RelType, std::void_t<decltype(&RelType::forEachInRange)>> : std::true_type {};
+
 /**
  * Relation wrapper used internally in the generated Datalog program
  */
@@ -117,6 +131,73 @@ public:
         }
         relation.insert(t);
     }
+    void insertRows(span<const RamDomain> rows, bool parallel = false) override {
+        if constexpr (Arity == 0) {
+            souffle::Relation::insertRows(rows, parallel);
+        } else {
+            assert(rows.size() % Arity == 0 && "row data is not a multiple of the arity");
+            const std::size_t numRows = rows.size() / Arity;
+            const RamDomain* data = rows.data();
+            if (!parallel) {
+                auto ctxt = relation.createContext();
+                for (std::size_t row = 0; row < numRows; ++row) {
+                    relation.insert(rowToTuple(data + row * Arity), ctxt);
+                }
+                return;
+            }
+            PARALLEL_START
+            auto ctxt = relation.createContext();
+            pfor(std::size_t row = 0; row < numRows; ++row) {
+                relation.insert(rowToTuple(data + row * Arity), ctxt);
+            }
+            PARALLEL_END
+        }
+    }
+    void forEachRowBlock(std::size_t blockSize,
+            const std::function<void(span<const RamDomain>)>& visitor) const override {
+        assert(blockSize > 0 && "empty block size");
+        if constexpr (Arity > 0) {
+            std::vector<RamDomain> block;
+            block.reserve(blockSize * Arity);
+            for (const auto& value : relation) {
+                for (std::size_t i = 0; i < Arity; i++) {
+                    block.push_back(value[i]);
+                }
+                if (block.size() == blockSize * Arity) {
+                    visitor(span<const RamDomain>(block.data(), block.size()));
+                    block.clear();
+                }
+            }
+            if (!block.empty()) {
+                visitor(span<const RamDomain>(block.data(), block.size()));
+            }
+        }
+    }
+    void forEachRowBlockInRange(span<const RamDomain> lower, span<const RamDomain> upper,
+            std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const override {
+        if constexpr (Arity > 0 && has_range_search<RelType>::value) {
+            assert(lower.size() == Arity && upper.size() == Arity && "bounds do not match the arity");
+            assert(blockSize > 0 && "empty block size");
+            std::vector<RamDomain> block;
+            block.reserve(blockSize * Arity);
+            relation.forEachInRange(rowToTuple(lower.data()), rowToTuple(upper.data()),
+                    [&](const TupleType& value) {
+                        if (!isRowInRange(value.data(), lower.data(), upper.data())) {
+                            return;
+                        }
+                        block.insert(block.end(), value.begin(), value.end());
+                        if (block.size() == blockSize * Arity) {
+                            visitor(span<const RamDomain>(block.data(), block.size()));
+                            block.clear();
+                        }
+                    });
+            if (!block.empty()) {
+                visitor(span<const RamDomain>(block.data(), block.size()));
+            }
+        } else {
+            souffle::Relation::forEachRowBlockInRange(lower, upper, blockSize, visitor);
+        }
+    }
     bool contains(const tuple& arg) const override {
         TupleType t;
         assert(arg.size() == Arity && "wrong tuple arity");
@@ -153,6 +234,15 @@ public:
     void purge() override {
         relation.purge();
     }
+
+private:
+    static TupleType rowToTuple(const RamDomain* row) {
+        TupleType t;
+        for (std::size_t i = 0; i < Arity; i++) {
+            t[i] = row[i];
+        }
+        return t;
+    }
 };
 
 }  // namespace souffle
@@ -0,0 +1,439 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file QueryServer.h
+ *
+ * Answers queries against the relations of a program that has been run.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/SouffleInterface.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/utility/StringUtil.h"
+#include "souffle/utility/span.h"
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace souffle {
+
+/**
+ * Answers queries against the relations of a program that has been run,
+ * while the relations and their indexes stay resident.
+ *
+ * A request is a line of fields separated by tabs, and its response is a
+ * number of answer lines followed by a line "ok ..." or "error MESSAGE":
+ *
+ *     relations                 one line per relation: name, arity and signature
+ *     size REL                  ok N, the number of tuples
+ *     contains REL V1 ... Vn    ok true or ok false
+ *     query REL P1 ... Pn       one line per matching tuple; ok N, the number of tuples
+ *     call SUB A1 ... Am        ok R1 ... Rk, the results of the subroutine
+ *     quit                      ends the session
+ *     shutdown                  ends the session and stops the server
+ *
+ * The values of symbols are their text, the other values are numbers; the
+ * arguments and results of subroutines are numbers in the encoding of the
+ * program. In a query, the pattern _ matches any value, a value matches
+ * itself, and LOW..HIGH matches the numbers between LOW and HIGH, inclusively,
+ * where either bound may be omitted. Queries are answered through the index
+ * that fixes the most attributes.
+ *
+ * Queries of concurrent sessions are answered concurrently, while the calls
+ * of subroutines are answered one at a time.
+ */
+class QueryServer {
+public:
+    explicit QueryServer(SouffleProgram& program) : program(program) {}
+
+    /**
+     * Answer a request.
+     *
+     * @return whether the session continues
+     */
+    bool handle(std::string request, std::ostream& out) {
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+        const std::vector<std::string> fields = splitString(request, '\t');
+        const std::string& command = fields[0];
+        try {
+            if (command == "quit") {
+                out << "ok\n";
+                return false;
+            } else if (command == "shutdown") {
+                out << "ok\n";
+                stop();
+                return false;
+            } else if (command == "relations") {
+                std::shared_lock<std::shared_mutex> lock(access);
+                for (Relation* rel : program.getAllRelations()) {
+                    out << rel->getName() << "\t" << rel->getPrimaryArity() << "\t" << rel->getSignature()
+                        << "\n";
+                }
+                out << "ok\n";
+            } else if (command == "size" && fields.size() == 2) {
+                std::shared_lock<std::shared_mutex> lock(access);
+                const std::size_t size = getRelation(fields[1]).size();
+                out << "ok " << size << "\n";
+            } else if (command == "contains" && fields.size() >= 2) {
+                std::shared_lock<std::shared_mutex> lock(access);
+                const bool found = query(getRelation(fields[1]), fields, nullptr, 1) > 0;
+                out << "ok " << (found ? "true" : "false") << "\n";
+            } else if (command == "query" && fields.size() >= 2) {
+                std::shared_lock<std::shared_mutex> lock(access);
+                const std::size_t count = query(getRelation(fields[1]), fields, &out);
+                out << "ok " << count << "\n";
+            } else if (command == "call" && fields.size() >= 2) {
+                std::vector<RamDomain> args;
+                std::vector<RamDomain> results;
+                for (std::size_t i = 2; i < fields.size(); ++i) {
+                    args.push_back(parseNumber<RamSigned>(fields[i]));
+                }
+                {
+                    std::unique_lock<std::shared_mutex> lock(access);
+                    program.executeSubroutine(fields[1], args, results);
+                }
+                out << "ok";
+                for (RamDomain result : results) {
+                    out << " " << result;
+                }
+                out << "\n";
+            } else {
+                out << "error invalid request\n";
+            }
+        } catch (const std::exception& e) {
+            out << "error " << e.what() << "\n";
+        }
+        return true;
+    }
+
+    /** Answer the requests of a stream until it ends or the session ends */
+    void serve(std::istream& in, std::ostream& out) {
+        std::string request;
+        while (std::getline(in, request)) {
+            if (request.empty()) {
+                continue;
+            }
+            const bool more = handle(request, out);
+            out.flush();
+            if (!more) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Serve an endpoint until a session stops the server: - for the standard
+     * input and output, or unix:PATH for a local socket accepting any number
+     * of concurrent sessions. A socket left at PATH is replaced, while any
+     * other file there is an error.
+     */
+    void serve(const std::string& endpoint) {
+        if (endpoint == "-") {
+            serve(std::cin, std::cout);
+            return;
+        }
+#ifndef _MSC_VER
+        if (isPrefix("unix:", endpoint)) {
+            serveSocket(endpoint.substr(5));
+            return;
+        }
+#endif
+        throw std::invalid_argument("invalid endpoint " + endpoint);
+    }
+
+    /** Stop the server, ending all sessions */
+    void stop() {
+        stopped = true;
+#ifndef _MSC_VER
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        if (listener >= 0) {
+            ::shutdown(listener, SHUT_RDWR);
+        }
+        for (int fd : sessions) {
+            ::shutdown(fd, SHUT_RD);
+        }
+#endif
+    }
+
+private:
+    /** The number of rows per block read from a relation */
+    static constexpr std::size_t rowBlockSize = 1024;
+
+    Relation& getRelation(const std::string& name) const {
+        Relation* rel = program.getRelation(name);
+        if (rel == nullptr) {
+            throw std::invalid_argument("unknown relation " + name);
+        }
+        return *rel;
+    }
+
+    template <class T>
+    static T parseNumber(const std::string& text) {
+        std::size_t position = 0;
+        T value;
+        if constexpr (std::is_same_v<T, RamFloat>) {
+            value = RamFloatFromString(text, &position);
+        } else if constexpr (std::is_same_v<T, RamUnsigned>) {
+            value = RamUnsignedFromString(text, &position);
+        } else {
+            value = RamSignedFromString(text, &position);
+        }
+        if (position != text.size()) {
+            throw std::invalid_argument("invalid number " + text);
+        }
+        return value;
+    }
+
+    /** The least and the greatest value of an attribute type */
+    static std::pair<RamDomain, RamDomain> getLimits(char type) {
+        switch (type) {
+            case 'f': return {ramBitCast(MIN_RAM_FLOAT), ramBitCast(MAX_RAM_FLOAT)};
+            case 'u': return {ramBitCast(MIN_RAM_UNSIGNED), ramBitCast(MAX_RAM_UNSIGNED)};
+            default: return {MIN_RAM_SIGNED, MAX_RAM_SIGNED};
+        }
+    }
+
+    static RamDomain parseValue(char type, const std::string& text) {
+        switch (type) {
+            case 'f': return ramBitCast(parseNumber<RamFloat>(text));
+            case 'u': return ramBitCast(parseNumber<RamUnsigned>(text));
+            default: return parseNumber<RamSigned>(text);
+        }
+    }
+
+    /**
+     * Visit the tuples matching the patterns fields[2..], writing them to out
+     * if given, up to a limit, and return their number.
+     */
+    std::size_t query(const Relation& rel, const std::vector<std::string>& fields, std::ostream* out,
+            std::size_t limit = static_cast<std::size_t>(-1)) const {
+        const std::size_t arity = rel.getArity();
+        const std::size_t primaryArity = rel.getPrimaryArity();
+        if (fields.size() != primaryArity + 2) {
+            throw std::invalid_argument("expected " + std::to_string(primaryArity) + " values");
+        }
+        if (arity == 0) {
+            const std::size_t count = rel.size() > 0 ? 1 : 0;
+            if (out != nullptr && count > 0) {
+                *out << "()\n";
+            }
+            return count;
+        }
+
+        std::vector<RamDomain> lower(arity);
+        std::vector<RamDomain> upper(arity);
+        SymbolTable& symbolTable = rel.getSymbolTable();
+        for (std::size_t i = 0; i < arity; ++i) {
+            const char type = *rel.getAttrType(i);
+            std::tie(lower[i], upper[i]) = getLimits(type);
+            if (i >= primaryArity || fields[i + 2] == "_") {
+                continue;
+            }
+            const std::string& pattern = fields[i + 2];
+            const std::size_t dots = pattern.find("..");
+            if (type == 's') {
+                // a symbol that is not in the table is in no tuple
+                if (!symbolTable.weakContains(pattern)) {
+                    return 0;
+                }
+                lower[i] = upper[i] = symbolTable.encode(pattern);
+            } else if (dots != std::string::npos) {
+                if (dots > 0) {
+                    lower[i] = parseValue(type, pattern.substr(0, dots));
+                }
+                if (dots + 2 < pattern.size()) {
+                    upper[i] = parseValue(type, pattern.substr(dots + 2));
+                }
+            } else {
+                lower[i] = upper[i] = parseValue(type, pattern);
+            }
+        }
+
+        std::size_t count = 0;
+        rel.forEachRowBlockInRange(lower, upper, rowBlockSize, [&](span<const RamDomain> rows) {
+            for (std::size_t offset = 0; offset < rows.size() && count < limit; offset += arity) {
+                ++count;
+                if (out != nullptr) {
+                    writeRow(*out, rel, rows.data() + offset);
+                }
+            }
+        });
+        return std::min(count, limit);
+    }
+
+    static void writeRow(std::ostream& out, const Relation& rel, const RamDomain* row) {
+        for (std::size_t i = 0; i < rel.getPrimaryArity(); ++i) {
+            if (i > 0) {
+                out << "\t";
+            }
+            switch (*rel.getAttrType(i)) {
+                case 's': out << rel.getSymbolTable().decode(row[i]); break;
+                case 'f': out << ramBitCast<RamFloat>(row[i]); break;
+                case 'u': out << ramBitCast<RamUnsigned>(row[i]); break;
+                default: out << row[i];
+            }
+        }
+        out << "\n";
+    }
+
+#ifndef _MSC_VER
+    /** Accept sessions on a local socket, each answered by its own thread */
+    void serveSocket(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument("invalid socket path " + path);
+        }
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw std::runtime_error("cannot create socket: " + std::string(std::strerror(errno)));
+        }
+        // only a socket left behind by an earlier server is replaced
+        struct stat status;
+        if (::lstat(path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                ::close(fd);
+                throw std::runtime_error("cannot listen on " + path + ": not a socket");
+            }
+            if (::unlink(path.c_str()) != 0) {
+                const std::string error = std::strerror(errno);
+                ::close(fd);
+                throw std::runtime_error("cannot remove the socket " + path + ": " + error);
+            }
+        }
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+                ::listen(fd, SOMAXCONN) != 0) {
+            const std::string error = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error("cannot listen on " + path + ": " + error);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            listener = fd;
+        }
+
+        std::vector<std::thread> threads;
+        while (!stopped) {
+            const int session = ::accept(fd, nullptr, nullptr);
+            if (session < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            if (stopped) {
+                ::close(session);
+                break;
+            }
+            sessions.insert(session);
+            threads.emplace_back([this, session]() { serveSession(session); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            listener = -1;
+        }
+        ::close(fd);
+        ::unlink(path.c_str());
+    }
+
+    /** Answer the requests of a connected socket until it is closed or the session ends */
+    void serveSession(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        bool more = true;
+        while (more) {
+            const ssize_t received = ::read(fd, chunk, sizeof(chunk));
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                break;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(received));
+            std::size_t end;
+            while (more && (end = buffer.find('\n')) != std::string::npos) {
+                const std::string request = buffer.substr(0, end);
+                buffer.erase(0, end + 1);
+                if (request.empty()) {
+                    continue;
+                }
+                std::ostringstream response;
+                more = handle(request, response);
+                more = sendAll(fd, response.str()) && more;
+            }
+        }
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        sessions.erase(fd);
+        ::close(fd);
+    }
+
+    static bool sendAll(int fd, const std::string& data) {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, flags);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+#endif
+
+    SouffleProgram& program;
+
+    /** Shared by queries, exclusive to the calls of subroutines */
+    mutable std::shared_mutex access;
+
+    std::atomic<bool> stopped{false};
+
+    /** The listening socket and the sockets of the open sessions */
+    std::mutex sessionsMutex;
+    int listener = -1;
+    std::set<int> sessions;
+};
+
+}  // namespace souffle
@@ -41,6 +41,11 @@ public:
     /// Enumerate each record.
     virtual void enumerate(const std::function<void(const RamDomain* /*tuple*/, std::size_t /* arity*/,
                     RamDomain /* key */)>& Callback) const = 0;
+
+    /// Remove the records whose reference is not live, keeping the references of the others.
+    /// Not thread-safe, use only when the datastructure is not being used.
+    virtual std::size_t retain(
+            const std::function<bool(std::size_t /* arity */, RamDomain /* key */)>& Live) = 0;
 };
 
 /** @brief helper to convert tuple to record reference for the synthesiser */
@@ -22,16 +22,19 @@
 #include "souffle/datastructure/ConcurrentCache.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StringUtil.h"
+#include "souffle/utility/span.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <optional>
 #include <regex>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -303,6 +306,94 @@ public:
      */
     virtual bool contains(const tuple& t) const = 0;
 
+    /**
+     * Insert a block of tuples stored contiguously in row-major order.
+     *
+     * Each row consists of getArity() elements in the encoding used by the relation, i.e.
+     * symbols must already be encoded (see SymbolTable::encodeMany) and floats/unsigned
+     * values must be bit-cast to RamDomain. Implementations of generated programs and
+     * of the interpreter override this method to avoid the per-tuple overhead of
+     * the `tuple` class; the default implementation falls back to insert(const tuple&).
+     * Rows of a nullary relation have no elements, so they cannot be inserted this way.
+     *
+     * @param rows Row-major tuple data; its size must be a multiple of the arity
+     * @param parallel If true, rows may be inserted concurrently by multiple threads
+     * @throws std::invalid_argument if the relation is nullary and rows is not empty
+     */
+    virtual void insertRows(span<const RamDomain> rows, bool /* parallel */ = false);
+
+    /**
+     * Visit all tuples of the relation as contiguous row-major blocks.
+     *
+     * Each block holds at most blockSize rows of getArity() elements. The memory
+     * of a block is owned by the relation and only valid during the call of the visitor.
+     *
+     * @param blockSize Maximal number of rows per block
+     * @param visitor Callback receiving each block
+     */
+    virtual void forEachRowBlock(
+            std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const;
+
+    /**
+     * Visit the tuples of the relation whose attributes lie between the given
+     * bounds, inclusively, as contiguous row-major blocks.
+     *
+     * Each attribute is compared according to its type; an attribute whose
+     * bounds are the least and the greatest value of its type is unconstrained.
+     * Implementations search the index that fixes the most attributes; the
+     * default implementation scans the relation.
+     *
+     * @param lower Lower bounds, of getArity() elements
+     * @param upper Upper bounds, of getArity() elements
+     * @param blockSize Maximal number of rows per block
+     * @param visitor Callback receiving each block
+     */
+    virtual void forEachRowBlockInRange(span<const RamDomain> lower, span<const RamDomain> upper,
+            std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const;
+
+    /**
+     * Check whether a row lies between the given bounds, comparing each attribute according to its type.
+     *
+     * @see forEachRowBlockInRange
+     */
+    bool isRowInRange(const RamDomain* row, const RamDomain* lower, const RamDomain* upper) const {
+        for (arity_type i = 0; i < getArity(); ++i) {
+            switch (*getAttrType(i)) {
+                case 'f': {
+                    const RamFloat low = ramBitCast<RamFloat>(lower[i]);
+                    const RamFloat high = ramBitCast<RamFloat>(upper[i]);
+                    const RamFloat value = ramBitCast<RamFloat>(row[i]);
+                    if ((low != MIN_RAM_FLOAT || high != MAX_RAM_FLOAT) && (value < low || high < value)) {
+                        return false;
+                    }
+                    break;
+                }
+                case 'u':
+                    if (ramBitCast<RamUnsigned>(row[i]) < ramBitCast<RamUnsigned>(lower[i]) ||
+                            ramBitCast<RamUnsigned>(upper[i]) < ramBitCast<RamUnsigned>(row[i])) {
+                        return false;
+                    }
+                    break;
+                default:
+                    if (row[i] < lower[i] || upper[i] < row[i]) {
+                        return false;
+                    }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Append all tuples of the relation in row-major order to the given buffer.
+     *
+     * @param rows Buffer receiving size() * getArity() elements
+     */
+    void readRows(std::vector<RamDomain>& rows) const {
+        rows.reserve(rows.size() + size() * getArity());
+        forEachRowBlock(defaultRowBlockSize,
+                [&](span<const RamDomain> block) { rows.insert(rows.end(), block.begin(), block.end()); });
+    }
+
     /**
      * Return an iterator pointing to the first tuple of the relation.
      * This iterator is used to access the tuples of the relation.
@@ -428,6 +519,10 @@ public:
      * in the table, set the next element pointer points to the current element itself.
      */
     virtual void purge() = 0;
+
+protected:
+    /** Number of rows per block used by readRows() */
+    static constexpr std::size_t defaultRowBlockSize = 1024;
 };
 
 /**
@@ -691,6 +786,65 @@ public:
     }
 };
 
+inline void Relation::insertRows(span<const RamDomain> rows, bool /* parallel */) {
+    const arity_type arity = getArity();
+    if (arity == 0) {
+        if (!rows.empty()) {
+            throw std::invalid_argument("row-based insertion into the nullary relation " + getName());
+        }
+        return;
+    }
+    assert(rows.size() % arity == 0 && "row data is not a multiple of the arity");
+    tuple t(this);
+    for (std::size_t offset = 0; offset < rows.size(); offset += arity) {
+        for (arity_type i = 0; i < arity; ++i) {
+            t[i] = rows[offset + i];
+        }
+        insert(t);
+    }
+}
+
+inline void Relation::forEachRowBlock(
+        std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const {
+    const arity_type arity = getArity();
+    assert(blockSize > 0 && "empty block size");
+    if (arity == 0) {
+        return;
+    }
+    std::vector<RamDomain> block;
+    block.reserve(blockSize * arity);
+    for (const auto& t : *this) {
+        for (arity_type i = 0; i < arity; ++i) {
+            block.push_back(t[i]);
+        }
+        if (block.size() == blockSize * arity) {
+            visitor(span<const RamDomain>(block.data(), block.size()));
+            block.clear();
+        }
+    }
+    if (!block.empty()) {
+        visitor(span<const RamDomain>(block.data(), block.size()));
+    }
+}
+
+inline void Relation::forEachRowBlockInRange(span<const RamDomain> lower, span<const RamDomain> upper,
+        std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const {
+    const arity_type arity = getArity();
+    assert(lower.size() == arity && upper.size() == arity && "bounds do not match the arity");
+    std::vector<RamDomain> block;
+    forEachRowBlock(blockSize, [&](span<const RamDomain> rows) {
+        for (std::size_t offset = 0; offset < rows.size(); offset += arity) {
+            if (isRowInRange(rows.data() + offset, lower.data(), upper.data())) {
+                block.insert(block.end(), rows.begin() + offset, rows.begin() + offset + arity);
+            }
+        }
+        if (!block.empty()) {
+            visitor(span<const RamDomain>(block.data(), block.size()));
+            block.clear();
+        }
+    });
+}
+
 /**
  * Abstract base class for generated Datalog programs.
  */
@@ -17,7 +17,10 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
+#include "souffle/utility/span.h"
 
+#include <cassert>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -111,6 +114,30 @@ public:
     /** @brief Decode a symbol index to a symbol. */
     virtual const std::string& decode(const RamDomain index) const = 0;
 
+    /**
+     * @brief Encode a batch of symbols.
+     *
+     * The index of `symbols[i]` is stored in `indices[i]`; both spans must have the same size.
+     */
+    virtual void encodeMany(span<const std::string> symbols, span<RamDomain> indices) {
+        assert(symbols.size() == indices.size() && "mismatching batch sizes");
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            indices[i] = encode(symbols[i]);
+        }
+    }
+
+    /**
+     * @brief Decode a batch of symbol indices.
+     *
+     * The symbol of `indices[i]` is stored in `symbols[i]`; both spans must have the same size.
+     */
+    virtual void decodeMany(span<const RamDomain> indices, span<std::string> symbols) const {
+        assert(symbols.size() == indices.size() && "mismatching batch sizes");
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            symbols[i] = decode(indices[i]);
+        }
+    }
+
     /** @brief Encode a symbol to a symbol index; aliases encode. */
     virtual RamDomain unsafeEncode(const std::string& symbol) = 0;
 
@@ -124,6 +151,17 @@ public:
      * happened.
      */
     virtual std::pair<RamDomain, bool> findOrInsert(const std::string& symbol) = 0;
+
+    /**
+     * @brief Remove the symbols whose index is not live.
+     *
+     * The other symbols keep their index, and the removed indexes are not
+     * reused. Not thread-safe, do not call when other threads are using the
+     * symbol table.
+     *
+     * @return the number of removed symbols
+     */
+    virtual std::size_t retain(const std::function<bool(RamDomain)>& live) = 0;
 };
 
 }  // namespace souffle
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "souffle/datastructure/BTreeUtil.h"
+#include "souffle/datastructure/NodeArena.h"
 #include "souffle/utility/CacheUtil.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
@@ -29,6 +30,7 @@
 #include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -50,7 +52,7 @@ namespace detail {
  * @tparam isSet        .. true = set, false = multiset
  */
 template <typename Key, typename Comparator,
-        typename Allocator,  // is ignored so far - TODO: add support
+        typename Allocator,
         unsigned blockSize, typename SearchStrategy, bool isSet, typename WeakComparator = Comparator,
         typename Updater = detail::updater<Key>>
 class btree_delete {
@@ -164,6 +166,8 @@ protected:
 
     struct inner_node;
 
+    struct node_allocator;
+
     /**
      * The actual, generic node implementation covering the operations
      * for both, inner and leaf nodes.
@@ -191,10 +195,9 @@ protected:
         /**
          * A deep-copy operation creating a clone of this node.
          */
-        node* clone() const {
+        node* clone(node_allocator& alloc) const {
             // create a clone of this node
-            node* res = (this->isInner()) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* res = alloc.newNode(this->isInner());
 
             // copy basic fields
             res->position = this->position;
@@ -212,7 +215,7 @@ protected:
             // copy child nodes recursively
             auto* ires = (inner_node*)res;
             for (size_type i = 0; i <= this->numElements; ++i) {
-                ires->children[i] = this->getChild(i)->clone();
+                ires->children[i] = this->getChild(i)->clone(alloc);
                 ires->children[i]->parent = res;
             }
 
@@ -350,14 +353,15 @@ protected:
          * @param idx  .. the position of the insert causing the split
          */
 #ifdef IS_PARALLEL
-        void split(node** root, lock_type& root_lock, int idx, std::vector<node*>& locked_nodes) {
+        void split(node_allocator& alloc, node** root, lock_type& root_lock, int idx,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        void split(node** root, lock_type& root_lock, int idx) {
+        void split(node_allocator& alloc, node** root, lock_type& root_lock, int idx) {
 #endif
             assert(this->numElements == maxKeys);
 
@@ -365,8 +369,7 @@ protected:
             int split_point = getSplitPoint(idx);
 
             // create a new sibling node
-            node* sibling = (this->inner) ? static_cast<node*>(new inner_node())
-                                          : static_cast<node*>(new leaf_node());
+            node* sibling = alloc.newNode(this->inner);
 
 #ifdef IS_PARALLEL
             // lock sibling
@@ -396,9 +399,9 @@ protected:
 
             // update parent
 #ifdef IS_PARALLEL
-            grow_parent(root, root_lock, sibling, locked_nodes);
+            grow_parent(alloc, root, root_lock, sibling, locked_nodes);
 #else
-            grow_parent(root, root_lock, sibling);
+            grow_parent(alloc, root, root_lock, sibling);
 #endif
         }
 
@@ -415,14 +418,15 @@ protected:
          */
         // TODO: remove root_lock ... no longer needed
 #ifdef IS_PARALLEL
-        int rebalance_or_split(node** root, lock_type& root_lock, int idx, std::vector<node*>& locked_nodes) {
+        int rebalance_or_split(node_allocator& alloc, node** root, lock_type& root_lock, int idx,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        int rebalance_or_split(node** root, lock_type& root_lock, int idx) {
+        int rebalance_or_split(node_allocator& alloc, node** root, lock_type& root_lock, int idx) {
 #endif
 
             // this node is full ... and needs some space
@@ -440,7 +444,7 @@ protected:
                 // lock access to left sibling
                 if (!left->lock.try_start_write()) {
                     // left node is currently updated => skip balancing and split
-                    split(root, root_lock, idx, locked_nodes);
+                    split(alloc, root, root_lock, idx, locked_nodes);
                     return 0;
                 }
 #endif
@@ -513,9 +517,9 @@ protected:
 
             // Option B) split node
 #ifdef IS_PARALLEL
-            split(root, root_lock, idx, locked_nodes);
+            split(alloc, root, root_lock, idx, locked_nodes);
 #else
-            split(root, root_lock, idx);
+            split(alloc, root, root_lock, idx);
 #endif
             return 0;  // = no re-balancing
         }
@@ -530,21 +534,22 @@ protected:
          * @param sibling .. the new right-sibling to be add to the parent node
          */
 #ifdef IS_PARALLEL
-        void grow_parent(node** root, lock_type& root_lock, node* sibling, std::vector<node*>& locked_nodes) {
+        void grow_parent(node_allocator& alloc, node** root, lock_type& root_lock, node* sibling,
+                std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(!this->parent || this->parent->lock.is_write_locked());
             assert((this->parent != nullptr) || root_lock.is_write_locked());
             assert(this->isLeaf() || souffle::contains(locked_nodes, this));
             assert(!this->parent || souffle::contains(locked_nodes, const_cast<node*>(this->parent)));
 #else
-        void grow_parent(node** root, lock_type& root_lock, node* sibling) {
+        void grow_parent(node_allocator& alloc, node** root, lock_type& root_lock, node* sibling) {
 #endif
 
             if (this->parent == nullptr) {
                 assert(*root == this);
 
                 // create a new root node
-                auto* new_root = new inner_node();
+                auto* new_root = alloc.newInner();
                 new_root->numElements = 1;
                 new_root->keys[0] = keys[this->numElements];
 
@@ -566,9 +571,9 @@ protected:
 
 #ifdef IS_PARALLEL
                 parent->insert_inner(
-                        root, root_lock, pos, this, keys[this->numElements], sibling, locked_nodes);
+                        alloc, root, root_lock, pos, this, keys[this->numElements], sibling, locked_nodes);
 #else
-                parent->insert_inner(root, root_lock, pos, this, keys[this->numElements], sibling);
+                parent->insert_inner(alloc, root, root_lock, pos, this, keys[this->numElements], sibling);
 #endif
             }
         }
@@ -582,13 +587,13 @@ protected:
          * @param newNode .. the new right-child of the inserted key
          */
 #ifdef IS_PARALLEL
-        void insert_inner(node** root, lock_type& root_lock, unsigned pos, node* predecessor, const Key& key,
-                node* newNode, std::vector<node*>& locked_nodes) {
+        void insert_inner(node_allocator& alloc, node** root, lock_type& root_lock, unsigned pos,
+                node* predecessor, const Key& key, node* newNode, std::vector<node*>& locked_nodes) {
             assert(this->lock.is_write_locked());
             assert(souffle::contains(locked_nodes, this));
 #else
-        void insert_inner(node** root, lock_type& root_lock, unsigned pos, node* predecessor, const Key& key,
-                node* newNode) {
+        void insert_inner(node_allocator& alloc, node** root, lock_type& root_lock, unsigned pos,
+                node* predecessor, const Key& key, node* newNode) {
 #endif
 
             // check capacity
@@ -601,9 +606,9 @@ protected:
 
                 // split this node
 #ifdef IS_PARALLEL
-                pos -= rebalance_or_split(root, root_lock, pos, locked_nodes);
+                pos -= rebalance_or_split(alloc, root, root_lock, pos, locked_nodes);
 #else
-                pos -= rebalance_or_split(root, root_lock, pos);
+                pos -= rebalance_or_split(alloc, root, root_lock, pos);
 #endif
 
                 // complete insertion within new sibling if necessary
@@ -628,9 +633,9 @@ protected:
                     }
 
                     pos = (i > static_cast<unsigned>(other->numElements)) ? 0 : static_cast<unsigned>(i);
-                    other->insert_inner(root, root_lock, pos, predecessor, key, newNode, locked_nodes);
+                    other->insert_inner(alloc, root, root_lock, pos, predecessor, key, newNode, locked_nodes);
 #else
-                    other->insert_inner(root, root_lock, pos, predecessor, key, newNode);
+                    other->insert_inner(alloc, root, root_lock, pos, predecessor, key, newNode);
 #endif
                     return;
                 }
@@ -874,19 +879,6 @@ protected:
 
         // a simple default constructor initializing member fields
         inner_node() : node(true) {}
-
-        // clear up child nodes recursively
-        ~inner_node() {
-            for (unsigned i = 0; i <= this->numElements; ++i) {
-                if (children[i] != nullptr) {
-                    if (children[i]->isLeaf()) {
-                        delete static_cast<leaf_node*>(children[i]);
-                    } else {
-                        delete static_cast<inner_node*>(children[i]);
-                    }
-                }
-            }
-        }
     };
 
     /**
@@ -898,6 +890,94 @@ protected:
         leaf_node() : node(false) {}
     };
 
+    /**
+     * Creates and destroys the nodes of a tree utilizing the allocator of the tree.
+     * If it is an arena allocator, a tree is freed by releasing its arena at once.
+     */
+    struct node_allocator {
+        using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf_node>;
+        using inner_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<inner_node>;
+        using leaf_traits = std::allocator_traits<leaf_allocator>;
+        using inner_traits = std::allocator_traits<inner_allocator>;
+
+        leaf_allocator leafs;
+        inner_allocator inners;
+
+        node_allocator(const Allocator& alloc = Allocator()) : leafs(alloc), inners(leafs) {}
+
+        // a copy obtains the allocator a copied container would use
+        node_allocator(const node_allocator& other)
+                : leafs(leaf_traits::select_on_container_copy_construction(other.leafs)), inners(leafs) {}
+
+        node_allocator(node_allocator&& other) = default;
+        node_allocator& operator=(node_allocator&& other) = default;
+        node_allocator& operator=(const node_allocator& other) = delete;
+
+        leaf_node* newLeaf() {
+            prepare();
+            leaf_node* res = leaf_traits::allocate(leafs, 1);
+            leaf_traits::construct(leafs, res);
+            return res;
+        }
+
+        inner_node* newInner() {
+            prepare();
+            inner_node* res = inner_traits::allocate(inners, 1);
+            inner_traits::construct(inners, res);
+            return res;
+        }
+
+        node* newNode(bool inner) {
+            return inner ? static_cast<node*>(newInner()) : static_cast<node*>(newLeaf());
+        }
+
+        // destroys a single node, leaving its children untouched
+        void deleteNode(node* n) {
+            if (n->isLeaf()) {
+                leaf_traits::destroy(leafs, static_cast<leaf_node*>(n));
+                leaf_traits::deallocate(leafs, static_cast<leaf_node*>(n), 1);
+            } else {
+                inner_traits::destroy(inners, static_cast<inner_node*>(n));
+                inner_traits::deallocate(inners, static_cast<inner_node*>(n), 1);
+            }
+        }
+
+        // destroys the given node and all its children; the node must be the root of a tree
+        void deleteTree(node* root) {
+            if constexpr (is_arena_allocator<leaf_allocator>::value &&
+                          std::is_trivially_destructible_v<leaf_node> &&
+                          std::is_trivially_destructible_v<inner_node>) {
+                (void)root;
+                leafs.release();
+            } else {
+                deleteSubTree(root);
+            }
+        }
+
+    private:
+        // the arena of a tree is created by its first node, which is never allocated concurrently, so
+        // that trees staying empty and moved-from trees own none
+        void prepare() {
+            if constexpr (is_arena_allocator<leaf_allocator>::value) {
+                if (!leafs.hasArena()) {
+                    leafs.createArena();
+                    inners = inner_allocator(leafs);
+                }
+            }
+        }
+
+        void deleteSubTree(node* n) {
+            if (n->isInner()) {
+                for (unsigned i = 0; i <= n->numElements; ++i) {
+                    if (n->getChild(i) != nullptr) {
+                        deleteSubTree(n->getChild(i));
+                    }
+                }
+            }
+            deleteNode(n);
+        }
+    };
+
     // ------------------- iterators ------------------------
 
 public:
@@ -1090,6 +1170,9 @@ protected:
     // a pointer to the left-most node of this tree (initial note for iteration)
     leaf_node* leftmost;
 
+    // the allocator of the nodes of this tree
+    node_allocator alloc;
+
     /* -------------- operator hint statistics ----------------- */
 
     // an aggregation of statistical values of the hint utilization
@@ -1128,14 +1211,15 @@ public:
 
     // a move constructor
     btree_delete(btree_delete&& other)
-            : comp(other.comp), weak_comp(other.weak_comp), root(other.root), leftmost(other.leftmost) {
+            : comp(other.comp), weak_comp(other.weak_comp), root(other.root), leftmost(other.leftmost),
+              alloc(std::exchange(other.alloc, node_allocator())) {
         other.root = nullptr;
         other.leftmost = nullptr;
     }
 
     // a copy constructor
     btree_delete(const btree_delete& set)
-            : comp(set.comp), weak_comp(set.weak_comp), root(nullptr), leftmost(nullptr) {
+            : comp(set.comp), weak_comp(set.weak_comp), root(nullptr), leftmost(nullptr), alloc(set.alloc) {
         // use assignment operator for a deep copy
         *this = set;
     }
@@ -1145,7 +1229,8 @@ protected:
      * An internal constructor enabling the specific creation of a tree
      * based on internal parameters.
      */
-    btree_delete(size_type /* size */, node* root, leaf_node* leftmost) : root(root), leftmost(leftmost) {}
+    btree_delete(size_type /* size */, node* root, leaf_node* leftmost, node_allocator alloc)
+            : root(root), leftmost(leftmost), alloc(std::move(alloc)) {}
 
 public:
     // the destructor freeing all contained nodes
@@ -1195,7 +1280,7 @@ public:
             }
 
             // create new node
-            leftmost = new leaf_node();
+            leftmost = alloc.newLeaf();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1394,7 +1479,7 @@ public:
                 // split this node
                 auto old_root = root;
                 idx -= cur->rebalance_or_split(
-                        const_cast<node**>(&root), root_lock, static_cast<int>(idx), parents);
+                        alloc, const_cast<node**>(&root), root_lock, static_cast<int>(idx), parents);
 
                 // release parent lock
                 for (auto it = parents.rbegin(); it != parents.rend(); ++it) {
@@ -1446,7 +1531,7 @@ public:
         // special handling for inserting first element
         if (empty()) {
             // create new node
-            leftmost = new leaf_node();
+            leftmost = alloc.newLeaf();
             leftmost->numElements = 1;
             leftmost->keys[0] = k;
             root = leftmost;
@@ -1519,7 +1604,7 @@ public:
 
             if (cur->numElements >= node::maxKeys) {
                 // split this node
-                idx -= cur->rebalance_or_split(&root, root_lock, static_cast<int>(idx));
+                idx -= cur->rebalance_or_split(alloc, &root, root_lock, static_cast<int>(idx));
 
                 // insert element in right fragment
                 if (((size_type)idx) > cur->numElements) {
@@ -1658,7 +1743,7 @@ public:
                         leftmost = nullptr;
                         res.cur = nullptr;
                         res.pos = 0;
-                        delete static_cast<leaf_node*>(iter.cur);
+                        alloc.deleteNode(iter.cur);
                     } else {
                         // Whole tree now contained in child at position 0
                         root = iter.cur->getChild(0);
@@ -1666,7 +1751,7 @@ public:
                         for (unsigned i = 0; i <= iter.cur->asInnerNode().numElements; ++i) {
                             iter.cur->asInnerNode().children[i] = nullptr;
                         }
-                        delete static_cast<inner_node*>(iter.cur);
+                        alloc.deleteNode(iter.cur);
                     }
                 }
                 break;
@@ -1916,12 +2001,12 @@ private:
 
         // Delete the right node
         if (right->isLeaf()) {
-            delete static_cast<leaf_node*>(right);
+            alloc.deleteNode(right);
         } else {
             for (unsigned i = 0; i <= right->asInnerNode().numElements; ++i) {
                 right->asInnerNode().children[i] = nullptr;
             }
-            delete static_cast<inner_node*>(right);
+            alloc.deleteNode(right);
         }
     }
 
@@ -2297,11 +2382,7 @@ public:
      */
     void clear() {
         if (root != nullptr) {
-            if (root->isLeaf()) {
-                delete static_cast<leaf_node*>(root);
-            } else {
-                delete static_cast<inner_node*>(root);
-            }
+            alloc.deleteTree(root);
         }
         root = nullptr;
         leftmost = nullptr;
@@ -2316,6 +2397,7 @@ public:
         // swap the content
         std::swap(root, other.root);
         std::swap(leftmost, other.leftmost);
+        std::swap(alloc, other.alloc);
     }
 
     // Implementation of the assignment operation for trees.
@@ -2332,7 +2414,7 @@ public:
         }
 
         // clone content (deep copy)
-        root = other.root->clone();
+        root = other.root->clone(alloc);
 
         // update leftmost reference
         auto tmp = root;
@@ -2465,7 +2547,8 @@ public:
         }
 
         // resolve tree recursively
-        auto root = buildSubTree(a, b - 1);
+        node_allocator alloc;
+        auto root = buildSubTree(alloc, a, b - 1);
 
         // find leftmost node
         node* leftmost = root;
@@ -2474,7 +2557,7 @@ public:
         }
 
         // build result
-        return R(b - a, root, static_cast<leaf_node*>(leftmost));
+        return R(b - a, root, static_cast<leaf_node*>(leftmost), std::move(alloc));
     }
 
 protected:
@@ -2518,7 +2601,7 @@ private:
 
     // Utility function for the load operation above.
     template <typename Iter>
-    static node* buildSubTree(const Iter& a, const Iter& b) {
+    static node* buildSubTree(node_allocator& alloc, const Iter& a, const Iter& b) {
         const int N = node::maxKeys;
 
         // divide range in N+1 sub-ranges
@@ -2527,7 +2610,7 @@ private:
         // terminal case: length is less then maxKeys
         if (length <= N) {
             // create a leaf node
-            node* res = new leaf_node();
+            node* res = alloc.newLeaf();
             res->numElements = length;
 
             for (int i = 0; i < length; ++i) {
@@ -2547,7 +2630,7 @@ private:
         }
 
         // create inner node
-        node* res = new inner_node();
+        node* res = alloc.newInner();
         res->numElements = numKeys;
 
         Iter c = a;
@@ -2556,7 +2639,7 @@ private:
             res->keys[i] = c[step];
 
             // get sub-tree
-            auto child = buildSubTree(c, c + (step - 1));
+            auto child = buildSubTree(alloc, c, c + (step - 1));
             child->parent = res;
             child->position = i;
             res->getChildren()[i] = child;
@@ -2565,7 +2648,7 @@ private:
         }
 
         // and the remaining part
-        auto child = buildSubTree(c, b);
+        auto child = buildSubTree(alloc, c, b);
         child->parent = res;
         child->position = numKeys;
         res->getChildren()[numKeys] = child;
@@ -2593,7 +2676,7 @@ const SearchStrategy btree_delete<Key, Comparator, Allocator, blockSize, SearchS
  * @tparam SearchStrategy .. enables switching between linear, binary or any other search strategy
  */
 template <typename Key, typename Comparator = detail::comparator<Key>,
-        typename Allocator = std::allocator<Key>,  // is ignored so far
+        typename Allocator = std::allocator<Key>,
         unsigned blockSize = 256,
         typename SearchStrategy = typename souffle::detail::default_strategy<Key>::type,
         typename WeakComparator = Comparator, typename Updater = souffle::detail::updater<Key>>
@@ -2629,8 +2712,8 @@ public:
 
 private:
     // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_delete_set(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
+    template <typename s, typename n, typename l, typename a>
+    btree_delete_set(s size, n* root, l* leftmost, a alloc) : super(size, root, leftmost, std::move(alloc)) {}
 
 public:
     // Support for the assignment operator.
@@ -2656,7 +2739,7 @@ public:
  * @tparam SearchStrategy .. enables switching between linear, binary or any other search strategy
  */
 template <typename Key, typename Comparator = detail::comparator<Key>,
-        typename Allocator = std::allocator<Key>,  // is ignored so far
+        typename Allocator = std::allocator<Key>,
         unsigned blockSize = 256,
         typename SearchStrategy = typename souffle::detail::default_strategy<Key>::type,
         typename WeakComparator = Comparator, typename Updater = souffle::detail::updater<Key>>
@@ -2692,8 +2775,9 @@ public:
 
 private:
     // A constructor required by the bulk-load facility.
-    template <typename s, typename n, typename l>
-    btree_delete_multiset(s size, n* root, l* leftmost) : super(size, root, leftmost) {}
+    template <typename s, typename n, typename l, typename a>
+    btree_delete_multiset(s size, n* root, l* leftmost, a alloc)
+            : super(size, root, leftmost, std::move(alloc)) {}
 
 public:
     // Support for the assignment operator.
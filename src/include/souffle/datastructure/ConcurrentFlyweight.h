@@ -17,7 +17,8 @@ namespace souffle {
 /**
  * A concurrent, almost lock-free associative datastructure that implements the
  * Flyweight pattern.  Assigns a unique index to each inserted key. Elements
- * cannot be removed, the datastructure can only grow.
+ * cannot be removed concurrently; removing them with retain() keeps the indexes
+ * of the others and never reuses their indexes.
  *
  * The datastructure enables a configurable number of concurrent access lanes.
  * Access to the datastructure is lock-free between different lanes.
@@ -199,7 +200,10 @@ public:
                     if (Slot == 0 && This->FirstSlotIsReserved) {
                         continue;
                     }
-                    return true;
+                    if (IsRetained()) {
+                        return true;
+                    }
+                    continue;
                 }
 
                 if (NextMaybeUnassignedHandle == NONE) {  // reaching end
@@ -215,13 +219,19 @@ public:
                     This->Lanes.unlock(NextMaybeUnassignedHandle);
                     Slot = Slot + 1;
                     FindNextMaybeUnassignedSlot();
-                    if (IsAssigned) {
+                    if (IsAssigned && IsRetained()) {
                         return true;
                     }
                 }
             }
             return false;
         }
+
+        /** Return true if the value of Slot was not removed by retain(). */
+        bool IsRetained() const {
+            const auto Guard = This->Lanes.guard(Lane);
+            return This->Slots[index(Slot)] != nullptr;
+        }
     };
 
     using iterator = Iterator;
@@ -363,6 +373,26 @@ public:
         }
     }
 
+    /**
+     * Remove the values whose index does not satisfy the predicate.
+     *
+     * The other values keep their index, and the indexes of the removed
+     * values are not given to new values. Not thread-safe, use only when the
+     * datastructure is not being used.
+     *
+     * @return the number of removed values
+     */
+    template <class Pred>
+    std::size_t retain(const Pred& IsLive) {
+        const slot_type End = NextSlot.load(std::memory_order_relaxed);
+        for (slot_type Slot = 0; Slot < End; ++Slot) {
+            if (Slots[Slot] != nullptr && !IsLive(index(Slot))) {
+                Slots[Slot] = nullptr;
+            }
+        }
+        return Mapping.eraseIf([&](const value_type& Value) { return !IsLive(Value.second); });
+    }
+
 private:
     using map_type = ConcurrentInsertOnlyHashMap<LanesPolicy, Key, index_type, Hash, KeyEqual, KeyFactory>;
     using node_type = typename map_type::node_type;
@@ -478,6 +508,10 @@ public:
     std::pair<index_type, bool> findOrInsert(Args&&... Xs) {
         return Base::findOrInsert(Base::Lanes.threadLane(), std::forward<Args>(Xs)...);
     }
+    template <class Pred>
+    std::size_t retain(const Pred& IsLive) {
+        return Base::retain(IsLive);
+    }
 };
 #endif
 
@@ -521,6 +555,10 @@ public:
     std::pair<index_type, bool> findOrInsert(Args&&... Xs) {
         return Base::findOrInsert(0, std::forward<Args>(Xs)...);
     }
+    template <class Pred>
+    std::size_t retain(const Pred& IsLive) {
+        return Base::retain(IsLive);
+    }
 };
 
 #ifdef _OPENMP
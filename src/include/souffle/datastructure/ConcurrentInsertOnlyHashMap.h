@@ -9,10 +9,13 @@
 
 #include "souffle/utility/ParallelUtil.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -213,6 +216,149 @@ public:
         return weakFind(H, X) != nullptr;
     }
 
+    /**
+     * @brief Iterator over the elements of a range of buckets.
+     *
+     * Iterators must not be used concurrently with insertions, as the
+     * buckets are reallocated when the map grows.
+     */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename ConcurrentInsertOnlyHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() = default;
+
+        iterator(const std::atomic<BucketList*>* Buckets, std::size_t First, std::size_t Last)
+                : Buckets(Buckets), Bucket(First), LastBucket(Last) {
+            skipEmptyBuckets();
+        }
+
+        reference operator*() const {
+            return Current->Value;
+        }
+
+        pointer operator->() const {
+            return &Current->Value;
+        }
+
+        iterator& operator++() {
+            Current = Current->Next;
+            skipEmptyBuckets();
+            return *this;
+        }
+
+        bool operator==(const iterator& Other) const {
+            return Current == Other.Current;
+        }
+
+        bool operator!=(const iterator& Other) const {
+            return Current != Other.Current;
+        }
+
+    private:
+        void skipEmptyBuckets() {
+            while (Current == nullptr && Bucket < LastBucket) {
+                Current = Buckets[Bucket++].load(std::memory_order_acquire);
+            }
+        }
+
+        const std::atomic<BucketList*>* Buckets = nullptr;
+        std::size_t Bucket = 0;
+        std::size_t LastBucket = 0;
+        BucketList* Current = nullptr;
+    };
+
+    iterator begin() const {
+        return iterator(Buckets.get(), 0, BucketCount);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+
+    /**
+     * @brief Return the range of the bucket the given key falls into.
+     *
+     * Besides the elements equal to the key, the range holds the
+     * elements of the same bucket, which callers have to skip.
+     */
+    template <class K>
+    std::pair<iterator, iterator> bucket(const K& X) const {
+        const std::size_t Bucket = Hasher(X) % BucketCount;
+        return {iterator(Buckets.get(), Bucket, Bucket + 1), end()};
+    }
+
+    /**
+     * @brief Split the elements into ranges of consecutive buckets.
+     *
+     * Ranges of empty buckets are left out.
+     */
+    std::vector<std::pair<iterator, iterator>> partition(const std::size_t PartitionCount) const {
+        std::vector<std::pair<iterator, iterator>> Res;
+        const std::size_t Step =
+                std::max<std::size_t>(1, BucketCount / std::max<std::size_t>(1, PartitionCount));
+        for (std::size_t First = 0; First < BucketCount; First += Step) {
+            iterator It(Buckets.get(), First, std::min(BucketCount, First + Step));
+            if (It != end()) {
+                Res.emplace_back(It, end());
+            }
+        }
+        return Res;
+    }
+
+    std::size_t size() const {
+        return Size;
+    }
+
+    /** @brief Remove all elements, not concurrently with other operations. */
+    void clear() {
+        for (std::size_t Bucket = 0; Bucket < BucketCount; ++Bucket) {
+            BucketList* L = Buckets[Bucket].exchange(nullptr, std::memory_order_relaxed);
+            while (L != nullptr) {
+                BucketList* BL = L;
+                L = L->Next;
+                delete (BL);
+            }
+        }
+        Size = 0;
+    }
+
+    /**
+     * @brief Remove the elements satisfying the predicate, not concurrently with other operations.
+     *
+     * @return the number of removed elements
+     */
+    template <class Pred>
+    std::size_t eraseIf(const Pred& P) {
+        std::size_t Erased = 0;
+        for (std::size_t Bucket = 0; Bucket < BucketCount; ++Bucket) {
+            BucketList* Head = Buckets[Bucket].load(std::memory_order_relaxed);
+            BucketList** Link = &Head;
+            while (*Link != nullptr) {
+                BucketList* L = *Link;
+                if (P(L->Value)) {
+                    *Link = L->Next;
+                    delete (L);
+                    ++Erased;
+                } else {
+                    Link = &L->Next;
+                }
+            }
+            Buckets[Bucket].store(Head, std::memory_order_relaxed);
+        }
+        Size -= Erased;
+        return Erased;
+    }
+
+    /** @brief The access lane of the calling thread. */
+    lane_id threadLane() const {
+        return Lanes.threadLane();
+    }
+
     /**
      * @brief Inserts in-place if the key is not mapped, does nothing if the key already exists.
      *
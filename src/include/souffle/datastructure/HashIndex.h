@@ -0,0 +1,350 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file HashIndex.h
+ *
+ * Unordered indexes of tuples for equality searches, supporting
+ * concurrent insertion.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/ConcurrentInsertOnlyHashMap.h"
+#include "souffle/utility/Iteration.h"
+#include "souffle/utility/ParallelUtil.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/** Hashes the given columns of a tuple */
+template <std::size_t... Columns>
+struct ColumnHash {
+    template <typename Tuple>
+    std::size_t operator()(const Tuple& tuple) const {
+        uint64_t hash = 14695981039346656037ull;
+        ((hash = (hash ^ static_cast<uint64_t>(tuple[Columns])) * 1099511628211ull), ...);
+        return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+};
+
+#ifdef _OPENMP
+using HashIndexLanes = ConcurrentLanes;
+#else
+using HashIndexLanes = SeqConcurrentLanes;
+#endif
+
+/** The buckets a hash map starts with, and returns to when cleared */
+constexpr std::size_t hashIndexInitialBuckets = 8;
+
+/** The access lane of the calling thread */
+template <typename Map>
+typename Map::lane_id hashIndexLane(const Map& map) {
+#ifdef _OPENMP
+    return map.threadLane();
+#else
+    (void)map;
+    return 0;
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * The tuples of a relation grouped by the given key columns.
+ *
+ * A group holds the tuples of one key contiguously, so that the tuples with a
+ * given key are found without visiting any other. Duplicates are not
+ * detected; the caller inserts each tuple once, e.g. after inserting it into
+ * a HashIndex of the full tuples.
+ *
+ * Insertions may run concurrently with each other, but not with searches.
+ *
+ * @tparam Arity the arity of the tuples
+ * @tparam Columns the key columns
+ */
+template <std::size_t Arity, std::size_t... Columns>
+class HashGroups {
+public:
+    using entry_type = Tuple<RamDomain, Arity>;
+    using iterator = const entry_type*;
+
+private:
+    using key_type = Tuple<RamDomain, sizeof...(Columns)>;
+
+    /** The tuples of one key */
+    struct Group {
+        SpinLock lock;
+        std::vector<entry_type> tuples;
+    };
+
+    /** Hashes a key, whose columns are the leading ones */
+    template <std::size_t... Is>
+    static detail::ColumnHash<Is...> keyHash(std::index_sequence<Is...>);
+
+    using map_type = ConcurrentInsertOnlyHashMap<detail::HashIndexLanes, key_type, Group*,
+            decltype(keyHash(std::make_index_sequence<sizeof...(Columns)>()))>;
+
+    static key_type keyOf(const entry_type& tuple) {
+        return key_type{{tuple[Columns]...}};
+    }
+
+public:
+    HashGroups() : map(newMap()) {}
+
+    HashGroups(const HashGroups&) = delete;
+    HashGroups& operator=(const HashGroups&) = delete;
+
+    ~HashGroups() {
+        deleteGroups();
+    }
+
+    /** Insert a tuple, which must not be present */
+    void insert(const entry_type& tuple) {
+        const key_type key = keyOf(tuple);
+        const auto lane = detail::hashIndexLane(*map);
+        const auto* found = map->weakFind(lane, key);
+        if (found == nullptr) {
+            auto group = std::make_unique<Group>();
+            auto node = map->node(group.get());
+            const auto res = map->get(lane, node, key);
+            if (res.second) {
+                group.release();
+            } else {
+                // created concurrently by another thread
+                delete node;
+            }
+            found = res.first;
+        }
+        Group& group = *found->second;
+        std::lock_guard<SpinLock> guard(group.lock);
+        group.tuples.push_back(tuple);
+        ++numTuples;
+    }
+
+    /** The tuples agreeing with the given tuple on the key columns */
+    range<iterator> equalRange(const entry_type& key) const {
+        const auto* found = map->weakFind(detail::hashIndexLane(*map), keyOf(key));
+        if (found == nullptr) {
+            return {nullptr, nullptr};
+        }
+        const auto& tuples = found->second->tuples;
+        return {tuples.data(), tuples.data() + tuples.size()};
+    }
+
+    std::size_t size() const {
+        return numTuples;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /** Remove all tuples and return the memory of the groups and buckets */
+    void clear() {
+        deleteGroups();
+        map = newMap();
+        numTuples = 0;
+    }
+
+    void printStats(std::ostream& o) const {
+        o << "   tuples: " << size() << "\n";
+        o << "   keys: " << map->size() << "\n";
+    }
+
+private:
+    static std::unique_ptr<map_type> newMap() {
+        return std::make_unique<map_type>(MAX_THREADS, detail::hashIndexInitialBuckets);
+    }
+
+    void deleteGroups() {
+        for (const auto& entry : *map) {
+            delete entry.second;
+        }
+    }
+
+    std::unique_ptr<map_type> map;
+    std::atomic<std::size_t> numTuples{0};
+};
+
+/**
+ * A set of tuples with equality searches on the given key columns.
+ *
+ * The tuples are hashed in full, so that inserting a tuple only compares it
+ * with tuples of the same hash, however many share its key. Unless the key
+ * is the full tuple, the tuples are also grouped by key in HashGroups. Tuples
+ * are kept in no particular order.
+ *
+ * Insertions may run concurrently with each other and with lookups of full
+ * tuples, but not with iterations.
+ *
+ * @tparam Arity the arity of the tuples
+ * @tparam Columns the key columns
+ */
+template <std::size_t Arity, std::size_t... Columns>
+class HashIndex {
+public:
+    using entry_type = Tuple<RamDomain, Arity>;
+
+private:
+    /** Hashes all columns of a tuple */
+    template <std::size_t... Is>
+    static detail::ColumnHash<Is...> tupleHash(std::index_sequence<Is...>);
+
+    /** Nothing is associated with the tuples */
+    struct Unit {};
+
+    using map_type = ConcurrentInsertOnlyHashMap<detail::HashIndexLanes, entry_type, Unit,
+            decltype(tupleHash(std::make_index_sequence<Arity>()))>;
+    using map_iterator = typename map_type::iterator;
+
+    /** Whether the key is the full tuple, so that the set itself answers searches */
+    static constexpr bool fullKey = sizeof...(Columns) == Arity;
+
+    using groups_type = HashGroups<Arity, Columns...>;
+
+public:
+    /** Iterates over the tuples */
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = entry_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() = default;
+
+        explicit iterator(map_iterator pos) : pos(pos) {}
+
+        reference operator*() const {
+            return pos->first;
+        }
+
+        pointer operator->() const {
+            return &pos->first;
+        }
+
+        iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return pos == other.pos;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return pos != other.pos;
+        }
+
+    private:
+        map_iterator pos;
+    };
+
+    HashIndex() : map(newMap()), groups(fullKey ? nullptr : std::make_unique<groups_type>()) {}
+
+    HashIndex(const HashIndex&) = delete;
+    HashIndex& operator=(const HashIndex&) = delete;
+
+    /** Insert a tuple, returning whether it was not present before */
+    bool insert(const entry_type& tuple) {
+        const auto lane = detail::hashIndexLane(*map);
+        // duplicates are common, so avoid allocating a node for them
+        if (map->weakContains(lane, tuple)) {
+            return false;
+        }
+        auto node = map->node(Unit{});
+        if (!map->get(lane, node, tuple).second) {
+            // inserted concurrently by another thread
+            delete node;
+            return false;
+        }
+        if constexpr (!fullKey) {
+            groups->insert(tuple);
+        }
+        return true;
+    }
+
+    bool contains(const entry_type& tuple) const {
+        return map->weakContains(detail::hashIndexLane(*map), tuple);
+    }
+
+    /** The tuples agreeing with the given tuple on the key columns */
+    range<const entry_type*> equalRange(const entry_type& key) const {
+        if constexpr (fullKey) {
+            const auto* found = map->weakFind(detail::hashIndexLane(*map), key);
+            if (found == nullptr) {
+                return {nullptr, nullptr};
+            }
+            return {&found->first, &found->first + 1};
+        } else {
+            return groups->equalRange(key);
+        }
+    }
+
+    iterator begin() const {
+        return iterator(map->begin());
+    }
+
+    iterator end() const {
+        return iterator(map->end());
+    }
+
+    std::size_t size() const {
+        return map->size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /** Remove all tuples and return the memory of the buckets */
+    void clear() {
+        map = newMap();
+        if constexpr (!fullKey) {
+            groups->clear();
+        }
+    }
+
+    /** Split the tuples into about the given number of chunks of buckets */
+    std::vector<range<iterator>> partition(std::size_t count) const {
+        std::vector<range<iterator>> res;
+        for (const auto& [first, last] : map->partition(count)) {
+            res.push_back({iterator(first), iterator(last)});
+        }
+        return res;
+    }
+
+    void printStats(std::ostream& o) const {
+        o << "   tuples: " << size() << "\n";
+    }
+
+private:
+    static std::unique_ptr<map_type> newMap() {
+        return std::make_unique<map_type>(MAX_THREADS, detail::hashIndexInitialBuckets);
+    }
+
+    std::unique_ptr<map_type> map;
+    std::unique_ptr<groups_type> groups;
+};
+
+}  // namespace souffle
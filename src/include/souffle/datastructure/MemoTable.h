@@ -0,0 +1,164 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file MemoTable.h
+ *
+ * A fixed-size, lock-free cache of the results of pure functions.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace souffle {
+
+/**
+ * Caches the results of a pure function of a fixed number of arguments.
+ *
+ * The arguments hash to a single slot of the table, and a result replaces
+ * the one of other arguments in its slot. Slots are accessed without locks:
+ * each slot has a version that is odd while the slot is written, so that a
+ * lookup ignores a slot written concurrently, and a result is dropped if
+ * its slot is being written by another thread.
+ */
+class MemoTable {
+public:
+    /**
+     * @param arity the number of arguments
+     * @param capacity the number of slots, rounded up to a power of two
+     * @param statistics whether to count the lookups and hits
+     */
+    explicit MemoTable(std::size_t arity, std::size_t capacity = 4096, bool statistics = false)
+            : arity(arity), statistics(statistics) {
+        std::size_t slots = 1;
+        while (slots < capacity) {
+            slots *= 2;
+        }
+        mask = slots - 1;
+        versions = std::make_unique<std::atomic<uint32_t>[]>(slots);
+        words = std::make_unique<std::atomic<RamDomain>[]>(slots * (arity + 1));
+        for (std::size_t i = 0; i < slots; ++i) {
+            versions[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < slots * (arity + 1); ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    MemoTable(const MemoTable&) = delete;
+    MemoTable& operator=(const MemoTable&) = delete;
+
+    /** Look up the result for the given arguments, and store it in result if present */
+    bool lookup(const RamDomain* args, RamDomain& result) {
+        const std::size_t slot = slotOf(args);
+        const std::atomic<RamDomain>* entry = &words[slot * (arity + 1)];
+        if (statistics) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+        }
+        const uint32_t version = versions[slot].load(std::memory_order_acquire);
+        if (version == 0 || version % 2 == 1) {
+            return false;
+        }
+        for (std::size_t i = 0; i < arity; ++i) {
+            if (entry[i].load(std::memory_order_relaxed) != args[i]) {
+                return false;
+            }
+        }
+        const RamDomain value = entry[arity].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (versions[slot].load(std::memory_order_relaxed) != version) {
+            return false;
+        }
+        result = value;
+        if (statistics) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /** Store the result for the given arguments */
+    void insert(const RamDomain* args, RamDomain result) {
+        const std::size_t slot = slotOf(args);
+        std::atomic<RamDomain>* entry = &words[slot * (arity + 1)];
+        uint32_t version = versions[slot].load(std::memory_order_relaxed);
+        if (version % 2 == 1 ||
+                !versions[slot].compare_exchange_strong(version, version + 1, std::memory_order_acquire)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < arity; ++i) {
+            entry[i].store(args[i], std::memory_order_relaxed);
+        }
+        entry[arity].store(result, std::memory_order_relaxed);
+        // skip 0, which marks an empty slot
+        const uint32_t next = version + 2 == 0 ? 2 : version + 2;
+        versions[slot].store(next, std::memory_order_release);
+    }
+
+    /** The cached result for the given arguments, computing it with compute(args) if needed */
+    template <class Compute>
+    RamDomain getOrCompute(const RamDomain* args, Compute&& compute) {
+        RamDomain result;
+        if (!lookup(args, result)) {
+            result = compute(args);
+            insert(args, result);
+        }
+        return result;
+    }
+
+    /** Forget all results, not concurrently with lookups and inserts */
+    void clear() {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            versions[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t getArity() const {
+        return arity;
+    }
+
+    /** The number of lookups, if counted */
+    std::size_t getCalls() const {
+        return calls.load(std::memory_order_relaxed);
+    }
+
+    /** The number of lookups that found a result, if counted */
+    std::size_t getHits() const {
+        return hits.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::size_t slotOf(const RamDomain* args) const {
+        uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < arity; ++i) {
+            hash = (hash ^ static_cast<uint64_t>(args[i])) * 1099511628211ull;
+        }
+        return static_cast<std::size_t>(hash ^ (hash >> 29)) & mask;
+    }
+
+    const std::size_t arity;
+    const bool statistics;
+    std::size_t mask = 0;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> versions;
+
+    // the arguments and the result of each slot
+    std::unique_ptr<std::atomic<RamDomain>[]> words;
+
+    std::atomic<std::size_t> calls{0};
+    std::atomic<std::size_t> hits{0};
+};
+
+}  // namespace souffle
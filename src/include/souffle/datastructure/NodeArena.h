@@ -0,0 +1,309 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file NodeArena.h
+ *
+ * A memory arena for the nodes of a data structure, and an allocator
+ * drawing from it.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace souffle {
+
+/**
+ * A memory arena for the nodes of a single data structure.
+ *
+ * Memory is carved from slabs of growing size. Every thread allocates from
+ * the slabs of its own lane, so nodes created by a thread are first touched
+ * by it and thus, under the default first-touch policy, placed on the NUMA
+ * node the thread runs on. Slabs of huge page size are advised to be backed
+ * by transparent huge pages. Freed blocks are kept for reuse, and all memory
+ * is returned at once by release().
+ *
+ * The lanes are created by the first allocation of their thread, and the first
+ * slab of a lane only holds the first block, so that an arena of a small data
+ * structure stays small.
+ */
+class NodeArena {
+public:
+    /** The size slabs grow to; also the size of a huge page */
+    static constexpr std::size_t maxSlabSize = std::size_t(2) << 20;
+
+    explicit NodeArena(std::size_t numLanes = MAX_THREADS) : numLanes(std::max<std::size_t>(numLanes, 1)) {}
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    ~NodeArena() {
+        release();
+        if (std::atomic<Lane*>* slots = lanes.load(std::memory_order_acquire)) {
+            for (std::size_t i = 0; i < numLanes; ++i) {
+                delete slots[i].load(std::memory_order_relaxed);
+            }
+            delete[] slots;
+        }
+    }
+
+    /** Allocates a block of the given size */
+    void* allocate(std::size_t size) {
+        size = roundUp(size);
+        Lane& lane = threadLane();
+        std::lock_guard<SpinLock> guard(lane.lock);
+
+        // reuse a freed block of the same size
+        for (auto& freeList : lane.freeLists) {
+            if (freeList.first == size && freeList.second != nullptr) {
+                void* res = freeList.second;
+                freeList.second = *static_cast<void**>(res);
+                return res;
+            }
+        }
+
+        // carve from the current slab, start a new one if it is exhausted
+        if (lane.cur == nullptr || static_cast<std::size_t>(lane.end - lane.cur) < size) {
+            lane.slabSize = std::min(std::max(lane.slabSize * 2, size), maxSlabSize);
+            lane.cur = newSlab(lane, std::max(lane.slabSize, size));
+            lane.end = lane.cur + std::max(lane.slabSize, size);
+        }
+        void* res = lane.cur;
+        lane.cur += size;
+        return res;
+    }
+
+    /** Returns a block of the given size for reuse by later allocations */
+    void deallocate(void* ptr, std::size_t size) {
+        size = roundUp(size);
+        Lane& lane = threadLane();
+        std::lock_guard<SpinLock> guard(lane.lock);
+        auto pos = std::find_if(lane.freeLists.begin(), lane.freeLists.end(),
+                [&](const auto& freeList) { return freeList.first == size; });
+        if (pos == lane.freeLists.end()) {
+            pos = lane.freeLists.emplace(lane.freeLists.end(), size, nullptr);
+        }
+        *static_cast<void**>(ptr) = pos->second;
+        pos->second = ptr;
+    }
+
+    /**
+     * Frees all memory of this arena at once. Blocks handed out before become
+     * invalid; objects in them are not destroyed.
+     */
+    void release() {
+        std::atomic<Lane*>* slots = lanes.load(std::memory_order_acquire);
+        for (std::size_t i = 0; slots != nullptr && i < numLanes; ++i) {
+            Lane* cur = slots[i].load(std::memory_order_acquire);
+            if (cur == nullptr) {
+                continue;
+            }
+            Lane& lane = *cur;
+            std::lock_guard<SpinLock> guard(lane.lock);
+            for (const auto& slab : lane.slabs) {
+                freeSlab(slab.first, slab.second);
+            }
+            lane.slabs.clear();
+            lane.freeLists.clear();
+            lane.cur = nullptr;
+            lane.end = nullptr;
+            lane.slabSize = 0;
+        }
+    }
+
+    /** The number of bytes reserved by this arena */
+    std::size_t getMemoryUsage() const {
+        std::size_t res = 0;
+        std::atomic<Lane*>* slots = lanes.load(std::memory_order_acquire);
+        for (std::size_t i = 0; slots != nullptr && i < numLanes; ++i) {
+            if (const Lane* lane = slots[i].load(std::memory_order_acquire)) {
+                for (const auto& slab : lane->slabs) {
+                    res += slab.second;
+                }
+            }
+        }
+        return res;
+    }
+
+private:
+    /** The memory of one thread */
+    struct alignas(hardware_destructive_interference_size) Lane {
+        SpinLock lock;
+        // the unused part of the current slab
+        char* cur = nullptr;
+        char* end = nullptr;
+        // the size of the most recently created slab
+        std::size_t slabSize = 0;
+        // all slabs of this lane and their sizes
+        std::vector<std::pair<char*, std::size_t>> slabs;
+        // heads of the lists of freed blocks, one per block size
+        std::vector<std::pair<std::size_t, void*>> freeLists;
+    };
+
+    static std::size_t roundUp(std::size_t size) {
+        constexpr std::size_t align = alignof(std::max_align_t);
+        return (std::max(size, sizeof(void*)) + align - 1) / align * align;
+    }
+
+    Lane& threadLane() {
+#ifdef _OPENMP
+        std::atomic<Lane*>& slot = laneSlots()[static_cast<std::size_t>(omp_get_thread_num()) % numLanes];
+#else
+        std::atomic<Lane*>& slot = laneSlots()[0];
+#endif
+        Lane* lane = slot.load(std::memory_order_acquire);
+        if (lane == nullptr) {
+            auto created = std::make_unique<Lane>();
+            if (slot.compare_exchange_strong(lane, created.get(), std::memory_order_acq_rel)) {
+                lane = created.release();
+            }
+        }
+        return *lane;
+    }
+
+    /** The slots of the lanes, created with the first lane */
+    std::atomic<Lane*>* laneSlots() {
+        std::atomic<Lane*>* slots = lanes.load(std::memory_order_acquire);
+        if (slots == nullptr) {
+            auto created = std::make_unique<std::atomic<Lane*>[]>(numLanes);
+            if (lanes.compare_exchange_strong(slots, created.get(), std::memory_order_acq_rel)) {
+                slots = created.release();
+            }
+        }
+        return slots;
+    }
+
+    static char* newSlab(Lane& lane, std::size_t size) {
+        char* slab;
+        if (size >= maxSlabSize) {
+            size = (size + maxSlabSize - 1) / maxSlabSize * maxSlabSize;
+            slab = static_cast<char*>(::operator new(size, std::align_val_t(maxSlabSize)));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            madvise(slab, size, MADV_HUGEPAGE);
+#endif
+        } else {
+            slab = static_cast<char*>(::operator new(size));
+        }
+        lane.slabs.emplace_back(slab, size);
+        return slab;
+    }
+
+    static void freeSlab(char* slab, std::size_t size) {
+        if (size >= maxSlabSize) {
+            ::operator delete(slab, std::align_val_t(maxSlabSize));
+        } else {
+            ::operator delete(slab);
+        }
+    }
+
+    const std::size_t numLanes;
+    std::atomic<std::atomic<Lane*>*> lanes{nullptr};
+};
+
+/**
+ * A standard allocator drawing memory from a NodeArena.
+ *
+ * Copies and rebound instances share the arena. A container copied from
+ * another one gets a fresh arena, so that every container owning an arena
+ * may release it independently of all others.
+ *
+ * A default-constructed allocator has no arena until its first allocation or
+ * a call of createArena(); copies made before do not share the arena created
+ * later, so a container creates it before rebinding.
+ */
+template <typename T>
+class ArenaAllocator {
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() = default;
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        if (!arena) {
+            createArena();
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) {
+        arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    /** Whether the arena has been created */
+    bool hasArena() const {
+        return arena != nullptr;
+    }
+
+    /** Creates the arena of this allocator and of its later copies */
+    void createArena() {
+        arena = std::make_shared<NodeArena>();
+    }
+
+    /** Frees all memory handed out by this allocator and its copies */
+    void release() {
+        if (arena) {
+            arena->release();
+        }
+    }
+
+    /** The number of bytes reserved by the underlying arena */
+    std::size_t getMemoryUsage() const {
+        return arena ? arena->getMemoryUsage() : 0;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+
+private:
+    std::shared_ptr<NodeArena> arena;
+};
+
+/** Determines whether the memory of an allocator may be released all at once */
+template <typename Allocator>
+struct is_arena_allocator : std::false_type {};
+
+template <typename T>
+struct is_arena_allocator<ArenaAllocator<T>> : std::true_type {};
+
+}  // namespace souffle
@@ -346,6 +346,7 @@ public:
     virtual const RamDomain* unpack(RamDomain index) const = 0;
     virtual void enumerate(const std::function<void(const RamDomain* /*tuple*/, std::size_t /* arity*/,
                     RamDomain /* key */)>& Callback) const = 0;
+    virtual std::size_t retain(const std::function<bool(RamDomain /* key */)>& Live) = 0;
 };
 
 /** @brief Bidirectional mappping between records and record references, for any record arity. */
@@ -400,6 +401,10 @@ public:
             Callback(tuple.data(), Arity, key);
         }
     }
+
+    std::size_t retain(const std::function<bool(RamDomain)>& Live) override {
+        return Base::retain([&](const std::size_t Index) { return Live(static_cast<RamDomain>(Index)); });
+    }
 };
 
 /** @brief Bidirectional mappping between records and record references, specialized for a record arity. */
@@ -459,6 +464,10 @@ public:
             Callback(tuple.data(), Arity, key);
         }
     }
+
+    std::size_t retain(const std::function<bool(RamDomain)>& Live) override {
+        return Base::retain([&](const std::size_t Index) { return Live(static_cast<RamDomain>(Index)); });
+    }
 };
 
 /** Record map specialized for arity 0 */
@@ -504,6 +513,10 @@ public:
 
     void enumerate(const std::function<void(const RamDomain* /*tuple*/, std::size_t /* arity*/,
                     RamDomain /* key */)>&) const override {}
+
+    std::size_t retain(const std::function<bool(RamDomain)>&) override {
+        return 0;
+    }
 };
 
 /** A concurrent Record Table with some specialized record maps. */
@@ -588,6 +601,17 @@ public:
         }
     }
 
+    std::size_t retain(
+            const std::function<bool(std::size_t /* arity */, RamDomain /* key */)>& Live) override {
+        std::size_t Removed = 0;
+        for (std::size_t Arity = 0; Arity < Maps.size(); ++Arity) {
+            if (Maps[Arity] != nullptr) {
+                Removed += Maps[Arity]->retain([&](RamDomain Key) { return Live(Arity, Key); });
+            }
+        }
+        return Removed;
+    }
+
 private:
     /** @brief lookup RecordMap for a given arity; the map for that arity must exist. */
     RecordMap& lookupMap(const std::size_t Arity) const {
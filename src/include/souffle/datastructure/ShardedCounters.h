@@ -0,0 +1,123 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ShardedCounters.h
+ *
+ * A set of counters with one private shard per thread.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ParallelUtil.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A fixed number of counters that can be incremented concurrently without
+ * synchronisation.
+ *
+ * Every thread increments the counters of its own shard. Shards are padded
+ * to full cache lines so that threads never write to a shared line. Reading
+ * the totals is only safe while no thread is incrementing, e.g. between two
+ * parallel regions.
+ */
+class ShardedCounters {
+public:
+    explicit ShardedCounters(std::size_t numCounters = 0, std::size_t numShards = MAX_THREADS) {
+        resize(numCounters, numShards);
+    }
+
+    /** Resize to the given number of counters and shards; all counts are reset */
+    void resize(std::size_t numCounters, std::size_t numShards) {
+        counters = numCounters;
+        shards = std::max<std::size_t>(numShards, 1);
+        // round up to whole cache lines and add one line of padding between shards
+        stride = ((counters + countersPerLine - 1) / countersPerLine + 1) * countersPerLine;
+        counts.assign(stride * shards, 0);
+    }
+
+    /** Number of counters */
+    std::size_t size() const {
+        return counters;
+    }
+
+    /** Number of shards */
+    std::size_t getNumShards() const {
+        return shards;
+    }
+
+    /** Increment a counter in the shard of the calling thread */
+    void increment(std::size_t counter, std::size_t delta = 1) {
+        increment(threadShard(), counter, delta);
+    }
+
+    /** Increment a counter in the given shard */
+    void increment(std::size_t shard, std::size_t counter, std::size_t delta) {
+        assert(shard < shards && "shard out of range");
+        assert(counter < counters && "counter out of range");
+        counts[shard * stride + counter] += delta;
+    }
+
+    /** Sum of a counter over all shards */
+    std::size_t get(std::size_t counter) const {
+        assert(counter < counters && "counter out of range");
+        std::size_t total = 0;
+        for (std::size_t shard = 0; shard < shards; ++shard) {
+            total += counts[shard * stride + counter];
+        }
+        return total;
+    }
+
+    /**
+     * Merge all shards: invoke the consumer with each counter whose total
+     * is non-zero, then reset all counts.
+     */
+    template <typename F>
+    void drain(F&& consumer) {
+        for (std::size_t counter = 0; counter < counters; ++counter) {
+            std::size_t total = get(counter);
+            if (total != 0) {
+                consumer(counter, total);
+            }
+        }
+        std::fill(counts.begin(), counts.end(), 0);
+    }
+
+private:
+    static constexpr std::size_t countersPerLine =
+            std::max<std::size_t>(hardware_destructive_interference_size / sizeof(std::size_t), 1);
+
+    static std::size_t threadShard() {
+#ifdef _OPENMP
+        return static_cast<std::size_t>(omp_get_thread_num());
+#else
+        return 0;
+#endif
+    }
+
+    /** Number of counters */
+    std::size_t counters = 0;
+
+    /** Number of shards */
+    std::size_t shards = 1;
+
+    /** Distance between two shards in the counts vector */
+    std::size_t stride = 0;
+
+    /** The shards, stored back to back */
+    std::vector<std::size_t> counts;
+};
+
+}  // namespace souffle
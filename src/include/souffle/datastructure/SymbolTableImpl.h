@@ -116,6 +116,20 @@ public:
         return Base::fetch(index);
     }
 
+    void encodeMany(span<const std::string> symbols, span<RamDomain> indices) override {
+        assert(symbols.size() == indices.size() && "mismatching batch sizes");
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            indices[i] = static_cast<RamDomain>(Base::findOrInsert(symbols[i]).first);
+        }
+    }
+
+    void decodeMany(span<const RamDomain> indices, span<std::string> symbols) const override {
+        assert(symbols.size() == indices.size() && "mismatching batch sizes");
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            symbols[i] = Base::fetch(indices[i]);
+        }
+    }
+
     RamDomain unsafeEncode(const std::string& symbol) override {
         return encode(symbol);
     }
@@ -128,6 +142,10 @@ public:
         auto Res = Base::findOrInsert(symbol);
         return std::make_pair(static_cast<RamDomain>(Res.first), Res.second);
     }
+
+    std::size_t retain(const std::function<bool(RamDomain)>& live) override {
+        return Base::retain([&](const std::size_t index) { return live(static_cast<RamDomain>(index)); });
+    }
 };
 
 }  // namespace souffle
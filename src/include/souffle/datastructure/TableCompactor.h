@@ -0,0 +1,161 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file TableCompactor.h
+ *
+ * Frees the symbols and records that the relations no longer reach.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Frees the entries of a symbol table and a record table that the tuples of
+ * the relations do not reach, by a mark and a sweep.
+ *
+ * Each tuple of the live relations is marked with the kind of its attributes,
+ * given by the type qualifiers of RAM: the symbols of symbol attributes, and
+ * the records of record and ADT attributes. The fields of records have no
+ * known kind, so a field is taken for a symbol and for a record of any arity.
+ * The symbols that exist when the compactor is constructed, e.g. the
+ * constants of the program, are never freed.
+ *
+ * The kept entries keep their index and freed indexes are not reused, so the
+ * relations remain valid as they are.
+ */
+class TableCompactor {
+public:
+    TableCompactor(SymbolTable& symbolTable, RecordTable& recordTable)
+            : symbolTable(symbolTable), recordTable(recordTable) {
+        pinnedSymbols = symbolCount();
+    }
+
+    /**
+     * Free the entries that the tuples do not reach.
+     *
+     * @param forEachTuple calls its argument with each tuple of the live
+     * relations and the type qualifiers of its attributes; attributes past
+     * the qualifiers are numbers
+     * @return the number of freed symbols and records
+     */
+    template <class ForEachTuple>
+    std::pair<std::size_t, std::size_t> compact(ForEachTuple&& forEachTuple) {
+        symbols.assign(symbolCount(), false);
+        forEachTuple([&](const RamDomain* tuple, const std::string& kinds) { markTuple(tuple, kinds); });
+        return sweep();
+    }
+
+private:
+    /** One more than the largest index of a symbol */
+    std::size_t symbolCount() const {
+        std::size_t count = 0;
+        for (const auto& entry : symbolTable) {
+            count = std::max(count, static_cast<std::size_t>(entry.second) + 1);
+        }
+        return count;
+    }
+
+    void markTuple(const RamDomain* tuple, const std::string& kinds) {
+        for (std::size_t i = 0; i < kinds.size(); ++i) {
+            switch (kinds[i]) {
+                case 's': markSymbol(tuple[i]); break;
+                case 'r':
+                case '+': recordRoots.push_back(tuple[i]); break;
+                default: break;
+            }
+        }
+    }
+
+    void markSymbol(RamDomain index) {
+        if (index >= 0 && static_cast<std::size_t>(index) < symbols.size()) {
+            symbols[index] = true;
+        }
+    }
+
+    /** Free the entries that are not marked, and clear the marks */
+    std::pair<std::size_t, std::size_t> sweep() {
+        // the records by arity and reference
+        std::vector<std::vector<const RamDomain*>> records;
+        recordTable.enumerate([&](const RamDomain* tuple, std::size_t arity, RamDomain key) {
+            if (records.size() <= arity) {
+                records.resize(arity + 1);
+            }
+            auto& byKey = records[arity];
+            if (byKey.size() <= static_cast<std::size_t>(key)) {
+                byKey.resize(key + 1, nullptr);
+            }
+            byKey[key] = tuple;
+        });
+
+        // mark the records reached from the roots, and their fields
+        std::vector<std::vector<bool>> reached(records.size());
+        for (std::size_t arity = 0; arity < records.size(); ++arity) {
+            reached[arity].resize(records[arity].size(), false);
+        }
+        std::vector<RamDomain> pending = std::move(recordRoots);
+        while (!pending.empty()) {
+            const RamDomain ref = pending.back();
+            pending.pop_back();
+            if (ref < 0) {
+                continue;
+            }
+            const auto key = static_cast<std::size_t>(ref);
+            for (std::size_t arity = 1; arity < records.size(); ++arity) {
+                if (key >= records[arity].size() || records[arity][key] == nullptr || reached[arity][key]) {
+                    continue;
+                }
+                reached[arity][key] = true;
+                const RamDomain* fields = records[arity][key];
+                for (std::size_t i = 0; i < arity; ++i) {
+                    markSymbol(fields[i]);
+                    pending.push_back(fields[i]);
+                }
+            }
+        }
+        records.clear();
+
+        const std::size_t freedSymbols = symbolTable.retain([&](RamDomain index) {
+            const auto i = static_cast<std::size_t>(index);
+            return i < pinnedSymbols || i >= symbols.size() || symbols[i];
+        });
+        const std::size_t freedRecords = recordTable.retain([&](std::size_t arity, RamDomain key) {
+            const auto i = static_cast<std::size_t>(key);
+            return arity >= reached.size() || (i < reached[arity].size() && reached[arity][i]);
+        });
+        symbols.clear();
+        recordRoots.clear();
+        return {freedSymbols, freedRecords};
+    }
+
+    SymbolTable& symbolTable;
+    RecordTable& recordTable;
+
+    /** Symbols below this index are kept */
+    std::size_t pinnedSymbols = 0;
+
+    /** The marked symbols */
+    std::vector<bool> symbols;
+
+    /** The values of record attributes */
+    std::vector<RamDomain> recordRoots;
+};
+
+}  // namespace souffle
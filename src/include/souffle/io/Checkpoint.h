@@ -0,0 +1,614 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Checkpoint.h
+ *
+ * Saves the state of an evaluation between strata and loop iterations, and
+ * resumes an evaluation from it.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/SpillStream.h"
+#include "souffle/utility/FileUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Saves the state of an evaluation to the checkpoint file of a directory, and
+ * resumes an evaluation from it.
+ *
+ * A checkpoint is saved after every given number of strata of the main
+ * program and, given an interval, after every interval iterations of a
+ * fixpoint loop. It holds the
+ * relations, including the delta and new relations of a loop, the spilled
+ * relations, the symbol and record tables, the auto-increment counter and the
+ * variables of the loop. A checkpoint is written to a temporary file that
+ * replaces the previous checkpoint once complete, so that an interrupted save
+ * leaves the previous checkpoint in place.
+ *
+ * An evaluation resuming from a checkpoint skips the strata before it and, if
+ * the checkpoint was saved in a loop, the statements of its stratum before
+ * that loop. Symbols and records keep their index, so that the tuples of the
+ * relations remain valid. The checkpoint is removed when the evaluation
+ * completes. A checkpoint of another program is removed with a warning, and
+ * the evaluation starts from the beginning.
+ */
+class Checkpoint {
+public:
+    /** Writes the relations of a checkpoint */
+    class Writer {
+    public:
+        /**
+         * Write the tuples of a relation, unless a relation of the same name has
+         * been written; a tuple is a pointer to its values, or has a data() method.
+         */
+        template <class Tuples>
+        void writeRelation(const std::string& name, std::size_t arity, const Tuples& tuples) {
+            if (!names.insert(name).second) {
+                return;
+            }
+            writeString(out, name);
+            writeValue<uint64_t>(out, arity);
+            const std::streampos countPos = beginCount(out);
+            uint64_t count = 0;
+            for (const auto& tuple : tuples) {
+                out.write(reinterpret_cast<const char*>(rowOf(tuple)),
+                        static_cast<std::streamsize>(arity * sizeof(RamDomain)));
+                ++count;
+            }
+            endCount(out, countPos, count);
+        }
+
+    private:
+        friend class Checkpoint;
+
+        explicit Writer(std::ostream& out) : out(out) {}
+
+        static const RamDomain* rowOf(const RamDomain* tuple) {
+            return tuple;
+        }
+
+        static const RamDomain* rowOf(RamDomain* tuple) {
+            return tuple;
+        }
+
+        template <class Tuple>
+        static const RamDomain* rowOf(const Tuple& tuple) {
+            return tuple.data();
+        }
+
+        std::ostream& out;
+        std::set<std::string> names;
+    };
+
+    /**
+     * @param fingerprint identifies the program, a checkpoint of another program is discarded
+     * @param strata the number of strata of the main program
+     * @param directory the directory of the checkpoint, or empty for no checkpoints
+     * @param iterations the number of iterations of a loop between checkpoints, or 0 for none
+     * @param strataInterval the number of strata between checkpoints
+     * @param stopAfter the number of checkpoints after which the evaluation stops as if it was
+     * interrupted, or 0 to never stop; used to test resuming. A stopped
+     * evaluation skips all remaining strata and keeps its checkpoint.
+     */
+    Checkpoint(SymbolTable& symbolTable, RecordTable& recordTable, std::atomic<RamDomain>& counter,
+            std::string fingerprint, std::size_t strata, std::string directory = "",
+            std::size_t iterations = 0, std::size_t strataInterval = 1, std::size_t stopAfter = 0)
+            : symbolTable(symbolTable), recordTable(recordTable), counter(counter),
+              fingerprint(std::move(fingerprint)), strata(strata), directory(std::move(directory)),
+              iterations(iterations), strataInterval(strataInterval), stopAfter(stopAfter) {}
+
+    void setDirectory(std::string dir) {
+        directory = std::move(dir);
+    }
+
+    const std::string& getDirectory() const {
+        return directory;
+    }
+
+    /** Set the function writing all relations of the program */
+    void setRelations(std::function<void(Writer&)> writeRelations) {
+        relations = std::move(writeRelations);
+    }
+
+    /**
+     * Read the checkpoint of the directory, if any, and restore the symbols,
+     * the records, the counter and the spilled relations. The relations are
+     * then restored with readRelation. A checkpoint of another program is
+     * removed with a warning.
+     *
+     * @return whether the evaluation resumes from a checkpoint
+     */
+    bool restore() {
+        stratum = 0;
+        loop = 0;
+        resumeStratum = 0;
+        resumeLoop = 0;
+        resuming = false;
+        stopped = false;
+        if (directory.empty()) {
+            return false;
+        }
+        std::ifstream in(getFile(), std::ios::binary);
+        if (!in) {
+            return false;
+        }
+
+        char magic[sizeof(fileMagic)] = {};
+        in.read(magic, sizeof(magic));
+        if (!in || std::memcmp(magic, fileMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Malformed checkpoint " + getFile());
+        }
+        if (readValue<uint64_t>(in) != RAM_DOMAIN_SIZE || readString(in) != fingerprint) {
+            in.close();
+            std::cerr << "Warning: checkpoint " << getFile()
+                      << " is not one of this program and is removed\n";
+            std::remove(getFile().c_str());
+            return false;
+        }
+
+        resumeStratum = readValue<uint64_t>(in);
+        resumeLoop = readValue<uint64_t>(in);
+        resumeIteration = readValue<uint64_t>(in);
+        counter.store(readValue<RamDomain>(in));
+        resumeVariables.clear();
+        for (uint64_t n = readValue<uint64_t>(in); n > 0; --n) {
+            std::string name = readString(in);
+            resumeVariables[name] = readValue<RamDomain>(in);
+        }
+
+        restoreSymbols(in);
+        restoreRecords(in);
+
+        for (uint64_t n = readValue<uint64_t>(in); n > 0; --n) {
+            const std::string name = readString(in);
+            const auto width = static_cast<std::size_t>(readValue<uint64_t>(in));
+            const std::string dir = readString(in);
+            std::vector<RamDomain> rows(static_cast<std::size_t>(readValue<uint64_t>(in)));
+            readValues(in, rows.data(), rows.size());
+            // rows of a spill file go back to a spill file
+            SpillStore::getInstance().store(&symbolTable, name, width, std::move(rows), dir,
+                    dir.empty() ? std::numeric_limits<std::size_t>::max() / 2 : 0);
+        }
+
+        resumeRelations.clear();
+        for (std::string name = readString(in); !name.empty(); name = readString(in)) {
+            Rows& rows = resumeRelations[name];
+            rows.arity = static_cast<std::size_t>(readValue<uint64_t>(in));
+            rows.count = static_cast<std::size_t>(readValue<uint64_t>(in));
+            rows.values.resize(rows.arity * rows.count);
+            readValues(in, rows.values.data(), rows.values.size());
+        }
+
+        return true;
+    }
+
+    /** Insert the restored tuples of a relation with insert(const RamDomain*) */
+    template <class Insert>
+    void readRelation(const std::string& name, std::size_t arity, Insert&& insert) {
+        auto pos = resumeRelations.find(name);
+        if (pos == resumeRelations.end()) {
+            return;
+        }
+        const Rows rows = std::move(pos->second);
+        resumeRelations.erase(pos);
+        if (rows.arity != arity) {
+            throw std::runtime_error("Relation " + name + " of the checkpoint has a different arity");
+        }
+        for (std::size_t i = 0; i < rows.count; ++i) {
+            insert(rows.values.data() + i * arity);
+        }
+    }
+
+    /**
+     * Enter the next stratum of the main program; false if the stratum precedes
+     * the checkpoint, or the evaluation stopped
+     */
+    bool enterStratum() {
+        const std::size_t index = stratum++;
+        loop = 0;
+        resuming = index == resumeStratum && resumeLoop > 0;
+        return index >= resumeStratum && !stopped;
+    }
+
+    /**
+     * Leave a stratum of the main program, saving a checkpoint if one is due,
+     * it was not the last one and the evaluation did not stop in the stratum.
+     *
+     * @return whether the evaluation stops after the checkpoint
+     */
+    bool leaveStratum() {
+        if (!stopped && !directory.empty() && stratum < strata && stratum % strataInterval == 0) {
+            write(stratum, 0, 0, {}, {});
+        }
+        return stopped;
+    }
+
+    /** Enter the next loop of the stratum; false if the loop precedes the loop of the checkpoint */
+    bool enterLoop() {
+        ++loop;
+        return !resuming || loop >= resumeLoop;
+    }
+
+    /** Whether the statements before the loop of the checkpoint are being skipped */
+    bool isResuming() const {
+        return resuming;
+    }
+
+    /** Whether the loop entered last is the loop of the checkpoint */
+    bool isResumedLoop() const {
+        return resuming && loop == resumeLoop;
+    }
+
+    /** The number of iterations of the loop of the checkpoint */
+    std::size_t getIteration() const {
+        return resumeIteration;
+    }
+
+    /** The variables of the loop of the checkpoint */
+    const std::map<std::string, RamDomain>& getVariables() const {
+        return resumeVariables;
+    }
+
+    /** The value of a variable of the loop of the checkpoint */
+    RamDomain getVariable(const std::string& name) const {
+        auto pos = resumeVariables.find(name);
+        return pos == resumeVariables.end() ? 0 : pos->second;
+    }
+
+    /** Continue the evaluation in the loop of the checkpoint */
+    void resume() {
+        resuming = false;
+        resumeVariables.clear();
+    }
+
+    /** Whether a checkpoint is due after the given number of iterations of a loop */
+    bool isDue(std::size_t iteration) const {
+        return iterations > 0 && iteration % iterations == 0 && !directory.empty();
+    }
+
+    /**
+     * Save a checkpoint after some iterations of the current loop.
+     *
+     * @param writeRelations writes the relations the loop holds, before all
+     * other relations of the program are written
+     * @return whether the evaluation stops after the checkpoint, leaving the
+     * rest of its stratum
+     */
+    bool save(std::size_t iteration, const std::map<std::string, RamDomain>& variables,
+            const std::function<void(Writer&)>& writeRelations = {}) {
+        write(stratum - 1, loop, iteration, variables, writeRelations);
+        return stopped;
+    }
+
+    /** Whether the evaluation stopped after saving a checkpoint */
+    bool isStopped() const {
+        return stopped;
+    }
+
+    /** Complete the evaluation, removing the checkpoint unless the evaluation stopped */
+    void finish() {
+        stratum = 0;
+        loop = 0;
+        resumeStratum = 0;
+        resumeLoop = 0;
+        if (!directory.empty() && !stopped) {
+            std::remove(getFile().c_str());
+        }
+    }
+
+private:
+    /** The tuples of a relation of a checkpoint */
+    struct Rows {
+        std::size_t arity = 0;
+        std::size_t count = 0;
+        std::vector<RamDomain> values;
+    };
+
+    static constexpr char fileMagic[8] = "SOUFCKP";
+
+    std::string getFile() const {
+        return directory + pathSeparator + "checkpoint";
+    }
+
+    void write(std::size_t position, std::size_t loopPosition, std::size_t iteration,
+            const std::map<std::string, RamDomain>& variables,
+            const std::function<void(Writer&)>& writeRelations) {
+        const std::string file = getFile();
+        const std::string temporary = file + ".tmp";
+        std::vector<char> buffer(1 << 20);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.open(temporary, std::ios::binary | std::ios::trunc);
+
+        out.write(fileMagic, sizeof(fileMagic));
+        writeValue<uint64_t>(out, RAM_DOMAIN_SIZE);
+        writeString(out, fingerprint);
+        writeValue<uint64_t>(out, position);
+        writeValue<uint64_t>(out, loopPosition);
+        writeValue<uint64_t>(out, iteration);
+        writeValue<RamDomain>(out, counter.load());
+        writeValue<uint64_t>(out, variables.size());
+        for (const auto& [name, value] : variables) {
+            writeString(out, name);
+            writeValue<RamDomain>(out, value);
+        }
+
+        std::streampos countPos = beginCount(out);
+        uint64_t count = 0;
+        for (const auto& [symbol, index] : symbolTable) {
+            writeValue<RamDomain>(out, static_cast<RamDomain>(index));
+            writeString(out, symbol);
+            ++count;
+        }
+        endCount(out, countPos, count);
+
+        countPos = beginCount(out);
+        count = 0;
+        recordTable.enumerate([&](const RamDomain* tuple, std::size_t arity, RamDomain key) {
+            writeValue<uint64_t>(out, arity);
+            writeValue<RamDomain>(out, key);
+            out.write(reinterpret_cast<const char*>(tuple),
+                    static_cast<std::streamsize>(arity * sizeof(RamDomain)));
+            ++count;
+        });
+        endCount(out, countPos, count);
+
+        countPos = beginCount(out);
+        count = 0;
+        SpillStore::getInstance().enumerate(&symbolTable, [&](const std::string& name, std::size_t width,
+                                                                  const std::vector<RamDomain>& rows,
+                                                                  const std::string& dir) {
+            writeString(out, name);
+            writeValue<uint64_t>(out, width);
+            writeString(out, dir);
+            writeValue<uint64_t>(out, rows.size());
+            out.write(reinterpret_cast<const char*>(rows.data()),
+                    static_cast<std::streamsize>(rows.size() * sizeof(RamDomain)));
+            ++count;
+        });
+        endCount(out, countPos, count);
+
+        Writer writer(out);
+        if (writeRelations) {
+            writeRelations(writer);
+        }
+        if (relations) {
+            relations(writer);
+        }
+        writeString(out, "");
+
+        out.close();
+        if (!out || std::rename(temporary.c_str(), file.c_str()) != 0) {
+            throw std::runtime_error("Cannot write checkpoint " + file);
+        }
+
+        if (++saved == stopAfter) {
+            stopped = true;
+        }
+    }
+
+    /** Restore the symbols at their index, filling the freed indexes with placeholders removed afterwards */
+    void restoreSymbols(std::istream& in) {
+        std::vector<std::pair<RamDomain, std::string>> symbols(
+                static_cast<std::size_t>(readValue<uint64_t>(in)));
+        for (auto& [index, symbol] : symbols) {
+            index = readValue<RamDomain>(in);
+            symbol = readString(in);
+        }
+        std::sort(symbols.begin(), symbols.end());
+
+        std::map<RamDomain, std::string> present;
+        RamDomain next = 0;
+        for (const auto& [symbol, index] : symbolTable) {
+            present.emplace(static_cast<RamDomain>(index), symbol);
+            next = std::max(next, static_cast<RamDomain>(index) + 1);
+        }
+        std::set<RamDomain> placeholders;
+        for (const auto& [index, symbol] : symbols) {
+            auto pos = present.find(index);
+            if (pos != present.end() ? pos->second != symbol : index < next) {
+                throw std::runtime_error("Symbols of checkpoint " + getFile() + " do not match the program");
+            }
+            if (pos != present.end()) {
+                continue;
+            }
+            for (; next < index; ++next) {
+                encodeAt(std::string("\0checkpoint:", 12) + std::to_string(next), next);
+                placeholders.insert(next);
+            }
+            encodeAt(symbol, next++);
+        }
+        if (!placeholders.empty()) {
+            symbolTable.retain([&](RamDomain index) { return placeholders.count(index) == 0; });
+        }
+    }
+
+    void encodeAt(const std::string& symbol, RamDomain index) {
+        if (symbolTable.encode(symbol) != index) {
+            throw std::runtime_error("Symbols of checkpoint " + getFile() + " do not match the program");
+        }
+    }
+
+    /** Restore the records at their reference, filling freed references with placeholders dropped after */
+    void restoreRecords(std::istream& in) {
+        // the records by arity, as references and fields
+        std::map<std::size_t, std::pair<std::vector<RamDomain>, std::vector<RamDomain>>> records;
+        for (uint64_t n = readValue<uint64_t>(in); n > 0; --n) {
+            const auto arity = static_cast<std::size_t>(readValue<uint64_t>(in));
+            auto& [keys, fields] = records[arity];
+            keys.push_back(readValue<RamDomain>(in));
+            fields.resize(fields.size() + arity);
+            readValues(in, fields.data() + fields.size() - arity, arity);
+        }
+
+        std::map<std::size_t, RamDomain> next;
+        std::map<std::pair<std::size_t, RamDomain>, std::vector<RamDomain>> present;
+        recordTable.enumerate([&](const RamDomain* tuple, std::size_t arity, RamDomain key) {
+            present.emplace(std::make_pair(arity, key), std::vector<RamDomain>(tuple, tuple + arity));
+            RamDomain& nextKey = next.emplace(arity, 1).first->second;
+            nextKey = std::max(nextKey, key + 1);
+        });
+
+        std::set<std::pair<std::size_t, RamDomain>> placeholders;
+        for (auto& [arity, entry] : records) {
+            const auto& [keys, fields] = entry;
+            std::vector<std::size_t> order(keys.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(),
+                    [&](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+
+            RamDomain& nextKey = next.emplace(arity, 1).first->second;
+            // tuples that are not records of the checkpoint, built when a reference has been freed
+            std::set<std::vector<RamDomain>> tuples;
+            RamDomain filler = MIN_RAM_SIGNED;
+            for (std::size_t i : order) {
+                const RamDomain key = keys[i];
+                const RamDomain* tuple = fields.data() + i * arity;
+                auto pos = present.find(std::make_pair(arity, key));
+                if (pos != present.end() ? !std::equal(tuple, tuple + arity, pos->second.begin())
+                                         : key < nextKey) {
+                    throw std::runtime_error(
+                            "Records of checkpoint " + getFile() + " do not match the program");
+                }
+                if (pos != present.end()) {
+                    continue;
+                }
+                if (nextKey < key && tuples.empty()) {
+                    for (std::size_t j = 0; j < keys.size(); ++j) {
+                        tuples.emplace(fields.data() + j * arity, fields.data() + (j + 1) * arity);
+                    }
+                }
+                for (; nextKey < key; ++nextKey) {
+                    std::vector<RamDomain> placeholder(arity, filler);
+                    while (tuples.count(placeholder) > 0) {
+                        std::fill(placeholder.begin(), placeholder.end(), ++filler);
+                    }
+                    ++filler;
+                    packAt(placeholder.data(), arity, nextKey);
+                    placeholders.emplace(arity, nextKey);
+                }
+                packAt(tuple, arity, nextKey++);
+            }
+        }
+        if (!placeholders.empty()) {
+            recordTable.retain([&](std::size_t arity, RamDomain key) {
+                return placeholders.count(std::make_pair(arity, key)) == 0;
+            });
+        }
+    }
+
+    void packAt(const RamDomain* tuple, std::size_t arity, RamDomain key) {
+        if (recordTable.pack(tuple, arity) != key) {
+            throw std::runtime_error("Records of checkpoint " + getFile() + " do not match the program");
+        }
+    }
+
+    template <class T>
+    static void writeValue(std::ostream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void writeString(std::ostream& out, const std::string& text) {
+        writeValue<uint64_t>(out, text.size());
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    /** Write a count to be set by endCount */
+    static std::streampos beginCount(std::ostream& out) {
+        const std::streampos pos = out.tellp();
+        writeValue<uint64_t>(out, 0);
+        return pos;
+    }
+
+    static void endCount(std::ostream& out, std::streampos pos, uint64_t count) {
+        const std::streampos end = out.tellp();
+        out.seekp(pos);
+        writeValue<uint64_t>(out, count);
+        out.seekp(end);
+    }
+
+    template <class T>
+    T readValue(std::istream& in) const {
+        T value{};
+        readValues(in, &value, 1);
+        return value;
+    }
+
+    template <class T>
+    void readValues(std::istream& in, T* values, std::size_t count) const {
+        in.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!in) {
+            throw std::runtime_error("Malformed checkpoint " + getFile());
+        }
+    }
+
+    std::string readString(std::istream& in) const {
+        std::string text(static_cast<std::size_t>(readValue<uint64_t>(in)), '\0');
+        readValues(in, text.data(), text.size());
+        return text;
+    }
+
+    SymbolTable& symbolTable;
+    RecordTable& recordTable;
+    std::atomic<RamDomain>& counter;
+    const std::string fingerprint;
+    const std::size_t strata;
+    std::string directory;
+    const std::size_t iterations;
+    const std::size_t strataInterval;
+    const std::size_t stopAfter;
+
+    /** The number of checkpoints saved */
+    std::size_t saved = 0;
+
+    /** Whether the evaluation stopped after saving a checkpoint */
+    bool stopped = false;
+
+    /** Writes all relations of the program */
+    std::function<void(Writer&)> relations;
+
+    /** The number of strata entered, and of loops entered in the current stratum */
+    std::size_t stratum = 0;
+    std::size_t loop = 0;
+
+    /** The position of the checkpoint the evaluation resumes from */
+    std::size_t resumeStratum = 0;
+    std::size_t resumeLoop = 0;
+    std::size_t resumeIteration = 0;
+    bool resuming = false;
+    std::map<std::string, RamDomain> resumeVariables;
+    std::map<std::string, Rows> resumeRelations;
+};
+
+}  // namespace souffle
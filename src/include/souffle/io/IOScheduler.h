@@ -0,0 +1,114 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file IOScheduler.h
+ *
+ * Runs the loading and storing of relations in the background, so that
+ * the evaluation overlaps with parsing inputs and writing outputs.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Schedules the IO tasks of relations.
+ *
+ * The tasks of a relation run one after the other, tasks of different
+ * relations run concurrently. A relation must not be accessed by the
+ * evaluation while one of its tasks is pending, except for reading it
+ * while it is stored.
+ *
+ * Interning symbols from another thread requires the concurrent symbol
+ * and record tables of OpenMP builds; without OpenMP the tasks are
+ * deferred until they are awaited.
+ */
+class IOScheduler {
+public:
+    IOScheduler() = default;
+    IOScheduler(const IOScheduler&) = delete;
+    IOScheduler& operator=(const IOScheduler&) = delete;
+
+    ~IOScheduler() {
+        for (auto& [relation, task] : tasks) {
+            task.wait();
+        }
+    }
+
+    /** Run a task for a relation after the pending tasks of the relation */
+    void submit(const std::string& relation, std::function<void()> task) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::shared_future<void> previous;
+        auto pos = tasks.find(relation);
+        if (pos != tasks.end()) {
+            previous = pos->second;
+        }
+        tasks[relation] = std::async(policy(), [previous, task = std::move(task)]() {
+            if (previous.valid()) {
+                previous.get();
+            }
+            task();
+        }).share();
+    }
+
+    /** Wait for the tasks of a relation, and rethrow the first error of a task */
+    void await(const std::string& relation) {
+        std::shared_future<void> task;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto pos = tasks.find(relation);
+            if (pos == tasks.end()) {
+                return;
+            }
+            task = std::move(pos->second);
+            tasks.erase(pos);
+        }
+        task.get();
+    }
+
+    /** Wait for the tasks of all relations */
+    void awaitAll() {
+        std::vector<std::string> relations;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (const auto& [relation, task] : tasks) {
+                relations.push_back(relation);
+            }
+        }
+        for (const auto& relation : relations) {
+            await(relation);
+        }
+    }
+
+private:
+    static std::launch policy() {
+#ifdef _OPENMP
+        return std::launch::async;
+#else
+        return std::launch::deferred;
+#endif
+    }
+
+    std::mutex lock;
+
+    /** The last task of each relation, which waits for the previous ones */
+    std::map<std::string, std::shared_future<void>> tasks;
+};
+
+}  // end of namespace souffle
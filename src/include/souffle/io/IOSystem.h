@@ -20,6 +20,7 @@
 #include "souffle/io/ReadStream.h"
 #include "souffle/io/ReadStreamCSV.h"
 #include "souffle/io/ReadStreamJSON.h"
+#include "souffle/io/SpillStream.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/io/WriteStreamCSV.h"
 #include "souffle/io/WriteStreamJSON.h"
@@ -86,6 +87,8 @@ private:
         registerWriteStreamFactory(std::make_shared<WriteCoutPrintSizeFactory>());
         registerWriteStreamFactory(std::make_shared<WriteFileJSONFactory>());
         registerWriteStreamFactory(std::make_shared<WriteCoutJSONFactory>());
+        registerReadStreamFactory(std::make_shared<ReadSpillFactory>());
+        registerWriteStreamFactory(std::make_shared<WriteSpillFactory>());
 #ifdef USE_SQLITE
         registerReadStreamFactory(std::make_shared<ReadSQLiteFactory>());
         registerWriteStreamFactory(std::make_shared<WriteSQLiteFactory>());
@@ -22,6 +22,7 @@
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include "souffle/utility/json11.h"
+#include <cassert>
 #include <cctype>
 #include <cstddef>
 #include <map>
@@ -37,7 +38,9 @@ class ReadStream : public SerialisationStream<false> {
 protected:
     ReadStream(
             const std::map<std::string, std::string>& rwOperation, SymbolTable& symTab, RecordTable& recTab)
-            : SerialisationStream(symTab, recTab, rwOperation) {}
+            : SerialisationStream(symTab, recTab, rwOperation) {
+        setupPushdown(rwOperation);
+    }
 
 public:
     template <typename T>
@@ -381,6 +384,81 @@ protected:
     }
 
     virtual Own<RamDomain[]> readNextTuple() = 0;
+
+    /**
+     * Whether a column is loaded. Columns the program never reads are not
+     * loaded, and left 0, if the directive load-columns says so.
+     */
+    bool isColumnLoaded(std::size_t column) const {
+        return loadedColumns.empty() || loadedColumns[column];
+    }
+
+    /**
+     * Whether a column is converted to check its values, although it is not loaded or its tuple
+     * is rejected by the load-time selection. Only numbers can be malformed, symbols cannot.
+     */
+    bool isColumnChecked(std::size_t column) const {
+        const char type = typeAttributes[column][0];
+        return type == 'i' || type == 'u' || type == 'f';
+    }
+
+    /** Columns of the load-time selection, check these before loading the other columns */
+    const std::vector<std::size_t>& getSelectedColumns() const {
+        return selectedColumns;
+    }
+
+    /** Whether a symbol passes the load-time selection of its column */
+    bool isSelected(std::size_t column, const std::string& symbol) const {
+        auto pos = selectedSymbols.find(column);
+        return pos == selectedSymbols.end() || pos->second == symbol;
+    }
+
+    /** Whether a value passes the load-time selection of its column */
+    bool isSelected(std::size_t column, RamDomain value) const {
+        auto pos = selectedValues.find(column);
+        return pos == selectedValues.end() || pos->second == value;
+    }
+
+private:
+    /**
+     * Read the load-time projection and selection. The directive load-columns
+     * holds a 0 or 1 per column, load-selection maps columns to the symbol or
+     * the value all tuples of the relation must have.
+     */
+    void setupPushdown(const std::map<std::string, std::string>& rwOperation) {
+        const std::string columns = getOr(rwOperation, "load-columns", "");
+        if (!columns.empty()) {
+            loadedColumns.resize(typeAttributes.size(), true);
+            for (std::size_t i = 0; i < columns.size() && i < loadedColumns.size(); ++i) {
+                loadedColumns[i] = columns[i] == '1';
+            }
+        }
+
+        const std::string selection = getOr(rwOperation, "load-selection", "");
+        if (selection.empty()) {
+            return;
+        }
+        std::string parseErrors;
+        Json constants = Json::parse(selection, parseErrors);
+        assert(parseErrors.size() == 0 && "Internal JSON parsing failed.");
+        for (const auto& [key, constant] : constants.object_items()) {
+            const std::size_t column = std::stoul(key);
+            if (column >= arity) {
+                continue;
+            }
+            selectedColumns.push_back(column);
+            if (typeAttributes[column][0] == 's') {
+                selectedSymbols[column] = constant.string_value();
+            } else {
+                selectedValues[column] = RamSignedFromString(constant.string_value());
+            }
+        }
+    }
+
+    std::vector<bool> loadedColumns;
+    std::vector<std::size_t> selectedColumns;
+    std::map<std::size_t, std::string> selectedSymbols;
+    std::map<std::size_t, RamDomain> selectedValues;
 };
 
 class ReadStreamFactory {
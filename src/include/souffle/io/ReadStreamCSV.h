@@ -49,7 +49,8 @@ public:
             : ReadStream(rwOperation, symbolTable, recordTable),
               rfc4180(getOr(rwOperation, "rfc4180", "false") == std::string("true")),
               delimiter(getOr(rwOperation, "delimiter", (rfc4180 ? "," : "\t"))), file(file), lineNumber(0),
-              inputMap(getInputColumnMap(rwOperation, static_cast<unsigned int>(arity))) {
+              inputMap(getInputColumnMap(rwOperation, static_cast<unsigned int>(arity))), elements(arity),
+              elementColumns(arity) {
         if (rfc4180 && delimiter.find('"') != std::string::npos) {
             std::stringstream errorMessage;
             errorMessage << "CSV delimiter cannot contain '\"' character when rfc4180 is enabled.";
@@ -83,70 +84,104 @@ protected:
      * @return
      */
     Own<RamDomain[]> readNextTuple() override {
-        if (file.eof()) {
-            return nullptr;
-        }
         std::string line;
-        Own<RamDomain[]> tuple = mk<RamDomain[]>(typeAttributes.size());
         bool wasCRLF = false;
-        if (!readNextLine(line, wasCRLF)) {
-            return nullptr;
-        }
+        while (!file.eof() && readNextLine(line, wasCRLF)) {
+            // split the line into the elements of the tuple
+            std::size_t start = 0;
+            std::size_t columnsFilled = 0;
+            for (uint32_t column = 0; columnsFilled < arity; column++) {
+                std::string element = nextElement(line, start, wasCRLF);
+                if (inputMap.count(column) == 0) {
+                    continue;
+                }
+                ++columnsFilled;
+                elements[inputMap[column]] = std::move(element);
+                elementColumns[inputMap[column]] = column;
+            }
 
-        std::size_t start = 0;
-        std::size_t columnsFilled = 0;
-        for (uint32_t column = 0; columnsFilled < arity; column++) {
-            std::size_t charactersRead = 0;
-            std::string element = nextElement(line, start, wasCRLF);
-            if (inputMap.count(column) == 0) {
-                continue;
+            // skip tuples outside of the load-time selection before interning any of their symbols
+            Own<RamDomain[]> tuple = mk<RamDomain[]>(typeAttributes.size());
+            bool selected = true;
+            for (std::size_t attribute : getSelectedColumns()) {
+                if (typeAttributes[attribute][0] == 's') {
+                    selected = isSelected(attribute, elements[attribute]);
+                } else {
+                    selected = isSelected(attribute, readElement(attribute));
+                }
+                if (!selected) {
+                    break;
+                }
             }
-            ++columnsFilled;
-
-            try {
-                auto&& ty = typeAttributes.at(inputMap[column]);
-                switch (ty[0]) {
-                    case 's': {
-                        tuple[inputMap[column]] = symbolTable.encode(element);
-                        charactersRead = element.size();
-                        break;
-                    }
-                    case 'r': {
-                        tuple[inputMap[column]] = readRecord(element, ty, 0, &charactersRead);
-                        break;
-                    }
-                    case '+': {
-                        tuple[inputMap[column]] = readADT(element, ty, 0, &charactersRead);
-                        break;
+            if (!selected) {
+                // malformed numbers of rejected tuples are reported all the same
+                for (std::size_t attribute = 0; attribute < arity; ++attribute) {
+                    if (isColumnChecked(attribute)) {
+                        readElement(attribute);
                     }
-                    case 'i': {
-                        tuple[inputMap[column]] = RamSignedFromString(element, &charactersRead);
-                        break;
-                    }
-                    case 'u': {
-                        tuple[inputMap[column]] = ramBitCast(readRamUnsigned(element, charactersRead));
-                        break;
-                    }
-                    case 'f': {
-                        tuple[inputMap[column]] = ramBitCast(RamFloatFromString(element, &charactersRead));
-                        break;
-                    }
-                    default: fatal("invalid type attribute: `%c`", ty[0]);
                 }
-                // Check if everything was read.
-                if (charactersRead != element.size()) {
-                    throw std::invalid_argument(
-                            "Expected: " + delimiter + " or \\n. Got: " + element[charactersRead]);
+                continue;
+            }
+
+            for (std::size_t attribute = 0; attribute < arity; ++attribute) {
+                if (isColumnLoaded(attribute)) {
+                    tuple[attribute] = readElement(attribute);
+                } else if (isColumnChecked(attribute)) {
+                    readElement(attribute);
                 }
-            } catch (...) {
-                std::stringstream errorMessage;
-                errorMessage << "Error converting <" + element + "> in column " << column + 1 << " in line "
-                             << lineNumber << "; ";
-                throw std::invalid_argument(errorMessage.str());
             }
+            return tuple;
         }
+        return nullptr;
+    }
 
-        return tuple;
+    /** Convert the element of the current line for the given attribute */
+    RamDomain readElement(std::size_t attribute) {
+        const std::string& element = elements[attribute];
+        std::size_t charactersRead = 0;
+        RamDomain value = 0;
+        try {
+            auto&& ty = typeAttributes.at(attribute);
+            switch (ty[0]) {
+                case 's': {
+                    value = symbolTable.encode(element);
+                    charactersRead = element.size();
+                    break;
+                }
+                case 'r': {
+                    value = readRecord(element, ty, 0, &charactersRead);
+                    break;
+                }
+                case '+': {
+                    value = readADT(element, ty, 0, &charactersRead);
+                    break;
+                }
+                case 'i': {
+                    value = RamSignedFromString(element, &charactersRead);
+                    break;
+                }
+                case 'u': {
+                    value = ramBitCast(readRamUnsigned(element, charactersRead));
+                    break;
+                }
+                case 'f': {
+                    value = ramBitCast(RamFloatFromString(element, &charactersRead));
+                    break;
+                }
+                default: fatal("invalid type attribute: `%c`", ty[0]);
+            }
+            // Check if everything was read.
+            if (charactersRead != element.size()) {
+                throw std::invalid_argument(
+                        "Expected: " + delimiter + " or \\n. Got: " + element[charactersRead]);
+            }
+        } catch (...) {
+            std::stringstream errorMessage;
+            errorMessage << "Error converting <" + element + "> in column " << elementColumns[attribute] + 1
+                         << " in line " << lineNumber << "; ";
+            throw std::invalid_argument(errorMessage.str());
+        }
+        return value;
     }
 
     /**
@@ -330,6 +365,9 @@ protected:
     std::istream& file;
     std::size_t lineNumber;
     std::map<int, int> inputMap;
+    // the elements of the current line, and the columns of the file they were read from
+    std::vector<std::string> elements;
+    std::vector<uint32_t> elementColumns;
 };
 
 class ReadFileCSV : public ReadStreamCSV {
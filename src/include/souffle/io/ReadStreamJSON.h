@@ -109,7 +109,25 @@ protected:
         }
     }
 
+    /** Whether a tuple, given as a list or an object, passes the load-time selection */
+    bool isSelectedTuple(const Json& jsonObj) const {
+        for (std::size_t column : getSelectedColumns()) {
+            const Json& value = useObjects ? jsonObj[params["relation"]["params"][column].string_value()]
+                                           : jsonObj[column];
+            const bool selected = typeAttributes[column][0] == 's'
+                                          ? isSelected(column, value.string_value())
+                                          : isSelected(column, static_cast<RamDomain>(value.int_value()));
+            if (!selected) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     Own<RamDomain[]> readNextTupleList() {
+        while (pos < jsonSource.array_items().size() && !isSelectedTuple(jsonSource[pos])) {
+            pos++;
+        }
         if (pos >= jsonSource.array_items().size()) {
             return nullptr;
         }
@@ -119,6 +137,9 @@ protected:
         assert(jsonObj.is_array() && "the input is not json array");
         pos++;
         for (std::size_t i = 0; i < typeAttributes.size(); ++i) {
+            if (!isColumnLoaded(i)) {
+                continue;
+            }
             try {
                 auto&& ty = typeAttributes.at(i);
                 switch (ty[0]) {
@@ -205,6 +226,17 @@ protected:
     }
 
     Own<RamDomain[]> readNextTupleObject() {
+        // unknown parameters of rejected tuples are reported all the same
+        while (pos < jsonSource.array_items().size() && !isSelectedTuple(jsonSource[pos])) {
+            for (auto p : jsonSource[pos].object_items()) {
+                if (paramIndex.find(p.first) == paramIndex.end()) {
+                    std::stringstream errorMessage;
+                    errorMessage << "Error converting: " << p.second.dump();
+                    throw std::invalid_argument(errorMessage.str());
+                }
+            }
+            pos++;
+        }
         if (pos >= jsonSource.array_items().size()) {
             return nullptr;
         }
@@ -220,6 +252,9 @@ protected:
                     throwError("invalid parameter: ", p.first);
                 }
                 std::size_t i = paramIndex.at(p.first);
+                if (!isColumnLoaded(i)) {
+                    continue;
+                }
                 auto&& ty = typeAttributes.at(i);
                 switch (ty[0]) {
                     case 's': {
@@ -56,43 +56,81 @@ protected:
      * @return
      */
     Own<RamDomain[]> readNextTuple() override {
-        if (sqlite3_step(selectStatement) != SQLITE_ROW) {
-            return nullptr;
+        // skip rows outside of the load-time selection, after checking their numbers
+        while (true) {
+            if (sqlite3_step(selectStatement) != SQLITE_ROW) {
+                return nullptr;
+            }
+            if (isSelectedRow()) {
+                break;
+            }
+            for (uint32_t column = 0; column < arity; column++) {
+                if (isColumnChecked(column)) {
+                    readColumn(column);
+                }
+            }
         }
 
         Own<RamDomain[]> tuple = mk<RamDomain[]>(arity + auxiliaryArity);
 
         uint32_t column;
         for (column = 0; column < arity; column++) {
-            std::string element;
-            if (0 == sqlite3_column_bytes(selectStatement, column)) {
-                element = "";
-            } else {
-                element = reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column));
-
-                if (element.empty()) {
-                    element = "";
-                }
+            if (isColumnLoaded(column)) {
+                tuple[column] = readColumn(column);
+            } else if (isColumnChecked(column)) {
+                readColumn(column);
+            }
+        }
+
+        return tuple;
+    }
+
+    /** Convert the given column of the current row */
+    RamDomain readColumn(uint32_t column) {
+        std::string element = readColumnText(column);
+        try {
+            auto&& ty = typeAttributes.at(column);
+            switch (ty[0]) {
+                case 's': return symbolTable.encode(element);
+                case 'f': return ramBitCast(RamFloatFromString(element));
+                case 'i':
+                case 'u':
+                case 'r': return RamSignedFromString(element);
+                default: fatal("invalid type attribute: `%c`", ty[0]);
             }
+        } catch (...) {
+            std::stringstream errorMessage;
+            errorMessage << "Error converting number in column " << (column) + 1;
+            throw std::invalid_argument(errorMessage.str());
+        }
+    }
+
+    std::string readColumnText(uint32_t column) {
+        if (0 == sqlite3_column_bytes(selectStatement, column)) {
+            return "";
+        }
+        return reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column));
+    }
 
+    /** Whether the current row passes the load-time selection */
+    bool isSelectedRow() {
+        for (std::size_t column : getSelectedColumns()) {
+            const std::string element = readColumnText(static_cast<uint32_t>(column));
+            bool selected = false;
             try {
-                auto&& ty = typeAttributes.at(column);
-                switch (ty[0]) {
-                    case 's': tuple[column] = symbolTable.encode(element); break;
-                    case 'f': tuple[column] = ramBitCast(RamFloatFromString(element)); break;
-                    case 'i':
-                    case 'u':
-                    case 'r': tuple[column] = RamSignedFromString(element); break;
-                    default: fatal("invalid type attribute: `%c`", ty[0]);
-                }
+                selected = typeAttributes[column][0] == 's'
+                                   ? isSelected(column, element)
+                                   : isSelected(column, RamSignedFromString(element));
             } catch (...) {
                 std::stringstream errorMessage;
-                errorMessage << "Error converting number in column " << (column) + 1;
+                errorMessage << "Error converting number in column " << column + 1;
                 throw std::invalid_argument(errorMessage.str());
             }
+            if (!selected) {
+                return false;
+            }
         }
-
-        return tuple;
+        return true;
     }
 
     void executeSQL(const std::string& sql) {
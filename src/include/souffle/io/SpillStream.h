@@ -0,0 +1,421 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SpillStream.h
+ *
+ * Streams moving the tuples of a relation out of memory and back again.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include "souffle/RecordTable.h"
+#include "souffle/SymbolTable.h"
+#include "souffle/io/ReadStream.h"
+#include "souffle/io/WriteStream.h"
+#include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/FileUtil.h"
+#include "souffle/utility/MiscUtil.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace souffle {
+
+/**
+ * Holds the tuples of spilled relations until they are restored.
+ *
+ * Tuples are kept as sorted rows of RamDomain values. Symbols and records are
+ * stored by their ordinal, which is valid as the symbol and record tables
+ * live for the whole run. Entries belong to the program instance owning the
+ * symbol table, so that several instances of a program in one process keep
+ * their relations apart. Spilled relations are kept in memory as long as
+ * they fit into the memory budget, and are written to a file otherwise.
+ */
+class SpillStore {
+public:
+    /** The symbol table identifying the program instance owning a spilled relation */
+    using Owner = const SymbolTable*;
+
+    static SpillStore& getInstance() {
+        static SpillStore singleton;
+        return singleton;
+    }
+
+    /**
+     * Store the rows of a relation.
+     *
+     * @param owner - the program instance spilling the relation
+     * @param name - name of the relation
+     * @param width - number of values per row
+     * @param rows - the values of all rows, back to back
+     * @param dir - directory for the spill file
+     * @param budget - number of bytes the spilled relations of the instance may keep in memory
+     */
+    void store(Owner owner, const std::string& name, std::size_t width, std::vector<RamDomain> rows,
+            const std::string& dir, std::size_t budget) {
+        std::lock_guard<std::mutex> guard(lock);
+        Instance& instance = getOwner(owner);
+        auto pos = instance.entries.find(name);
+        if (pos != instance.entries.end()) {
+            discard(instance, pos->second);
+        }
+        Entry entry;
+        entry.width = width;
+        const std::size_t bytes = rows.size() * sizeof(RamDomain);
+        if (instance.resident + bytes <= budget) {
+            instance.resident += bytes;
+            entry.rows = std::move(rows);
+        } else {
+            entry.dir = dir;
+            entry.file = dir + pathSeparator + name + "." + std::to_string(processId()) + "-" +
+                         std::to_string(instance.id) + ".spill";
+            writeFile(entry.file, width, rows);
+        }
+        instance.entries[name] = std::move(entry);
+    }
+
+    /** Remove the rows of a relation from the store; a spill file is left for the caller to read */
+    std::pair<std::vector<RamDomain>, std::string> take(
+            Owner owner, const std::string& name, std::size_t width) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto instance = instances.find(owner);
+        if (instance == instances.end() || instance->second.entries.count(name) == 0) {
+            throw std::invalid_argument("Relation " + name + " has not been spilled");
+        }
+        auto pos = instance->second.entries.find(name);
+        if (pos->second.width != width) {
+            throw std::invalid_argument("Spilled relation " + name + " has a different arity");
+        }
+        Entry entry = std::move(pos->second);
+        instance->second.entries.erase(pos);
+        instance->second.resident -= entry.rows.size() * sizeof(RamDomain);
+        return {std::move(entry.rows), std::move(entry.file)};
+    }
+
+    /**
+     * Visit the relations stored by a program instance, reading the rows of
+     * spill files, without removing them from the store.
+     *
+     * @param owner - the program instance
+     * @param visitor - called with the name, the width, the rows and the
+     * directory of the spill file of each relation, or an empty directory for
+     * rows held in memory
+     */
+    void enumerate(Owner owner, const std::function<void(const std::string&, std::size_t,
+                                        const std::vector<RamDomain>&, const std::string&)>& visitor) const {
+        std::lock_guard<std::mutex> guard(lock);
+        auto instance = instances.find(owner);
+        if (instance == instances.end()) {
+            return;
+        }
+        for (const auto& [name, entry] : instance->second.entries) {
+            if (entry.file.empty()) {
+                visitor(name, entry.width, entry.rows, entry.dir);
+                continue;
+            }
+            std::ifstream in(entry.file, std::ios::binary);
+            FileHeader header{};
+            in.read(reinterpret_cast<char*>(&header), sizeof(header));
+            std::vector<RamDomain> rows(static_cast<std::size_t>(header.rows * header.width));
+            in.read(reinterpret_cast<char*>(rows.data()),
+                    static_cast<std::streamsize>(rows.size() * sizeof(RamDomain)));
+            if (!in || std::strncmp(header.magic, fileMagic, sizeof(header.magic)) != 0) {
+                throw std::runtime_error("Cannot read spill file " + entry.file);
+            }
+            visitor(name, entry.width, rows, entry.dir);
+        }
+    }
+
+    /** Drop the relations of a program instance that were never restored, removing their spill files */
+    void release(Owner owner) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto instance = instances.find(owner);
+        if (instance == instances.end()) {
+            return;
+        }
+        for (auto& [name, entry] : instance->second.entries) {
+            discard(instance->second, entry);
+        }
+        instances.erase(instance);
+    }
+
+    /** Number of bytes held in memory for a program instance */
+    std::size_t getResidentBytes(Owner owner) const {
+        std::lock_guard<std::mutex> guard(lock);
+        auto instance = instances.find(owner);
+        return instance == instances.end() ? 0 : instance->second.resident;
+    }
+
+    /** Header of a spill file */
+    struct FileHeader {
+        char magic[8];
+        uint64_t width;
+        uint64_t rows;
+    };
+
+    static constexpr const char* fileMagic = "SOUFSPL";
+
+private:
+    struct Entry {
+        std::size_t width = 0;
+        std::vector<RamDomain> rows;
+        std::string dir;
+        std::string file;
+    };
+
+    /** The spilled relations of a program instance */
+    struct Instance {
+        std::size_t id = 0;
+        std::map<std::string, Entry> entries;
+        std::size_t resident = 0;
+    };
+
+    Instance& getOwner(Owner owner) {
+        auto pos = instances.find(owner);
+        if (pos == instances.end()) {
+            pos = instances.emplace(owner, Instance{}).first;
+            pos->second.id = nextInstance++;
+        }
+        return pos->second;
+    }
+
+    /** Free the rows of an entry, or remove its spill file */
+    static void discard(Instance& instance, Entry& entry) {
+        instance.resident -= entry.rows.size() * sizeof(RamDomain);
+        entry.rows.clear();
+        if (!entry.file.empty()) {
+            std::remove(entry.file.c_str());
+            entry.file.clear();
+        }
+    }
+
+    static void writeFile(const std::string& file, std::size_t width, const std::vector<RamDomain>& rows) {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        FileHeader header{};
+        std::strncpy(header.magic, fileMagic, sizeof(header.magic));
+        header.width = width;
+        header.rows = width == 0 ? 0 : rows.size() / width;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(rows.data()),
+                static_cast<std::streamsize>(rows.size() * sizeof(RamDomain)));
+        if (!out) {
+            throw std::runtime_error("Cannot write spill file " + file);
+        }
+    }
+
+    static long processId() {
+#ifndef _MSC_VER
+        return static_cast<long>(getpid());
+#else
+        return 0;
+#endif
+    }
+
+    std::map<Owner, Instance> instances;
+    std::size_t nextInstance = 0;
+    mutable std::mutex lock;
+};
+
+/**
+ * Moves the tuples of a relation into the spill store, sorted lexicographically.
+ */
+class WriteStreamSpill : public WriteStream {
+public:
+    WriteStreamSpill(const std::map<std::string, std::string>& rwOperation, const SymbolTable& symbolTable,
+            const RecordTable& recordTable)
+            : WriteStream(rwOperation, symbolTable, recordTable), name(rwOperation.at("name")),
+              dir(getOr(rwOperation, "spill-dir", ".")),
+              budget(std::stoull(getOr(rwOperation, "budget", "0"))), width(typeAttributes.size()) {}
+
+    /**
+     * Move the tuples written so far into the spill store, sorted; errors
+     * are thrown to the caller. The relation is stored once.
+     */
+    void close() override {
+        if (closed) {
+            return;
+        }
+        closed = true;
+        // sort the rows, restoring them in order keeps the insertion hints of the indexes hot
+        std::size_t numRows = width == 0 ? 0 : rows.size() / width;
+        std::vector<std::size_t> order(numRows);
+        for (std::size_t i = 0; i < numRows; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return std::lexicographical_compare(&rows[a * width], &rows[(a + 1) * width], &rows[b * width],
+                    &rows[(b + 1) * width]);
+        });
+        std::vector<RamDomain> sorted;
+        sorted.reserve(rows.size());
+        for (std::size_t i : order) {
+            sorted.insert(sorted.end(), &rows[i * width], &rows[(i + 1) * width]);
+        }
+        rows.clear();
+        rows.shrink_to_fit();
+        SpillStore::getInstance().store(&symbolTable, name, width, std::move(sorted), dir, budget);
+    }
+
+protected:
+    void writeNullary() override {}
+
+    void writeNextTuple(const RamDomain* tuple) override {
+        rows.insert(rows.end(), tuple, tuple + width);
+    }
+
+    const std::string name;
+    const std::string dir;
+    const std::size_t budget;
+    const std::size_t width;
+    std::vector<RamDomain> rows;
+    bool closed = false;
+};
+
+/**
+ * Restores the tuples of a relation from the spill store. Spill files are
+ * mapped into memory read-only and removed once they have been read.
+ */
+class ReadStreamSpill : public ReadStream {
+public:
+    ReadStreamSpill(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable)
+            : ReadStream(rwOperation, symbolTable, recordTable), width(typeAttributes.size()) {
+        std::tie(rows, file) = SpillStore::getInstance().take(&symbolTable, rwOperation.at("name"), width);
+        if (file.empty()) {
+            data = rows.data();
+            numRows = width == 0 ? 0 : rows.size() / width;
+        } else {
+            openFile();
+        }
+    }
+
+    ~ReadStreamSpill() override {
+#ifndef _MSC_VER
+        if (mapping != nullptr) {
+            munmap(mapping, mappingSize);
+        }
+#endif
+        if (!file.empty()) {
+            std::remove(file.c_str());
+        }
+    }
+
+protected:
+    Own<RamDomain[]> readNextTuple() override {
+        if (next == numRows) {
+            return nullptr;
+        }
+        Own<RamDomain[]> tuple = mk<RamDomain[]>(width);
+        std::copy_n(data + next * width, width, tuple.get());
+        ++next;
+        return tuple;
+    }
+
+    void openFile() {
+        SpillStore::FileHeader header{};
+#ifndef _MSC_VER
+        int fd = ::open(file.c_str(), O_RDONLY);
+        struct stat info {};
+        if (fd < 0 || fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(header)) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::runtime_error("Cannot read spill file " + file);
+        }
+        mappingSize = static_cast<std::size_t>(info.st_size);
+        void* map = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            throw std::runtime_error("Cannot map spill file " + file);
+        }
+        mapping = map;
+#ifdef MADV_SEQUENTIAL
+        madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+#endif
+        std::memcpy(&header, mapping, sizeof(header));
+        data = reinterpret_cast<const RamDomain*>(static_cast<const char*>(mapping) + sizeof(header));
+#else
+        std::ifstream in(file, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        rows.resize(static_cast<std::size_t>(header.rows * header.width));
+        in.read(reinterpret_cast<char*>(rows.data()),
+                static_cast<std::streamsize>(rows.size() * sizeof(RamDomain)));
+        if (!in) {
+            throw std::runtime_error("Cannot read spill file " + file);
+        }
+        data = rows.data();
+#endif
+        if (std::strncmp(header.magic, SpillStore::fileMagic, sizeof(header.magic)) != 0 ||
+                header.width != width) {
+            throw std::runtime_error("Malformed spill file " + file);
+        }
+        numRows = static_cast<std::size_t>(header.rows);
+    }
+
+    const std::size_t width;
+    std::vector<RamDomain> rows;
+    std::string file;
+    const RamDomain* data = nullptr;
+    std::size_t numRows = 0;
+    std::size_t next = 0;
+#ifndef _MSC_VER
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+#endif
+};
+
+class WriteSpillFactory : public WriteStreamFactory {
+public:
+    Own<WriteStream> getWriter(const std::map<std::string, std::string>& rwOperation,
+            const SymbolTable& symbolTable, const RecordTable& recordTable) override {
+        return mk<WriteStreamSpill>(rwOperation, symbolTable, recordTable);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "spill";
+        return name;
+    }
+    ~WriteSpillFactory() override = default;
+};
+
+class ReadSpillFactory : public ReadStreamFactory {
+public:
+    Own<ReadStream> getReader(const std::map<std::string, std::string>& rwOperation, SymbolTable& symbolTable,
+            RecordTable& recordTable) override {
+        return mk<ReadStreamSpill>(rwOperation, symbolTable, recordTable);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "spill";
+        return name;
+    }
+    ~ReadSpillFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -42,19 +42,22 @@ public:
     template <typename T>
     void writeAll(const T& relation) {
         if (summary) {
-            return writeSize(relation.size());
-        }
-        if (arity == 0) {
+            writeSize(relation.size());
+        } else if (arity == 0) {
             if (relation.begin() != relation.end()) {
                 writeNullary();
             }
-            return;
-        }
-        for (const auto& current : relation) {
-            writeNext(current);
+        } else {
+            for (const auto& current : relation) {
+                writeNext(current);
+            }
         }
+        close();
     }
 
+    /** Complete the output of a relation; errors are thrown to the caller */
+    virtual void close() {}
+
     template <typename T>
     void writeSize(const T& relation) {
         writeSize(relation.size());
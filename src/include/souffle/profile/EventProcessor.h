@@ -576,6 +576,30 @@ public:
 
 } relationReadsProcessor;
 
+/**
+ * Memoisation Processor
+ */
+const class MemoProcessor : public EventProcessor {
+public:
+    MemoProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@memo", this);
+    }
+    /** process event input, adding up call sites of the same text */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& site = signature[1];
+        std::size_t hits = va_arg(args, std::size_t);
+        std::size_t calls = va_arg(args, std::size_t);
+        if (const auto* previous = as<SizeEntry>(db.lookupEntry({"program", "memo", site, "hits"}))) {
+            hits += previous->getSize();
+        }
+        if (const auto* previous = as<SizeEntry>(db.lookupEntry({"program", "memo", site, "calls"}))) {
+            calls += previous->getSize();
+        }
+        db.addSizeEntry({"program", "memo", site, "hits"}, hits);
+        db.addSizeEntry({"program", "memo", site, "calls"}, calls);
+    }
+} memoProcessor;
+
 /**
  * Config entry processor
  */
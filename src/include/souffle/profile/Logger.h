@@ -77,4 +77,24 @@ private:
     std::function<std::size_t()> size;
     std::size_t preSize;
 };
+
+/**
+ * Records a span of the profile timeline for its lifetime, without
+ * creating a profile event. Used for phases that have no timing event
+ * of their own, e.g. strata.
+ */
+class SpanLogger {
+public:
+    SpanLogger(std::string label, std::size_t iteration)
+            : label(std::move(label)), start(now()), iteration(iteration) {}
+
+    ~SpanLogger() {
+        ProfileEventSingleton::instance().makeSpan(label, start, now(), iteration);
+    }
+
+private:
+    std::string label;
+    time_point start;
+    std::size_t iteration;
+};
 }  // end of namespace souffle
@@ -18,7 +18,9 @@
 
 #include "souffle/profile/EventProcessor.h"
 #include "souffle/profile/ProfileDatabase.h"
+#include "souffle/profile/ProfileTrace.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/StringUtil.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -45,6 +47,9 @@ class ProfileEventSingleton {
     /** profile database */
     profile::ProfileDatabase database{};
     std::string filename{""};
+    /** timeline of spans, only recorded if a trace file is set */
+    Own<profile::ProfileTrace> trace;
+    std::string traceFilename{""};
 
     ProfileEventSingleton() {}
 
@@ -78,6 +83,14 @@ public:
         microseconds end_ms = std::chrono::duration_cast<microseconds>(end.time_since_epoch());
         profile::EventProcessorSingleton::instance().process(
                 database, txt.c_str(), start_ms, end_ms, startMaxRSS, endMaxRSS, size, iteration);
+        makeSpan(txt, start, end, iteration);
+    }
+
+    /** record a span of the timeline on the calling thread, if tracing is enabled */
+    void makeSpan(const std::string& txt, time_point start, time_point end, std::size_t iteration) {
+        if (trace) {
+            trace->record(txt, start, end, iteration);
+        }
     }
 
     /** create quantity event */
@@ -85,6 +98,11 @@ public:
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), number, iteration);
     }
 
+    /** create memoisation event with the hits and lookups of a call site */
+    void makeMemoEvent(const std::string& txt, std::size_t hits, std::size_t calls) {
+        profile::EventProcessorSingleton::instance().process(database, txt.c_str(), hits, calls);
+    }
+
     void makeNonRecursiveCountEvent(const std::string& txt, double joinSize) {
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), joinSize);
     }
@@ -136,6 +154,23 @@ public:
     void setOutputFile(std::string outputFilename) {
         filename = outputFilename;
     }
+
+    /**
+     * Enable the timeline and set the file it is written to. A file ending in
+     * .json receives a Chrome trace, any other file folded stacks for flame graphs.
+     */
+    void setTraceFile(std::string traceOutputFilename) {
+        traceFilename = traceOutputFilename;
+        if (!trace) {
+            trace = mk<profile::ProfileTrace>();
+        }
+    }
+
+    /** whether spans are recorded */
+    bool isTracing() const {
+        return trace != nullptr;
+    }
+
     /** Dump all events */
     void dump() {
         if (!filename.empty()) {
@@ -146,6 +181,16 @@ public:
                 database.print(os);
             }
         }
+        if (trace && !traceFilename.empty()) {
+            std::ofstream os(traceFilename);
+            if (!os.is_open()) {
+                std::cerr << "Cannot open profile trace file <" + traceFilename + ">";
+            } else if (endsWith(traceFilename, ".json")) {
+                trace->printChromeTrace(os);
+            } else {
+                trace->printFoldedStacks(os);
+            }
+        }
     }
 
     /** Start timer */
@@ -165,6 +210,10 @@ public:
         return database;
     }
 
+    const profile::ProfileTrace* getTrace() const {
+        return trace.get();
+    }
+
     void setDBFromFile(const std::string& databaseFilename) {
         database = profile::ProfileDatabase(databaseFilename);
     }
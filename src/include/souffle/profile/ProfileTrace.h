@@ -0,0 +1,261 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileTrace.h
+ *
+ * Per-thread timeline of profile spans and its exporters
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/json11.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace souffle::profile {
+
+/**
+ * A timed interval of the evaluation, e.g. a stratum, a rule, a fixpoint iteration or an IO operation.
+ */
+struct TraceSpan {
+    /** Category of the span: stratum, relation, rule, iteration, io or runtime */
+    std::string category;
+    /** Human readable name */
+    std::string name;
+    /** Source location, if any */
+    std::string location;
+    /** Start and end, relative to the start of the trace */
+    microseconds start;
+    microseconds end;
+    /** Loop iteration the span belongs to */
+    std::size_t iteration;
+    /** Dense id of the recording thread */
+    std::size_t thread;
+
+    /**
+     * Create a span from a profile label such as "@t-recursive-rule;rel;1;loc;text;".
+     */
+    static TraceSpan fromLabel(const std::string& label, microseconds start, microseconds end,
+            std::size_t iteration, std::size_t thread) {
+        std::vector<std::string> fields;
+        std::size_t begin = 0;
+        for (std::size_t pos = label.find(';'); pos != std::string::npos; pos = label.find(';', begin)) {
+            fields.push_back(label.substr(begin, pos - begin));
+            begin = pos + 1;
+        }
+        fields.push_back(label.substr(begin));
+        // drop the empty field produced by the trailing separator
+        if (fields.size() > 1 && fields.back().empty()) {
+            fields.pop_back();
+        }
+        // the datalog text of a rule may itself contain separators
+        auto rest = [&](std::size_t from) {
+            std::string text;
+            for (std::size_t i = from; i < fields.size(); ++i) {
+                text += (i == from ? "" : ";") + fields[i];
+            }
+            return text;
+        };
+        auto field = [&](std::size_t i) { return i < fields.size() ? fields[i] : std::string(); };
+
+        const std::string& type = fields[0];
+        TraceSpan span;
+        if (type == "@t-nonrecursive-relation") {
+            span = {"relation", field(1), field(2), start, end, iteration, thread};
+        } else if (type == "@t-recursive-relation") {
+            span = {"iteration", field(1) + " #" + std::to_string(iteration), field(2), start, end, iteration,
+                    thread};
+        } else if (type == "@t-nonrecursive-rule") {
+            span = {"rule", rest(3), field(2), start, end, iteration, thread};
+        } else if (type == "@t-recursive-rule") {
+            span = {"rule", rest(4), field(3), start, end, iteration, thread};
+        } else if (type == "@t-relation-loadtime") {
+            span = {"io", "load " + field(1), field(2), start, end, iteration, thread};
+        } else if (type == "@t-relation-savetime") {
+            span = {"io", "save " + field(1), field(2), start, end, iteration, thread};
+        } else if (type == "@runtime") {
+            span = {"runtime", "runtime", "", start, end, iteration, thread};
+        } else if (type == "@stratum") {
+            span = {"stratum", field(1), "", start, end, iteration, thread};
+        } else {
+            span = {type.substr(type.empty() || type[0] != '@' ? 0 : 1), rest(1), "", start, end, iteration,
+                    thread};
+        }
+        return span;
+    }
+};
+
+/**
+ * Recorder of trace spans.
+ *
+ * Every thread appends to its own buffer, so recording only synchronises
+ * the first time a thread records a span. The exporters must only be called
+ * once no thread is recording any more.
+ */
+class ProfileTrace {
+public:
+    ProfileTrace() : id(nextId()), origin(now()) {}
+
+    /** Record a span for the calling thread */
+    void record(const std::string& label, time_point start, time_point end, std::size_t iteration) {
+        Buffer& buffer = threadBuffer();
+        buffer.spans.push_back(TraceSpan::fromLabel(label,
+                std::chrono::duration_cast<microseconds>(start - origin),
+                std::chrono::duration_cast<microseconds>(end - origin), iteration, buffer.thread));
+    }
+
+    /** All recorded spans, ordered by thread and start time; enclosing spans come first */
+    std::vector<TraceSpan> getSpans() const {
+        std::vector<TraceSpan> spans;
+        {
+            std::lock_guard<std::mutex> guard(buffersMutex);
+            for (const auto& buffer : buffers) {
+                spans.insert(spans.end(), buffer->spans.begin(), buffer->spans.end());
+            }
+        }
+        std::stable_sort(spans.begin(), spans.end(), [](const TraceSpan& a, const TraceSpan& b) {
+            return std::make_tuple(a.thread, a.start, b.end) < std::make_tuple(b.thread, b.start, a.end);
+        });
+        return spans;
+    }
+
+    /** Number of threads that recorded spans */
+    std::size_t getNumThreads() const {
+        std::lock_guard<std::mutex> guard(buffersMutex);
+        return buffers.size();
+    }
+
+    /** Write all spans in the Chrome Trace Event format (chrome://tracing, Perfetto) */
+    void printChromeTrace(std::ostream& os) const {
+        os << "{\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() {
+            os << (first ? "" : ",\n");
+            first = false;
+        };
+        for (std::size_t thread = 0; thread < getNumThreads(); ++thread) {
+            separator();
+            std::string threadName = thread == 0 ? "main" : "worker " + std::to_string(thread);
+            os << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << thread << R"(,"args":{"name":)"
+               << json11::Json(threadName).dump() << "}}";
+        }
+        for (const auto& span : getSpans()) {
+            separator();
+            os << "{\"name\":" << json11::Json(span.name).dump()
+               << ",\"cat\":" << json11::Json(span.category).dump() << R"(,"ph":"X","ts":)"
+               << span.start.count() << ",\"dur\":" << (span.end - span.start).count()
+               << ",\"pid\":0,\"tid\":" << span.thread << ",\"args\":{\"iteration\":" << span.iteration;
+            if (!span.location.empty()) {
+                os << ",\"location\":" << json11::Json(span.location).dump();
+            }
+            os << "}}";
+        }
+        os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    /**
+     * Write all spans as folded stacks (one "frame;frame;frame weight" line per distinct
+     * stack) that can be rendered as a flame graph. Nesting is derived from the time
+     * intervals of the spans of each thread; the weight is the self time in microseconds.
+     */
+    void printFoldedStacks(std::ostream& os) const {
+        std::map<std::string, int64_t> selfTime;
+        std::vector<std::pair<TraceSpan, std::string>> stack;
+        auto pop = [&]() {
+            int64_t duration = (stack.back().first.end - stack.back().first.start).count();
+            selfTime[stack.back().second] += duration;
+            stack.pop_back();
+            if (!stack.empty()) {
+                selfTime[stack.back().second] -= duration;
+            }
+        };
+        std::size_t thread = 0;
+        for (const auto& span : getSpans()) {
+            if (span.thread != thread) {
+                while (!stack.empty()) {
+                    pop();
+                }
+                thread = span.thread;
+            }
+            while (!stack.empty() && stack.back().first.end <= span.start) {
+                pop();
+            }
+            std::string path = stack.empty() ? "thread " + std::to_string(span.thread) : stack.back().second;
+            path += ";" + frameName(span);
+            stack.emplace_back(span, std::move(path));
+        }
+        while (!stack.empty()) {
+            pop();
+        }
+        for (const auto& [path, weight] : selfTime) {
+            if (weight > 0) {
+                os << path << " " << weight << "\n";
+            }
+        }
+    }
+
+private:
+    /** Spans recorded by one thread */
+    struct Buffer {
+        explicit Buffer(std::size_t thread) : thread(thread) {}
+        const std::size_t thread;
+        std::vector<TraceSpan> spans;
+    };
+
+    Buffer& threadBuffer() {
+        // cache the buffer of this thread for the trace that recorded last
+        thread_local std::size_t owner = 0;
+        thread_local Buffer* buffer = nullptr;
+        if (owner != id) {
+            std::lock_guard<std::mutex> guard(buffersMutex);
+            buffers.push_back(mk<Buffer>(buffers.size()));
+            buffer = buffers.back().get();
+            owner = id;
+        }
+        return *buffer;
+    }
+
+    static std::size_t nextId() {
+        static std::atomic<std::size_t> counter{0};
+        return ++counter;
+    }
+
+    /** Frame name of a span; separators of the folded format are replaced */
+    static std::string frameName(const TraceSpan& span) {
+        std::string name = span.category + " " + span.name;
+        std::replace(name.begin(), name.end(), ';', ',');
+        std::replace(name.begin(), name.end(), '\n', ' ');
+        return name;
+    }
+
+    /** Unique id of this trace */
+    const std::size_t id;
+
+    /** Time the trace was started */
+    const time_point origin;
+
+    /** Per-thread span buffers, indexed by thread id */
+    std::vector<Own<Buffer>> buffers;
+    mutable std::mutex buffersMutex;
+};
+
+}  // namespace souffle::profile
@@ -211,6 +211,8 @@ public:
             }
         } else if (c[0] == "configuration") {
             configuration();
+        } else if (c[0] == "memo") {
+            memo();
         } else {
             std::cout << "Unknown command. Use \"help\" for a list of commands.\n";
         }
@@ -711,6 +713,7 @@ public:
         std::printf("  %-30s%-5s %s\n", "usage [relation id|rule id]", "-",
                 "display CPU usage graphs for a relation or rule.");
         std::printf("  %-30s%-5s %s\n", "memory", "-", "display memory usage.");
+        std::printf("  %-30s%-5s %s\n", "memo", "-", "display hit rates of memoised call sites.");
         std::printf("  %-30s%-5s %s\n", "help", "-", "print this.");
 
         std::cout << "\nInteractive mode only commands:" << std::endl;
@@ -1005,6 +1008,7 @@ public:
         linereader.appendTabCompletion("limit ");
         linereader.appendTabCompletion("memory");
         linereader.appendTabCompletion("configuration");
+        linereader.appendTabCompletion("memo");
 
         // add rel tab completes after the rest so users can see all commands first
         for (auto& row : Tools::formatTable(relationTable, precision)) {
@@ -1030,6 +1034,33 @@ public:
         std::cout << std::endl;
     }
 
+    void memo() {
+        auto* sites = as<DirectoryEntry>(
+                ProfileEventSingleton::instance().getDB().lookupEntry({"program", "memo"}));
+        if (sites == nullptr) {
+            std::cout << "No memoised call sites. Run the program with --memoise.\n";
+            return;
+        }
+        std::cout << "Memoisation" << '\n';
+        std::printf("%12s%12s%10s  %s\n\n", "CALLS", "HITS", "HIT RATE", "CALL SITE");
+        for (const auto& site : sites->getKeys()) {
+            auto* entry = sites->readDirectoryEntry(site);
+            if (entry == nullptr) {
+                continue;
+            }
+            auto* calls = as<SizeEntry>(entry->readEntry("calls"));
+            auto* hits = as<SizeEntry>(entry->readEntry("hits"));
+            if (calls == nullptr || hits == nullptr) {
+                continue;
+            }
+            const std::size_t callCount = calls->getSize();
+            const std::size_t hitCount = hits->getSize();
+            const double rate = callCount == 0 ? 0.0 : 100.0 * static_cast<double>(hitCount) / callCount;
+            std::printf("%12zu%12zu%9.1f%%  %s\n", callCount, hitCount, rate, site.c_str());
+        }
+        std::cout << std::endl;
+    }
+
     void top() {
         const std::shared_ptr<ProgramRun>& run = out.getProgramRun();
         auto* totalRelationsEntry = as<TextEntry>(ProfileEventSingleton::instance().getDB().lookupEntry(
@@ -0,0 +1,53 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompactAnnotation.h
+ *
+ * Packing of the rule and level numbers of provenance into one value
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/RamTypes.h"
+#include <limits>
+
+namespace souffle::provenance {
+
+/**
+ * With compact provenance, the rule number of a tuple is stored in the low
+ * bits of a single annotation and its level number above them. Annotations
+ * then compare by level first and by rule second, as the two separate
+ * numbers do.
+ */
+constexpr int compactRuleBits = 12;
+
+/** The mask of the rule number, which is also the greatest rule number */
+constexpr RamDomain compactRuleMask = (RamDomain(1) << compactRuleBits) - 1;
+
+/** The greatest level number; greater levels are kept at this one */
+constexpr RamDomain compactMaxLevel = std::numeric_limits<RamDomain>::max() >> compactRuleBits;
+
+/** Name of the annotation attribute of relations with compact provenance */
+constexpr const char* compactAnnotationName = "@provenance";
+
+inline RamDomain packAnnotation(RamDomain ruleNum, RamDomain levelNum) {
+    return static_cast<RamDomain>(static_cast<RamUnsigned>(levelNum) << compactRuleBits) | ruleNum;
+}
+
+inline RamDomain getCompactRuleNum(RamDomain annotation) {
+    return annotation & compactRuleMask;
+}
+
+inline RamDomain getCompactLevelNum(RamDomain annotation) {
+    return annotation >> compactRuleBits;
+}
+
+}  // namespace souffle::provenance
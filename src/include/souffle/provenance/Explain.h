@@ -101,6 +101,18 @@ public:
             }
             query = parseTuple(command[1]);
             printTree(prov.explain(query.first, query.second, ExplainConfig::getExplainConfig().depthLimit));
+        } else if (command[0] == "explainbatch") {
+            std::vector<std::pair<std::string, std::vector<std::string>>> queries;
+            if (command.size() == 2) {
+                queries = parseTuples(command[1]);
+            }
+            if (queries.empty()) {
+                printError(
+                        "Usage: explainbatch relation_name(\"<string element1>\", <number element2>, ...), "
+                        "...\n");
+                return true;
+            }
+            printDag(*prov.explainBatch(queries));
         } else if (command[0] == "subproof") {
             std::pair<std::string, std::vector<std::string>> query;
             int label = -1;
@@ -257,6 +269,8 @@ public:
                     "----------\n"
                     "setdepth <depth>: Set a limit for printed derivation tree height\n"
                     "explain <relation>(<element1>, <element2>, ...): Prints derivation tree\n"
+                    "explainbatch <relation1>(<element1>, ...), <relation2>(<element1>, ...), ...:\n"
+                    "    Prints the complete derivations of many tuples, sharing common subproofs\n"
                     "explainnegation <relation>(<element1>, <element2>, ...): Enters an interactive\n"
                     "    interface where the non-existence of a tuple can be explained\n"
                     "subproof <relation>(<label>): Prints derivation tree for a subproof, label is\n"
@@ -289,12 +303,42 @@ private:
     /* Print a tree */
     virtual void printTree(Own<TreeNode> tree) = 0;
 
+    /* Print a proof DAG */
+    virtual void printDag(const ProofDag& dag) = 0;
+
     /* Print any other information, disabled for non-terminal outputs */
     virtual void printInfo(const std::string& info) = 0;
 
     /* Print an error, such as a wrong command */
     virtual void printError(const std::string& error) = 0;
 
+    /* Regex for matching tuples, whose values are numbers or strings enclosed in quotation marks */
+    static const std::regex& getTupleRegex() {
+        static const std::regex relationRegex(
+                "([a-zA-Z0-9_.-]*)[[:blank:]]*\\(([[:blank:]]*([0-9]+|\"[^\"]*\")([[:blank:]]*,[[:blank:]]*(["
+                "0-"
+                "9]+|\"[^\"]*\"))*)?\\)",
+                std::regex_constants::extended);
+        return relationRegex;
+    }
+
+    /**
+     * Parse a list of tuples, returning nothing if one of them is malformed
+     * @param str The string to parse, should be something like "R(x1, x2, ...), S(y1, ...), ..."
+     */
+    std::vector<std::pair<std::string, std::vector<std::string>>> parseTuples(std::string str) {
+        std::vector<std::pair<std::string, std::vector<std::string>>> tuples;
+        std::smatch tupleMatcher;
+        while (std::regex_search(str, tupleMatcher, getTupleRegex())) {
+            tuples.push_back(parseTuple(tupleMatcher[0]));
+            if (tuples.back().first.empty()) {
+                return {};
+            }
+            str = tupleMatcher.suffix().str();
+        }
+        return tuples;
+    }
+
     /**
      * Parse tuple, split into relation name and values
      * @param str The string to parse, should be something like "R(x1, x2, x3, ...)"
@@ -303,13 +347,7 @@ private:
         std::string relName;
         std::vector<std::string> args;
 
-        // regex for matching tuples
-        // values matches numbers or strings enclosed in quotation marks
-        std::regex relationRegex(
-                "([a-zA-Z0-9_.-]*)[[:blank:]]*\\(([[:blank:]]*([0-9]+|\"[^\"]*\")([[:blank:]]*,[[:blank:]]*(["
-                "0-"
-                "9]+|\"[^\"]*\"))*)?\\)",
-                std::regex_constants::extended);
+        const std::regex& relationRegex = getTupleRegex();
         std::smatch relMatch;
 
         // first check that format matches correctly
@@ -448,6 +486,26 @@ private:
         }
     }
 
+    /* Print a proof DAG */
+    void printDag(const ProofDag& dag) override {
+        std::ostream* output;
+        if (ExplainConfig::getExplainConfig().outputStream == nullptr) {
+            output = &std::cout;
+        } else {
+            output = ExplainConfig::getExplainConfig().outputStream.get();
+        }
+
+        if (!ExplainConfig::getExplainConfig().json) {
+            dag.print(*output);
+        } else {
+            *output << "{ \"proofs\":\n";
+            dag.printJSON(*output);
+            *output << ",";
+            prov.printRulesJSON(*output);
+            *output << "}\n";
+        }
+    }
+
     /* Print any other information, disabled for non-terminal outputs */
     void printInfo(const std::string& info) override {
         if (isatty(fileno(stdin)) == 0) {
@@ -558,6 +616,26 @@ private:
         }
     }
 
+    /* Print a proof DAG */
+    void printDag(const ProofDag& dag) override {
+        std::stringstream ss;
+        if (!ExplainConfig::getExplainConfig().json) {
+            dag.print(ss);
+        } else {
+            ss << "{ \"proofs\":\n";
+            dag.printJSON(ss);
+            ss << ",";
+            prov.printRulesJSON(ss);
+            ss << "}\n";
+        }
+
+        if (ExplainConfig::getExplainConfig().outputStream == nullptr) {
+            wprintw(treePad, "%s", ss.str().c_str());
+        } else {
+            *ExplainConfig::getExplainConfig().outputStream << ss.str();
+        }
+    }
+
     /* Print any other information, disabled for non-terminal outputs */
     void printInfo(const std::string& info) override {
         if (!isatty(fileno(stdin))) {
@@ -33,6 +33,7 @@
 #include <vector>
 
 namespace souffle {
+class ProofDag;
 class TreeNode;
 
 /** Equivalence class for variables in query command */
@@ -169,6 +170,14 @@ public:
 
     virtual Own<TreeNode> explainSubproof(std::string relName, RamDomain label, std::size_t depthLimit) = 0;
 
+    /**
+     * Explain many tuples at once
+     * @param queries, vector of relation, argument pairs
+     * @return the complete proofs of the tuples, sharing common subproofs
+     */
+    virtual Own<ProofDag> explainBatch(
+            const std::vector<std::pair<std::string, std::vector<std::string>>>& queries) = 0;
+
     virtual std::vector<std::string> explainNegationGetVariables(
             std::string relName, std::vector<std::string> args, std::size_t ruleNum) = 0;
 
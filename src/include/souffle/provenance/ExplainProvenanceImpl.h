@@ -20,6 +20,7 @@
 #include "souffle/RamTypes.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/provenance/ExplainProvenance.h"
 #include "souffle/provenance/ExplainTree.h"
 #include "souffle/utility/ContainerUtil.h"
@@ -30,6 +31,7 @@
 #include <cassert>
 #include <chrono>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -38,6 +40,7 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -108,14 +111,12 @@ public:
             tuple.push_back(levelNum);
 
             // find if subproof exists already
-            std::size_t idx = 0;
-            auto it = std::find(subproofs.begin(), subproofs.end(), tuple);
-            if (it != subproofs.end()) {
-                idx = it - subproofs.begin();
-            } else {
+            auto pos = subproofIndex.find(tuple);
+            if (pos == subproofIndex.end()) {
+                pos = subproofIndex.emplace(tuple, subproofs.size()).first;
                 subproofs.push_back(tuple);
-                idx = subproofs.size() - 1;
             }
+            std::size_t idx = pos->second;
 
             return mk<LeafNode>("subproof " + relName + "(" + std::to_string(idx) + ")");
         }
@@ -125,89 +126,17 @@ public:
         auto internalNode =
                 mk<InnerNode>(relName + "(" + joinedArgsStr + ")", "(R" + std::to_string(ruleNum) + ")");
 
-        // make return vector pointer
-        std::vector<RamDomain> ret;
-
-        // execute subroutine to get subproofs
-        prog.executeSubroutine(relName + "_" + std::to_string(ruleNum) + "_subproof", tuple, ret);
-
         // recursively get nodes for subproofs
-        std::size_t tupleCurInd = 0;
-        auto bodyRelations = info.at(std::make_pair(relName, ruleNum));
-
-        // start from begin + 1 because the first element represents the head atom
-        for (auto it = bodyRelations.begin() + 1; it < bodyRelations.end(); it++) {
-            std::string bodyLiteral = *it;
-            // split bodyLiteral since it contains relation name plus arguments
-            std::string bodyRel = splitString(bodyLiteral, ',')[0];
-
-            // check whether the current atom is a constraint
-            assert(bodyRel.size() > 0 && "body of a relation should have positive length");
-            bool isConstraint = contains(constraintList, bodyRel);
-
-            // handle negated atom names
-            auto bodyRelAtomName = bodyRel;
-            if (bodyRel[0] == '!' && bodyRel != "!=") {
-                bodyRelAtomName = bodyRel.substr(1);
-            }
-
-            // traverse subroutine return
-            std::size_t arity;
-            std::size_t auxiliaryArity;
-            if (isConstraint) {
-                // we only handle binary constraints, and assume arity is 4 to account for hidden provenance
-                // annotations
-                arity = 4;
-                auxiliaryArity = 2;
-            } else {
-                arity = prog.getRelation(bodyRelAtomName)->getArity();
-                auxiliaryArity = prog.getRelation(bodyRelAtomName)->getAuxiliaryArity();
-            }
-            auto tupleEnd = tupleCurInd + arity;
-
-            // store current tuple
-            std::vector<RamDomain> subproofTuple;
-
-            for (; tupleCurInd < tupleEnd - auxiliaryArity; tupleCurInd++) {
-                subproofTuple.push_back(ret[tupleCurInd]);
-            }
-
-            int subproofRuleNum = ret[tupleCurInd];
-            int subproofLevelNum = ret[tupleCurInd + 1];
-
-            tupleCurInd += 2;
-
-            // for a negation, display the corresponding tuple and do not recurse
-            if (bodyRel[0] == '!' && bodyRel != "!=") {
-                std::stringstream joinedTuple;
-                joinedTuple << join(decodeArguments(bodyRelAtomName, subproofTuple), ", ");
-                auto joinedTupleStr = joinedTuple.str();
-                internalNode->add_child(mk<LeafNode>(bodyRel + "(" + joinedTupleStr + ")"));
-                internalNode->setSize(internalNode->getSize() + 1);
-                // for a binary constraint, display the corresponding values and do not recurse
-            } else if (isConstraint) {
-                std::stringstream joinedConstraint;
-
-                // FIXME: We need type info in order to figure out how to print arguments.
-                BinaryConstraintOp rawBinOp = toBinaryConstraintOp(bodyRel);
-                if (isOrderedBinaryConstraintOp(rawBinOp)) {
-                    joinedConstraint << subproofTuple[0] << " " << bodyRel << " " << subproofTuple[1];
-                } else {
-                    joinedConstraint << bodyRel << "(\"" << symTable.decode(subproofTuple[0]) << "\", \""
-                                     << symTable.decode(subproofTuple[1]) << "\")";
-                }
-
-                internalNode->add_child(mk<LeafNode>(joinedConstraint.str()));
+        for (const Premise& premise : getPremises(relName, ruleNum, tuple)) {
+            if (!premise.isTuple) {
+                internalNode->add_child(mk<LeafNode>(premise.txt));
                 internalNode->setSize(internalNode->getSize() + 1);
-                // otherwise, for a normal tuple, recurse
             } else {
-                auto child =
-                        explain(bodyRel, subproofTuple, subproofRuleNum, subproofLevelNum, depthLimit - 1);
+                auto child = explain(premise.relName, premise.tuple, premise.ruleNum, premise.levelNum,
+                        depthLimit - 1);
                 internalNode->setSize(internalNode->getSize() + child->getSize());
                 internalNode->add_child(std::move(child));
             }
-
-            tupleCurInd = tupleEnd;
         }
 
         return internalNode;
@@ -240,21 +169,110 @@ public:
 
         auto tup = subproofs[subproofNum];
 
-        auto rel = prog.getRelation(relName);
-
-        assert(rel->getAuxiliaryArity() == 2 && "unexpected auxiliary arity in provenance context");
-
+        // subproofs are recorded with separate rule and level numbers, also for compact annotations
         RamDomain ruleNum;
-        ruleNum = tup[rel->getArity() - 2];
+        ruleNum = tup[tup.size() - 2];
 
         RamDomain levelNum;
-        levelNum = tup[rel->getArity() - 1];
+        levelNum = tup[tup.size() - 1];
 
-        tup.erase(tup.begin() + rel->getArity() - 2, tup.end());
+        tup.erase(tup.end() - 2, tup.end());
 
         return explain(relName, tup, ruleNum, levelNum, depthLimit);
     }
 
+    Own<ProofDag> explainBatch(
+            const std::vector<std::pair<std::string, std::vector<std::string>>>& queries) override {
+        auto dag = mk<ProofDag>();
+
+        // the node of each tuple, keyed by the tuple followed by its rule and level numbers
+        std::map<std::string, std::unordered_map<std::vector<RamDomain>, std::size_t, TupleHash>> nodes;
+
+        // the derived tuples whose premises are still to be added
+        struct Pending {
+            std::size_t node;
+            std::string relName;
+            std::vector<RamDomain> tuple;
+            int ruleNum;
+        };
+        std::vector<Pending> frontier;
+
+        auto addTuple = [&](const std::string& relName, std::vector<RamDomain> tuple, int ruleNum,
+                                int levelNum) {
+            std::vector<RamDomain> key = tuple;
+            key.push_back(ruleNum);
+            key.push_back(levelNum);
+            auto pos = nodes[relName].find(key);
+            if (pos != nodes[relName].end()) {
+                return pos->second;
+            }
+
+            std::stringstream txt;
+            txt << relName << "(" << join(decodeArguments(relName, tuple), ", ") << ")";
+            std::size_t node;
+            if (levelNum == 0) {
+                node = dag->addNode(txt.str());
+            } else {
+                node = dag->addNode(txt.str(), "(R" + std::to_string(ruleNum) + ")");
+                tuple.push_back(levelNum);
+                frontier.push_back({node, relName, std::move(tuple), ruleNum});
+            }
+            nodes[relName].emplace(std::move(key), node);
+            return node;
+        };
+
+        // look up the rule and level numbers of the tuples, scanning each relation once
+        std::map<std::string, std::vector<std::vector<RamDomain>>> targets;
+        std::vector<std::vector<RamDomain>> tuples;
+        for (const auto& [relName, args] : queries) {
+            tuples.push_back(argsToNums(relName, args));
+            targets[relName].push_back(tuples.back());
+        }
+        std::map<std::string, std::map<std::vector<RamDomain>, std::tuple<int, int>>> found;
+        for (const auto& [relName, relTuples] : targets) {
+            auto infos = findTuples(relName, relTuples);
+            for (std::size_t i = 0; i < relTuples.size(); ++i) {
+                found[relName].emplace(relTuples[i], infos[i]);
+            }
+        }
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const std::string& relName = queries[i].first;
+            std::string txt = relName + "(" + toString(join(queries[i].second, ", ")) + ")";
+            if (tuples[i].empty()) {
+                dag->addRoot(dag->addNode(txt + ": Relation not found"));
+                continue;
+            }
+            auto [ruleNum, levelNum] = found[relName].at(tuples[i]);
+            if (ruleNum < 0 || levelNum == -1) {
+                dag->addRoot(dag->addNode(txt + ": Tuple not found"));
+                continue;
+            }
+            dag->addRoot(addTuple(relName, tuples[i], ruleNum, levelNum));
+        }
+
+        // expand the proofs a level at a time, running the subproofs of each level in parallel
+        while (!frontier.empty()) {
+            std::vector<std::pair<std::string, std::vector<RamDomain>>> calls;
+            for (const auto& pending : frontier) {
+                calls.emplace_back(getSubproofName(pending.relName, pending.ruleNum), pending.tuple);
+            }
+            runSubproofs(calls);
+
+            std::vector<Pending> current;
+            std::swap(current, frontier);
+            for (const auto& pending : current) {
+                for (const Premise& premise : getPremises(pending.relName, pending.ruleNum, pending.tuple)) {
+                    std::size_t node = premise.isTuple ? addTuple(premise.relName, premise.tuple,
+                                                                 premise.ruleNum, premise.levelNum)
+                                                       : dag->addNode(premise.txt);
+                    dag->addPremise(pending.node, node);
+                }
+            }
+        }
+
+        return dag;
+    }
+
     std::vector<std::string> explainNegationGetVariables(
             std::string relName, std::vector<std::string> args, std::size_t ruleNum) override {
         std::vector<std::string> variables;
@@ -556,11 +574,7 @@ public:
                 currentTuple.push_back(n);
             }
 
-            RamDomain ruleNum;
-            tuple >> ruleNum;
-
-            RamDomain levelNum;
-            tuple >> levelNum;
+            auto [ruleNum, levelNum] = readAnnotation(rel, tuple);
 
             std::cout << "Tuples expanded: "
                       << explain(relName, currentTuple, ruleNum, levelNum, 10000)->getSize();
@@ -737,6 +751,153 @@ private:
     std::map<std::pair<std::string, std::size_t>, std::vector<std::string>> info;
     std::map<std::pair<std::string, std::size_t>, std::string> rules;
     std::vector<std::vector<RamDomain>> subproofs;
+
+    /** Hashes tuples */
+    struct TupleHash {
+        std::size_t operator()(const std::vector<RamDomain>& tuple) const {
+            std::size_t seed = tuple.size();
+            for (RamDomain value : tuple) {
+                seed ^= std::hash<RamDomain>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
+    };
+
+    /** Hashes subroutine calls */
+    struct CallHash {
+        std::size_t operator()(const std::pair<std::string, std::vector<RamDomain>>& call) const {
+            return std::hash<std::string>()(call.first) ^ (TupleHash()(call.second) << 1);
+        }
+    };
+
+    /** The numbers of the subproofs, which are given out when the depth limit is exceeded */
+    std::unordered_map<std::vector<RamDomain>, std::size_t, TupleHash> subproofIndex;
+
+    /** The results of the subproof subroutines, shared by all explanations */
+    std::unordered_map<std::pair<std::string, std::vector<RamDomain>>, std::vector<RamDomain>, CallHash>
+            subproofCache;
+
+    /** A body literal of a rule instance deriving a tuple */
+    struct Premise {
+        // whether the literal is a tuple to be proven, instead of a negation or constraint
+        bool isTuple;
+        std::string relName;
+        std::vector<RamDomain> tuple;
+        int ruleNum;
+        int levelNum;
+        // the text of a negation or constraint
+        std::string txt;
+    };
+
+    static std::string getSubproofName(const std::string& relName, int ruleNum) {
+        return relName + "_" + std::to_string(ruleNum) + "_subproof";
+    }
+
+    /** Run the given subproof subroutines, concurrently, and cache their results */
+    void runSubproofs(const std::vector<std::pair<std::string, std::vector<RamDomain>>>& calls) {
+        std::vector<const std::pair<std::string, std::vector<RamDomain>>*> missing;
+        for (const auto& call : calls) {
+            if (!contains(subproofCache, call)) {
+                missing.push_back(&call);
+            }
+        }
+        std::vector<std::vector<RamDomain>> results(missing.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (std::size_t i = 0; i < missing.size(); i++) {
+            prog.executeSubroutine(missing[i]->first, missing[i]->second, results[i]);
+        }
+        for (std::size_t i = 0; i < missing.size(); i++) {
+            subproofCache.emplace(*missing[i], std::move(results[i]));
+        }
+    }
+
+    /**
+     * Get the body literals of the rule instance deriving a tuple
+     * @param relName, relation of the tuple
+     * @param ruleNum, rule deriving the tuple
+     * @param tuple, the tuple followed by its level number
+     */
+    std::vector<Premise> getPremises(
+            const std::string& relName, int ruleNum, const std::vector<RamDomain>& tuple) {
+        std::pair<std::string, std::vector<RamDomain>> call(getSubproofName(relName, ruleNum), tuple);
+        runSubproofs({call});
+        const std::vector<RamDomain>& ret = subproofCache.at(call);
+
+        std::vector<Premise> premises;
+        std::size_t tupleCurInd = 0;
+        auto bodyRelations = info.at(std::make_pair(relName, ruleNum));
+
+        // start from begin + 1 because the first element represents the head atom
+        for (auto it = bodyRelations.begin() + 1; it < bodyRelations.end(); it++) {
+            std::string bodyLiteral = *it;
+            // split bodyLiteral since it contains relation name plus arguments
+            std::string bodyRel = splitString(bodyLiteral, ',')[0];
+
+            // check whether the current atom is a constraint
+            assert(bodyRel.size() > 0 && "body of a relation should have positive length");
+            bool isConstraint = contains(constraintList, bodyRel);
+
+            // handle negated atom names
+            auto bodyRelAtomName = bodyRel;
+            if (bodyRel[0] == '!' && bodyRel != "!=") {
+                bodyRelAtomName = bodyRel.substr(1);
+            }
+
+            // traverse subroutine return
+            std::size_t arity;
+            std::size_t auxiliaryArity;
+            if (isConstraint) {
+                // we only handle binary constraints, and assume arity is 4 to account for hidden provenance
+                // annotations
+                arity = 4;
+                auxiliaryArity = 2;
+            } else {
+                // subroutines return a rule and a level number for each atom, also for compact annotations
+                arity = prog.getRelation(bodyRelAtomName)->getPrimaryArity() + 2;
+                auxiliaryArity = 2;
+            }
+            auto tupleEnd = tupleCurInd + arity;
+
+            // store current tuple
+            std::vector<RamDomain> subproofTuple;
+
+            for (; tupleCurInd < tupleEnd - auxiliaryArity; tupleCurInd++) {
+                subproofTuple.push_back(ret[tupleCurInd]);
+            }
+
+            int subproofRuleNum = ret[tupleCurInd];
+            int subproofLevelNum = ret[tupleCurInd + 1];
+
+            // for a negation, display the corresponding tuple
+            if (bodyRel[0] == '!' && bodyRel != "!=") {
+                std::stringstream joinedTuple;
+                joinedTuple << join(decodeArguments(bodyRelAtomName, subproofTuple), ", ");
+                premises.push_back({false, bodyRel, {}, 0, 0, bodyRel + "(" + joinedTuple.str() + ")"});
+                // for a binary constraint, display the corresponding values
+            } else if (isConstraint) {
+                std::stringstream joinedConstraint;
+
+                // FIXME: We need type info in order to figure out how to print arguments.
+                BinaryConstraintOp rawBinOp = toBinaryConstraintOp(bodyRel);
+                if (isOrderedBinaryConstraintOp(rawBinOp)) {
+                    joinedConstraint << subproofTuple[0] << " " << bodyRel << " " << subproofTuple[1];
+                } else {
+                    joinedConstraint << bodyRel << "(\"" << symTable.decode(subproofTuple[0]) << "\", \""
+                                     << symTable.decode(subproofTuple[1]) << "\")";
+                }
+                premises.push_back({false, bodyRel, {}, 0, 0, joinedConstraint.str()});
+                // otherwise, a tuple to be proven
+            } else {
+                premises.push_back(
+                        {true, bodyRel, std::move(subproofTuple), subproofRuleNum, subproofLevelNum, ""});
+            }
+
+            tupleCurInd = tupleEnd;
+        }
+        return premises;
+    }
     std::vector<std::string> constraintList = {
             "=", "!=", "<", "<=", ">=", ">", "match", "contains", "not_match", "not_contains"};
 
@@ -748,16 +909,41 @@ private:
         return Res.first;
     }
 
+    /** Read the rule and level numbers following the primary attributes of a tuple */
+    static std::pair<RamDomain, RamDomain> readAnnotation(const Relation* rel, tuple& tup) {
+        RamDomain ruleNum;
+        tup >> ruleNum;
+        if (rel->getAuxiliaryArity() == 1) {
+            // compact provenance packs both numbers into one annotation
+            return {provenance::getCompactRuleNum(ruleNum), provenance::getCompactLevelNum(ruleNum)};
+        }
+
+        RamDomain levelNum;
+        tup >> levelNum;
+        return {ruleNum, levelNum};
+    }
+
     std::tuple<int, int> findTuple(const std::string& relName, std::vector<RamDomain> tup) {
+        return findTuples(relName, {tup})[0];
+    }
+
+    /** Find the rule and level numbers of tuples of a relation, or -1 for missing tuples */
+    std::vector<std::tuple<int, int>> findTuples(
+            const std::string& relName, const std::vector<std::vector<RamDomain>>& tuples) {
+        std::vector<std::tuple<int, int>> res(tuples.size(), std::make_tuple(-1, -1));
         auto rel = prog.getRelation(relName);
 
         if (rel == nullptr) {
-            return std::make_tuple(-1, -1);
+            return res;
         }
 
-        // find correct tuple
+        std::unordered_map<std::vector<RamDomain>, std::vector<std::size_t>, TupleHash> wanted;
+        for (std::size_t i = 0; i < tuples.size(); i++) {
+            wanted[tuples[i]].push_back(i);
+        }
+
+        // find correct tuples
         for (auto& tuple : *rel) {
-            bool match = true;
             std::vector<RamDomain> currentTuple;
 
             for (arity_type i = 0; i < rel->getPrimaryArity(); i++) {
@@ -779,26 +965,23 @@ private:
                 }
 
                 currentTuple.push_back(n);
-
-                if (n != tup[i]) {
-                    match = false;
-                    break;
-                }
             }
 
-            if (match) {
-                RamDomain ruleNum;
-                tuple >> ruleNum;
-
-                RamDomain levelNum;
-                tuple >> levelNum;
+            auto pos = wanted.find(currentTuple);
+            if (pos != wanted.end()) {
+                auto [ruleNum, levelNum] = readAnnotation(rel, tuple);
 
-                return std::make_tuple(ruleNum, levelNum);
+                for (std::size_t i : pos->second) {
+                    res[i] = std::make_tuple(ruleNum, levelNum);
+                }
+                wanted.erase(pos);
+                if (wanted.empty()) {
+                    break;
+                }
             }
         }
 
-        // if no tuple exists
-        return std::make_tuple(-1, -1);
+        return res;
     }
 
     /*
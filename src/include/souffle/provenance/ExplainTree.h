@@ -17,12 +17,14 @@
 #pragma once
 
 #include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -224,4 +226,80 @@ public:
     }
 };
 
+/***
+ * The proofs of several tuples, sharing the proofs of the tuples they
+ * have in common
+ */
+class ProofDag {
+public:
+    struct Node {
+        // the tuple, or the constraint or negation of a body literal
+        std::string txt;
+        // the rule deriving the tuple, empty for axioms
+        std::string label;
+        // the nodes of the body literals
+        std::vector<std::size_t> premises;
+    };
+
+    /** Add a node, returning its number */
+    std::size_t addNode(std::string txt, std::string label = "") {
+        nodes.push_back({std::move(txt), std::move(label), {}});
+        return nodes.size() - 1;
+    }
+
+    void addPremise(std::size_t node, std::size_t premise) {
+        nodes[node].premises.push_back(premise);
+    }
+
+    /** Add the node of a tuple to explain */
+    void addRoot(std::size_t node) {
+        roots.push_back(node);
+    }
+
+    const std::vector<Node>& getNodes() const {
+        return nodes;
+    }
+
+    const std::vector<std::size_t>& getRoots() const {
+        return roots;
+    }
+
+    // print one line per node, roots first
+    void print(std::ostream& os) const {
+        for (std::size_t root : roots) {
+            os << "explain n" << root << "\n";
+        }
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            os << "n" << i << ": " << nodes[i].txt;
+            if (!nodes[i].label.empty()) {
+                os << " " << nodes[i].label << " <-";
+                for (std::size_t premise : nodes[i].premises) {
+                    os << " n" << premise;
+                }
+            }
+            os << "\n";
+        }
+    }
+
+    // print JSON
+    void printJSON(std::ostream& os) const {
+        os << "{ \"roots\": [" << join(roots, ", ") << "],\n";
+        os << "  \"nodes\": [\n";
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            os << "\t" << R"({ "premises": ")" << stringify(nodes[i].txt) << "\"";
+            if (!nodes[i].label.empty()) {
+                os << R"(, "rule-number": ")" << nodes[i].label << "\"";
+                os << R"(, "children": [)" << join(nodes[i].premises, ", ") << "]";
+            }
+            os << (i + 1 < nodes.size() ? "},\n" : "}\n");
+        }
+        os << "  ]\n";
+        os << "}";
+    }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<std::size_t> roots;
+};
+
 }  // end of namespace souffle
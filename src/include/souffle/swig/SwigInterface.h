@@ -17,8 +17,79 @@
 #pragma once
 
 #include "souffle/SouffleInterface.h"
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Column-oriented, in-memory representation of the tuples of a relation
+ *
+ * Every attribute is stored contiguously in the buffer of its primitive type: signed numbers,
+ * records and ADTs in signedColumns, unsigned numbers in unsignedColumns, floats in floatColumns
+ * and symbols in symbolColumns. A buffer holds the columns of its type one after another, each
+ * of length numRows. Symbols are dictionary-encoded, i.e. a symbol column stores indices into
+ * dictionary.
+ */
+struct SWIGRelationColumns {
+    /** Number of tuples */
+    std::size_t numRows = 0;
+
+    /** Primitive type of each attribute, one character per attribute (see Relation::getAttrType) */
+    std::string columnTypes;
+
+    std::vector<int64_t> signedColumns;
+    std::vector<uint64_t> unsignedColumns;
+    std::vector<double> floatColumns;
+    std::vector<int64_t> symbolColumns;
+
+    /** Symbols referenced by symbolColumns */
+    std::vector<std::string> dictionary;
+
+    /**
+     * Return the offset of the given attribute's column in the buffer of its type
+     */
+    std::size_t getColumnOffset(std::size_t attribute) const {
+        if (attribute >= columnTypes.size()) {
+            throw std::out_of_range("attribute out of range");
+        }
+        const char kind = bufferKind(columnTypes[attribute]);
+        std::size_t slot = 0;
+        for (std::size_t i = 0; i < attribute; ++i) {
+            if (bufferKind(columnTypes[i]) == kind) {
+                ++slot;
+            }
+        }
+        return slot * numRows;
+    }
+
+    /**
+     * Return the number of attributes stored in the buffer of the given kind ('i', 'u', 'f' or 's')
+     */
+    std::size_t countColumns(char kind) const {
+        std::size_t count = 0;
+        for (char type : columnTypes) {
+            if (bufferKind(type) == kind) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Map a primitive type to the buffer it is stored in
+     */
+    static char bufferKind(char type) {
+        switch (type) {
+            case 'u':
+            case 'f':
+            case 's': return type;
+            default: return 'i';
+        }
+    }
+};
 
 /**
  * Abstract base class for generated Datalog programs
@@ -77,6 +148,148 @@ public:
     void dumpOutputs() {
         program->dumpOutputs();
     }
+
+    /**
+     * Return the primitive types of the attributes of a relation, one character per attribute
+     */
+    std::string getColumnTypes(const std::string& relationName) const {
+        const souffle::Relation& rel = getRelation(relationName);
+        std::string types;
+        for (std::size_t i = 0; i < rel.getArity(); ++i) {
+            types += *rel.getAttrType(i);
+        }
+        return types;
+    }
+
+    /**
+     * Copy all tuples of a relation into typed column buffers
+     */
+    SWIGRelationColumns getColumns(const std::string& relationName) const {
+        const souffle::Relation& rel = getRelation(relationName);
+        const std::size_t arity = rel.getArity();
+
+        SWIGRelationColumns columns;
+        columns.numRows = rel.size();
+        columns.columnTypes = getColumnTypes(relationName);
+        columns.signedColumns.resize(columns.countColumns('i') * columns.numRows);
+        columns.unsignedColumns.resize(columns.countColumns('u') * columns.numRows);
+        columns.floatColumns.resize(columns.countColumns('f') * columns.numRows);
+        columns.symbolColumns.resize(columns.countColumns('s') * columns.numRows);
+        std::vector<std::size_t> offsets(arity);
+        for (std::size_t i = 0; i < arity; ++i) {
+            offsets[i] = columns.getColumnOffset(i);
+        }
+
+        // symbols are numbered densely in order of first occurrence
+        std::unordered_map<souffle::RamDomain, int64_t> symbolIndex;
+        souffle::SymbolTable& symbolTable = rel.getSymbolTable();
+
+        std::size_t row = 0;
+        rel.forEachRowBlock(blockSize, [&](souffle::span<const souffle::RamDomain> block) {
+            for (std::size_t pos = 0; pos < block.size(); pos += arity, ++row) {
+                for (std::size_t i = 0; i < arity; ++i) {
+                    const souffle::RamDomain value = block[pos + i];
+                    const std::size_t idx = offsets[i] + row;
+                    switch (SWIGRelationColumns::bufferKind(columns.columnTypes[i])) {
+                        case 'u':
+                            columns.unsignedColumns[idx] = souffle::ramBitCast<souffle::RamUnsigned>(value);
+                            break;
+                        case 'f':
+                            columns.floatColumns[idx] = souffle::ramBitCast<souffle::RamFloat>(value);
+                            break;
+                        case 's': {
+                            auto res = symbolIndex.emplace(value, int64_t(columns.dictionary.size()));
+                            if (res.second) {
+                                columns.dictionary.push_back(symbolTable.decode(value));
+                            }
+                            columns.symbolColumns[idx] = res.first->second;
+                            break;
+                        }
+                        default: columns.signedColumns[idx] = value; break;
+                    }
+                }
+            }
+        });
+        return columns;
+    }
+
+    /**
+     * Insert tuples given as typed column buffers into a relation
+     *
+     * The column types must match the types of the relation, see getColumnTypes().
+     */
+    void insertColumns(const std::string& relationName, const SWIGRelationColumns& columns) {
+        souffle::Relation& rel = getRelation(relationName);
+        const std::size_t arity = rel.getArity();
+        const std::size_t numRows = columns.numRows;
+        if (columns.columnTypes != getColumnTypes(relationName)) {
+            throw std::invalid_argument("column types do not match relation " + relationName);
+        }
+
+        if (columns.signedColumns.size() != columns.countColumns('i') * numRows ||
+                columns.unsignedColumns.size() != columns.countColumns('u') * numRows ||
+                columns.floatColumns.size() != columns.countColumns('f') * numRows ||
+                columns.symbolColumns.size() != columns.countColumns('s') * numRows) {
+            throw std::invalid_argument("column buffers do not match the number of rows");
+        }
+
+        if (arity == 0) {
+            if (numRows > 0) {
+                rel.insert(souffle::tuple(&rel));
+            }
+            return;
+        }
+
+        // encode the dictionary once rather than every symbol occurrence
+        std::vector<souffle::RamDomain> symbols(columns.dictionary.size());
+        rel.getSymbolTable().encodeMany(columns.dictionary, symbols);
+
+        std::vector<std::size_t> offsets(arity);
+        for (std::size_t i = 0; i < arity; ++i) {
+            offsets[i] = columns.getColumnOffset(i);
+        }
+
+        std::vector<souffle::RamDomain> rows(numRows * arity);
+        for (std::size_t row = 0; row < numRows; ++row) {
+            for (std::size_t i = 0; i < arity; ++i) {
+                const std::size_t idx = offsets[i] + row;
+                souffle::RamDomain& value = rows[row * arity + i];
+                switch (SWIGRelationColumns::bufferKind(columns.columnTypes[i])) {
+                    case 'u':
+                        value = souffle::ramBitCast(souffle::RamUnsigned(columns.unsignedColumns[idx]));
+                        break;
+                    case 'f':
+                        value = souffle::ramBitCast(souffle::RamFloat(columns.floatColumns[idx]));
+                        break;
+                    case 's': {
+                        const int64_t symbol = columns.symbolColumns[idx];
+                        if (symbol < 0 || std::size_t(symbol) >= symbols.size()) {
+                            throw std::out_of_range("symbol index out of dictionary range");
+                        }
+                        value = symbols[symbol];
+                        break;
+                    }
+                    default: value = souffle::RamSigned(columns.signedColumns[idx]); break;
+                }
+            }
+        }
+        rel.insertRows(rows, program->getNumThreads() > 1);
+    }
+
+private:
+    /** Number of rows fetched per block when reading a relation */
+    static constexpr std::size_t blockSize = 4096;
+
+    /**
+     * Look up a relation by name, throwing if it does not exist
+     */
+    souffle::Relation& getRelation(const std::string& relationName) const {
+        souffle::Relation* rel = program->getRelation(relationName);
+        if (rel == nullptr) {
+            throw std::invalid_argument("unknown relation " + relationName);
+        }
+        return *rel;
+    }
 };
 
 /**
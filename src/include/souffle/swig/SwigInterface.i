@@ -18,11 +18,28 @@
 %module SwigInterface 
 %include "std_string.i" 
 %include "std_map.i" 
+%include "stdint.i"
+%include "exception.i"
 %include<std_vector.i>
 namespace std {
     %template(map_string_string) map<string, string>;
+    %template(vector_int64) vector<int64_t>;
+    %template(vector_uint64) vector<uint64_t>;
+    %template(vector_double) vector<double>;
+    %template(vector_string) vector<string>;
 }
 
+%exception {
+    try {
+        $action
+    } catch (const std::exception& e) {
+        SWIG_exception(SWIG_RuntimeError, e.what());
+    }
+}
+
+// expose the column buffers by value so that they can be assigned from native lists
+%naturalvar SWIGRelationColumns;
+
 %{
 #include "SwigInterface.h"
 #include <iostream>
@@ -17,9 +17,14 @@
 #pragma once
 
 #include "souffle/RamTypes.h"
+#include "souffle/utility/Iteration.h"
 #include "souffle/utility/StringUtil.h"
 #include "souffle/utility/tinyformat.h"
+#include <algorithm>
 #include <csignal>
+#include <cstddef>
+#include <random>
+#include <vector>
 
 namespace souffle::evaluator {
 
@@ -109,4 +114,127 @@ lxor_infix::curry<A> operator+(A x, lxor_infix) {
     return lxor_infix::curry<A>{x};
 }
 
+/** Number of consecutive tuples visited per chunk when sampling join size statistics */
+constexpr std::size_t joinSizeSampleBlock = 64;
+
+/** Seed of the block offsets, fixed so that repeated runs report the same statistics */
+constexpr std::uint_fast32_t joinSizeSampleSeed = 5489u;
+
+/**
+ * Statistics gathered for an EstimateJoinSize statement
+ */
+struct JoinSizeSample {
+    /** Whether all tuples have been visited */
+    bool exact = true;
+    /** Number of tuples visited */
+    double visited = 0;
+    /** Number of visited tuples matching the constants */
+    double matched = 0;
+    /** Number of matching tuples compared with a matching predecessor */
+    double pairs = 0;
+    /** Number of matching tuples with the same key as their predecessor */
+    double duplicates = 0;
+};
+
+/**
+ * Gather the statistics of an EstimateJoinSize statement from chunks of an index sorted by the key columns.
+ *
+ * A tuple is considered if it satisfies matchesConstants, and it is a duplicate if sameKey holds for it
+ * and the previously considered tuple. With a non-zero blockSize only blockSize consecutive tuples of each
+ * chunk are visited, giving a block sample of the index; otherwise the chunks are visited completely and
+ * are assumed to be consecutive.
+ *
+ * The chunks of an index start at the boundaries of its nodes, which follow the key groups, so a block
+ * starts at a random offset below stride, the mean length of the chunks. Skipped tuples are not evaluated.
+ */
+template <typename Chunks, typename Match, typename SameKey>
+JoinSizeSample sampleJoinSizeChunks(const Chunks& chunks, std::size_t blockSize, std::size_t stride,
+        Match&& matchesConstants, SameKey&& sameKey) {
+    JoinSizeSample sample;
+    sample.exact = (blockSize == 0);
+    std::minstd_rand random(joinSizeSampleSeed);
+    bool first = true;
+    for (const auto& chunk : chunks) {
+        auto it = chunk.begin();
+        const auto end = chunk.end();
+        if (blockSize > 0) {
+            first = true;
+            if (stride > blockSize) {
+                auto offset = std::uniform_int_distribution<std::size_t>(0, stride - blockSize)(random);
+                for (; offset > 0 && it != end; --offset) {
+                    ++it;
+                }
+            }
+        }
+        if (it == end) {
+            continue;
+        }
+        auto prev = *it;
+        std::size_t count = 0;
+        for (; it != end; ++it) {
+            const auto& tuple = *it;
+            if (blockSize > 0 && count++ == blockSize) {
+                break;
+            }
+            ++sample.visited;
+            if (!matchesConstants(tuple)) {
+                continue;
+            }
+            if (first) {
+                first = false;
+            } else {
+                ++sample.pairs;
+                if (sameKey(prev, tuple)) {
+                    ++sample.duplicates;
+                }
+            }
+            prev = tuple;
+            ++sample.matched;
+        }
+    }
+    return sample;
+}
+
+/**
+ * Gather the statistics of an EstimateJoinSize statement from an index sorted by the key columns.
+ *
+ * If sampleSize is zero or the index is not larger than sampleSize, the whole index is visited.
+ * Otherwise, the index is partitioned into sampleSize / joinSizeSampleBlock chunks of which only
+ * a block of joinSizeSampleBlock tuples at a random offset is visited.
+ */
+template <typename Index, typename Match, typename SameKey>
+JoinSizeSample sampleJoinSize(
+        const Index& index, std::size_t sampleSize, Match&& matchesConstants, SameKey&& sameKey) {
+    using Chunk = range<decltype(index.begin())>;
+    std::vector<Chunk> chunks;
+    if (sampleSize == 0 || index.size() <= sampleSize) {
+        chunks.push_back(Chunk(index.begin(), index.end()));
+        return sampleJoinSizeChunks(chunks, 0, 0, matchesConstants, sameKey);
+    }
+    for (const auto& cur : index.partition(std::max<std::size_t>(1, sampleSize / joinSizeSampleBlock))) {
+        chunks.push_back(Chunk(cur.begin(), cur.end()));
+    }
+    return sampleJoinSizeChunks(
+            chunks, joinSizeSampleBlock, index.size() / chunks.size(), matchesConstants, sameKey);
+}
+
+/**
+ * Compute the join size estimate from (sampled) statistics of a relation with the given size.
+ *
+ * For a sample, the number of distinct keys is extrapolated from the fraction of adjacent tuple pairs
+ * with differing keys, which is not biased by groups being cut at block boundaries.
+ */
+inline double estimateJoinSize(const JoinSizeSample& sample, std::size_t relationSize, bool onlyConstants) {
+    const double scale = sample.visited > 0 ? double(relationSize) / sample.visited : 0.0;
+    const double total = sample.matched * scale;
+    if (onlyConstants) {
+        return total;
+    }
+    double distinct = total - sample.duplicates;
+    if (!sample.exact) {
+        distinct = (sample.pairs > 0) ? total * (sample.pairs - sample.duplicates) / sample.pairs : total;
+    }
+    return total / std::max(1.0, distinct);
+}
+
 }  // namespace souffle::evaluator
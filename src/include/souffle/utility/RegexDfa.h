@@ -0,0 +1,678 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RegexDfa.h
+ *
+ * Matching of regular expressions with deterministic finite automata.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+namespace detail {
+
+/**
+ * A parsed regular expression.
+ *
+ * An empty concatenation matches the empty string.
+ */
+struct RegexTerm {
+    enum class Kind { Bytes, Concatenation, Alternation, Repetition };
+
+    Kind kind = Kind::Concatenation;
+
+    // the bytes matched by a Bytes term
+    std::bitset<256> bytes;
+
+    std::vector<RegexTerm> children;
+
+    // the bounds of a Repetition, where max is npos if unbounded
+    std::size_t min = 0;
+    std::size_t max = 0;
+};
+
+/**
+ * Parses the regular subset of the ECMAScript patterns of std::regex.
+ *
+ * Anything else fails the parse, including invalid patterns, so that the
+ * caller may leave all of them to std::regex.
+ */
+class RegexParser {
+public:
+    static constexpr std::size_t maxRepetition = 1000;
+
+    explicit RegexParser(const std::string& pattern) : pattern(pattern) {}
+
+    std::optional<RegexTerm> parse() {
+        std::size_t first = 0;
+        std::size_t last = pattern.size();
+        // anchors at the ends of the pattern always hold for a full match
+        if (last > 0 && pattern[0] == '^') {
+            first = 1;
+        }
+        if (last > first && pattern[last - 1] == '$') {
+            std::size_t escapes = 0;
+            while (last - 1 - escapes > first && pattern[last - 2 - escapes] == '\\') {
+                ++escapes;
+            }
+            if (escapes % 2 == 0) {
+                --last;
+            }
+        }
+        pos = first;
+        end = last;
+        RegexTerm term;
+        if (!parseAlternation(term) || pos != end) {
+            return std::nullopt;
+        }
+        return term;
+    }
+
+private:
+    bool atEnd() const {
+        return pos >= end;
+    }
+
+    char peek() const {
+        return pattern[pos];
+    }
+
+    bool parseAlternation(RegexTerm& term) {
+        RegexTerm alternative;
+        if (!parseConcatenation(alternative)) {
+            return false;
+        }
+        if (atEnd() || peek() != '|') {
+            term = std::move(alternative);
+            return true;
+        }
+        term.kind = RegexTerm::Kind::Alternation;
+        term.children.push_back(std::move(alternative));
+        while (!atEnd() && peek() == '|') {
+            ++pos;
+            RegexTerm next;
+            if (!parseConcatenation(next)) {
+                return false;
+            }
+            term.children.push_back(std::move(next));
+        }
+        return true;
+    }
+
+    bool parseConcatenation(RegexTerm& term) {
+        term.kind = RegexTerm::Kind::Concatenation;
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            RegexTerm atom;
+            if (!parseAtom(atom) || !parseQuantifier(atom)) {
+                return false;
+            }
+            term.children.push_back(std::move(atom));
+        }
+        return true;
+    }
+
+    bool parseQuantifier(RegexTerm& atom) {
+        if (atEnd()) {
+            return true;
+        }
+        std::size_t min = 0;
+        std::size_t max = std::string::npos;
+        switch (peek()) {
+            case '*': ++pos; break;
+            case '+':
+                ++pos;
+                min = 1;
+                break;
+            case '?':
+                ++pos;
+                max = 1;
+                break;
+            case '{': {
+                ++pos;
+                if (!parseNumber(min)) {
+                    return false;
+                }
+                max = min;
+                if (!atEnd() && peek() == ',') {
+                    ++pos;
+                    max = std::string::npos;
+                    if (!atEnd() && peek() != '}' && !parseNumber(max)) {
+                        return false;
+                    }
+                }
+                if (atEnd() || peek() != '}' || min > max || min > maxRepetition ||
+                        (max != std::string::npos && max > maxRepetition)) {
+                    return false;
+                }
+                ++pos;
+                break;
+            }
+            default: return true;
+        }
+        // laziness does not change whether the whole text matches
+        if (!atEnd() && peek() == '?') {
+            ++pos;
+        }
+        if (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) {
+            return false;
+        }
+        RegexTerm repetition;
+        repetition.kind = RegexTerm::Kind::Repetition;
+        repetition.min = min;
+        repetition.max = max;
+        repetition.children.push_back(std::move(atom));
+        atom = std::move(repetition);
+        return true;
+    }
+
+    bool parseNumber(std::size_t& number) {
+        const std::size_t first = pos;
+        number = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9' && pos - first < 6) {
+            number = number * 10 + static_cast<std::size_t>(peek() - '0');
+            ++pos;
+        }
+        return pos > first && (atEnd() || peek() < '0' || peek() > '9');
+    }
+
+    bool parseAtom(RegexTerm& atom) {
+        const char c = peek();
+        atom.kind = RegexTerm::Kind::Bytes;
+        switch (c) {
+            case '(': {
+                ++pos;
+                if (!atEnd() && peek() == '?') {
+                    // only non-capturing groups, no lookaheads
+                    if (pos + 1 >= end || pattern[pos + 1] != ':') {
+                        return false;
+                    }
+                    pos += 2;
+                }
+                if (!parseAlternation(atom) || atEnd() || peek() != ')') {
+                    return false;
+                }
+                ++pos;
+                return true;
+            }
+            case '[': ++pos; return parseClass(atom.bytes);
+            case '.':
+                ++pos;
+                atom.bytes.set();
+                atom.bytes.reset('\n');
+                atom.bytes.reset('\r');
+                return true;
+            case '\\': {
+                ++pos;
+                bool isClass = false;
+                return parseEscape(atom.bytes, isClass);
+            }
+            case '^':
+            case '$':
+            case '*':
+            case '+':
+            case '?':
+            case ')':
+            case ']':
+            case '{':
+            case '}':
+            case '|': return false;
+            default:
+                ++pos;
+                atom.bytes.set(static_cast<unsigned char>(c));
+                return true;
+        }
+    }
+
+    /** Parse an escape sequence after the backslash, noting whether it denotes a class */
+    bool parseEscape(std::bitset<256>& bytes, bool& isClass) {
+        if (atEnd()) {
+            return false;
+        }
+        const char c = peek();
+        ++pos;
+        isClass = false;
+        auto addIf = [&](auto predicate, bool negated) {
+            isClass = true;
+            for (std::size_t b = 0; b < 256; ++b) {
+                if (predicate(b) != negated) {
+                    bytes.set(b);
+                }
+            }
+            return true;
+        };
+        auto isDigit = [](std::size_t b) { return b >= '0' && b <= '9'; };
+        auto isWord = [&](std::size_t b) {
+            return isDigit(b) || (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || b == '_';
+        };
+        auto isSpace = [](std::size_t b) { return b == ' ' || (b >= '\t' && b <= '\r'); };
+        switch (c) {
+            case 'd': return addIf(isDigit, false);
+            case 'D': return addIf(isDigit, true);
+            case 'w': return addIf(isWord, false);
+            case 'W': return addIf(isWord, true);
+            case 's': return addIf(isSpace, false);
+            case 'S': return addIf(isSpace, true);
+            case 't': bytes.set('\t'); return true;
+            case 'n': bytes.set('\n'); return true;
+            case 'r': bytes.set('\r'); return true;
+            case 'f': bytes.set('\f'); return true;
+            case 'v': bytes.set('\v'); return true;
+            case '0':
+                if (!atEnd() && isDigit(static_cast<unsigned char>(peek()))) {
+                    return false;
+                }
+                bytes.set(0);
+                return true;
+            case 'x': {
+                unsigned value = 0;
+                for (int i = 0; i < 2; ++i) {
+                    if (atEnd()) {
+                        return false;
+                    }
+                    const char h = peek();
+                    ++pos;
+                    if (h >= '0' && h <= '9') {
+                        value = value * 16 + static_cast<unsigned>(h - '0');
+                    } else if (h >= 'a' && h <= 'f') {
+                        value = value * 16 + static_cast<unsigned>(h - 'a' + 10);
+                    } else if (h >= 'A' && h <= 'F') {
+                        value = value * 16 + static_cast<unsigned>(h - 'A' + 10);
+                    } else {
+                        return false;
+                    }
+                }
+                bytes.set(value);
+                return true;
+            }
+            default:
+                // word boundaries, back references and the like are not supported
+                if (isWord(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 128) {
+                    return false;
+                }
+                bytes.set(static_cast<unsigned char>(c));
+                return true;
+        }
+    }
+
+    /** Parse a bracket expression after the opening bracket */
+    bool parseClass(std::bitset<256>& bytes) {
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++pos;
+        }
+        if (!atEnd() && peek() == ']') {
+            return false;
+        }
+        while (!atEnd() && peek() != ']') {
+            std::bitset<256> item;
+            std::optional<unsigned char> low;
+            if (!parseClassAtom(item, low)) {
+                return false;
+            }
+            if (!atEnd() && peek() == '-' && pos + 1 < end && pattern[pos + 1] != ']') {
+                ++pos;
+                std::bitset<256> last;
+                std::optional<unsigned char> high;
+                if (!parseClassAtom(last, high) || !low || !high || *low >= 128 || *high >= 128 ||
+                        *low > *high) {
+                    return false;
+                }
+                for (unsigned b = *low; b <= *high; ++b) {
+                    item.set(b);
+                }
+            }
+            bytes |= item;
+        }
+        if (atEnd()) {
+            return false;
+        }
+        ++pos;
+        if (negated) {
+            bytes.flip();
+        }
+        return true;
+    }
+
+    /** Parse a member of a bracket expression, and the byte it denotes if it is a single one */
+    bool parseClassAtom(std::bitset<256>& bytes, std::optional<unsigned char>& single) {
+        const char c = peek();
+        ++pos;
+        if (c == '[') {
+            // character classes, equivalence classes and collating elements
+            return false;
+        }
+        if (c != '\\') {
+            bytes.set(static_cast<unsigned char>(c));
+            single = static_cast<unsigned char>(c);
+            return true;
+        }
+        if (!atEnd() && peek() == 'b') {
+            return false;
+        }
+        bool isClass = false;
+        if (!parseEscape(bytes, isClass)) {
+            return false;
+        }
+        if (!isClass) {
+            for (std::size_t b = 0; b < 256; ++b) {
+                if (bytes.test(b)) {
+                    single = static_cast<unsigned char>(b);
+                }
+            }
+        }
+        return true;
+    }
+
+    const std::string& pattern;
+    std::size_t pos = 0;
+    std::size_t end = 0;
+};
+
+}  // namespace detail
+
+/**
+ * A deterministic finite automaton deciding whether a whole string matches
+ * a regular expression.
+ *
+ * The automaton covers the ECMAScript patterns of std::regex that are
+ * regular, i.e. those without assertions other than anchors at the ends of
+ * the pattern and without back references, and matches in time linear in
+ * the length of the string.
+ *
+ * Bytes that no transition tells apart share a column of the transition
+ * table. State 0 rejects every string and state 1 is the initial state.
+ */
+class RegexDfa {
+public:
+    /** The maximal number of states of an automaton before giving up on a pattern */
+    static constexpr std::size_t maxStates = 4096;
+
+    /**
+     * @param classes the column of each byte
+     * @param transitions the row-major transition table, with one column per class
+     * @param accepting whether each state is accepting
+     */
+    RegexDfa(std::vector<uint8_t> classes, std::vector<uint32_t> transitions, std::vector<bool> accepting)
+            : classes(std::move(classes)), transitions(std::move(transitions)),
+              accepting(std::move(accepting)) {
+        width = this->transitions.size() / this->accepting.size();
+    }
+
+    /**
+     * Compile a pattern, unless it uses features the automaton cannot express
+     * or the automaton would be too large.
+     */
+    static std::optional<RegexDfa> compile(const std::string& pattern) {
+        auto term = detail::RegexParser(pattern).parse();
+        if (!term) {
+            return std::nullopt;
+        }
+        Nfa nfa;
+        auto fragment = nfa.build(*term);
+        if (!fragment) {
+            return std::nullopt;
+        }
+        return nfa.determinise(fragment->first, fragment->second);
+    }
+
+    /** Whether the whole text matches */
+    bool match(const std::string& text) const {
+        uint32_t state = 1;
+        for (char c : text) {
+            state = transitions[state * width + classes[static_cast<unsigned char>(c)]];
+            if (state == 0) {
+                return false;
+            }
+        }
+        return accepting[state];
+    }
+
+    const std::vector<uint8_t>& getClasses() const {
+        return classes;
+    }
+
+    const std::vector<uint32_t>& getTransitions() const {
+        return transitions;
+    }
+
+    const std::vector<bool>& getAccepting() const {
+        return accepting;
+    }
+
+private:
+    /** A Thompson automaton */
+    struct Nfa {
+        static constexpr std::size_t maxNfaStates = 10000;
+
+        struct State {
+            // the bytes leading to the next state
+            std::bitset<256> bytes;
+            std::size_t next = 0;
+            std::vector<std::size_t> epsilon;
+        };
+
+        std::vector<State> states;
+
+        std::size_t add() {
+            states.emplace_back();
+            return states.size() - 1;
+        }
+
+        /** Add the states of a term, returning its initial and final state */
+        std::optional<std::pair<std::size_t, std::size_t>> build(const detail::RegexTerm& term) {
+            using Kind = detail::RegexTerm::Kind;
+            if (states.size() > maxNfaStates) {
+                return std::nullopt;
+            }
+            const std::size_t first = add();
+            std::size_t last = first;
+            auto append = [&](const detail::RegexTerm& child) {
+                auto fragment = build(child);
+                if (fragment) {
+                    states[last].epsilon.push_back(fragment->first);
+                    last = fragment->second;
+                }
+                return fragment.has_value();
+            };
+            switch (term.kind) {
+                case Kind::Bytes:
+                    last = add();
+                    states[first].bytes = term.bytes;
+                    states[first].next = last;
+                    break;
+                case Kind::Concatenation:
+                    for (const auto& child : term.children) {
+                        if (!append(child)) {
+                            return std::nullopt;
+                        }
+                    }
+                    break;
+                case Kind::Alternation:
+                    last = add();
+                    for (const auto& child : term.children) {
+                        auto fragment = build(child);
+                        if (!fragment) {
+                            return std::nullopt;
+                        }
+                        states[first].epsilon.push_back(fragment->first);
+                        states[fragment->second].epsilon.push_back(last);
+                    }
+                    break;
+                case Kind::Repetition: {
+                    const auto& child = term.children.front();
+                    for (std::size_t i = 0; i < term.min; ++i) {
+                        if (!append(child)) {
+                            return std::nullopt;
+                        }
+                    }
+                    if (term.max == std::string::npos) {
+                        auto fragment = build(child);
+                        if (!fragment) {
+                            return std::nullopt;
+                        }
+                        const std::size_t loop = last;
+                        last = add();
+                        states[loop].epsilon.push_back(fragment->first);
+                        states[loop].epsilon.push_back(last);
+                        states[fragment->second].epsilon.push_back(loop);
+                        break;
+                    }
+                    // each optional occurrence may skip the remaining ones
+                    std::vector<std::size_t> skips;
+                    for (std::size_t i = term.min; i < term.max; ++i) {
+                        skips.push_back(last);
+                        if (!append(child)) {
+                            return std::nullopt;
+                        }
+                    }
+                    for (std::size_t skip : skips) {
+                        states[skip].epsilon.push_back(last);
+                    }
+                    break;
+                }
+            }
+            return std::make_pair(first, last);
+        }
+
+        /** Add the states reachable by epsilon transitions, keeping the set sorted */
+        void close(std::vector<std::size_t>& set, std::vector<bool>& member) const {
+            std::vector<std::size_t> pending = set;
+            set.clear();
+            while (!pending.empty()) {
+                const std::size_t s = pending.back();
+                pending.pop_back();
+                if (member[s]) {
+                    continue;
+                }
+                member[s] = true;
+                set.push_back(s);
+                pending.insert(pending.end(), states[s].epsilon.begin(), states[s].epsilon.end());
+            }
+            for (std::size_t s : set) {
+                member[s] = false;
+            }
+            std::sort(set.begin(), set.end());
+        }
+
+        /** The subset construction */
+        std::optional<RegexDfa> determinise(std::size_t initial, std::size_t final) const {
+            // split the bytes into the classes no transition tells apart
+            std::vector<std::size_t> byteClass(256, 0);
+            std::size_t classCount = 1;
+            for (const auto& state : states) {
+                if (state.bytes.none()) {
+                    continue;
+                }
+                std::map<std::pair<std::size_t, bool>, std::size_t> refined;
+                for (std::size_t b = 0; b < 256; ++b) {
+                    auto key = std::make_pair(byteClass[b], state.bytes.test(b));
+                    byteClass[b] = refined.emplace(key, refined.size()).first->second;
+                }
+                classCount = refined.size();
+            }
+            std::vector<std::size_t> representative(classCount);
+            for (std::size_t b = 256; b-- > 0;) {
+                representative[byteClass[b]] = b;
+            }
+
+            std::map<std::vector<std::size_t>, uint32_t> ids;
+            std::vector<std::vector<std::size_t>> sets;
+            ids[{}] = 0;
+            sets.emplace_back();
+            std::vector<bool> member(states.size(), false);
+            std::vector<std::size_t> start{initial};
+            close(start, member);
+            ids[start] = 1;
+            sets.push_back(start);
+
+            std::vector<uint32_t> transitions(2 * classCount, 0);
+            for (std::size_t id = 1; id < sets.size(); ++id) {
+                for (std::size_t c = 0; c < classCount; ++c) {
+                    std::vector<std::size_t> target;
+                    for (std::size_t s : sets[id]) {
+                        if (states[s].bytes.test(representative[c])) {
+                            target.push_back(states[s].next);
+                        }
+                    }
+                    close(target, member);
+                    auto [pos, added] = ids.emplace(target, static_cast<uint32_t>(sets.size()));
+                    if (added) {
+                        if (sets.size() >= maxStates) {
+                            return std::nullopt;
+                        }
+                        sets.push_back(std::move(target));
+                        transitions.resize(sets.size() * classCount, 0);
+                    }
+                    transitions[id * classCount + c] = pos->second;
+                }
+            }
+
+            std::vector<bool> accepting;
+            for (const auto& set : sets) {
+                accepting.push_back(std::binary_search(set.begin(), set.end(), final));
+            }
+            std::vector<uint8_t> classes;
+            for (std::size_t b = 0; b < 256; ++b) {
+                classes.push_back(static_cast<uint8_t>(byteClass[b]));
+            }
+            return RegexDfa(std::move(classes), std::move(transitions), std::move(accepting));
+        }
+    };
+
+    std::vector<uint8_t> classes;
+    std::vector<uint32_t> transitions;
+    std::vector<bool> accepting;
+    std::size_t width = 1;
+};
+
+/**
+ * Matches strings against a pattern, with an automaton where possible and
+ * with std::regex otherwise.
+ */
+class RegexMatcher {
+public:
+    /** @throws std::regex_error if the pattern is not valid */
+    explicit RegexMatcher(const std::string& pattern) : dfa(RegexDfa::compile(pattern)) {
+        if (!dfa) {
+            regex.emplace(pattern);
+        }
+    }
+
+    explicit RegexMatcher(RegexDfa dfa) : dfa(std::move(dfa)) {}
+
+    /** Whether the whole text matches */
+    bool match(const std::string& text) const {
+        return dfa ? dfa->match(text) : std::regex_match(text, *regex);
+    }
+
+    bool isAutomaton() const {
+        return dfa.has_value();
+    }
+
+private:
+    std::optional<RegexDfa> dfa;
+    std::optional<std::regex> regex;
+};
+
+}  // namespace souffle
@@ -21,11 +21,13 @@
 #include <cctype>
 #include <cstdlib>
 #include <fstream>
+#include <initializer_list>
 #include <limits>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <typeinfo>
 #include <vector>
@@ -333,6 +335,22 @@ inline bool endsWith(const std::string& value, const std::string& ending) {
     return std::equal(ending.rbegin(), ending.rend(), value.rbegin());
 }
 
+/**
+ * Concatenates strings, allocating the result once.
+ */
+inline std::string concatenate(std::initializer_list<std::string_view> parts) {
+    std::size_t size = 0;
+    for (const auto& part : parts) {
+        size += part.size();
+    }
+    std::string result;
+    result.reserve(size);
+    for (const auto& part : parts) {
+        result.append(part);
+    }
+    return result;
+}
+
 /**
  * Splits a string given a delimiter
  */
@@ -0,0 +1,305 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Cluster.cpp
+ *
+ * Socket transport and collective operations of a cluster of workers.
+ ***********************************************************************/
+
+#include "interpreter/Cluster.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifndef _MSC_VER
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace souffle::interpreter {
+
+namespace {
+
+#ifndef _MSC_VER
+
+[[noreturn]] void socketError(const std::string& what, const std::string& endpoint) {
+    throw std::runtime_error(what + " " + endpoint + ": " + std::strerror(errno));
+}
+
+/** A link over a connected stream socket; messages are prefixed by their length */
+class SocketTransport : public Transport {
+public:
+    explicit SocketTransport(int fd) : fd(fd) {}
+
+    ~SocketTransport() override {
+        ::close(fd);
+    }
+
+    void send(const std::string& message) override {
+        uint64_t length = message.size();
+        write(&length, sizeof(length));
+        write(message.data(), message.size());
+    }
+
+    std::string receive() override {
+        uint64_t length = 0;
+        read(&length, sizeof(length));
+        std::string message(static_cast<std::size_t>(length), '\0');
+        read(message.data(), message.size());
+        return message;
+    }
+
+private:
+    void write(const void* data, std::size_t size) {
+        const char* pos = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t res = ::send(fd, pos, size, MSG_NOSIGNAL);
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                socketError("cannot send to", "peer");
+            }
+            pos += res;
+            size -= static_cast<std::size_t>(res);
+        }
+    }
+
+    void read(void* data, std::size_t size) {
+        char* pos = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t res = ::recv(fd, pos, size, 0);
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res == 0) {
+                throw std::runtime_error("peer closed the connection");
+            }
+            if (res < 0) {
+                socketError("cannot receive from", "peer");
+            }
+            pos += res;
+            size -= static_cast<std::size_t>(res);
+        }
+    }
+
+    const int fd;
+};
+
+/** A parsed endpoint, holding the socket address */
+struct Endpoint {
+    int family = AF_UNSPEC;
+    sockaddr_storage address{};
+    socklen_t length = 0;
+    std::string name;
+};
+
+Endpoint parseEndpoint(const std::string& endpoint) {
+    Endpoint res;
+    res.name = endpoint;
+    if (endpoint.rfind("unix:", 0) == 0) {
+        std::string path = endpoint.substr(5);
+        auto* addr = reinterpret_cast<sockaddr_un*>(&res.address);
+        if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+            throw std::invalid_argument("invalid socket path in endpoint " + endpoint);
+        }
+        addr->sun_family = AF_UNIX;
+        std::strncpy(addr->sun_path, path.c_str(), sizeof(addr->sun_path) - 1);
+        res.family = AF_UNIX;
+        res.length = sizeof(sockaddr_un);
+        return res;
+    }
+
+    std::string hostPort = endpoint.rfind("tcp:", 0) == 0 ? endpoint.substr(4) : endpoint;
+    std::size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos) {
+        throw std::invalid_argument("missing port in endpoint " + endpoint);
+    }
+    std::string host = hostPort.substr(0, colon);
+    std::string port = hostPort.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* info = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &info) != 0 ||
+            info == nullptr) {
+        throw std::invalid_argument("cannot resolve endpoint " + endpoint);
+    }
+    res.family = info->ai_family;
+    res.length = info->ai_addrlen;
+    std::memcpy(&res.address, info->ai_addr, info->ai_addrlen);
+    freeaddrinfo(info);
+    return res;
+}
+
+int openSocket(const Endpoint& endpoint) {
+    int fd = ::socket(endpoint.family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        socketError("cannot create socket for", endpoint.name);
+    }
+    if (endpoint.family != AF_UNIX) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    return fd;
+}
+
+#endif
+
+}  // namespace
+
+Cluster::Cluster(std::size_t rank, VecOwn<Transport> links) : rank(rank), links(std::move(links)) {
+    if (rank >= this->links.size()) {
+        throw std::invalid_argument("rank " + std::to_string(rank) + " is not part of the cluster");
+    }
+}
+
+Own<Cluster> Cluster::connect(std::size_t rank, const std::vector<std::string>& endpoints, int timeout) {
+#ifndef _MSC_VER
+    const std::size_t size = endpoints.size();
+    if (rank >= size) {
+        throw std::invalid_argument("rank " + std::to_string(rank) + " is not part of the cluster");
+    }
+    VecOwn<Transport> links(size);
+
+    // listen for the workers of higher rank
+    const Endpoint own = parseEndpoint(endpoints[rank]);
+    int listener = -1;
+    if (rank + 1 < size) {
+        listener = openSocket(own);
+        if (own.family == AF_UNIX) {
+            ::unlink(reinterpret_cast<const sockaddr_un*>(&own.address)->sun_path);
+        }
+        if (::bind(listener, reinterpret_cast<const sockaddr*>(&own.address), own.length) != 0 ||
+                ::listen(listener, static_cast<int>(size)) != 0) {
+            ::close(listener);
+            socketError("cannot listen on", own.name);
+        }
+    }
+
+    // connect to the workers of lower rank and introduce this worker
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+    for (std::size_t peer = 0; peer < rank; ++peer) {
+        const Endpoint endpoint = parseEndpoint(endpoints[peer]);
+        while (true) {
+            int fd = openSocket(endpoint);
+            if (::connect(fd, reinterpret_cast<const sockaddr*>(&endpoint.address), endpoint.length) == 0) {
+                links[peer] = mk<SocketTransport>(fd);
+                break;
+            }
+            ::close(fd);
+            if (std::chrono::steady_clock::now() > deadline) {
+                socketError("cannot connect to", endpoint.name);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        links[peer]->send(std::to_string(rank));
+    }
+
+    // accept the workers of higher rank, which introduce themselves
+    for (std::size_t i = rank + 1; i < size; ++i) {
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            ::close(listener);
+            socketError("cannot accept on", own.name);
+        }
+        auto link = mk<SocketTransport>(fd);
+        std::size_t peer = std::stoul(link->receive());
+        if (peer <= rank || peer >= size || links[peer] != nullptr) {
+            ::close(listener);
+            throw std::runtime_error("unexpected worker " + std::to_string(peer) + " on " + own.name);
+        }
+        links[peer] = std::move(link);
+    }
+    if (listener >= 0) {
+        ::close(listener);
+        if (own.family == AF_UNIX) {
+            ::unlink(reinterpret_cast<const sockaddr_un*>(&own.address)->sun_path);
+        }
+    }
+    return mk<Cluster>(rank, std::move(links));
+#else
+    (void)rank;
+    (void)endpoints;
+    (void)timeout;
+    throw std::runtime_error("distributed evaluation is not supported on this platform");
+#endif
+}
+
+std::vector<std::string> Cluster::allGather(std::string message) {
+    std::vector<std::string> res(links.size());
+    exchange([&](std::size_t) -> const std::string& { return message; }, res);
+    res[rank] = std::move(message);
+    return res;
+}
+
+std::vector<std::string> Cluster::allToAll(std::vector<std::string> messages) {
+    if (messages.size() != links.size()) {
+        throw std::invalid_argument("expected one message per worker");
+    }
+    std::vector<std::string> res(links.size());
+    exchange([&](std::size_t peer) -> const std::string& { return messages[peer]; }, res);
+    res[rank] = std::move(messages[rank]);
+    return res;
+}
+
+void Cluster::exchange(const std::function<const std::string&(std::size_t)>& outgoing,
+        std::vector<std::string>& incoming) {
+    const std::size_t size = links.size();
+    if (size == 1) {
+        return;
+    }
+
+    // Send in the order rank+1, rank+2, ... and receive in the order rank-1, rank-2, ...
+    // In step k every worker sends to the worker that receives from it in step k, so
+    // a sender blocked on a full socket buffer always has a matching receiver.
+    std::exception_ptr sendError;
+    std::thread sender([&]() {
+        try {
+            for (std::size_t step = 1; step < size; ++step) {
+                std::size_t peer = (rank + step) % size;
+                links[peer]->send(outgoing(peer));
+            }
+        } catch (...) {
+            sendError = std::current_exception();
+        }
+    });
+    std::exception_ptr receiveError;
+    try {
+        for (std::size_t step = 1; step < size; ++step) {
+            std::size_t peer = (rank + size - step) % size;
+            incoming[peer] = links[peer]->receive();
+        }
+    } catch (...) {
+        receiveError = std::current_exception();
+    }
+    sender.join();
+    if (receiveError) {
+        std::rethrow_exception(receiveError);
+    }
+    if (sendError) {
+        std::rethrow_exception(sendError);
+    }
+}
+
+}  // namespace souffle::interpreter
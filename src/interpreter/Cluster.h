@@ -0,0 +1,88 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Cluster.h
+ *
+ * Declares the communication between the worker processes of a
+ * distributed evaluation.
+ ***********************************************************************/
+
+#pragma once
+
+#include "souffle/utility/ContainerUtil.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace souffle::interpreter {
+
+/**
+ * @class Transport
+ * @brief A bidirectional link to a peer process carrying whole messages.
+ */
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    /** Send a message to the peer */
+    virtual void send(const std::string& message) = 0;
+
+    /** Receive the next message from the peer, blocking until it arrived */
+    virtual std::string receive() = 0;
+};
+
+/**
+ * @class Cluster
+ * @brief The set of worker processes evaluating a program together.
+ *
+ * Every worker holds a link to every other worker. Links are established
+ * by connect() from a list of endpoints of the form unix:PATH or
+ * tcp:HOST:PORT; the worker of rank i listens on the i-th endpoint.
+ */
+class Cluster {
+public:
+    /** Create a cluster from already established links, one per rank; the own link is empty */
+    Cluster(std::size_t rank, VecOwn<Transport> links);
+
+    /** Connect to all other workers, waiting up to the given number of seconds for them */
+    static Own<Cluster> connect(
+            std::size_t rank, const std::vector<std::string>& endpoints, int timeout = 60);
+
+    std::size_t getRank() const {
+        return rank;
+    }
+
+    std::size_t getSize() const {
+        return links.size();
+    }
+
+    /**
+     * Exchange a message with all workers. Returns the messages of all
+     * workers indexed by rank, including the own one.
+     */
+    std::vector<std::string> allGather(std::string message);
+
+    /**
+     * Send the i-th message to the worker of rank i. Returns the messages
+     * sent to this worker indexed by rank, including the own one.
+     */
+    std::vector<std::string> allToAll(std::vector<std::string> messages);
+
+private:
+    /** Send the outgoing message of each other worker, and receive its incoming one */
+    void exchange(const std::function<const std::string&(std::size_t)>& outgoing,
+            std::vector<std::string>& incoming);
+
+    const std::size_t rank;
+    VecOwn<Transport> links;
+};
+
+}  // namespace souffle::interpreter
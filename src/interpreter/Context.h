@@ -27,6 +27,8 @@
 
 namespace souffle::interpreter {
 
+class Node;
+
 /**
  * Evaluation context for Interpreter operations
  */
@@ -117,6 +119,35 @@ public:
         variables[name] = value;
     }
 
+    const std::map<std::string, RamDomain>& getVariables() const {
+        return variables;
+    }
+
+    /** @brief Set the results of a batch functor for the tuples of a batch */
+    void setFunctorResults(const Node* functor, const RamDomain* results) {
+        functorResults.emplace_back(functor, results);
+    }
+
+    /** @brief Drop the results of the batch functors */
+    void clearFunctorResults() {
+        functorResults.clear();
+    }
+
+    /** @brief Set the tuple of a batch being evaluated */
+    void setBatchRow(std::size_t row) {
+        batchRow = row;
+    }
+
+    /** @brief Get the result of a batch functor for the tuple of a batch being evaluated, if set */
+    const RamDomain* getFunctorResult(const Node* functor) const {
+        for (const auto& [node, results] : functorResults) {
+            if (node == functor) {
+                return &results[batchRow];
+            }
+        }
+        return nullptr;
+    }
+
 private:
     /** @brief Run-time value */
     std::vector<const RamDomain*> data;
@@ -129,6 +160,10 @@ private:
     /** @brief Views */
     VecOwn<ViewWrapper> views;
     std::map<std::string, RamDomain> variables;
+    /** @brief Results of batch functors for the tuples of a batch */
+    std::vector<std::pair<const Node*, const RamDomain*>> functorResults;
+    /** @brief Tuple of a batch being evaluated */
+    std::size_t batchRow = 0;
 };
 
 }  // namespace souffle::interpreter
@@ -94,9 +94,11 @@
 #include "souffle/datastructure/SymbolTableImpl.h"
 #include "souffle/io/IOSystem.h"
 #include "souffle/io/ReadStream.h"
+#include "souffle/io/SpillStream.h"
 #include "souffle/io/WriteStream.h"
 #include "souffle/profile/Logger.h"
 #include "souffle/profile/ProfileEvent.h"
+#include "souffle/utility/DigestUtil.h"
 #include "souffle/utility/EvaluatorUtil.h"
 #include "souffle/utility/ParallelUtil.h"
 #include "souffle/utility/StringUtil.h"
@@ -108,7 +110,6 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <iostream>
 #include <iterator>
@@ -243,8 +244,8 @@ std::tuple<ArgTs...> statelessCallTuple(souffle::SymbolTable& symbolTable,
 }
 
 /** Call a stateful functor. */
-template <std::size_t I = 0, typename ExecuteFn, typename Shadow, typename... ArgTs>
-RamDomain callStateless(ExecuteFn&& execute, Context& ctxt, Shadow& shadow, souffle::SymbolTable& symbolTable,
+template <std::size_t I = 0, typename ArgumentFn, typename... ArgTs>
+RamDomain callStateless(ArgumentFn&& argument, souffle::SymbolTable& symbolTable,
         const TypeAttribute returnType, const std::vector<TypeAttribute>& argTypes, void (*userFunctor)()) {
     if (I == argTypes.size()) {
         constexpr std::size_t Arity = sizeof...(ArgTs);
@@ -252,7 +253,7 @@ RamDomain callStateless(ExecuteFn&& execute, Context& ctxt, Shadow& shadow, souf
 
         if constexpr (Arity > 0) {
             for (std::size_t i = 0; i < Arity; ++i) {
-                args[i] = execute(shadow.getChild(i), ctxt);
+                args[i] = argument(i);
             }
         }
 
@@ -276,21 +277,17 @@ RamDomain callStateless(ExecuteFn&& execute, Context& ctxt, Shadow& shadow, souf
             // construct argument tuple type
 
             if (argTypes[I] == TypeAttribute::Signed) {
-                return callStateless<I + 1, ExecuteFn, Shadow, ArgTs..., RamDomain>(
-                        std::forward<ExecuteFn>(execute), ctxt, std::forward<Shadow>(shadow), symbolTable,
-                        returnType, argTypes, userFunctor);
+                return callStateless<I + 1, ArgumentFn, ArgTs..., RamDomain>(
+                        std::forward<ArgumentFn>(argument), symbolTable, returnType, argTypes, userFunctor);
             } else if (argTypes[I] == TypeAttribute::Unsigned) {
-                return callStateless<I + 1, ExecuteFn, Shadow, ArgTs..., RamUnsigned>(
-                        std::forward<ExecuteFn>(execute), ctxt, std::forward<Shadow>(shadow), symbolTable,
-                        returnType, argTypes, userFunctor);
+                return callStateless<I + 1, ArgumentFn, ArgTs..., RamUnsigned>(
+                        std::forward<ArgumentFn>(argument), symbolTable, returnType, argTypes, userFunctor);
             } else if (argTypes[I] == TypeAttribute::Float) {
-                return callStateless<I + 1, ExecuteFn, Shadow, ArgTs..., RamFloat>(
-                        std::forward<ExecuteFn>(execute), ctxt, std::forward<Shadow>(shadow), symbolTable,
-                        returnType, argTypes, userFunctor);
+                return callStateless<I + 1, ArgumentFn, ArgTs..., RamFloat>(
+                        std::forward<ArgumentFn>(argument), symbolTable, returnType, argTypes, userFunctor);
             } else if (argTypes[I] == TypeAttribute::Symbol) {
-                return callStateless<I + 1, ExecuteFn, Shadow, ArgTs..., const char*>(
-                        std::forward<ExecuteFn>(execute), ctxt, std::forward<Shadow>(shadow), symbolTable,
-                        returnType, argTypes, userFunctor);
+                return callStateless<I + 1, ArgumentFn, ArgTs..., const char*>(
+                        std::forward<ArgumentFn>(argument), symbolTable, returnType, argTypes, userFunctor);
             } else {
                 fatal("unsupported argument type");
             }
@@ -300,15 +297,340 @@ RamDomain callStateless(ExecuteFn&& execute, Context& ctxt, Shadow& shadow, souf
     }
 }
 
+/** A batch functor, see ast::FunctorDeclaration */
+using BatchFunctor = void (*)(std::size_t, const RamDomain*, RamDomain*);
+
+/** A stateful batch functor */
+using StatefulBatchFunctor = void (*)(SymbolTable*, RecordTable*, std::size_t, const RamDomain*, RamDomain*);
+
+/** Number of tuples a scan with a batch plan evaluates at a time */
+static constexpr std::size_t BatchSize = 256;
+
+/** Keep the rows of a batch selection that satisfy a comparison, comparing as values of type T */
+template <typename T, typename Compare>
+std::size_t selectRowsAs(const BatchPlan::Comparison& comparison, const RamDomain* rows, std::size_t arity,
+        uint32_t* selection, std::size_t count, const Context& ctxt, Compare compare) {
+    const auto& lhs = comparison.lhs;
+    const auto& rhs = comparison.rhs;
+    // the loop keeps every selected row and advances past the rejected ones, without branching
+    auto select = [&](auto lhsOf, auto rhsOf) {
+        std::size_t selected = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const RamDomain* row = rows + selection[i] * arity;
+            selection[selected] = selection[i];
+            selected += compare(lhsOf(row), rhsOf(row)) ? 1 : 0;
+        }
+        return selected;
+    };
+    auto column = [](std::size_t element) {
+        return [element](const RamDomain* row) { return ramBitCast<T>(row[element]); };
+    };
+    // operands other than columns are the same for the whole batch
+    auto fixed = [&](const BatchPlan::Operand& operand) {
+        RamDomain value = operand.constant;
+        if (operand.kind == BatchPlan::Operand::Element) {
+            value = ctxt[operand.tupleId][operand.element];
+        }
+        return [value = ramBitCast<T>(value)](const RamDomain*) { return value; };
+    };
+    if (lhs.kind != BatchPlan::Operand::Column) {
+        return select(fixed(lhs), column(rhs.element));
+    } else if (rhs.kind != BatchPlan::Operand::Column) {
+        return select(column(lhs.element), fixed(rhs));
+    }
+    return select(column(lhs.element), column(rhs.element));
+}
+
+/** Keep the rows of a batch selection that satisfy a comparison */
+std::size_t selectRows(const BatchPlan::Comparison& comparison, const RamDomain* rows, std::size_t arity,
+        uint32_t* selection, std::size_t count, const Context& ctxt) {
+#define SELECT_ROWS(ty, compare) \
+    return selectRowsAs<ty>(comparison, rows, arity, selection, count, ctxt, compare<ty>())
+    switch (comparison.op) {
+        case BinaryConstraintOp::EQ: SELECT_ROWS(RamDomain, std::equal_to);
+        case BinaryConstraintOp::FEQ: SELECT_ROWS(RamFloat, std::equal_to);
+        case BinaryConstraintOp::NE: SELECT_ROWS(RamDomain, std::not_equal_to);
+        case BinaryConstraintOp::FNE: SELECT_ROWS(RamFloat, std::not_equal_to);
+        case BinaryConstraintOp::LT: SELECT_ROWS(RamSigned, std::less);
+        case BinaryConstraintOp::ULT: SELECT_ROWS(RamUnsigned, std::less);
+        case BinaryConstraintOp::FLT: SELECT_ROWS(RamFloat, std::less);
+        case BinaryConstraintOp::LE: SELECT_ROWS(RamSigned, std::less_equal);
+        case BinaryConstraintOp::ULE: SELECT_ROWS(RamUnsigned, std::less_equal);
+        case BinaryConstraintOp::FLE: SELECT_ROWS(RamFloat, std::less_equal);
+        case BinaryConstraintOp::GT: SELECT_ROWS(RamSigned, std::greater);
+        case BinaryConstraintOp::UGT: SELECT_ROWS(RamUnsigned, std::greater);
+        case BinaryConstraintOp::FGT: SELECT_ROWS(RamFloat, std::greater);
+        case BinaryConstraintOp::GE: SELECT_ROWS(RamSigned, std::greater_equal);
+        case BinaryConstraintOp::UGE: SELECT_ROWS(RamUnsigned, std::greater_equal);
+        case BinaryConstraintOp::FGE: SELECT_ROWS(RamFloat, std::greater_equal);
+        default: fatal("unsupported comparison in a batch");
+    }
+#undef SELECT_ROWS
+}
+
 }  // namespace
 
 Engine::Engine(ram::TranslationUnit& tUnit, const std::size_t numberOfThreadsOrZero)
         : tUnit(tUnit), global(tUnit.global()), profileEnabled(global.config().has("profile")),
           frequencyCounterEnabled(global.config().has("profile-frequency")),
+          statisticsSampleSize(global.config().has("statistics-sample")
+                                       ? std::stoul(global.config().get("statistics-sample"))
+                                       : 0),
           numOfThreads(number_of_threads(numberOfThreadsOrZero)),
+          clusterRank(global.config().has("cluster-rank") ? std::stoul(global.config().get("cluster-rank"))
+                                                           : 0),
+          clusterSize(global.config().has("cluster")
+                              ? splitString(global.config().get("cluster"), ',').size()
+                              : 1),
           isa(tUnit.getAnalysis<ram::analysis::IndexAnalysis>()), recordTable(numOfThreads),
           symbolTable(numOfThreads), regexCache(numOfThreads) {}
 
+Engine::~Engine() {
+    SpillStore::getInstance().release(&symbolTable);
+}
+
+bool Engine::isOwnTuple(const RamDomain* tuple, const Scan& shadow) const {
+    return getWorker(tuple, shadow.getPartitionColumns()) == clusterRank;
+}
+
+std::size_t Engine::getWorker(const RamDomain* values, const std::vector<char>& columnTypes) const {
+    // hash the values, and symbols by their text, as symbol ordinals differ between workers
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+    for (std::size_t i = 0; i < columnTypes.size(); ++i) {
+        switch (columnTypes[i]) {
+            case 's':
+                for (char c : symbolTable.decode(values[i])) {
+                    mix(static_cast<unsigned char>(c));
+                }
+                break;
+            // record ordinals differ between workers
+            case 'r':
+            case '+': break;
+            default: mix(static_cast<RamUnsigned>(values[i]));
+        }
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return static_cast<std::size_t>(hash % clusterSize);
+}
+
+void Engine::compactTables() {
+    std::map<std::string, std::string> kinds;
+    for (const auto* rel : tUnit.getProgram().getRelations()) {
+        std::string& relKinds = kinds[rel->getName()];
+        for (const auto& type : rel->getAttributeTypes()) {
+            relKinds.push_back(type[0]);
+        }
+    }
+    // the relations expired by the stratum are empty by now
+    compactor->compact([&](auto&& markTuple) {
+        for (const auto& handle : relations) {
+            if (handle == nullptr || *handle == nullptr) {
+                continue;
+            }
+            const RelationWrapper& rel = **handle;
+            const std::string& relKinds = kinds[rel.getName()];
+            for (const RamDomain* tuple : rel) {
+                markTuple(tuple, relKinds);
+            }
+        }
+        // spilled relations are purged, but their rows still hold symbols and records
+        try {
+            SpillStore::getInstance().enumerate(&symbolTable, [&](const std::string& name, std::size_t width,
+                                                                      const std::vector<RamDomain>& rows,
+                                                                      const std::string& /* dir */) {
+                const std::string& relKinds = kinds[name];
+                for (std::size_t i = 0; width > 0 && i < rows.size(); i += width) {
+                    markTuple(&rows[i], relKinds);
+                }
+            });
+        } catch (std::exception& e) {
+            std::cerr << "Error compacting tables: " << e.what() << "\n";
+            exit(EXIT_FAILURE);
+        }
+    });
+    // cached results may be freed symbols or records
+    for (auto& [site, memo] : memoTables) {
+        memo->clear();
+    }
+}
+
+void Engine::setupCheckpoint() {
+    std::size_t strata = 0;
+    visit(tUnit.getProgram().getMain(), [&](const ram::Call&) { ++strata; });
+    auto getCount = [&](const std::string& option, std::size_t byDefault) -> std::size_t {
+        return global.config().has(option) ? std::stoul(global.config().get(option)) : byDefault;
+    };
+    checkpoint = mk<Checkpoint>(symbolTable, recordTable, counter, sha256Hex(toString(tUnit.getProgram())),
+            strata, global.config().get("checkpoint"), getCount("checkpoint-iterations", 0),
+            getCount("checkpoint-strata", 1), getCount("checkpoint-stop", 0));
+
+    // relations are written by their name in the program, which swaps move between handles
+    checkpoint->setRelations([&](Checkpoint::Writer& writer) {
+        for (const auto& [name, idx] : relationIndexes) {
+            const RelationHandle& handle = *relations[idx];
+            if (handle != nullptr) {
+                writer.writeRelation(name, handle->getArity(), *handle);
+            }
+        }
+    });
+    if (checkpoint->restore()) {
+        for (const auto& [name, idx] : relationIndexes) {
+            RelationHandle& handle = *relations[idx];
+            if (handle != nullptr) {
+                checkpoint->readRelation(
+                        name, handle->getArity(), [&](const RamDomain* tuple) { handle->insert(tuple); });
+            }
+        }
+    }
+}
+
+bool Engine::stoppedAtCheckpoint() const {
+    return checkpoint != nullptr && checkpoint->isStopped();
+}
+
+bool Engine::containsLoop(const Node* node) {
+    bool found = false;
+    visit(*node->getShadow(), [&](const ram::Loop&) { found = true; });
+    return found;
+}
+
+const ram::Relation& Engine::getRamRelation(const std::string& name) const {
+    for (const auto* rel : tUnit.getProgram().getRelations()) {
+        if (rel->getName() == name) {
+            return *rel;
+        }
+    }
+    fatal("unknown relation %s", name);
+}
+
+void Engine::serialiseTuple(std::string& message, const RamDomain* tuple, const ram::Relation& rel) const {
+    const auto& types = rel.getAttributeTypes();
+    for (std::size_t i = 0; i < rel.getArity(); ++i) {
+        if (types[i][0] == 's') {
+            const std::string& symbol = symbolTable.decode(tuple[i]);
+            uint32_t length = static_cast<uint32_t>(symbol.size());
+            message.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            message.append(symbol);
+        } else {
+            message.append(reinterpret_cast<const char*>(&tuple[i]), sizeof(RamDomain));
+        }
+    }
+}
+
+void Engine::deserialiseTuples(const std::string& message, const ram::Relation& rel,
+        const std::function<void(const RamDomain*)>& consume) {
+    const auto& types = rel.getAttributeTypes();
+    std::vector<RamDomain> tuple(rel.getArity());
+    std::size_t pos = 0;
+    while (pos < message.size()) {
+        for (std::size_t i = 0; i < tuple.size(); ++i) {
+            if (types[i][0] == 's') {
+                uint32_t length = 0;
+                std::memcpy(&length, message.data() + pos, sizeof(length));
+                pos += sizeof(length);
+                tuple[i] = symbolTable.encode(message.substr(pos, length));
+                pos += length;
+            } else {
+                std::memcpy(&tuple[i], message.data() + pos, sizeof(RamDomain));
+                pos += sizeof(RamDomain);
+            }
+        }
+        consume(tuple.data());
+    }
+}
+
+std::vector<std::string> Engine::splitRelation(RelationWrapper& rel) {
+    const ram::Relation& ramRel = getRamRelation(rel.getName());
+    const std::size_t column = partitionColumns.at(rel.getName());
+    const std::vector<char> columnType{ramRel.getAttributeTypes()[column][0]};
+    const std::size_t arity = rel.getArity();
+
+    std::vector<std::string> messages(clusterSize);
+    std::vector<RamDomain> own;
+    bool foreign = false;
+    for (const RamDomain* tuple : rel) {
+        std::size_t worker = getWorker(&tuple[column], columnType);
+        if (worker == clusterRank) {
+            own.insert(own.end(), tuple, tuple + arity);
+        } else {
+            serialiseTuple(messages[worker], tuple, ramRel);
+            foreign = true;
+        }
+    }
+    if (foreign) {
+        rel.purge();
+        for (std::size_t pos = 0; pos < own.size(); pos += arity) {
+            rel.insert(&own[pos]);
+        }
+    }
+    return messages;
+}
+
+void Engine::exchangeRelation(RelationWrapper& rel, const RelationWrapper* known) {
+    if (cluster == nullptr) {
+        return;
+    }
+    const ram::Relation& ramRel = getRamRelation(rel.getName());
+
+    std::vector<std::string> messages;
+    if (partitionColumns.count(rel.getName()) > 0) {
+        // each tuple goes to its owner only
+        messages = cluster->allToAll(splitRelation(rel));
+    } else {
+        std::string message;
+        for (const RamDomain* tuple : rel) {
+            serialiseTuple(message, tuple, ramRel);
+        }
+        messages = cluster->allGather(std::move(message));
+    }
+
+    // insert the tuples of all other workers
+    for (std::size_t worker = 0; worker < messages.size(); ++worker) {
+        if (worker == clusterRank) {
+            continue;
+        }
+        deserialiseTuples(messages[worker], ramRel, [&](const RamDomain* tuple) {
+            if (known == nullptr || !known->contains(tuple)) {
+                rel.insert(tuple);
+            }
+        });
+    }
+}
+
+Engine::RelationHandle Engine::gatherRelation(const RelationWrapper& rel) {
+    const ram::Relation& ramRel = getRamRelation(rel.getName());
+    std::vector<std::string> messages(clusterSize);
+    if (clusterRank != 0) {
+        for (const RamDomain* tuple : rel) {
+            serialiseTuple(messages[0], tuple, ramRel);
+        }
+    }
+    messages = cluster->allToAll(std::move(messages));
+    if (clusterRank != 0) {
+        return nullptr;
+    }
+    RelationHandle gathered = createBTreeRelation(ramRel, isa.getIndexSelection(ramRel.getName()));
+    for (const RamDomain* tuple : rel) {
+        gathered->insert(tuple);
+    }
+    for (const std::string& message : messages) {
+        deserialiseTuples(message, ramRel, [&](const RamDomain* tuple) { gathered->insert(tuple); });
+    }
+    return gathered;
+}
+
+bool Engine::holdsOnAllWorkers(bool condition) {
+    for (const std::string& message : cluster->allGather(condition ? "1" : "0")) {
+        if (message != "1") {
+            return false;
+        }
+    }
+    return true;
+}
+
 Engine::RelationHandle& Engine::getRelationHandle(const std::size_t idx) {
     return *relations[idx];
 }
@@ -359,7 +681,7 @@ void Engine::createRelation(const ram::Relation& id, const std::size_t idx) {
     }
 
     RelationHandle res;
-    bool hasProvenance = id.getArity() > 0 && id.getAttributeNames().back() == "@level_number";
+    bool hasProvenance = id.hasProvenance();
     if (hasProvenance) {
         res = createProvenanceRelation(id, isa.getIndexSelection(id.getName()));
     } else if (id.getRepresentation() == RelationRepresentation::EQREL) {
@@ -370,6 +692,7 @@ void Engine::createRelation(const ram::Relation& id, const std::size_t idx) {
         res = createBTreeRelation(id, isa.getIndexSelection(id.getName()));
     }
     relations[idx] = mk<RelationHandle>(std::move(res));
+    relationIndexes[id.getName()] = idx;
 }
 
 const std::vector<void*>& Engine::loadDLL() {
@@ -426,13 +749,41 @@ std::size_t Engine::getIterationNumber() const {
 }
 
 void Engine::incIterationNumber() {
+    if (profileEnabled && frequencyCounterEnabled) {
+        mergeFrequencies();
+    }
     ++iteration;
 }
 
 void Engine::resetIterationNumber() {
+    if (profileEnabled && frequencyCounterEnabled) {
+        mergeFrequencies();
+    }
     iteration = 0;
 }
 
+std::size_t Engine::lookupFrequencyCounter(const std::string& profileText) {
+    auto [pos, inserted] = frequencyCounters.emplace(profileText, frequencyCounters.size());
+    if (inserted) {
+        frequencies.emplace_back(1, 0);
+    }
+    return pos->second;
+}
+
+std::size_t Engine::lookupReadCounter(const std::string& relationName) {
+    return readCounters.emplace(relationName, readCounters.size()).first->second;
+}
+
+void Engine::mergeFrequencies() {
+    frequencyShards.drain([&](std::size_t counter, std::size_t count) {
+        auto& perIteration = frequencies[counter];
+        if (perIteration.size() <= iteration) {
+            perIteration.resize(iteration + 1, 0);
+        }
+        perIteration[iteration] += count;
+    });
+}
+
 void Engine::executeMain() {
     SignalHandler::instance()->set();
     if (global.config().has("verbose")) {
@@ -446,19 +797,33 @@ void Engine::executeMain() {
     generateIR();
     assert(main != nullptr && "Executing an empty program");
 
+    if (clusterSize > 1 && cluster == nullptr) {
+        try {
+            cluster = Cluster::connect(clusterRank, splitString(global.config().get("cluster"), ','));
+        } catch (std::exception& e) {
+            std::cerr << "Error joining the cluster: " << e.what() << "\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (global.config().has("compact-tables")) {
+        // the symbols of the program's constants exist by now, and are kept
+        compactor = mk<TableCompactor>(symbolTable, recordTable);
+    }
+
+    if (global.config().has("checkpoint")) {
+        setupCheckpoint();
+    }
+
     if (!profileEnabled) {
         Context ctxt;
         execute(main.get(), ctxt);
     } else {
         ProfileEventSingleton::instance().setOutputFile(global.config().get("profile"));
-        // Prepare the frequency table for threaded use
+        if (global.config().has("profile-trace")) {
+            ProfileEventSingleton::instance().setTraceFile(global.config().get("profile-trace"));
+        }
         const ram::Program& program = tUnit.getProgram();
-        visit(program, [&](const ram::TupleOperation& node) {
-            if (!node.getProfileText().empty()) {
-                frequencies.emplace(node.getProfileText(), std::deque<std::atomic<std::size_t>>());
-                frequencies[node.getProfileText()].emplace_back(0);
-            }
-        });
         // Enable profiling for execution of main
         ProfileEventSingleton::instance().startTimer();
         ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");
@@ -472,7 +837,6 @@ void Engine::executeMain() {
         for (auto rel : tUnit.getProgram().getRelations()) {
             if (rel->getName()[0] != '@') {
                 ++relationCount;
-                reads[rel->getName()] = 0;
             }
         }
         ProfileEventSingleton::instance().makeConfigRecord("relationCount", std::to_string(relationCount));
@@ -487,22 +851,74 @@ void Engine::executeMain() {
         Context ctxt;
         execute(main.get(), ctxt);
         ProfileEventSingleton::instance().stopTimer();
-        for (auto const& cur : frequencies) {
-            for (std::size_t i = 0; i < cur.second.size(); ++i) {
+        mergeFrequencies();
+        for (auto const& cur : frequencyCounters) {
+            const auto& perIteration = frequencies[cur.second];
+            for (std::size_t i = 0; i < perIteration.size(); ++i) {
                 ProfileEventSingleton::instance().makeQuantityEvent(
-                        cur.first, cur.second[i], static_cast<int>(i));
+                        cur.first, perIteration[i], static_cast<int>(i));
             }
         }
-        for (auto const& cur : reads) {
+        for (auto const& cur : readCounters) {
             ProfileEventSingleton::instance().makeQuantityEvent(
-                    "@relation-reads;" + cur.first, cur.second, 0);
+                    "@relation-reads;" + cur.first, reads.get(cur.second), 0);
         }
+        for (auto const& [site, memo] : memoTables) {
+            ProfileEventSingleton::instance().makeMemoEvent(
+                    "@memo;" + stringify(site), memo->getHits(), memo->getCalls());
+        }
+    }
+    if (checkpoint != nullptr) {
+        checkpoint->finish();
     }
     SignalHandler::instance()->reset();
 }
 
+bool Engine::evalStringConstraint(const Constraint& constraint, BinaryConstraintOp op, RamDomain left,
+        RamDomain right, bool& valid) {
+    const std::string& text = getSymbolTable().decode(right);
+    switch (op) {
+        case BinaryConstraintOp::MATCH:
+        case BinaryConstraintOp::NOT_MATCH: {
+            const bool negated = op == BinaryConstraintOp::NOT_MATCH;
+            if (const auto* regexNode = dynamic_cast<const RegexConstant*>(constraint.getLhs())) {
+                const auto& regex = regexNode->getRegex();
+                // a pattern that does not compile matches neither way
+                return regex && regex->match(text) != negated;
+            }
+            try {
+                const RegexMatcher& regex = regexCache.getOrCreate(left,
+                        [&](RamDomain pattern) { return RegexMatcher(getSymbolTable().decode(pattern)); });
+                return regex.match(text) != negated;
+            } catch (...) {
+                std::cerr << "warning: wrong pattern provided for " << (negated ? "!" : "") << "match(\""
+                          << getSymbolTable().decode(left) << "\",\"" << text << "\").\n";
+                valid = false;
+            }
+            return false;
+        }
+        case BinaryConstraintOp::CONTAINS:
+            return text.find(getSymbolTable().decode(left)) != std::string::npos;
+        case BinaryConstraintOp::NOT_CONTAINS:
+            return text.find(getSymbolTable().decode(left)) == std::string::npos;
+        default: fatal("unsupported string constraint");
+    }
+}
+
+void Engine::registerMemoTable(const std::string& site, MemoTable& memo) {
+    memoTables.emplace_back(site, &memo);
+}
+
 void Engine::generateIR() {
     const ram::Program& program = tUnit.getProgram();
+    if (profileEnabled) {
+        // reads of every user relation are reported, even if never read
+        for (auto rel : program.getRelations()) {
+            if (rel->getName()[0] != '@') {
+                lookupReadCounter(rel->getName());
+            }
+        }
+    }
     NodeGenerator generator(*this);
     if (subroutine.empty()) {
         for (const auto& sub : program.getSubroutines()) {
@@ -512,6 +928,13 @@ void Engine::generateIR() {
     if (main == nullptr) {
         main = generator.generateTree(program.getMain());
     }
+    // counters are registered by the generator and sized once it is done
+    if (frequencyShards.size() != frequencyCounters.size()) {
+        frequencyShards.resize(frequencyCounters.size(), numOfThreads);
+    }
+    if (reads.size() != readCounters.size()) {
+        reads.resize(readCounters.size(), numOfThreads);
+    }
 }
 
 void Engine::executeSubroutine(
@@ -519,8 +942,14 @@ void Engine::executeSubroutine(
     Context ctxt;
     ctxt.setReturnValues(ret);
     ctxt.setArguments(args);
-    generateIR();
-    execute(subroutine["stratum_" + name].get(), ctxt);
+    const Node* node;
+    {
+        // subroutines may be run concurrently, e.g. to explain many tuples
+        std::lock_guard<std::mutex> guard(subroutineLock);
+        generateIR();
+        node = subroutine.at("stratum_" + name).get();
+    }
+    execute(node, ctxt);
 }
 
 RamDomain Engine::execute(const Node* node, Context& ctxt) {
@@ -659,8 +1088,14 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
             switch (cur.getOperator()) {
                 /** Unary Functor Operators */
                 case FunctorOp::ORD: return execute(shadow.getChild(0), ctxt);
-                case FunctorOp::STRLEN:
+                case FunctorOp::STRLEN: {
+                    if (isStringBuilder(shadow.getChild(0))) {
+                        std::string str;
+                        appendString(shadow.getChild(0), ctxt, str);
+                        return str.size();
+                    }
                     return getSymbolTable().decode(execute(shadow.getChild(0), ctxt)).size();
+                }
                 case FunctorOp::NEG: return -execute(shadow.getChild(0), ctxt);
                 case FunctorOp::FNEG: {
                     RamDomain result = execute(shadow.getChild(0), ctxt);
@@ -761,27 +1196,13 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                 case FunctorOp::SMIN: MINMAX_OP_SYM(>)
                     // clang-format on
 
-                case FunctorOp::CAT: {
-                    std::stringstream ss;
-                    for (std::size_t i = 0; i < numArgs; i++) {
-                        ss << getSymbolTable().decode(execute(shadow.getChild(i), ctxt));
-                    }
-                    return getSymbolTable().encode(ss.str());
-                }
+                case FunctorOp::CAT:
                 /** Ternary Functor Operators */
                 case FunctorOp::SUBSTR: {
-                    auto symbol = execute(shadow.getChild(0), ctxt);
-                    const std::string& str = getSymbolTable().decode(symbol);
-                    auto idx = execute(shadow.getChild(1), ctxt);
-                    auto len = execute(shadow.getChild(2), ctxt);
-                    std::string sub_str;
-                    try {
-                        sub_str = str.substr(idx, len);
-                    } catch (std::out_of_range&) {
-                        std::cerr << "warning: wrong index position provided by substr(\"";
-                        std::cerr << str << "\"," << (int32_t)idx << "," << (int32_t)len << ") functor.\n";
-                    }
-                    return getSymbolTable().encode(sub_str);
+                    // only the outermost string built is interned
+                    std::string str;
+                    appendString(&shadow, ctxt, str);
+                    return getSymbolTable().encode(str);
                 }
 
                 case FunctorOp::RANGE:
@@ -843,6 +1264,20 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
             if (userFunctor == nullptr) fatal("cannot find user-defined operator `%s`", name);
             std::size_t arity = cur.getNumArgs();
 
+            if (cur.isBatch()) {
+                // in a batch plan, the results for the tuples of the batch are computed ahead of the insert
+                if (const RamDomain* result = ctxt.getFunctorResult(&shadow)) {
+                    return *result;
+                }
+                std::vector<RamDomain> args(arity);
+                for (std::size_t i = 0; i < arity; i++) {
+                    args[i] = execute(shadow.getChild(i), ctxt);
+                }
+                RamDomain result;
+                callBatchFunctor(shadow, 1, args.data(), &result);
+                return result;
+            }
+
             if (cur.isStateful()) {
                 auto exec = std::bind(&Engine::execute, this, std::placeholders::_1, std::placeholders::_2);
 #define CALL_STATEFUL(ARITY) \
@@ -890,15 +1325,30 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #else
                 fatal("unsupported stateful functor arity without libffi support");
 #endif
-            } else {
-                const std::vector<TypeAttribute>& types = cur.getArgsTypes();
-                const auto returnType = cur.getReturnType();
+            }
 
+            const std::vector<TypeAttribute>& types = cur.getArgsTypes();
+            const auto returnType = cur.getReturnType();
+
+            // with --memoise, the arguments are evaluated once to look up the cached result first
+            MemoTable* memo = shadow.getMemo();
+            std::array<RamDomain, MemoisedNode::MaxArity> memoArgs{};
+            if (memo != nullptr) {
+                for (std::size_t i = 0; i < arity; i++) {
+                    memoArgs[i] = execute(shadow.getChild(i), ctxt);
+                }
+                RamDomain result;
+                if (memo->lookup(memoArgs.data(), result)) {
+                    return result;
+                }
+            }
+            auto argument = [&](std::size_t i) {
+                return memo != nullptr ? memoArgs[i] : execute(shadow.getChild(i), ctxt);
+            };
+
+            auto call = [&]() -> RamDomain {
                 if (types.size() <= StatelessFunctorMaxArity) {
-                    auto exec =
-                            std::bind(&Engine::execute, this, std::placeholders::_1, std::placeholders::_2);
-                    return callStateless(
-                            exec, ctxt, shadow, getSymbolTable(), returnType, types, userFunctor);
+                    return callStateless(argument, getSymbolTable(), returnType, types, userFunctor);
                 }
 
 #ifdef USE_LIBFFI
@@ -911,7 +1361,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
                 /* Initialize arguments for ffi-call */
                 for (std::size_t i = 0; i < arity; i++) {
-                    RamDomain arg = execute(shadow.getChild(i), ctxt);
+                    RamDomain arg = argument(i);
                     switch (types[i]) {
                         case TypeAttribute::Symbol:
                             strVal[i] = getSymbolTable().decode(arg).c_str();
@@ -956,8 +1406,13 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #else
                 fatal("unsupported stateless functor arity without libffi support");
 #endif
-            }
+            };
 
+            RamDomain result = call();
+            if (memo != nullptr) {
+                memo->insert(memoArgs.data(), result);
+            }
+            return result;
         ESAC(UserDefinedOperator)
 
         CASE(PackRecord)
@@ -1053,71 +1508,23 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                 COMPARE(GT, >)
                 COMPARE(GE, >=)
 
-                case BinaryConstraintOp::MATCH: {
-                    bool result = false;
-                    RamDomain right = execute(shadow.getRhs(), ctxt);
-                    const std::string& text = getSymbolTable().decode(right);
-
-                    const Node* patternNode = shadow.getLhs();
-                    if (const RegexConstant* regexNode = dynamic_cast<const RegexConstant*>(patternNode);
-                            regexNode) {
-                        const auto& regex = regexNode->getRegex();
-                        if (regex) {
-                            result = std::regex_match(text, *regex);
-                        }
-                    } else {
-                        RamDomain left = execute(patternNode, ctxt);
-                        const std::string& pattern = getSymbolTable().decode(left);
-                        try {
-                            const std::regex& regex = regexCache.getOrCreate(pattern);
-                            result = std::regex_match(text, regex);
-                        } catch (...) {
-                            std::cerr << "warning: wrong pattern provided for match(\"" << pattern << "\",\""
-                                      << text << "\").\n";
-                        }
-                    }
-
-                    return result;
-                }
-                case BinaryConstraintOp::NOT_MATCH: {
-                    bool result = false;
-                    RamDomain right = execute(shadow.getRhs(), ctxt);
-                    const std::string& text = getSymbolTable().decode(right);
-
-                    const Node* patternNode = shadow.getLhs();
-                    if (const RegexConstant* regexNode = dynamic_cast<const RegexConstant*>(patternNode);
-                            regexNode) {
-                        const auto& regex = regexNode->getRegex();
-                        if (regex) {
-                            result = !std::regex_match(text, *regex);
-                        }
-                    } else {
-                        RamDomain left = execute(patternNode, ctxt);
-                        const std::string& pattern = getSymbolTable().decode(left);
-                        try {
-                            const std::regex& regex = regexCache.getOrCreate(pattern);
-                            result = !std::regex_match(text, regex);
-                        } catch (...) {
-                            std::cerr << "warning: wrong pattern provided for !match(\"" << pattern << "\",\""
-                                      << text << "\").\n";
+                case BinaryConstraintOp::MATCH:
+                case BinaryConstraintOp::NOT_MATCH:
+                case BinaryConstraintOp::CONTAINS:
+                case BinaryConstraintOp::NOT_CONTAINS: {
+                    const RamDomain args[] = {execute(shadow.getLhs(), ctxt), execute(shadow.getRhs(), ctxt)};
+                    MemoTable* memo = shadow.getMemo();
+                    RamDomain result;
+                    if (memo == nullptr || !memo->lookup(args, result)) {
+                        // failures of invalid patterns are not memoised, so that each one is reported
+                        bool valid = true;
+                        result = evalStringConstraint(shadow, cur.getOperator(), args[0], args[1], valid);
+                        if (memo != nullptr && valid) {
+                            memo->insert(args, result);
                         }
                     }
                     return result;
                 }
-                case BinaryConstraintOp::CONTAINS: {
-                    RamDomain left = execute(shadow.getLhs(), ctxt);
-                    RamDomain right = execute(shadow.getRhs(), ctxt);
-                    const std::string& pattern = getSymbolTable().decode(left);
-                    const std::string& text = getSymbolTable().decode(right);
-                    return text.find(pattern) != std::string::npos;
-                }
-                case BinaryConstraintOp::NOT_CONTAINS: {
-                    RamDomain left = execute(shadow.getLhs(), ctxt);
-                    RamDomain right = execute(shadow.getRhs(), ctxt);
-                    const std::string& pattern = getSymbolTable().decode(left);
-                    const std::string& text = getSymbolTable().decode(right);
-                    return text.find(pattern) == std::string::npos;
-                }
             }
 
         {UNREACHABLE_BAD_CASE_ANALYSIS}
@@ -1130,16 +1537,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
         CASE(TupleOperation)
             bool result = execute(shadow.getChild(), ctxt);
-
-            auto& currentFrequencies = frequencies[cur.getProfileText()];
-            while (currentFrequencies.size() <= getIterationNumber()) {
-#ifdef _OPENMP
-#pragma omp critical(frequencies)
-#endif
-                currentFrequencies.emplace_back(0);
-            }
-            frequencies[cur.getProfileText()][getIterationNumber()]++;
-
+            frequencyShards.increment(shadow.getFrequencyCounter());
             return result;
         ESAC(TupleOperation)
 
@@ -1282,11 +1680,7 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
             }
 
             if (profileEnabled && frequencyCounterEnabled && !cur.getProfileText().empty()) {
-                auto& currentFrequencies = frequencies[cur.getProfileText()];
-                while (currentFrequencies.size() <= getIterationNumber()) {
-                    currentFrequencies.emplace_back(0);
-                }
-                frequencies[cur.getProfileText()][getIterationNumber()]++;
+                frequencyShards.increment(shadow.getFrequencyCounter());
             }
             return result;
         ESAC(Filter)
@@ -1332,6 +1726,10 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
         CASE(Sequence)
             for (const auto& child : shadow.getChildren()) {
+                // resuming in a loop skips the statements before it
+                if (checkpoint != nullptr && checkpoint->isResuming() && !containsLoop(child.get())) {
+                    continue;
+                }
                 if (!execute(child.get(), ctxt)) {
                     return false;
                 }
@@ -1350,9 +1748,26 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 
         CASE(Loop)
             resetIterationNumber();
+            if (checkpoint != nullptr) {
+                if (!checkpoint->enterLoop()) {
+                    return true;
+                }
+                if (checkpoint->isResumedLoop()) {
+                    iteration = checkpoint->getIteration();
+                    for (const auto& [name, value] : checkpoint->getVariables()) {
+                        ctxt.setVariable(name, value);
+                    }
+                    checkpoint->resume();
+                }
+            }
 
             while (execute(shadow.getChild(), ctxt)) {
                 incIterationNumber();
+                // an evaluation stopping at a checkpoint leaves the rest of the stratum
+                if (checkpoint != nullptr && checkpoint->isDue(getIterationNumber()) &&
+                        checkpoint->save(getIterationNumber(), ctxt.getVariables())) {
+                    return false;
+                }
             }
 
             resetIterationNumber();
@@ -1360,7 +1775,17 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
         ESAC(Loop)
 
         CASE(Exit)
-            return !execute(shadow.getChild(), ctxt);
+            bool condition = execute(shadow.getChild(), ctxt);
+            // workers leave a loop together, once the condition holds for all partitions
+            if (cluster != nullptr) {
+                try {
+                    condition = holdsOnAllWorkers(condition);
+                } catch (std::exception& e) {
+                    std::cerr << "Error exchanging the exit condition: " << e.what() << "\n";
+                    exit(EXIT_FAILURE);
+                }
+            }
+            return !condition;
         ESAC(Exit)
 
         CASE(LogRelationTimer)
@@ -1395,7 +1820,21 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
 #undef ESTIMATEJOINSIZE
 
         CASE(Call)
-            execute(subroutine[shadow.getSubroutineName()].get(), ctxt);
+            if (checkpoint != nullptr && !checkpoint->enterStratum()) {
+                return true;
+            }
+            if (profileEnabled && ProfileEventSingleton::instance().isTracing()) {
+                SpanLogger span("@stratum;" + shadow.getSubroutineName(), getIterationNumber());
+                execute(subroutine[shadow.getSubroutineName()].get(), ctxt);
+            } else {
+                execute(subroutine[shadow.getSubroutineName()].get(), ctxt);
+            }
+            if (compactor != nullptr) {
+                compactTables();
+            }
+            if (checkpoint != nullptr) {
+                checkpoint->leaveStratum();
+            }
             return true;
         ESAC(Call)
 
@@ -1420,17 +1859,70 @@ RamDomain Engine::execute(const Node* node, Context& ctxt) {
                     std::cerr << "Error loading " << rel.getName() << " data: " << e.what() << "\n";
                     exit(EXIT_FAILURE);
                 }
+                // every worker reads all inputs, and keeps its own tuples of partitioned ones
+                if (cluster != nullptr && partitionColumns.count(rel.getName()) > 0) {
+                    splitRelation(rel);
+                }
                 return true;
             } else if (op == "output" || op == "printsize") {
+                // the first worker writes all relations, after collecting the partitioned ones
+                RelationHandle gathered;
+                if (cluster != nullptr && partitionColumns.count(rel.getName()) > 0) {
+                    try {
+                        gathered = gatherRelation(rel);
+                    } catch (std::exception& e) {
+                        std::cerr << "Error gathering " << rel.getName() << ": " << e.what() << "\n";
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                if (clusterRank != 0) {
+                    return true;
+                }
                 try {
                     IOSystem::getInstance()
                             .getWriter(directive, getSymbolTable(), getRecordTable())
-                            ->writeAll(rel);
+                            ->writeAll(gathered != nullptr ? *gathered : rel);
                 } catch (std::exception& e) {
                     std::cerr << e.what();
                     exit(EXIT_FAILURE);
                 }
                 return true;
+            } else if (op == "spill") {
+                try {
+                    IOSystem::getInstance()
+                            .getWriter(directive, getSymbolTable(), getRecordTable())
+                            ->writeAll(rel);
+                } catch (std::exception& e) {
+                    std::cerr << "Error spilling " << rel.getName() << ": " << e.what() << "\n";
+                    exit(EXIT_FAILURE);
+                }
+                rel.purge();
+                return true;
+            } else if (op == "exchange") {
+                const RelationWrapper* known = nullptr;
+                if (directive.count("known") > 0) {
+                    auto knownIndex = relationIndexes.find(cur.get("known"));
+                    if (knownIndex != relationIndexes.end()) {
+                        known = getRelationHandle(knownIndex->second).get();
+                    }
+                }
+                try {
+                    exchangeRelation(rel, known);
+                } catch (std::exception& e) {
+                    std::cerr << "Error exchanging " << rel.getName() << ": " << e.what() << "\n";
+                    exit(EXIT_FAILURE);
+                }
+                return true;
+            } else if (op == "restore") {
+                try {
+                    IOSystem::getInstance()
+                            .getReader(directive, getSymbolTable(), getRecordTable())
+                            ->readAll(rel);
+                } catch (std::exception& e) {
+                    std::cerr << "Error restoring " << rel.getName() << ": " << e.what() << "\n";
+                    exit(EXIT_FAILURE);
+                }
+                return true;
             } else {
                 assert("wrong i/o operation");
                 return true;
@@ -1507,7 +1999,7 @@ RamDomain Engine::evalExistenceCheck(const ExistenceCheck& shadow, Context& ctxt
     std::size_t viewPos = shadow.getViewId();
 
     if (profileEnabled && !shadow.isTemp()) {
-        reads[shadow.getRelationName()]++;
+        reads.increment(shadow.getReadCounter());
     }
 
     const auto& superInfo = shadow.getSuperInst();
@@ -1571,10 +2063,10 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
         high[expr.first] = low[expr.first];
     }
 
-    low[Arity - 2] = MIN_RAM_SIGNED;
-    low[Arity - 1] = MIN_RAM_SIGNED;
-    high[Arity - 2] = MAX_RAM_SIGNED;
-    high[Arity - 1] = MAX_RAM_SIGNED;
+    for (std::size_t i = Arity - Rel::AuxiliaryArity; i < Arity; i++) {
+        low[i] = MIN_RAM_SIGNED;
+        high[i] = MAX_RAM_SIGNED;
+    }
 
     // obtain view
     std::size_t viewPos = shadow.getViewId();
@@ -1587,13 +2079,154 @@ RamDomain Engine::evalProvenanceExistenceCheck(const ProvenanceExistenceCheck& s
         return false;
     }
 
-    // check whether the height is less than the current height
+    // check whether the height is less than the current height; compact annotations hold the height in
+    // their high bits, and are compared against the height with all bits of the rule number set
     return (*equalRange.begin())[Arity - 1] <= execute(shadow.getChild(), ctxt);
 }
 
+void Engine::evalBatch(const BatchPlan& plan, const RamDomain* rows, std::size_t arity, std::size_t count,
+        std::size_t tupleId, Context& ctxt) {
+    std::array<uint32_t, BatchSize> selection;
+    std::iota(selection.begin(), selection.begin() + count, 0);
+    for (const auto& comparison : plan.getComparisons()) {
+        count = selectRows(comparison, rows, arity, selection.data(), count, ctxt);
+        if (count == 0) {
+            return;
+        }
+    }
+    // the remaining conditions and the insert are evaluated tuple at a time
+    const auto& conditions = plan.getConditions();
+    const auto& functors = plan.getFunctors();
+    if (functors.empty()) {
+        for (std::size_t i = 0; i < count; ++i) {
+            ctxt[tupleId] = rows + selection[i] * arity;
+            if (std::all_of(conditions.begin(), conditions.end(),
+                        [&](const Node* condition) { return execute(condition, ctxt); })) {
+                execute(plan.getInsert(), ctxt);
+            }
+        }
+        return;
+    }
+
+    // with batch functors, all tuples are selected before each functor is called once for them
+    std::size_t selected = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        ctxt[tupleId] = rows + selection[i] * arity;
+        selection[selected] = selection[i];
+        selected += std::all_of(conditions.begin(), conditions.end(),
+                [&](const Node* condition) { return execute(condition, ctxt); });
+    }
+    count = selected;
+    if (count == 0) {
+        return;
+    }
+    std::vector<RamDomain> args;
+    std::vector<RamDomain> results(functors.size() * count);
+    for (std::size_t k = 0; k < functors.size(); ++k) {
+        const UserDefinedOperator& functor = *functors[k];
+        const std::size_t functorArity = functor.getChildren().size();
+        args.resize(count * functorArity);
+        for (std::size_t i = 0; i < count; ++i) {
+            ctxt[tupleId] = rows + selection[i] * arity;
+            ctxt.setBatchRow(i);
+            for (std::size_t j = 0; j < functorArity; ++j) {
+                args[i * functorArity + j] = execute(functor.getChild(j), ctxt);
+            }
+        }
+        callBatchFunctor(functor, count, args.data(), &results[k * count]);
+        ctxt.setFunctorResults(&functor, &results[k * count]);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        ctxt[tupleId] = rows + selection[i] * arity;
+        ctxt.setBatchRow(i);
+        execute(plan.getInsert(), ctxt);
+    }
+    ctxt.clearFunctorResults();
+}
+
+bool Engine::isStringBuilder(const Node* node) {
+    if (node->getType() != I_IntrinsicOperator) {
+        return false;
+    }
+    const auto op = as<ram::IntrinsicOperator>(node->getShadow())->getOperator();
+    return op == FunctorOp::CAT || op == FunctorOp::SUBSTR;
+}
+
+void Engine::appendString(const Node* node, Context& ctxt, std::string& out) {
+    if (!isStringBuilder(node)) {
+        out += getSymbolTable().decode(execute(node, ctxt));
+        return;
+    }
+    const auto& builder = *static_cast<const IntrinsicOperator*>(node);
+    if (as<ram::IntrinsicOperator>(node->getShadow())->getOperator() == FunctorOp::CAT) {
+        for (const auto& child : builder.getChildren()) {
+            appendString(child.get(), ctxt, out);
+        }
+        return;
+    }
+
+    // the string of a substring is built only if it has no symbol yet
+    std::string built;
+    const std::string* str = &built;
+    if (isStringBuilder(builder.getChild(0))) {
+        appendString(builder.getChild(0), ctxt, built);
+    } else {
+        str = &getSymbolTable().decode(execute(builder.getChild(0), ctxt));
+    }
+    auto idx = execute(builder.getChild(1), ctxt);
+    auto len = execute(builder.getChild(2), ctxt);
+    try {
+        out.append(*str, idx, len);
+    } catch (std::out_of_range&) {
+        std::cerr << "warning: wrong index position provided by substr(\"";
+        std::cerr << *str << "\"," << (int32_t)idx << "," << (int32_t)len << ") functor.\n";
+    }
+}
+
+void Engine::callBatchFunctor(
+        const UserDefinedOperator& functor, std::size_t count, const RamDomain* args, RamDomain* results) {
+    void* functionPointer = functor.getFunctionPointer();
+    if (as<ram::UserDefinedOperator>(functor.getShadow())->isStateful()) {
+        reinterpret_cast<StatefulBatchFunctor>(functionPointer)(
+                &getSymbolTable(), &getRecordTable(), count, args, results);
+    } else {
+        reinterpret_cast<BatchFunctor>(functionPointer)(count, args, results);
+    }
+}
+
+template <typename Rel, typename Range>
+void Engine::evalBatches(const Range& range, const Scan& shadow, std::size_t tupleId, Context& ctxt) {
+    constexpr std::size_t Arity = Rel::Arity;
+    // tuples are copied, as iterators of some structures do not keep them in place
+    std::array<RamDomain, BatchSize * Arity> rows;
+    std::size_t count = 0;
+    const bool partitioned = shadow.isPartitioned();
+    for (const auto& tuple : range) {
+        if (partitioned && !isOwnTuple(tuple.data(), shadow)) {
+            continue;
+        }
+        std::copy_n(tuple.data(), Arity, &rows[count * Arity]);
+        if (++count == BatchSize) {
+            evalBatch(*shadow.getBatchPlan(), rows.data(), Arity, count, tupleId, ctxt);
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        evalBatch(*shadow.getBatchPlan(), rows.data(), Arity, count, tupleId, ctxt);
+    }
+}
+
 template <typename Rel>
 RamDomain Engine::evalScan(const Rel& rel, const ram::Scan& cur, const Scan& shadow, Context& ctxt) {
+    if (shadow.getBatchPlan() != nullptr) {
+        evalBatches<Rel>(rel.scan(), shadow, cur.getTupleId(), ctxt);
+        return true;
+    }
+    const bool partitioned = shadow.isPartitioned();
     for (const auto& tuple : rel.scan()) {
+        if (partitioned && !isOwnTuple(tuple.data(), shadow)) {
+            continue;
+        }
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
             break;
@@ -1608,6 +2241,7 @@ RamDomain Engine::evalParallelScan(
     auto viewContext = shadow.getViewContext();
 
     auto pStream = rel.partitionScan(numOfThreads * 20);
+    const bool partitioned = shadow.isPartitioned();
 
     PARALLEL_START
         Context newCtxt(ctxt);
@@ -1623,7 +2257,14 @@ RamDomain Engine::evalParallelScan(
 #else
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
 #endif
+            if (shadow.getBatchPlan() != nullptr) {
+                evalBatches<Rel>(*it, shadow, cur.getTupleId(), newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
+                if (partitioned && !isOwnTuple(tuple.data(), shadow)) {
+                    continue;
+                }
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
                     break;
@@ -1683,39 +2324,34 @@ RamDomain Engine::evalEstimateJoinSize(
         keyConstants[inverseOrder[k]] = value;
     }
 
-    // ensure range is non-empty
     auto* index = rel.getIndex(indexPos);
-    // initial values
-    double total = 0;
-    double duplicates = 0;
 
-    if (!index->scan().empty()) {
-        // assign first tuple as prev as a dummy
-        bool first = true;
-        Tuple<RamDomain, Arity> prev = *index->scan().begin();
+    // visit either the whole index or a block sample of it; partitions of brie and eqrel indexes are
+    // aligned with key values, which would bias a block sample, hence they are always scanned completely
+    constexpr bool blockSampling = std::is_base_of_v<Relation<Arity, Rel::AuxiliaryArity, Btree>, Rel> ||
+                                   std::is_base_of_v<Relation<Arity, Rel::AuxiliaryArity, BtreeDelete>, Rel>;
+    std::vector<decltype(index->scan())> chunks;
+    const bool sampled = blockSampling && statisticsSampleSize > 0 && index->size() > statisticsSampleSize;
+    if (sampled) {
+        chunks = index->partitionScan(
+                std::max<std::size_t>(1, statisticsSampleSize / evaluator::joinSizeSampleBlock));
+    } else {
+        chunks.push_back(index->scan());
+    }
 
-        for (const auto& tuple : index->scan()) {
+    auto sample = evaluator::sampleJoinSizeChunks(
+            chunks, sampled ? evaluator::joinSizeSampleBlock : 0, index->size() / chunks.size(),
             // only if every constant matches do we consider the tuple
-            bool matchesConstants = std::all_of(keyConstants.begin(), keyConstants.end(),
-                    [tuple](const auto& p) { return tuple[p.first] == p.second; });
-            if (!matchesConstants) {
-                continue;
-            }
-            if (first) {
-                first = false;
-            } else {
-                // only if on every column do we have a match do we consider it a duplicate
-                bool matchesPrev = std::all_of(keyColumns.begin(), keyColumns.end(),
-                        [&prev, &tuple](std::size_t column) { return tuple[column] == prev[column]; });
-                if (matchesPrev) {
-                    ++duplicates;
-                }
-            }
-            prev = tuple;
-            ++total;
-        }
-    }
-    double joinSize = (onlyConstants ? total : total / std::max(1.0, (total - duplicates)));
+            [&](const auto& tuple) {
+                return std::all_of(keyConstants.begin(), keyConstants.end(),
+                        [&](const auto& p) { return tuple[p.first] == p.second; });
+            },
+            // only if on every column do we have a match do we consider it a duplicate
+            [&](const auto& prev, const auto& tuple) {
+                return std::all_of(keyColumns.begin(), keyColumns.end(),
+                        [&](std::size_t column) { return tuple[column] == prev[column]; });
+            });
+    double joinSize = evaluator::estimateJoinSize(sample, index->size(), onlyConstants);
 
     std::stringstream columnsStream;
     columnsStream << cur.getKeyColumns();
@@ -1760,7 +2396,15 @@ RamDomain Engine::evalIndexScan(const ram::IndexScan& cur, const IndexScan& shad
     std::size_t viewId = shadow.getViewId();
     auto view = Rel::castView(ctxt.getView(viewId));
     // conduct range query
+    if (shadow.getBatchPlan() != nullptr) {
+        evalBatches<Rel>(view->range(low, high), shadow, cur.getTupleId(), ctxt);
+        return true;
+    }
+    const bool partitioned = shadow.isPartitioned();
     for (const auto& tuple : view->range(low, high)) {
+        if (partitioned && !isOwnTuple(tuple.data(), shadow)) {
+            continue;
+        }
         ctxt[cur.getTupleId()] = tuple.data();
         if (!execute(shadow.getNestedOperation(), ctxt)) {
             break;
@@ -1783,6 +2427,7 @@ RamDomain Engine::evalParallelIndexScan(
 
     std::size_t indexPos = shadow.getViewId();
     auto pStream = rel.partitionRange(indexPos, low, high, numOfThreads * 20);
+    const bool partitioned = shadow.isPartitioned();
     PARALLEL_START
         Context newCtxt(ctxt);
         auto viewInfo = viewContext->getViewInfoForNested();
@@ -1797,7 +2442,14 @@ RamDomain Engine::evalParallelIndexScan(
 #else
         pfor(auto it = pStream.begin(); it < pStream.end(); it++) {
 #endif
+            if (shadow.getBatchPlan() != nullptr) {
+                evalBatches<Rel>(*it, shadow, cur.getTupleId(), newCtxt);
+                continue;
+            }
             for (const auto& tuple : *it) {
+                if (partitioned && !isOwnTuple(tuple.data(), shadow)) {
+                    continue;
+                }
                 newCtxt[cur.getTupleId()] = tuple.data();
                 if (!execute(shadow.getNestedOperation(), newCtxt)) {
                     break;
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "Global.h"
+#include "interpreter/Cluster.h"
 #include "interpreter/Context.h"
 #include "interpreter/Generator.h"
 #include "interpreter/Index.h"
@@ -29,15 +30,21 @@
 #include "souffle/SymbolTable.h"
 #include "souffle/datastructure/ConcurrentCache.h"
 #include "souffle/datastructure/RecordTableImpl.h"
+#include "souffle/datastructure/ShardedCounters.h"
 #include "souffle/datastructure/SymbolTableImpl.h"
+#include "souffle/datastructure/TableCompactor.h"
+#include "souffle/io/Checkpoint.h"
 #include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/RegexDfa.h"
 #include <atomic>
 #include <cstddef>
-#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #ifdef _OPENMP
 #include <omp.h>
@@ -59,9 +66,15 @@ class Engine {
 public:
     Engine(ram::TranslationUnit& tUnit, const std::size_t numThreads);
 
+    /** @brief Drop the relations this engine spilled and never restored */
+    ~Engine();
+
     /** @brief Execute the main program */
     void executeMain();
 
+    /** @brief Whether the main program stopped at a checkpoint with --checkpoint-stop */
+    bool stoppedAtCheckpoint() const;
+
     /** @brief Execute the subroutine program */
     void executeSubroutine(
             const std::string& name, const std::vector<RamDomain>& args, std::vector<RamDomain>& ret);
@@ -98,14 +111,74 @@ private:
     void incIterationNumber();
     /** @brief Reset iteration number */
     void resetIterationNumber();
+    /** @brief Return the profile counter of a rule frequency, registering it if needed */
+    std::size_t lookupFrequencyCounter(const std::string& profileText);
+    /** @brief Return the profile counter of a relation's reads, registering it if needed */
+    std::size_t lookupReadCounter(const std::string& relationName);
+    /** @brief Merge the per-thread frequency counters into the current iteration */
+    void mergeFrequencies();
     /** @brief Increment the counter */
     RamDomain incCounter();
     /** @brief Return the relation map. */
     VecOwn<RelationHandle>& getRelationMap();
     /** @brief Create and add relation into the runtime environment.  */
     void createRelation(const ram::Relation& id, const std::size_t idx);
+    /** @brief Return true if a tuple of a partitioned scan belongs to this worker */
+    bool isOwnTuple(const RamDomain* tuple, const Scan& shadow) const;
+    /** @brief Return the worker owning the given values, hashed according to the types of their columns */
+    std::size_t getWorker(const RamDomain* values, const std::vector<char>& columnTypes) const;
+    /** @brief Remove the tuples of other workers from a partitioned relation, serialised per worker */
+    std::vector<std::string> splitRelation(RelationWrapper& rel);
+    /**
+     * @brief Exchange the tuples of a relation with the other workers, and insert the received
+     * ones that are not yet known. Partitioned relations are sent to their owners, replicated
+     * relations to all workers.
+     */
+    void exchangeRelation(RelationWrapper& rel, const RelationWrapper* known);
+    /** @brief Collect the tuples of a partitioned relation of all workers on the first one */
+    RelationHandle gatherRelation(const RelationWrapper& rel);
+    /** @brief Return true if a condition holds on all workers */
+    bool holdsOnAllWorkers(bool condition);
+    /** @brief Append a tuple to a message, symbols by their text */
+    void serialiseTuple(std::string& message, const RamDomain* tuple, const ram::Relation& rel) const;
+    /** @brief Read the tuples of a message and pass them on */
+    void deserialiseTuples(const std::string& message, const ram::Relation& rel,
+            const std::function<void(const RamDomain*)>& consume);
+    /** @brief Return the RAM relation of the given name */
+    const ram::Relation& getRamRelation(const std::string& name) const;
+    /** @brief Free the symbols and records the relations no longer reach */
+    void compactTables();
+    /** @brief Set up checkpoints with --checkpoint, and restore the relations of the last checkpoint */
+    void setupCheckpoint();
+    /** @brief Return true if a node contains a fixpoint loop */
+    static bool containsLoop(const Node* node);
+
+    /**
+     * @brief Evaluate a match or contains constraint on the symbols of its arguments
+     *
+     * A pattern that does not compile is reported on each evaluation, and clears valid
+     * so that the result is not memoised.
+     */
+    bool evalStringConstraint(const Constraint& constraint, BinaryConstraintOp op, RamDomain left,
+            RamDomain right, bool& valid);
+    /** @brief Report the hit rate of the cache of a call site with the profile */
+    void registerMemoTable(const std::string& site, MemoTable& memo);
+
+    /** @brief Return true if a node builds a string by cat or substr */
+    static bool isStringBuilder(const Node* node);
+    /** @brief Append the string of a symbol expression, without interning the strings cat and substr build */
+    void appendString(const Node* node, Context& ctxt, std::string& out);
+    /** @brief Call a batch functor on count rows of arguments */
+    void callBatchFunctor(
+            const UserDefinedOperator& functor, std::size_t count, const RamDomain* args, RamDomain* results);
+    /** @brief Evaluate the filters and the insert of a batch plan on a batch of tuples */
+    void evalBatch(const BatchPlan& plan, const RamDomain* rows, std::size_t arity, std::size_t count,
+            std::size_t tupleId, Context& ctxt);
 
     // -- Defines template for specialized interpreter operation -- */
+    template <typename Rel, typename Range>
+    void evalBatches(const Range& range, const Scan& shadow, std::size_t tupleId, Context& ctxt);
+
     template <typename Rel>
     RamDomain evalExistenceCheck(const ExistenceCheck& shadow, Context& ctxt);
 
@@ -178,8 +251,12 @@ private:
     /** If profile is enable in this program */
     const bool profileEnabled;
     const bool frequencyCounterEnabled;
+    /** Sample size for join size statistics, zero for a full scan */
+    const std::size_t statisticsSampleSize;
     /** subroutines */
     std::map<std::string /*name*/, Own<Node>> subroutine;
+    /** Guards the generation of subroutines */
+    std::mutex subroutineLock;
     /** main program */
     Own<Node> main;
     /** Number of threads enabled for this program */
@@ -188,10 +265,24 @@ private:
     std::atomic<RamDomain> counter{0};
     /** Loop iteration counter */
     std::size_t iteration = 0;
-    /** Profile for rule frequencies */
-    std::map<std::string, std::deque<std::atomic<std::size_t>>> frequencies;
+    /** Profile counters of rule frequencies, indexed by profile text */
+    std::map<std::string, std::size_t> frequencyCounters;
+    /** Per-thread rule frequencies of the current iteration */
+    ShardedCounters frequencyShards;
+    /** Profile for rule frequencies, per counter and iteration */
+    std::vector<std::vector<std::size_t>> frequencies;
+    /** Profile counters of relation reads, indexed by relation name */
+    std::map<std::string, std::size_t> readCounters;
     /** Profile for relation reads */
-    std::map<std::string, std::atomic<std::size_t>> reads;
+    ShardedCounters reads;
+    /** Rank of this worker in a distributed evaluation */
+    const std::size_t clusterRank;
+    /** Number of workers in a distributed evaluation */
+    const std::size_t clusterSize;
+    /** Links to the other workers, once connected */
+    Own<Cluster> cluster;
+    /** Partition column of the relations each worker only holds its own tuples of, by name */
+    std::unordered_map<std::string, std::size_t> partitionColumns;
     /** DLL */
     std::vector<void*> dll;
     /** IndexAnalysis */
@@ -200,10 +291,18 @@ private:
     SpecializedRecordTable<0, 1, 2, 3, 4, 5, 6, 7, 8, 9> recordTable;
     /** Symbol table for relations */
     VecOwn<RelationHandle> relations;
+    /** The index of each relation in the relation map, by name */
+    std::map<std::string, std::size_t> relationIndexes;
     /** Symbol table */
     SymbolTableImpl symbolTable;
-    /** A cache for regexes */
-    ConcurrentCache<std::string, std::regex> regexCache;
+    /** The caches of the call sites with --memoise, by the text of the call site */
+    std::vector<std::pair<std::string, MemoTable*>> memoTables;
+    /** Frees symbols and records between strata with --compact-tables */
+    Own<TableCompactor> compactor;
+    /** Saves and resumes the evaluation with --checkpoint */
+    Own<Checkpoint> checkpoint;
+    /** A cache for the regexes of patterns given by symbols */
+    ConcurrentCache<RamDomain, RegexMatcher> regexCache;
 };
 
 }  // namespace souffle::interpreter
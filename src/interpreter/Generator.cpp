@@ -23,11 +23,31 @@ using NodePtr = Own<Node>;
 using NodePtrVec = std::vector<NodePtr>;
 using RelationHandle = Own<RelationWrapper>;
 
+namespace {
+/** The relation that a relation of a recursive stratum is part of, i.e. its name without @new_ or @delta_ */
+std::string partitionGroup(const std::string& name) {
+    for (const std::string prefix : {"@new_", "@delta_"}) {
+        if (name.rfind(prefix, 0) == 0) {
+            return name.substr(prefix.size());
+        }
+    }
+    return name;
+}
+}  // namespace
+
 NodeGenerator::NodeGenerator(Engine& engine) : engine(engine), global(engine.getGlobal()) {
     visit(engine.tUnit.getProgram(), [&](const ram::Relation& relation) {
         assert(relationMap.find(relation.getName()) == relationMap.end() && "double-naming of relations");
         relationMap[relation.getName()] = &relation;
     });
+    visit(engine.tUnit.getProgram(), [&](const ram::IO& io) {
+        if (io.get("operation") == "exchange") {
+            exchangedRelations.insert(io.getRelation());
+        }
+    });
+    if (engine.clusterSize > 1) {
+        partitionRelations();
+    }
 }
 
 NodePtr NodeGenerator::generateTree(const ram::Node& root) {
@@ -95,7 +115,18 @@ NodePtr NodeGenerator::visit_(type_identity<ram::UserDefinedOperator>, const ram
     /* Resolve functor to actual function pointer now */
     void* functionPointer = engine.getMethodHandle(op.getName());
 
-    auto node = mk<UserDefinedOperator>(I_UserDefinedOperator, &op, std::move(children), functionPointer);
+    Own<MemoTable> memo;
+    if (!op.isStateful() && !op.isBatch() && op.getArguments().size() <= MemoisedNode::MaxArity) {
+        memo = memoise(op, op.getArguments().size());
+    }
+    auto node = mk<UserDefinedOperator>(
+            I_UserDefinedOperator, &op, std::move(children), functionPointer, std::move(memo));
+
+    // batch functors take arrays of RamDomain values, and are called without libffi
+    if (op.isBatch()) {
+        batchFunctors[&op] = node.get();
+        return node;
+    }
 
 #ifdef USE_LIBFFI
     /* Prepare FFI dynamic call structure */
@@ -246,8 +277,12 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ExistenceCheck>, const ram::Exi
     }
     const auto& ramRelation = lookup(exists.getRelation());
     NodeType type = constructNodeType(global, "ExistenceCheck", ramRelation);
+    std::size_t readCounter = 0;
+    if (engine.profileEnabled && !ramRelation.isTemp()) {
+        readCounter = engine.lookupReadCounter(ramRelation.getName());
+    }
     return mk<ExistenceCheck>(type, &exists, isTotal, encodeView(&exists), std::move(superOp),
-            ramRelation.isTemp(), ramRelation.getName());
+            ramRelation.isTemp(), readCounter);
 }
 
 NodePtr NodeGenerator::visit_(
@@ -267,9 +302,8 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Constraint>, const ram::Constra
             if (const StringConstant* str = dynamic_cast<const StringConstant*>(left.get()); str) {
                 const std::string& pattern = engine.getSymbolTable().unsafeDecode(str->getConstant());
                 try {
-                    std::regex regex(pattern);
                     // treat the string constant as a regex
-                    left = mk<RegexConstant>(*str, std::move(regex));
+                    left = mk<RegexConstant>(*str, RegexMatcher(pattern));
                 } catch (const std::exception&) {
                     std::cerr << "warning: wrong pattern provided \"" << pattern << "\"\n";
 
@@ -281,7 +315,15 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Constraint>, const ram::Constra
         default: break;
     }
 
-    return mk<Constraint>(I_Constraint, &relOp, std::move(left), std::move(right));
+    Own<MemoTable> memo;
+    switch (relOp.getOperator()) {
+        case BinaryConstraintOp::MATCH:
+        case BinaryConstraintOp::NOT_MATCH:
+        case BinaryConstraintOp::CONTAINS:
+        case BinaryConstraintOp::NOT_CONTAINS: memo = memoise(relOp, 2); break;
+        default: break;
+    }
+    return mk<Constraint>(I_Constraint, &relOp, std::move(left), std::move(right), std::move(memo));
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::NestedOperation>, const ram::NestedOperation& nested) {
@@ -290,7 +332,8 @@ NodePtr NodeGenerator::visit_(type_identity<ram::NestedOperation>, const ram::Ne
 
 NodePtr NodeGenerator::visit_(type_identity<ram::TupleOperation>, const ram::TupleOperation& search) {
     if (engine.profileEnabled && engine.frequencyCounterEnabled && !search.getProfileText().empty()) {
-        return mk<TupleOperation>(I_TupleOperation, &search, dispatch(search.getOperation()));
+        return mk<TupleOperation>(I_TupleOperation, &search, dispatch(search.getOperation()),
+                engine.lookupFrequencyCounter(search.getProfileText()));
     }
     return dispatch(search.getOperation());
 }
@@ -300,7 +343,9 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Scan>, const ram::Scan& scan) {
     std::size_t relId = encodeRelation(scan.getRelation());
     auto rel = getRelationHandle(relId);
     NodeType type = constructNodeType(global, "Scan", lookup(scan.getRelation()));
-    return mk<Scan>(type, &scan, rel, visit_(type_identity<ram::TupleOperation>(), scan));
+    auto res = mk<Scan>(type, &scan, rel, visit_(type_identity<ram::TupleOperation>(), scan));
+    planBatch(*res, scan);
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::ParallelScan& pScan) {
@@ -310,6 +355,7 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelScan>, const ram::Paral
     NodeType type = constructNodeType(global, "ParallelScan", lookup(pScan.getRelation()));
     auto res = mk<ParallelScan>(type, &pScan, rel, visit_(type_identity<ram::TupleOperation>(), pScan));
     res->setViewContext(parentQueryViewContext);
+    planBatch(*res, pScan);
     return res;
 }
 
@@ -317,8 +363,10 @@ NodePtr NodeGenerator::visit_(type_identity<ram::IndexScan>, const ram::IndexSca
     orderingContext.addTupleWithIndexOrder(iScan.getTupleId(), iScan);
     SuperInstruction indexOperation = getIndexSuperInstInfo(iScan);
     NodeType type = constructNodeType(global, "IndexScan", lookup(iScan.getRelation()));
-    return mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
+    auto res = mk<IndexScan>(type, &iScan, nullptr, visit_(type_identity<ram::TupleOperation>(), iScan),
             encodeView(&iScan), std::move(indexOperation));
+    planBatch(*res, iScan);
+    return res;
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::ParallelIndexScan& piscan) {
@@ -330,6 +378,7 @@ NodePtr NodeGenerator::visit_(type_identity<ram::ParallelIndexScan>, const ram::
     auto res = mk<ParallelIndexScan>(type, &piscan, rel, visit_(type_identity<ram::TupleOperation>(), piscan),
             encodeIndexPos(piscan), std::move(indexOperation));
     res->setViewContext(parentQueryViewContext);
+    planBatch(*res, piscan);
     return res;
 }
 
@@ -489,7 +538,12 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Break>, const ram::Break& break
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::Filter>, const ram::Filter& filter) {
-    return mk<Filter>(I_Filter, &filter, dispatch(filter.getCondition()), dispatch(filter.getOperation()));
+    std::size_t frequencyCounter = 0;
+    if (engine.profileEnabled && engine.frequencyCounterEnabled && !filter.getProfileText().empty()) {
+        frequencyCounter = engine.lookupFrequencyCounter(filter.getProfileText());
+    }
+    return mk<Filter>(I_Filter, &filter, dispatch(filter.getCondition()), dispatch(filter.getOperation()),
+            frequencyCounter);
 }
 
 NodePtr NodeGenerator::visit_(type_identity<ram::GuardedInsert>, const ram::GuardedInsert& guardedInsert) {
@@ -641,7 +695,25 @@ NodePtr NodeGenerator::visit_(type_identity<ram::Query>, const ram::Query& query
     viewContext->isParallel =
             visitExists(*next, [&](const Node& n) { return as<ram::AbstractParallel, AllowCrossCast>(n); });
 
-    auto res = mk<Query>(I_Query, &query, dispatch(*next));
+    auto nested = dispatch(*next);
+
+    // split the outermost scan among the workers of a distributed evaluation, unless
+    // the scanned relation is partitioned and each worker only holds its own tuples
+    if (engine.clusterSize > 1 && isPartitionable(query)) {
+        auto* scan = dynamic_cast<Scan*>(nested.get());
+        if (scan != nullptr) {
+            const auto& rel = lookup(as<ram::RelationOperation>(next)->getRelation());
+            if (engine.partitionColumns.count(rel.getName()) == 0) {
+                std::vector<char> columnTypes;
+                for (const auto& type : rel.getAttributeTypes()) {
+                    columnTypes.push_back(type[0]);
+                }
+                scan->setPartition(std::move(columnTypes));
+            }
+        }
+    }
+
+    auto res = mk<Query>(I_Query, &query, std::move(nested));
     res->setViewContext(parentQueryViewContext);
     return res;
 }
@@ -732,6 +804,223 @@ RelationHandle* NodeGenerator::getRelationHandle(const std::size_t idx) {
     return engine.relations[idx].get();
 }
 
+bool NodeGenerator::isPartitionable(const ram::Query& query) const {
+    if (isLocalCopy(query)) {
+        return false;
+    }
+    bool inserts = false;
+    bool partitionable = true;
+    visit(query, [&](const ram::Insert& insert) {
+        inserts = true;
+        partitionable = partitionable && exchangedRelations.count(insert.getRelation()) > 0;
+    });
+    visit(query, [&](const ram::Erase&) { partitionable = false; });
+    return inserts && partitionable;
+}
+
+bool NodeGenerator::isLocalCopy(const ram::Query& query) const {
+    const auto* scan = as<ram::Scan>(query.getOperation());
+    if (scan == nullptr) {
+        return false;
+    }
+    const auto* insert = as<ram::Insert>(scan->getOperation());
+    return insert != nullptr && partitionGroup(insert->getRelation()) == partitionGroup(scan->getRelation());
+}
+
+void NodeGenerator::partitionRelations() {
+    const ram::Program& program = engine.tUnit.getProgram();
+
+    // columns on which the exchanged relations could be partitioned, grouped with their @new and @delta
+    std::map<std::string, std::set<std::size_t>> candidates;
+    for (const std::string& name : exchangedRelations) {
+        const ram::Relation& rel = *relationMap.at(name);
+        if (rel.getRepresentation() == RelationRepresentation::EQREL ||
+                rel.getRepresentation() == RelationRepresentation::BTREE_DELETE) {
+            continue;
+        }
+        auto& columns = candidates[partitionGroup(name)];
+        for (std::size_t i = 0; i < rel.getArity(); ++i) {
+            columns.insert(i);
+        }
+    }
+
+    // A read of a partitioned relation in the middle of a query only finds the tuples of
+    // this worker. That is all of them if the read binds the partition column to the partition
+    // column of a tuple of another partitioned relation, as that tuple belongs to this worker.
+    struct Binding {
+        std::string group;
+        /** the group and column of the tuple element each bound column is equal to */
+        std::map<std::size_t, std::pair<std::string, std::size_t>> columns;
+    };
+    std::vector<Binding> bindings;
+    std::set<std::string> replicated;
+    using BoundValues = std::vector<std::pair<std::size_t, const ram::Expression*>>;
+
+    visit(program, [&](const ram::Query& query) {
+        const ram::Operation* outer = &query.getOperation();
+        if (const auto* filter = as<ram::Filter>(outer)) {
+            outer = &filter->getOperation();
+        }
+        // queries run redundantly by every worker must see all tuples
+        const bool distributed = isPartitionable(query) || isLocalCopy(query);
+
+        std::map<std::size_t, std::string> tupleGroups;
+        std::set<std::string> scanned;
+        visit(query, [&](const ram::RelationOperation& op) {
+            tupleGroups[op.getTupleId()] = partitionGroup(op.getRelation());
+            scanned.insert(partitionGroup(op.getRelation()));
+        });
+        auto bind = [&](const std::string& relation, const BoundValues& values) {
+            Binding binding{partitionGroup(relation), {}};
+            for (const auto& [column, value] : values) {
+                if (const auto* element = as<ram::TupleElement>(value)) {
+                    auto group = tupleGroups.find(element->getTupleId());
+                    if (group != tupleGroups.end()) {
+                        binding.columns[column] = std::make_pair(group->second, element->getElement());
+                    }
+                }
+            }
+            bindings.push_back(std::move(binding));
+        };
+
+        // tuples missed by the negated checks of derived relations are dropped when exchanged
+        std::set<std::string> targets;
+        visit(query,
+                [&](const ram::Insert& insert) { targets.insert(partitionGroup(insert.getRelation())); });
+        std::set<const ram::ExistenceCheck*> deduplications;
+        visit(query, [&](const ram::Negation& negation) {
+            if (const auto* check = as<ram::ExistenceCheck>(negation.getOperand())) {
+                if (targets.count(partitionGroup(check->getRelation())) > 0 ||
+                        check->getRelation().rfind("@delta_", 0) == 0) {
+                    deduplications.insert(check);
+                }
+            }
+        });
+
+        visit(query, [&](const ram::Node& node) {
+            if (const auto* insert = as<ram::Insert>(node)) {
+                if (!distributed) {
+                    replicated.insert(partitionGroup(insert->getRelation()));
+                }
+            } else if (const auto* scan = as<ram::Scan>(node)) {
+                if (!distributed || scan != outer) {
+                    replicated.insert(partitionGroup(scan->getRelation()));
+                }
+            } else if (const auto* indexScan = as<ram::IndexScan>(node)) {
+                if (!distributed) {
+                    replicated.insert(partitionGroup(indexScan->getRelation()));
+                } else if (indexScan != outer) {
+                    auto [lower, upper] = indexScan->getRangePattern();
+                    BoundValues values;
+                    for (std::size_t i = 0; i < lower.size(); ++i) {
+                        if (!isUndefValue(lower[i]) && *lower[i] == *upper[i]) {
+                            values.emplace_back(i, lower[i]);
+                        }
+                    }
+                    bind(indexScan->getRelation(), values);
+                }
+            } else if (const auto* operation = as<ram::RelationOperation>(node)) {
+                replicated.insert(partitionGroup(operation->getRelation()));
+            } else if (const auto* check = as<ram::ExistenceCheck>(node)) {
+                if (!distributed) {
+                    replicated.insert(partitionGroup(check->getRelation()));
+                } else if (deduplications.count(check) == 0) {
+                    BoundValues values;
+                    const auto checkValues = check->getValues();
+                    for (std::size_t i = 0; i < checkValues.size(); ++i) {
+                        values.emplace_back(i, checkValues[i]);
+                    }
+                    bind(check->getRelation(), values);
+                }
+            } else if (const auto* emptiness = as<ram::EmptinessCheck>(node)) {
+                // only the guards of scanned relations, which find no tuples of an empty partition
+                if (scanned.count(partitionGroup(emptiness->getRelation())) == 0) {
+                    replicated.insert(partitionGroup(emptiness->getRelation()));
+                }
+            } else if (const auto* provenance = as<ram::ProvenanceExistenceCheck>(node)) {
+                replicated.insert(partitionGroup(provenance->getRelation()));
+            } else if (const auto* erase = as<ram::Erase>(node)) {
+                replicated.insert(partitionGroup(erase->getRelation()));
+            }
+        });
+    });
+
+    // sizes are compared by the exit conditions of size-limited relations
+    visit(program,
+            [&](const ram::RelationSize& size) { replicated.insert(partitionGroup(size.getRelation())); });
+    visit(program, [&](const ram::MergeExtend& merge) {
+        replicated.insert(partitionGroup(merge.getFirstRelation()));
+        replicated.insert(partitionGroup(merge.getSecondRelation()));
+    });
+    visit(program, [&](const ram::Swap& swap) {
+        if (partitionGroup(swap.getFirstRelation()) != partitionGroup(swap.getSecondRelation())) {
+            replicated.insert(partitionGroup(swap.getFirstRelation()));
+            replicated.insert(partitionGroup(swap.getSecondRelation()));
+        }
+    });
+
+    for (const std::string& group : replicated) {
+        candidates.erase(group);
+    }
+    for (const Binding& binding : bindings) {
+        auto candidate = candidates.find(binding.group);
+        if (candidate == candidates.end()) {
+            continue;
+        }
+        auto& columns = candidate->second;
+        for (auto column = columns.begin(); column != columns.end();) {
+            column = binding.columns.count(*column) > 0 ? std::next(column) : columns.erase(column);
+        }
+    }
+
+    // Choose the columns most often bound to, and drop the choices that leave a read unbound,
+    // until every read is bound to the partition column of the tuple it depends on.
+    std::map<std::string, std::size_t> partitions;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto candidate = candidates.begin(); candidate != candidates.end();) {
+            candidate = candidate->second.empty() ? candidates.erase(candidate) : std::next(candidate);
+        }
+        std::map<std::string, std::map<std::size_t, std::size_t>> demand;
+        for (const Binding& binding : bindings) {
+            if (candidates.count(binding.group) > 0) {
+                for (const auto& [column, source] : binding.columns) {
+                    ++demand[source.first][source.second];
+                }
+            }
+        }
+        partitions.clear();
+        for (const auto& [group, columns] : candidates) {
+            std::size_t best = *columns.begin();
+            for (std::size_t column : columns) {
+                if (demand[group][column] > demand[group][best]) {
+                    best = column;
+                }
+            }
+            partitions[group] = best;
+        }
+        for (const Binding& binding : bindings) {
+            auto own = partitions.find(binding.group);
+            if (own == partitions.end()) {
+                continue;
+            }
+            const auto& [sourceGroup, sourceColumn] = binding.columns.at(own->second);
+            auto source = partitions.find(sourceGroup);
+            if (source == partitions.end() || source->second != sourceColumn) {
+                changed = candidates[binding.group].erase(own->second) > 0 || changed;
+            }
+        }
+    }
+
+    engine.partitionColumns.clear();
+    for (const auto& [name, rel] : relationMap) {
+        auto partition = partitions.find(partitionGroup(name));
+        if (partition != partitions.end()) {
+            engine.partitionColumns[name] = partition->second;
+        }
+    }
+}
+
 bool NodeGenerator::requireView(const ram::Node* node) {
     if (isA<ram::AbstractExistenceCheck>(node)) {
         return true;
@@ -867,6 +1156,118 @@ SuperInstruction NodeGenerator::getExistenceSuperInstInfo(const ram::AbstractExi
     return superOp;
 }
 
+Own<MemoTable> NodeGenerator::memoise(const ram::Node& site, std::size_t arity) {
+    if (!global.config().has("memoise")) {
+        return nullptr;
+    }
+    auto memo = mk<MemoTable>(arity, MemoisedNode::Capacity, engine.profileEnabled);
+    engine.registerMemoTable(toString(site), *memo);
+    return memo;
+}
+
+void NodeGenerator::planBatch(Scan& scan, const ram::RelationOperation& op) {
+    // frequency counters of the profile count single tuples
+    if (!global.config().has("vectorise") || engine.profileEnabled ||
+            lookup(op.getRelation()).getArity() == 0) {
+        return;
+    }
+
+    // collect the conjunctive terms of the filters down to the insert
+    std::vector<const Node*> terms;
+    std::function<void(const Node*)> addTerms = [&](const Node* cond) {
+        if (cond->getType() == I_Conjunction) {
+            for (const auto& child : static_cast<const Conjunction*>(cond)->getChildren()) {
+                addTerms(child.get());
+            }
+        } else {
+            terms.push_back(cond);
+        }
+    };
+    const Node* nested = scan.getNestedOperation();
+    while (nested->getType() == I_Filter) {
+        const auto* filter = static_cast<const Filter*>(nested);
+        addTerms(filter->getCondition());
+        nested = filter->getNestedOperation();
+    }
+    const auto* insert = as<ram::Insert>(nested->getShadow());
+    if (insert == nullptr || isA<ram::GuardedInsert>(insert) || insert->getRelation() == op.getRelation()) {
+        return;
+    }
+
+    auto getOperand = [&](const Node* node, BatchPlan::Operand& operand) {
+        switch (node->getType()) {
+            case I_TupleElement: {
+                const auto* element = static_cast<const TupleElement*>(node);
+                const bool scanned = element->getTupleId() == op.getTupleId();
+                operand.kind = scanned ? BatchPlan::Operand::Column : BatchPlan::Operand::Element;
+                operand.tupleId = element->getTupleId();
+                operand.element = element->getElement();
+                return true;
+            }
+            case I_NumericConstant:
+                operand.constant = as<ram::NumericConstant>(node->getShadow())->getConstant();
+                return true;
+            case I_StringConstant:
+                operand.constant =
+                        static_cast<RamDomain>(static_cast<const StringConstant*>(node)->getConstant());
+                return true;
+            default: return false;
+        }
+    };
+
+    // the batch functors of the values inserted, callees before callers, if they can be called after
+    // evaluating the conditions of all tuples of a batch
+    std::vector<const UserDefinedOperator*> functors;
+    bool readsInserted = false;
+    for (const Node* term : terms) {
+        visit(*term->getShadow(), [&](const ram::Node& node) {
+            if (const auto* search = as<ram::RelationOperation>(node)) {
+                readsInserted |= search->getRelation() == insert->getRelation();
+            } else if (const auto* exists = as<ram::AbstractExistenceCheck>(node)) {
+                readsInserted |= exists->getRelation() == insert->getRelation();
+            } else if (const auto* emptiness = as<ram::EmptinessCheck>(node)) {
+                readsInserted |= emptiness->getRelation() == insert->getRelation();
+            }
+        });
+    }
+    std::function<void(const ram::Node&)> addFunctors = [&](const ram::Node& node) {
+        for (const ram::Node& child : node.getChildNodes()) {
+            addFunctors(child);
+        }
+        if (const auto* udf = as<ram::UserDefinedOperator>(node); udf != nullptr && udf->isBatch()) {
+            functors.push_back(batchFunctors.at(udf));
+        }
+    };
+    if (!readsInserted) {
+        for (const auto& value : insert->getValues()) {
+            addFunctors(*value);
+        }
+    }
+
+    std::vector<BatchPlan::Comparison> comparisons;
+    std::vector<const Node*> conditions;
+    for (const Node* term : terms) {
+        if (term->getType() == I_Constraint) {
+            const auto* constraint = static_cast<const Constraint*>(term);
+            BatchPlan::Comparison comparison{as<ram::Constraint>(term->getShadow())->getOperator(), {}, {}};
+            // orderings of symbols and string matching need the symbol table
+            const bool numeric = isIndexableConstraint(comparison.op) ||
+                                 comparison.op == BinaryConstraintOp::NE ||
+                                 comparison.op == BinaryConstraintOp::FNE;
+            if (numeric && getOperand(constraint->getLhs(), comparison.lhs) &&
+                    getOperand(constraint->getRhs(), comparison.rhs) &&
+                    (comparison.lhs.kind == BatchPlan::Operand::Column ||
+                            comparison.rhs.kind == BatchPlan::Operand::Column)) {
+                comparisons.push_back(comparison);
+                continue;
+            }
+        }
+        conditions.push_back(term);
+    }
+    scan.setBatchPlan(
+            mk<BatchPlan>(std::move(comparisons), std::move(conditions), nested, std::move(functors)));
+}
+
 SuperInstruction NodeGenerator::getInsertSuperInstInfo(const ram::Insert& exist) {
     std::size_t arity = getArity(exist.getRelation());
     SuperInstruction superOp(arity);
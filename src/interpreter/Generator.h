@@ -34,12 +34,14 @@
 #include "ram/Constraint.h"
 #include "ram/DebugInfo.h"
 #include "ram/EmptinessCheck.h"
+#include "ram/Erase.h"
 #include "ram/EstimateJoinSize.h"
 #include "ram/ExistenceCheck.h"
 #include "ram/Exit.h"
 #include "ram/Expression.h"
 #include "ram/False.h"
 #include "ram/Filter.h"
+#include "ram/GuardedInsert.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
@@ -71,6 +73,7 @@
 #include "ram/ProvenanceExistenceCheck.h"
 #include "ram/Query.h"
 #include "ram/Relation.h"
+#include "ram/RelationOperation.h"
 #include "ram/RelationSize.h"
 #include "ram/Scan.h"
 #include "ram/Sequence.h"
@@ -94,13 +97,16 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -322,6 +328,33 @@ private:
      */
     bool requireView(const ram::Node* node);
 
+    /**
+     * Return true if the work of a query may be split among the workers of a
+     * distributed evaluation, i.e. it only inserts into exchanged relations.
+     */
+    bool isPartitionable(const ram::Query& query) const;
+
+    /** Return true if a query copies a relation into its @new or @delta relation, or back */
+    bool isLocalCopy(const ram::Query& query) const;
+
+    /**
+     * Choose the relations of a distributed evaluation that are hash-partitioned among the
+     * workers, and the column they are partitioned on. All other relations are replicated.
+     */
+    void partitionRelations();
+
+    /**
+     * Let the scan evaluate a batch of tuples at a time with --vectorise, if its
+     * nested operation is a chain of filters ending in an insert.
+     */
+    void planBatch(Scan& scan, const ram::RelationOperation& op);
+
+    /**
+     * Return a cache for the results of a pure call site with --memoise, or
+     * nullptr otherwise.
+     */
+    Own<MemoTable> memoise(const ram::Node& site, std::size_t arity);
+
     /**
      * @brief Return the associated relation of a operation which requires a view.
      * This function assume the operation does requires a view.
@@ -366,6 +399,10 @@ private:
     std::unordered_map<std::string, std::size_t> relTable;
     /** name / relation mapping */
     std::unordered_map<std::string, const ram::Relation*> relationMap;
+    /** Nodes of the calls of batch functors */
+    std::unordered_map<const ram::Node*, const UserDefinedOperator*> batchFunctors;
+    /** Relations whose tuples are exchanged between the workers of a distributed evaluation */
+    std::unordered_set<std::string> exchangedRelations;
     /** ordering context */
     OrderingContext orderingContext = OrderingContext(*this);
     /** Reference to the engine instance */
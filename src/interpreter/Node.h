@@ -25,9 +25,12 @@
 
 #include "interpreter/Util.h"
 #include "ram/Relation.h"
+#include "souffle/BinaryConstraintOps.h"
 #include "souffle/RamTypes.h"
+#include "souffle/datastructure/MemoTable.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/RegexDfa.h"
 
 #ifdef USE_LIBFFI
 #include <ffi.h>
@@ -150,7 +153,7 @@ inline NodeType constructNodeType(Global&, std::string tokBase, const ram::Relat
 
     std::string arity = std::to_string(rel.getArity());
     std::string auxiliaryArity = std::to_string(rel.getAuxiliaryArity());
-    bool hasProvenance = rel.getArity() > 0 && rel.getAttributeNames().back() == "@level_number";
+    bool hasProvenance = rel.hasProvenance();
     if (hasProvenance) {
         return map.at("I_" + tokBase + "_Provenance_" + arity + "_" + auxiliaryArity);
     } else if (rel.getRepresentation() == RelationRepresentation::EQREL) {
@@ -455,15 +458,15 @@ private:
  */
 class RegexConstant : public StringConstant {
 public:
-    RegexConstant(const StringConstant& c, std::optional<std::regex> r)
+    RegexConstant(const StringConstant& c, std::optional<RegexMatcher> r)
             : StringConstant(c.getType(), c.getShadow(), c.getConstant()), regex(std::move(r)) {}
 
-    inline const std::optional<std::regex>& getRegex() const {
+    inline const std::optional<RegexMatcher>& getRegex() const {
         return regex;
     }
 
 private:
-    const std::optional<std::regex> regex;
+    const std::optional<RegexMatcher> regex;
 };
 
 /**
@@ -532,13 +535,38 @@ private:
 #endif
 };
 
+/**
+ * @class MemoisedNode
+ * @brief A call site of a pure function whose results may be cached with --memoise
+ */
+class MemoisedNode {
+public:
+    /** The number of results cached per call site */
+    static constexpr std::size_t Capacity = 4096;
+
+    /** The maximal number of arguments of a cached call */
+    static constexpr std::size_t MaxArity = 16;
+
+    MemoisedNode(Own<MemoTable> memo) : memo(std::move(memo)) {}
+
+    /** @brief get the cache of the call site, or nullptr */
+    MemoTable* getMemo() const {
+        return memo.get();
+    }
+
+private:
+    Own<MemoTable> memo;
+};
+
 /**
  * @class UserDefinedOperator
  */
-class UserDefinedOperator : public CompoundNode, public FunctorNode {
+class UserDefinedOperator : public CompoundNode, public FunctorNode, public MemoisedNode {
 public:
-    UserDefinedOperator(NodeType ty, const ram::Node* sdw, VecOwn<Node> children, void* functionPointer)
-            : CompoundNode(ty, sdw, std::move(children)), FunctorNode(functionPointer) {}
+    UserDefinedOperator(NodeType ty, const ram::Node* sdw, VecOwn<Node> children, void* functionPointer,
+            Own<MemoTable> memo = nullptr)
+            : CompoundNode(ty, sdw, std::move(children)), FunctorNode(functionPointer),
+              MemoisedNode(std::move(memo)) {}
 };
 
 /**
@@ -617,9 +645,9 @@ public:
 class ExistenceCheck : public Node, public SuperOperation, public ViewOperation {
 public:
     ExistenceCheck(enum NodeType ty, const ram::Node* sdw, bool totalSearch, std::size_t viewId,
-            SuperInstruction superInst, bool tempRelation, std::string relationName)
+            SuperInstruction superInst, bool tempRelation, std::size_t readCounter)
             : Node(ty, sdw), SuperOperation(std::move(superInst)), ViewOperation(viewId),
-              totalSearch(totalSearch), tempRelation(tempRelation), relationName(std::move(relationName)) {}
+              totalSearch(totalSearch), tempRelation(tempRelation), readCounter(readCounter) {}
 
     bool isTotalSearch() const {
         return totalSearch;
@@ -629,14 +657,15 @@ public:
         return tempRelation;
     }
 
-    const std::string& getRelationName() const {
-        return relationName;
+    /** Profile counter of the relation reads */
+    std::size_t getReadCounter() const {
+        return readCounter;
     }
 
 private:
     const bool totalSearch;
     const bool tempRelation;
-    const std::string relationName;
+    const std::size_t readCounter;
 };
 
 /**
@@ -653,15 +682,89 @@ public:
 /**
  * @class Constraint
  */
-class Constraint : public BinaryNode {
-    using BinaryNode::BinaryNode;
+class Constraint : public BinaryNode, public MemoisedNode {
+public:
+    Constraint(enum NodeType ty, const ram::Node* sdw, Own<Node> lhs, Own<Node> rhs,
+            Own<MemoTable> memo = nullptr)
+            : BinaryNode(ty, sdw, std::move(lhs), std::move(rhs)), MemoisedNode(std::move(memo)) {}
 };
 
 /**
  * @class TupleOperation
  */
 class TupleOperation : public UnaryNode {
-    using UnaryNode::UnaryNode;
+public:
+    TupleOperation(enum NodeType ty, const ram::Node* sdw, Own<Node> child, std::size_t frequencyCounter)
+            : UnaryNode(ty, sdw, std::move(child)), frequencyCounter(frequencyCounter) {}
+
+    /** Profile counter of the rule frequency */
+    std::size_t getFrequencyCounter() const {
+        return frequencyCounter;
+    }
+
+private:
+    const std::size_t frequencyCounter;
+};
+
+/**
+ * @class BatchPlan
+ * @brief Plan of a scan whose nested operation is a chain of filters ending in an
+ *        insert, so that the scan can be evaluated a batch of tuples at a time.
+ *
+ * Comparisons of the scanned tuple are evaluated over the whole batch, narrowing
+ * a selection vector. Conditions of any other shape are evaluated tuple by tuple
+ * on the remaining selection, and the insert is then executed for each selected
+ * tuple in turn. Batch functors of the inserted values are called once for all
+ * selected tuples, before the inserts.
+ */
+class BatchPlan {
+public:
+    /** An operand of a comparison that is fixed while the scan runs, or a column of the scanned tuple */
+    struct Operand {
+        enum Kind { Column, Element, Constant } kind = Constant;
+        /** tuple of an element of an enclosing operation */
+        std::size_t tupleId = 0;
+        /** column of the scanned tuple, or element of the enclosing tuple */
+        std::size_t element = 0;
+        RamDomain constant = 0;
+    };
+
+    /** A comparison with at least one column of the scanned tuple as operand */
+    struct Comparison {
+        BinaryConstraintOp op;
+        Operand lhs;
+        Operand rhs;
+    };
+
+    BatchPlan(std::vector<Comparison> comparisons, std::vector<const Node*> conditions, const Node* insert,
+            std::vector<const UserDefinedOperator*> functors = {})
+            : comparisons(std::move(comparisons)), conditions(std::move(conditions)), insert(insert),
+              functors(std::move(functors)) {}
+
+    const std::vector<Comparison>& getComparisons() const {
+        return comparisons;
+    }
+
+    /** Conditions evaluated tuple by tuple, owned by the filters of the scan */
+    const std::vector<const Node*>& getConditions() const {
+        return conditions;
+    }
+
+    /** The insert ending the nested operation, owned by the scan */
+    const Node* getInsert() const {
+        return insert;
+    }
+
+    /** Calls of batch functors in the values inserted, with the calls in their arguments first */
+    const std::vector<const UserDefinedOperator*>& getFunctors() const {
+        return functors;
+    }
+
+private:
+    const std::vector<Comparison> comparisons;
+    const std::vector<const Node*> conditions;
+    const Node* const insert;
+    const std::vector<const UserDefinedOperator*> functors;
 };
 
 /**
@@ -671,6 +774,38 @@ class Scan : public Node, public NestedOperation, public RelationalOperation {
 public:
     Scan(enum NodeType ty, const ram::Node* sdw, RelationHandle* relHandle, Own<Node> nested)
             : Node(ty, sdw), NestedOperation(std::move(nested)), RelationalOperation(relHandle) {}
+
+    /**
+     * Restrict the scan to the partition of the tuples owned by this worker of
+     * a distributed evaluation. The type of each column selects how it is hashed.
+     */
+    void setPartition(std::vector<char> columnTypes) {
+        partitionColumns = std::move(columnTypes);
+    }
+
+    /** Whether the scan only visits the tuples of this worker */
+    bool isPartitioned() const {
+        return !partitionColumns.empty();
+    }
+
+    /** Types of the columns hashed to find the owner of a tuple */
+    const std::vector<char>& getPartitionColumns() const {
+        return partitionColumns;
+    }
+
+    /** Evaluate the scan a batch of tuples at a time */
+    void setBatchPlan(Own<BatchPlan> plan) {
+        batchPlan = std::move(plan);
+    }
+
+    /** The batch plan of the scan, or nullptr if it is evaluated tuple at a time */
+    const BatchPlan* getBatchPlan() const {
+        return batchPlan.get();
+    }
+
+private:
+    std::vector<char> partitionColumns;
+    Own<BatchPlan> batchPlan;
 };
 
 /**
@@ -823,8 +958,18 @@ public:
  */
 class Filter : public Node, public ConditionalOperation, public NestedOperation {
 public:
-    Filter(enum NodeType ty, const ram::Node* sdw, Own<Node> cond, Own<Node> nested)
-            : Node(ty, sdw), ConditionalOperation(std::move(cond)), NestedOperation(std::move(nested)) {}
+    Filter(enum NodeType ty, const ram::Node* sdw, Own<Node> cond, Own<Node> nested,
+            std::size_t frequencyCounter)
+            : Node(ty, sdw), ConditionalOperation(std::move(cond)), NestedOperation(std::move(nested)),
+              frequencyCounter(frequencyCounter) {}
+
+    /** Profile counter of the rule frequency */
+    std::size_t getFrequencyCounter() const {
+        return frequencyCounter;
+    }
+
+private:
+    const std::size_t frequencyCounter;
 };
 
 /**
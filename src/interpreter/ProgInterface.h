@@ -29,9 +29,12 @@
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolTable.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/ParallelUtil.h"
+#include "souffle/utility/span.h"
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -58,6 +61,104 @@ public:
         relation.insert(t.data);
     }
 
+    /** Insert a block of row-major tuples */
+    void insertRows(span<const RamDomain> rows, bool parallel = false) override {
+        const std::size_t arity = getArity();
+        if (arity == 0) {
+            souffle::Relation::insertRows(rows, parallel);
+            return;
+        }
+        assert(rows.size() % arity == 0 && "row data is not a multiple of the arity");
+        const std::size_t numRows = rows.size() / arity;
+        const RamDomain* data = rows.data();
+        if (!parallel) {
+            for (std::size_t row = 0; row < numRows; ++row) {
+                relation.insert(data + row * arity);
+            }
+            return;
+        }
+        PARALLEL_START
+        pfor(std::size_t row = 0; row < numRows; ++row) {
+            relation.insert(data + row * arity);
+        }
+        PARALLEL_END
+    }
+
+    /** Visit tuples as blocks of row-major data */
+    void forEachRowBlock(std::size_t blockSize,
+            const std::function<void(span<const RamDomain>)>& visitor) const override {
+        const std::size_t arity = getArity();
+        assert(blockSize > 0 && "empty block size");
+        if (arity == 0) {
+            return;
+        }
+        std::vector<RamDomain> block;
+        block.reserve(blockSize * arity);
+        for (auto it = relation.begin(), end = relation.end(); it != end; ++it) {
+            const RamDomain* value = *it;
+            block.insert(block.end(), value, value + arity);
+            if (block.size() == blockSize * arity) {
+                visitor(span<const RamDomain>(block.data(), block.size()));
+                block.clear();
+            }
+        }
+        if (!block.empty()) {
+            visitor(span<const RamDomain>(block.data(), block.size()));
+        }
+    }
+
+    /** Visit the tuples between bounds as blocks of row-major data, searching the best index */
+    void forEachRowBlockInRange(span<const RamDomain> lower, span<const RamDomain> upper,
+            std::size_t blockSize, const std::function<void(span<const RamDomain>)>& visitor) const override {
+        const std::size_t arity = getArity();
+        assert(lower.size() == arity && upper.size() == arity && "bounds do not match the arity");
+        assert(blockSize > 0 && "empty block size");
+        if (arity == 0) {
+            return;
+        }
+
+        // the index with the longest prefix of fixed attributes; indexes compare attributes as
+        // signed numbers, so the attributes that are not fixed are left open
+        std::vector<RamDomain> low(arity, MIN_RAM_SIGNED);
+        std::vector<RamDomain> high(arity, MAX_RAM_SIGNED);
+        std::size_t best = 0;
+        std::size_t bestFixed = 0;
+        for (std::size_t i = 0; i < relation.getIndexCount(); ++i) {
+            const Order order = relation.getIndexOrder(i);
+            std::size_t fixed = 0;
+            while (fixed < order.size() && lower[order[fixed]] == upper[order[fixed]]) {
+                ++fixed;
+            }
+            if (fixed > bestFixed) {
+                best = i;
+                bestFixed = fixed;
+            }
+        }
+        const Order order = relation.getIndexOrder(best);
+        for (std::size_t i = 0; i < bestFixed; ++i) {
+            low[order[i]] = lower[order[i]];
+            high[order[i]] = upper[order[i]];
+        }
+
+        std::vector<RamDomain> block;
+        block.reserve(blockSize * arity);
+        auto [it, end] = relation.indexRange(best, low.data(), high.data());
+        for (; it != end; ++it) {
+            const RamDomain* value = *it;
+            if (!isRowInRange(value, lower.data(), upper.data())) {
+                continue;
+            }
+            block.insert(block.end(), value, value + arity);
+            if (block.size() == blockSize * arity) {
+                visitor(span<const RamDomain>(block.data(), block.size()));
+                block.clear();
+            }
+        }
+        if (!block.empty()) {
+            visitor(span<const RamDomain>(block.data(), block.size()));
+        }
+    }
+
     /** Check whether tuple exists */
     bool contains(const tuple& t) const override {
         return relation.contains(t.data);
@@ -136,6 +136,18 @@ public:
      */
     virtual Order getIndexOrder(std::size_t) const = 0;
 
+    /**
+     * Return the number of indexes.
+     */
+    virtual std::size_t getIndexCount() const = 0;
+
+    /**
+     * Obtains the iterators covering the interval between the two given
+     * entries of an index, given in the order of the attributes.
+     */
+    virtual std::pair<Iterator, Iterator> indexRange(
+            std::size_t indexPos, const RamDomain* low, const RamDomain* high) const = 0;
+
     /**
      * Obtains a view on an index of this relation, facilitating hint-supported accesses.
      *
@@ -236,6 +248,10 @@ public:
         return indexes[idx]->getOrder();
     }
 
+    std::size_t getIndexCount() const override {
+        return indexes.size();
+    }
+
     class iterator_base : public RelationWrapper::iterator_base {
         iterator iter;
         Order order;
@@ -279,6 +295,15 @@ public:
         return Iterator(new iterator_base(main->end(), main->getOrder()));
     }
 
+    std::pair<Iterator, Iterator> indexRange(
+            std::size_t indexPos, const RamDomain* low, const RamDomain* high) const override {
+        const Index& index = *indexes[indexPos];
+        const Order order = index.getOrder();
+        auto range = index.range(order.encode(constructTuple(low)), order.encode(constructTuple(high)));
+        return {Iterator(new iterator_base(range.begin(), order)),
+                Iterator(new iterator_base(range.end(), order))};
+    }
+
     // -----
     // Following section defines and implement interfaces for interpreter execution.
     //
@@ -49,7 +49,28 @@ namespace souffle::interpreter {
     func(Provenance, 19, 2, __VA_ARGS__)  \
     func(Provenance, 20, 2, __VA_ARGS__)  \
     func(Provenance, 21, 2, __VA_ARGS__)  \
-    func(Provenance, 22, 2, __VA_ARGS__)
+    func(Provenance, 22, 2, __VA_ARGS__)  \
+    func(Provenance, 1, 1, __VA_ARGS__)   \
+    func(Provenance, 2, 1, __VA_ARGS__)   \
+    func(Provenance, 3, 1, __VA_ARGS__)   \
+    func(Provenance, 4, 1, __VA_ARGS__)   \
+    func(Provenance, 5, 1, __VA_ARGS__)   \
+    func(Provenance, 6, 1, __VA_ARGS__)   \
+    func(Provenance, 7, 1, __VA_ARGS__)   \
+    func(Provenance, 8, 1, __VA_ARGS__)   \
+    func(Provenance, 9, 1, __VA_ARGS__)   \
+    func(Provenance, 10, 1, __VA_ARGS__)  \
+    func(Provenance, 11, 1, __VA_ARGS__)  \
+    func(Provenance, 12, 1, __VA_ARGS__)  \
+    func(Provenance, 13, 1, __VA_ARGS__)  \
+    func(Provenance, 14, 1, __VA_ARGS__)  \
+    func(Provenance, 15, 1, __VA_ARGS__)  \
+    func(Provenance, 16, 1, __VA_ARGS__)  \
+    func(Provenance, 17, 1, __VA_ARGS__)  \
+    func(Provenance, 18, 1, __VA_ARGS__)  \
+    func(Provenance, 19, 1, __VA_ARGS__)  \
+    func(Provenance, 20, 1, __VA_ARGS__)  \
+    func(Provenance, 21, 1, __VA_ARGS__)
 
 #define FOR_EACH_BTREE(func, ...)\
     func(Btree, 0, 0, __VA_ARGS__) \
@@ -268,14 +289,23 @@ struct Updater {
 template <std::size_t Arity, std::size_t AuxiliaryArity>
 struct ProvenanceUpdater {
     bool update(t_tuple<Arity>& old_t, const t_tuple<Arity>& new_t) {
-        constexpr std::size_t level = Arity - 1;
-        constexpr std::size_t rule = Arity - 2;
-        if (ramBitCast<RamSigned>(new_t[level]) < ramBitCast<RamSigned>(old_t[level]) ||
-                (ramBitCast<RamSigned>(new_t[level]) == ramBitCast<RamSigned>(old_t[level]) &&
-                        ramBitCast<RamSigned>(new_t[rule]) < ramBitCast<RamSigned>(old_t[rule]))) {
-            old_t[level] = new_t[level];
-            old_t[rule] = new_t[rule];
-            return true;
+        if constexpr (AuxiliaryArity == 1) {
+            // a compact annotation holds the level number above the rule number
+            constexpr std::size_t annotation = Arity - 1;
+            if (ramBitCast<RamSigned>(new_t[annotation]) < ramBitCast<RamSigned>(old_t[annotation])) {
+                old_t[annotation] = new_t[annotation];
+                return true;
+            }
+        } else {
+            constexpr std::size_t level = Arity - 1;
+            constexpr std::size_t rule = Arity - 2;
+            if (ramBitCast<RamSigned>(new_t[level]) < ramBitCast<RamSigned>(old_t[level]) ||
+                    (ramBitCast<RamSigned>(new_t[level]) == ramBitCast<RamSigned>(old_t[level]) &&
+                            ramBitCast<RamSigned>(new_t[rule]) < ramBitCast<RamSigned>(old_t[rule]))) {
+                old_t[level] = new_t[level];
+                old_t[rule] = new_t[rule];
+                return true;
+            }
         }
         return false;
     }
@@ -283,13 +313,13 @@ struct ProvenanceUpdater {
 
 // Alias for btree_set
 template <std::size_t Arity, std::size_t AuxiliaryArity>
-using Btree = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t_tuple<Arity>>, 256,
+using Btree = btree_set<t_tuple<Arity>, comparator<Arity>, ArenaAllocator<t_tuple<Arity>>, 256,
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - AuxiliaryArity>,
         Updater<Arity, AuxiliaryArity>>;
 
 // Alias for btree_delete_set
 template <std::size_t Arity, std::size_t AuxiliaryArity>
-using BtreeDelete = btree_delete_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t_tuple<Arity>>, 256,
+using BtreeDelete = btree_delete_set<t_tuple<Arity>, comparator<Arity>, ArenaAllocator<t_tuple<Arity>>, 256,
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - AuxiliaryArity>,
         Updater<Arity, AuxiliaryArity>>;
 
@@ -298,7 +328,7 @@ template <std::size_t Arity, std::size_t AuxiliaryArity>
 using Brie = Trie<Arity>;
 
 template <std::size_t Arity, std::size_t AuxiliaryArity>
-using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, std::allocator<t_tuple<Arity>>, 256,
+using Provenance = btree_set<t_tuple<Arity>, comparator<Arity>, ArenaAllocator<t_tuple<Arity>>, 256,
         typename detail::default_strategy<t_tuple<Arity>>::type, comparator<Arity - AuxiliaryArity>,
         ProvenanceUpdater<Arity, AuxiliaryArity>>;
 
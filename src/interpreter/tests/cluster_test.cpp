@@ -0,0 +1,100 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file cluster_test.cpp
+ *
+ * Tests the communication between the workers of a cluster
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "interpreter/Cluster.h"
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace souffle::interpreter::test {
+
+TEST(Cluster, SingleWorker) {
+    VecOwn<Transport> links(1);
+    Cluster cluster(0, std::move(links));
+    EXPECT_EQ(cluster.getSize(), 1);
+    auto messages = cluster.allGather("alone");
+    EXPECT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0], "alone");
+}
+
+#ifndef _MSC_VER
+/** Exchange messages larger than socket buffers between forked workers, to all and to each */
+TEST(Cluster, AllGather) {
+    const std::size_t numWorkers = 4;
+    std::vector<std::string> endpoints;
+    for (std::size_t i = 0; i < numWorkers; ++i) {
+        endpoints.push_back("unix:/tmp/souffle-cluster-test-" + std::to_string(getpid()) + "-" +
+                            std::to_string(i));
+    }
+    auto messageOf = [](std::size_t rank, std::size_t round) {
+        return std::string((rank + 1) * 300000 + round, static_cast<char>('a' + rank));
+    };
+    auto messageBetween = [](std::size_t from, std::size_t to) {
+        return std::string(from * 200000 + to, static_cast<char>('a' + to));
+    };
+
+    // every worker checks what it received, workers other than the first report by exit code
+    auto run = [&](std::size_t rank) {
+        auto cluster = Cluster::connect(rank, endpoints, 10);
+        bool ok = cluster->getSize() == numWorkers && cluster->getRank() == rank;
+        for (std::size_t round = 0; round < 3; ++round) {
+            auto messages = cluster->allGather(messageOf(rank, round));
+            for (std::size_t peer = 0; peer < numWorkers; ++peer) {
+                ok = ok && messages.at(peer) == messageOf(peer, round);
+            }
+        }
+        std::vector<std::string> outgoing;
+        for (std::size_t peer = 0; peer < numWorkers; ++peer) {
+            outgoing.push_back(messageBetween(rank, peer));
+        }
+        auto incoming = cluster->allToAll(std::move(outgoing));
+        for (std::size_t peer = 0; peer < numWorkers; ++peer) {
+            ok = ok && incoming.at(peer) == messageBetween(peer, rank);
+        }
+        return ok;
+    };
+
+    std::vector<pid_t> children;
+    for (std::size_t rank = 1; rank < numWorkers; ++rank) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            bool ok = false;
+            try {
+                ok = run(rank);
+            } catch (...) {
+            }
+            _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        children.push_back(pid);
+    }
+    EXPECT_TRUE(run(0));
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS);
+    }
+}
+#endif
+
+}  // namespace souffle::interpreter::test
@@ -625,4 +625,73 @@ meow	-3	3	0.5
     std::cin.rdbuf(backupCin);
 }
 
+TEST(IO_spill, Restore) {
+    std::streambuf* backupCin = std::cin.rdbuf();
+    std::istringstream testInput("5\t3\n1\t2\n");
+    std::cin.rdbuf(testInput.rdbuf());
+
+    Global glb;
+    glb.config().set("jobs", "1");
+
+    VecOwn<ram::Relation> rels;
+
+    std::vector<std::string> attribs = {"a", "b"};
+    std::vector<std::string> attribsTypes = {"i", "i"};
+    Own<ram::Relation> myrel =
+            mk<ram::Relation>("test", 2, 0, attribs, attribsTypes, RelationRepresentation::BTREE);
+
+    Json types = Json::object{
+            {"relation", Json::object{{"arity", static_cast<long long>(attribsTypes.size())},
+                                 {"types", Json::array(attribsTypes.begin(), attribsTypes.end())}}}};
+
+    std::map<std::string, std::string> readDirs = {{"operation", "input"}, {"IO", "stdin"}, {"auxArity", "0"},
+            {"attributeNames", "x\ty"}, {"name", "test"}, {"types", types.dump()}};
+    std::map<std::string, std::string> spillDirs = {{"operation", "spill"}, {"IO", "spill"},
+            {"auxArity", "0"}, {"name", "test"}, {"spill-dir", "."}, {"types", types.dump()}};
+    std::map<std::string, std::string> restoreDirs = {{"operation", "restore"}, {"IO", "spill"},
+            {"auxArity", "0"}, {"name", "test"}, {"spill-dir", "."}, {"types", types.dump()}};
+    std::map<std::string, std::string> writeDirs = {{"operation", "output"}, {"IO", "stdout"},
+            {"auxArity", "0"}, {"attributeNames", "x\ty"}, {"name", "test"}, {"types", types.dump()}};
+
+    // the relation is empty while it is spilled
+    Own<ram::Statement> main = mk<ram::Sequence>(mk<ram::IO>("test", readDirs),
+            mk<ram::IO>("test", spillDirs), mk<ram::IO>("test", writeDirs), mk<ram::IO>("test", restoreDirs),
+            mk<ram::IO>("test", writeDirs));
+
+    rels.push_back(std::move(myrel));
+    std::map<std::string, Own<Statement>> subs;
+    Own<Program> prog = mk<Program>(std::move(rels), std::move(main), std::move(subs));
+
+    ErrorReport errReport;
+    DebugReport debugReport(glb);
+
+    TranslationUnit translationUnit(glb, std::move(prog), errReport, debugReport);
+
+    // configure and execute interpreter
+    Own<Engine> interpreter = mk<Engine>(translationUnit, 1);
+
+    std::streambuf* oldCoutStreambuf = std::cout.rdbuf();
+    std::ostringstream sout;
+    std::cout.rdbuf(sout.rdbuf());
+
+    interpreter->executeMain();
+
+    std::cout.rdbuf(oldCoutStreambuf);
+
+    std::string expected = R"(---------------
+test
+===============
+===============
+---------------
+test
+===============
+1	2
+5	3
+===============
+)";
+    EXPECT_EQ(expected, sout.str());
+
+    std::cin.rdbuf(backupCin);
+}
+
 }  // namespace souffle::interpreter::test
@@ -309,8 +309,8 @@ Own<ast::Counter> ParserDriver::addDeprecatedCounter(SrcLocation tagLoc) {
 
 std::set<RelationTag> ParserDriver::addReprTag(
         RelationTag tag, SrcLocation tagLoc, std::set<RelationTag> tags) {
-    return addTag(tag, {RelationTag::BTREE, RelationTag::BRIE, RelationTag::EQREL}, std::move(tagLoc),
-            std::move(tags));
+    return addTag(tag, {RelationTag::BTREE, RelationTag::BRIE, RelationTag::EQREL, RelationTag::HASH},
+            std::move(tagLoc), std::move(tags));
 }
 
 std::set<RelationTag> ParserDriver::addTag(RelationTag tag, SrcLocation tagLoc, std::set<RelationTag> tags) {
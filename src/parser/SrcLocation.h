@@ -18,6 +18,7 @@
 
 #include "VirtualFileSystem.h"
 
+#include <array>
 #include <filesystem>
 #include <list>
 #include <memory>
@@ -172,6 +173,9 @@ struct ScannerInfo {
     /** Kind of the current comment */
     CommentKind commentKind;
 
+    /** Parser symbol kinds of the last two tokens returned by the scanner, most recent last */
+    std::array<int, 2> LastTokens{};
+
     /** Push a file on the include stack */
     void push(const std::filesystem::path& PhysicalPath, const SrcLocation& IncludeLoc,
             bool reducedWhitespaces = false);
@@ -144,6 +144,7 @@
 %token BTREE_QUALIFIER           "BTREE datastructure qualifier"
 %token BTREE_DELETE_QUALIFIER    "BTREE_DELETE datastructure qualifier"
 %token EQREL_QUALIFIER           "equivalence relation qualifier"
+%token HASH_QUALIFIER            "HASH datastructure qualifier"
 %token OVERRIDABLE_QUALIFIER     "relation qualifier overidable"
 %token INLINE_QUALIFIER          "relation qualifier inline"
 %token NO_INLINE_QUALIFIER       "relation qualifier no_inline"
@@ -152,6 +153,7 @@
 %token TMATCH                    "match predicate"
 %token TCONTAINS                 "checks whether substring is contained in a string"
 %token STATEFUL                  "stateful functor"
+%token BATCH                     "batch functor"
 %token CAT                       "concatenation of strings"
 %token ORD                       "ordinal number of a string"
 %token RANGE                     "range"
@@ -723,6 +725,10 @@ relation_tags
     {
       $$ = driver.addReprTag(RelationTag::EQREL, @2, $1);
     }
+  | relation_tags HASH_QUALIFIER
+    {
+      $$ = driver.addReprTag(RelationTag::HASH, @2, $1);
+    }
   /* Deprecated Qualifiers */
   | relation_tags OUTPUT_QUALIFIER
     {
@@ -1585,11 +1591,19 @@ component_init
 functor_decl
   : FUNCTOR IDENT LPAREN functor_arg_type_list[args] RPAREN COLON qualified_name
     {
-      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), false, @$);
+      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), false, false, @$);
     }
   | FUNCTOR IDENT LPAREN functor_arg_type_list[args] RPAREN COLON qualified_name STATEFUL
     {
-      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), true, @$);
+      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), true, false, @$);
+    }
+  | FUNCTOR IDENT LPAREN functor_arg_type_list[args] RPAREN COLON qualified_name BATCH
+    {
+      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), false, true, @$);
+    }
+  | FUNCTOR IDENT LPAREN functor_arg_type_list[args] RPAREN COLON qualified_name STATEFUL BATCH
+    {
+      $$ = mk<ast::FunctorDeclaration>($IDENT, $args, mk<ast::Attribute>("return_type", $qualified_name, @qualified_name), true, true, @$);
     }
   ;
 
@@ -1915,6 +1929,7 @@ ident_token
   : IDENT     { $$ = makeTokenTree(ast::TokenKind::Ident, $IDENT); }
   | AS                        { $$ = makeTokenTree(ast::TokenKind::Ident, "as"); }
   | AUTOINC                   { $$ = makeTokenTree(ast::TokenKind::Ident, "autoinc"); }
+  | BATCH                     { $$ = makeTokenTree(ast::TokenKind::Ident, "batch"); }
   | BRIE_QUALIFIER            { $$ = makeTokenTree(ast::TokenKind::Ident, "brie"); }
   | BTREE_DELETE_QUALIFIER    { $$ = makeTokenTree(ast::TokenKind::Ident, "btree_delete"); }
   | BTREE_QUALIFIER           { $$ = makeTokenTree(ast::TokenKind::Ident, "btree"); }
@@ -1930,6 +1945,7 @@ ident_token
   | COUNT                     { $$ = makeTokenTree(ast::TokenKind::Ident, "count"); }
   | EQREL_QUALIFIER           { $$ = makeTokenTree(ast::TokenKind::Ident, "eqrel"); }
   | FALSELIT                  { $$ = makeTokenTree(ast::TokenKind::Ident, "false"); }
+  | HASH_QUALIFIER            { $$ = makeTokenTree(ast::TokenKind::Ident, "hash"); }
   | INLINE_QUALIFIER          { $$ = makeTokenTree(ast::TokenKind::Ident, "inline"); }
   | INPUT_QUALIFIER           { $$ = makeTokenTree(ast::TokenKind::Ident, "input"); }
   | L_AND                     { $$ = makeTokenTree(ast::TokenKind::Ident, "land"); }
@@ -50,7 +50,7 @@
 
     #define YYLTYPE SrcLocation
 
-    #define YY_DECL yy::parser::symbol_type yylex(souffle::ParserDriver& driver, yyscan_t yyscanner)
+    #define YY_DECL yy::parser::symbol_type scanToken(souffle::ParserDriver& driver, yyscan_t yyscanner)
     YY_DECL;
 
     #include "souffle/RamTypes.h"
@@ -122,6 +122,39 @@
       return result;
     }
 
+    // a relation qualifier follows the attribute list or another qualifier of a declaration;
+    // elsewhere a qualifier keyword such as `hash` is an ordinary identifier.
+    bool inRelationTags(const ScannerInfo& info) {
+      switch (info.LastTokens[1]) {
+        case yy::parser::symbol_kind::S_RPAREN:
+        case yy::parser::symbol_kind::S_OVERRIDABLE_QUALIFIER:
+        case yy::parser::symbol_kind::S_INLINE_QUALIFIER:
+        case yy::parser::symbol_kind::S_NO_INLINE_QUALIFIER:
+        case yy::parser::symbol_kind::S_MAGIC_QUALIFIER:
+        case yy::parser::symbol_kind::S_NO_MAGIC_QUALIFIER:
+        case yy::parser::symbol_kind::S_BRIE_QUALIFIER:
+        case yy::parser::symbol_kind::S_BTREE_QUALIFIER:
+        case yy::parser::symbol_kind::S_BTREE_DELETE_QUALIFIER:
+        case yy::parser::symbol_kind::S_EQREL_QUALIFIER:
+        case yy::parser::symbol_kind::S_HASH_QUALIFIER:
+        case yy::parser::symbol_kind::S_OUTPUT_QUALIFIER:
+        case yy::parser::symbol_kind::S_INPUT_QUALIFIER:
+        case yy::parser::symbol_kind::S_PRINTSIZE_QUALIFIER: return true;
+        default: return false;
+      }
+    }
+
+    // a functor qualifier follows the return type of a functor declaration or `stateful`;
+    // elsewhere `batch` is an ordinary identifier.
+    bool inFunctorTags(const ScannerInfo& info) {
+      if (info.LastTokens[1] == yy::parser::symbol_kind::S_STATEFUL) {
+        return true;
+      }
+      return info.LastTokens[1] == yy::parser::symbol_kind::S_IDENT &&
+             (info.LastTokens[0] == yy::parser::symbol_kind::S_COLON ||
+                 info.LastTokens[0] == yy::parser::symbol_kind::S_DOT);
+    }
+
 %}
 
 %x BLOCK_COMMENT
@@ -188,6 +221,13 @@ WS [ \t\r\v\f]
 "strlen"                              { return yy::parser::make_STRLEN(yylloc); }
 "substr"                              { return yy::parser::make_SUBSTR(yylloc); }
 "stateful"                            { return yy::parser::make_STATEFUL(yylloc); }
+"batch"/(({WS}|\n)*"("|"."[_\?a-zA-Z]) { return yy::parser::make_IDENT(yytext, yylloc); }
+"batch"                               {
+                                        if (inFunctorTags(yyinfo)) {
+                                          return yy::parser::make_BATCH(yylloc);
+                                        }
+                                        return yy::parser::make_IDENT(yytext, yylloc);
+                                      }
 "contains"                            { return yy::parser::make_TCONTAINS(yylloc); }
 "output"                              { return yy::parser::make_OUTPUT_QUALIFIER(yylloc); }
 "input"                               { return yy::parser::make_INPUT_QUALIFIER(yylloc); }
@@ -201,6 +241,13 @@ WS [ \t\r\v\f]
 "brie"                                { return yy::parser::make_BRIE_QUALIFIER(yylloc); }
 "btree_delete"                        { return yy::parser::make_BTREE_DELETE_QUALIFIER(yylloc); }
 "btree"                               { return yy::parser::make_BTREE_QUALIFIER(yylloc); }
+"hash"/(({WS}|\n)*"("|"."[_\?a-zA-Z]) { return yy::parser::make_IDENT(yytext, yylloc); }
+"hash"                                {
+                                        if (inRelationTags(yyinfo)) {
+                                          return yy::parser::make_HASH_QUALIFIER(yylloc);
+                                        }
+                                        return yy::parser::make_IDENT(yytext, yylloc);
+                                      }
 "min"                                 { return yy::parser::make_MIN(yylloc); }
 "max"                                 { return yy::parser::make_MAX(yylloc); }
 "as"                                  { return yy::parser::make_AS(yylloc); }
@@ -526,4 +573,11 @@ WS [ \t\r\v\f]
                                         return yy::parser::make_YYUNDEF(yylloc);
                                       }
 %%
+
+yy::parser::symbol_type yylex(souffle::ParserDriver& driver, yyscan_t yyscanner) {
+  yy::parser::symbol_type token = scanToken(driver, yyscanner);
+  yyinfo.LastTokens = {yyinfo.LastTokens[1], token.kind()};
+  return token;
+}
+
 // vim: filetype=lex
@@ -33,7 +33,8 @@ namespace souffle::ram {
  * @class IO
  * @brief I/O statement for a relation
  *
- * I/O operation for a relation, e.g., input/output/printsize
+ * I/O operation for a relation, e.g., input/output/printsize, or spill/restore
+ * moving a relation out of memory and back
  */
 class IO : public RelationStatement {
 public:
@@ -18,6 +18,7 @@
 #include "RelationTag.h"
 #include "ram/AbstractOperator.h"
 #include "ram/Node.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/MiscUtil.h"
 #include <cassert>
@@ -90,6 +91,12 @@ public:
         return auxiliaryArity;
     }
 
+    /** @brief Has provenance annotations, either as rule and level numbers or packed into one */
+    bool hasProvenance() const {
+        return arity > 0 && (attributeNames.back() == "@level_number" ||
+                                    attributeNames.back() == provenance::compactAnnotationName);
+    }
+
     /** @brief Compare two relations via their name */
     bool operator<(const Relation& other) const {
         return name < other.name;
@@ -38,9 +38,9 @@ namespace souffle::ram {
 class UserDefinedOperator : public AbstractOperator {
 public:
     UserDefinedOperator(std::string n, std::vector<TypeAttribute> argsTypes, TypeAttribute returnType,
-            bool stateful, VecOwn<Expression> args)
+            bool stateful, VecOwn<Expression> args, bool batch = false)
             : AbstractOperator(NK_UserDefinedOperator, std::move(args)), name(std::move(n)),
-              argsTypes(std::move(argsTypes)), returnType(returnType), stateful(stateful) {
+              argsTypes(std::move(argsTypes)), returnType(returnType), stateful(stateful), batch(batch) {
         assert(argsTypes.size() == args.size());
     }
 
@@ -68,8 +68,13 @@ public:
         return stateful;
     }
 
+    /** @brief Is functor called with batches of arguments? */
+    bool isBatch() const {
+        return batch;
+    }
+
     UserDefinedOperator* cloning() const override {
-        auto* res = new UserDefinedOperator(name, argsTypes, returnType, stateful, {});
+        auto* res = new UserDefinedOperator(name, argsTypes, returnType, stateful, {}, batch);
         for (auto& cur : arguments) {
             Expression* arg = cur->cloning();
             res->arguments.emplace_back(arg);
@@ -91,7 +96,7 @@ protected:
     bool equal(const Node& node) const override {
         const auto& other = asAssert<UserDefinedOperator>(node);
         return AbstractOperator::equal(node) && name == other.name && argsTypes == other.argsTypes &&
-               returnType == other.returnType && stateful == other.stateful;
+               returnType == other.returnType && stateful == other.stateful && batch == other.batch;
     }
 
     /** Name of user-defined operator */
@@ -105,5 +110,8 @@ protected:
 
     /** Stateful */
     const bool stateful;
+
+    /** Batch */
+    const bool batch;
 };
 }  // namespace souffle::ram
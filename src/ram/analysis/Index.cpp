@@ -19,6 +19,7 @@
 #include "RelationTag.h"
 #include "ram/EstimateJoinSize.h"
 #include "ram/Expression.h"
+#include "ram/IO.h"
 #include "ram/Node.h"
 #include "ram/Program.h"
 #include "ram/Relation.h"
@@ -27,13 +28,16 @@
 #include "ram/analysis/Relation.h"
 #include "ram/utility/Utils.h"
 #include "ram/utility/Visitor.h"
+#include "reports/ErrorReport.h"
 #include "souffle/utility/StreamUtil.h"
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <queue>
+#include <set>
 
 namespace souffle::ram::analysis {
 
@@ -443,6 +447,77 @@ void IndexAnalysis::run(const TranslationUnit& translationUnit) {
         auto& searches = relToSearch.second;
         indexCover.insert({relation, solver->solve(searches)});
     }
+
+    // Relations searched only by equalities may be kept in hash indexes: those
+    // with the hash qualifier, and those without a qualifier unless they are
+    // written, to keep the order of output files. The join size estimates
+    // sample the order of the indexes, so their relations stay ordered. Hash
+    // indexes compare bits, which differs from comparing floats.
+    std::set<std::string> ordered;
+    visit(translationUnit.getProgram(), [&](const Node& node) {
+        if (const auto* estimateJoinSize = as<EstimateJoinSize>(node)) {
+            ordered.insert(estimateJoinSize->getRelation());
+        } else if (const auto* io = as<IO>(node)) {
+            const auto& rep = relAnalysis->lookup(io->getRelation()).getRepresentation();
+            if (io->get("operation") == "output" && rep != RelationRepresentation::HASH) {
+                ordered.insert(io->getRelation());
+            }
+        }
+    });
+    // the reason why a relation with the hash qualifier is kept in b-trees
+    std::map<std::string, std::string> fallbacks;
+    for (auto& [relation, cluster] : indexCover) {
+        const Relation& rel = relAnalysis->lookup(relation);
+        const auto rep = rel.getRepresentation();
+        const auto& types = rel.getAttributeTypes();
+        const auto& searches = relationToSearches[relation];
+        std::string fallback;
+        if (rel.getArity() == 0) {
+            fallback = "it has no attributes";
+        } else if (rel.getAuxiliaryArity() != 0) {
+            fallback = "it has provenance or lattice attributes";
+        } else if (std::any_of(types.begin(), types.end(), [](const auto& type) { return type[0] == 'f'; })) {
+            fallback = "it has a float attribute";
+        } else if (std::any_of(searches.begin(), searches.end(), [](const SearchSignature& search) {
+                       return std::any_of(search.begin(), search.end(),
+                               [](AttributeConstraint c) { return c == AttributeConstraint::Inequal; });
+                   })) {
+            fallback = "it is searched by an inequality";
+        } else if (ordered.count(relation) != 0) {
+            fallback = "its order is sampled by join size estimates";
+        }
+        const bool requested = rep == RelationRepresentation::HASH;
+        cluster.setHashed((requested || rep == RelationRepresentation::DEFAULT) && fallback.empty());
+        if (requested && !fallback.empty()) {
+            fallbacks[relation] = fallback;
+        }
+    }
+
+    // relations swapped with each other must have the same type
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        visit(translationUnit.getProgram(), [&](const Swap& swap) {
+            auto& first = indexCover.at(swap.getFirstRelation());
+            auto& second = indexCover.at(swap.getSecondRelation());
+            if (first.isHashed() != second.isHashed()) {
+                const auto& hashed = first.isHashed() ? swap.getFirstRelation() : swap.getSecondRelation();
+                const auto& partner = first.isHashed() ? swap.getSecondRelation() : swap.getFirstRelation();
+                if (relAnalysis->lookup(hashed).getRepresentation() == RelationRepresentation::HASH) {
+                    fallbacks[hashed] = "it is swapped with " + partner + ", which is not hashed";
+                }
+                first.setHashed(false);
+                second.setHashed(false);
+                changed = true;
+            }
+        });
+    }
+
+    // the hash qualifier is explicit, so falling back to b-trees must not go unnoticed
+    for (const auto& [relation, fallback] : fallbacks) {
+        translationUnit.getErrorReport().addWarning(WarnType::HashFallback,
+                "Relation " + relation + " with the hash qualifier is kept in b-trees: " + fallback, {});
+    }
 }
 
 void IndexAnalysis::print(std::ostream& os) const {
@@ -467,6 +542,9 @@ void IndexAnalysis::print(std::ostream& os) const {
             os << join(order, "<") << "\n";
             os << "\n";
         }
+        if (selection.isHashed()) {
+            os << "\tHashed\n";
+        }
     }
 }
 
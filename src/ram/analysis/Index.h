@@ -477,10 +477,20 @@ public:
         return static_cast<std::size_t>(std::distance(orders.begin(), it));
     }
 
+    /** Whether the relation is only searched by equalities, and may be kept in hash indexes */
+    bool isHashed() const {
+        return hashed;
+    }
+
+    void setHashed(bool value) {
+        hashed = value;
+    }
+
 private:
     SignatureOrderMap indexSelection;
     SearchCollection searches;
     OrderCollection orders;
+    bool hashed = false;
 };
 
 /**
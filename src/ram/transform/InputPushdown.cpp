@@ -0,0 +1,271 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file InputPushdown.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/InputPushdown.h"
+#include "RelationTag.h"
+#include "ram/AbstractAggregate.h"
+#include "ram/AbstractExistenceCheck.h"
+#include "ram/EmptinessCheck.h"
+#include "ram/Erase.h"
+#include "ram/EstimateJoinSize.h"
+#include "ram/IO.h"
+#include "ram/IndexOperation.h"
+#include "ram/MergeExtend.h"
+#include "ram/Node.h"
+#include "ram/NumericConstant.h"
+#include "ram/Query.h"
+#include "ram/Relation.h"
+#include "ram/RelationOperation.h"
+#include "ram/RelationSize.h"
+#include "ram/StringConstant.h"
+#include "ram/Swap.h"
+#include "ram/TupleElement.h"
+#include "ram/UndefValue.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/RamTypes.h"
+#include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/json11.h"
+#include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+namespace {
+
+/** How the program uses an input relation */
+struct InputUsage {
+    // whether the relation may be loaded partially at all
+    bool restricted = true;
+    // whether the relation is read at all
+    bool read = false;
+    // whether tuples may be dropped, which an emptiness check not guarding a read would notice
+    bool selectable = true;
+    // columns read by some use
+    std::vector<bool> columns;
+    // per column, the constant all uses bind it to, or nullptr
+    std::vector<const Expression*> constants;
+};
+
+/** The constant an expression is, or nullptr */
+const Expression* asConstant(const Expression* expr) {
+    if (expr != nullptr && (isA<NumericConstant>(expr) || isA<StringConstant>(expr))) {
+        return expr;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+bool InputPushdownTransformer::pushdown(Program& program) {
+    std::map<std::string, InputUsage> usage;
+    visit(program, [&](const IO& io) {
+        if (io.get("operation") == "input") {
+            usage[io.getRelation()];
+        }
+    });
+    for (const Relation* rel : program.getRelations()) {
+        auto pos = usage.find(rel->getName());
+        if (pos == usage.end()) {
+            continue;
+        }
+        pos->second.columns.resize(rel->getArity(), false);
+        pos->second.constants.resize(rel->getArity(), nullptr);
+        if (rel->getArity() == 0 || rel->getAuxiliaryArity() > 0 ||
+                rel->getRepresentation() == RelationRepresentation::EQREL ||
+                rel->getRepresentation() == RelationRepresentation::INFO) {
+            pos->second.restricted = false;
+        }
+    }
+
+    auto forbid = [&](const std::string& relation) {
+        auto pos = usage.find(relation);
+        if (pos != usage.end()) {
+            pos->second.restricted = false;
+        }
+    };
+
+    // Record a use binding the columns of a relation to the given values, where
+    // nullptr denotes an unbound column and readAll that every column is read.
+    auto use = [&](const std::string& relation, const std::vector<const Expression*>& values,
+                       const std::set<std::size_t>& elements, bool readAll) {
+        auto pos = usage.find(relation);
+        if (pos == usage.end()) {
+            return;
+        }
+        InputUsage& input = pos->second;
+        const bool first = !input.read;
+        input.read = true;
+        for (std::size_t i = 0; i < input.columns.size(); ++i) {
+            const Expression* value = i < values.size() ? values[i] : nullptr;
+            if (readAll || value != nullptr || elements.count(i) > 0) {
+                input.columns[i] = true;
+            }
+            const Expression* constant = asConstant(value);
+            if (first) {
+                input.constants[i] = constant;
+            } else if (input.constants[i] != nullptr &&
+                       (constant == nullptr || !(*constant == *input.constants[i]))) {
+                input.constants[i] = nullptr;
+            }
+        }
+    };
+
+    visit(program, [&](const IO& io) {
+        static const std::set<std::string> keeping = {"input", "spill", "restore", "exchange"};
+        if (keeping.count(io.get("operation")) == 0) {
+            forbid(io.getRelation());
+        }
+    });
+
+    // A guard of a read in the same query has the same outcome after a selection, as the read
+    // finds no selected tuple either way. Other emptiness checks could see an empty relation.
+    std::set<const EmptinessCheck*> guards;
+    visit(program, [&](const Query& query) {
+        std::set<std::string> reads;
+        visit(query, [&](const RelationOperation& op) { reads.insert(op.getRelation()); });
+        visit(query, [&](const AbstractExistenceCheck& check) { reads.insert(check.getRelation()); });
+        visit(query, [&](const EmptinessCheck& check) {
+            if (reads.count(check.getRelation()) > 0) {
+                guards.insert(&check);
+            }
+        });
+    });
+    visit(program, [&](const EmptinessCheck& check) {
+        auto pos = usage.find(check.getRelation());
+        if (pos != usage.end() && guards.count(&check) == 0) {
+            pos->second.selectable = false;
+        }
+    });
+    visit(program, [&](const RelationSize& size) { forbid(size.getRelation()); });
+    visit(program, [&](const EstimateJoinSize& estimate) { forbid(estimate.getRelation()); });
+    visit(program, [&](const Erase& erase) { forbid(erase.getRelation()); });
+    visit(program, [&](const Swap& swap) {
+        forbid(swap.getFirstRelation());
+        forbid(swap.getSecondRelation());
+    });
+    visit(program, [&](const MergeExtend& merge) {
+        forbid(merge.getSourceRelation());
+        forbid(merge.getTargetRelation());
+    });
+
+    visit(program, [&](const RelationOperation& op) {
+        std::set<std::size_t> elements;
+        visit(op, [&](const TupleElement& element) {
+            if (element.getTupleId() == op.getTupleId()) {
+                elements.insert(element.getElement());
+            }
+        });
+
+        std::vector<const Expression*> values;
+        if (const auto* indexOp = as<IndexOperation>(op)) {
+            auto [lower, upper] = indexOp->getRangePattern();
+            for (std::size_t i = 0; i < lower.size(); ++i) {
+                if (isA<UndefValue>(lower[i]) && isA<UndefValue>(upper[i])) {
+                    values.push_back(nullptr);
+                } else if (*lower[i] == *upper[i]) {
+                    values.push_back(lower[i]);
+                } else {
+                    // a range binds the column, but not to a constant
+                    values.push_back(isA<UndefValue>(lower[i]) ? upper[i] : lower[i]);
+                    elements.insert(i);
+                }
+            }
+        }
+
+        // aggregates count duplicates that a projection would merge
+        use(op.getRelation(), values, elements, dynamic_cast<const AbstractAggregate*>(&op) != nullptr);
+    });
+
+    visit(program, [&](const AbstractExistenceCheck& check) {
+        std::vector<const Expression*> values;
+        for (const Expression* value : check.getValues()) {
+            values.push_back(isA<UndefValue>(value) ? nullptr : value);
+        }
+        use(check.getRelation(), values, {}, false);
+    });
+
+    // derive the directives of the input statements
+    std::map<std::string, std::map<std::string, std::string>> directives;
+    for (const Relation* rel : program.getRelations()) {
+        auto pos = usage.find(rel->getName());
+        if (pos == usage.end() || !pos->second.restricted || !pos->second.read) {
+            continue;
+        }
+        const InputUsage& input = pos->second;
+
+        // readers still check the numbers of columns they do not load and of tuples they reject,
+        // but records and ADTs can only be checked by packing them, so they are loaded in full
+        std::string columns;
+        bool hasRecords = false;
+        for (std::size_t i = 0; i < input.columns.size(); ++i) {
+            const char type = rel->getAttributeTypes()[i][0];
+            hasRecords = hasRecords || type == 'r' || type == '+';
+            columns += input.columns[i] || type == 'r' || type == '+' ? '1' : '0';
+        }
+        if (columns.find('0') != std::string::npos) {
+            directives[rel->getName()]["load-columns"] = columns;
+        }
+        if (hasRecords || !input.selectable) {
+            continue;
+        }
+
+        // floats are left out, as readers do not agree on their representation
+        json11::Json::object selection;
+        for (std::size_t i = 0; i < input.constants.size(); ++i) {
+            const Expression* constant = input.constants[i];
+            const char type = rel->getAttributeTypes()[i][0];
+            if (constant == nullptr || (type != 's' && type != 'i' && type != 'u')) {
+                continue;
+            }
+            if (const auto* str = as<StringConstant>(constant)) {
+                if (type == 's') {
+                    selection[std::to_string(i)] = str->getConstant();
+                }
+            } else if (type != 's') {
+                RamDomain value = as<NumericConstant>(constant)->getConstant();
+                selection[std::to_string(i)] = std::to_string(value);
+            }
+        }
+        if (!selection.empty()) {
+            directives[rel->getName()]["load-selection"] = json11::Json(selection).dump();
+        }
+    }
+    if (directives.empty()) {
+        return false;
+    }
+
+    bool changed = false;
+    program.apply(nodeMapper<Node>([&](auto&& go, Own<Node> node) -> Own<Node> {
+        if (const auto* io = as<IO>(node)) {
+            auto pos = directives.find(io->getRelation());
+            if (pos != directives.end() && io->get("operation") == "input") {
+                auto extended = io->getDirectives();
+                for (const auto& [key, value] : pos->second) {
+                    changed = changed || getOr(extended, key, "") != value;
+                    extended[key] = value;
+                }
+                return mk<IO>(io->getRelation(), std::move(extended));
+            }
+        }
+        node->apply(go);
+        return node;
+    }));
+    return changed;
+}
+
+}  // namespace souffle::ram::transform
@@ -0,0 +1,74 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file InputPushdown.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/Program.h"
+#include "ram/TranslationUnit.h"
+#include "ram/transform/Transformer.h"
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class InputPushdownTransformer
+ * @brief Push projections and selections on input relations into their readers
+ *
+ * If every use of an input relation binds a column to the same constant,
+ * only tuples with this constant are loaded. If no use reads a column, the
+ * column is not loaded. Both are passed to the reader as directives of the
+ * input statement, so that tuples are dropped before their symbols are
+ * interned. Readers still convert the numbers they skip, so malformed
+ * facts are reported as before; records and ADTs are always loaded.
+ *
+ * For example,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  IO edge (operation="input", ...)
+ *  ...
+ *  FOR t0 IN edge ON INDEX t0.0 = "call"
+ *   INSERT (t0.1) INTO callee
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  IO edge (load-columns="110", load-selection="{"0": "call"}", operation="input", ...)
+ *  ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * Relations that are written, counted, aggregated over, or used as a whole
+ * are loaded completely. The transformer must not run with provenance, as
+ * the subproof subroutines read the input relations completely.
+ */
+class InputPushdownTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "InputPushdownTransformer";
+    }
+
+    /**
+     * @brief Add load-time projections and selections to the input statements
+     * @param program the RAM program
+     * @result A flag indicating whether the program has been changed
+     */
+    bool pushdown(Program& program);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        return pushdown(translationUnit.getProgram());
+    }
+};
+
+}  // namespace souffle::ram::transform
@@ -0,0 +1,184 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SubproofScan.cpp
+ *
+ ***********************************************************************/
+
+#include "ram/transform/SubproofScan.h"
+#include "ram/Aggregate.h"
+#include "ram/Conjunction.h"
+#include "ram/Constraint.h"
+#include "ram/EstimateJoinSize.h"
+#include "ram/ExistenceCheck.h"
+#include "ram/Filter.h"
+#include "ram/IfExists.h"
+#include "ram/IndexAggregate.h"
+#include "ram/IndexIfExists.h"
+#include "ram/IndexScan.h"
+#include "ram/Node.h"
+#include "ram/Program.h"
+#include "ram/ProvenanceExistenceCheck.h"
+#include "ram/Relation.h"
+#include "ram/Scan.h"
+#include "ram/Swap.h"
+#include "ram/TupleElement.h"
+#include "ram/analysis/Index.h"
+#include "ram/analysis/Relation.h"
+#include "ram/utility/NodeMapper.h"
+#include "ram/utility/Utils.h"
+#include "ram/utility/Visitor.h"
+#include "souffle/BinaryConstraintOps.h"
+#include "souffle/utility/MiscUtil.h"
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace souffle::ram::transform {
+
+bool SubproofScanTransformer::scanSubproofs(TranslationUnit& translationUnit) {
+    Program& program = translationUnit.getProgram();
+    const auto& indexAnalysis = translationUnit.getAnalysis<analysis::IndexAnalysis>();
+    const auto& relAnalysis = translationUnit.getAnalysis<analysis::RelationAnalysis>();
+    const auto subroutines = program.getSubroutines();
+
+    // the searches that have indexes regardless of the subroutine scans
+    std::map<std::string, analysis::SearchSet> searches;
+    for (const Relation* rel : program.getRelations()) {
+        searches[rel->getName()].insert(indexAnalysis.getSearchSignature(rel));
+    }
+    auto addSearches = [&](const Node& root) {
+        visit(root, [&](const Node& node) {
+            if (const auto* estimateJoinSize = as<EstimateJoinSize>(node)) {
+                searches[estimateJoinSize->getRelation()].insert(
+                        indexAnalysis.getSearchSignature(estimateJoinSize));
+            } else if (const auto* exists = as<ExistenceCheck>(node)) {
+                searches[exists->getRelation()].insert(indexAnalysis.getSearchSignature(exists));
+            } else if (const auto* provExists = as<ProvenanceExistenceCheck>(node)) {
+                searches[provExists->getRelation()].insert(indexAnalysis.getSearchSignature(provExists));
+            } else if (const auto* search = as<IndexOperation>(node)) {
+                if (&root == &program.getMain()) {
+                    searches[search->getRelation()].insert(indexAnalysis.getSearchSignature(search));
+                }
+            }
+        });
+    };
+    addSearches(program.getMain());
+    for (const auto& [name, sub] : subroutines) {
+        addSearches(*sub);
+    }
+    visit(program, [&](const Swap& swap) {
+        auto& searchesA = searches[swap.getFirstRelation()];
+        auto& searchesB = searches[swap.getSecondRelation()];
+        searchesA.insert(searchesB.begin(), searchesB.end());
+        searchesB.insert(searchesA.begin(), searchesA.end());
+    });
+    for (auto& [rel, relSearches] : searches) {
+        for (auto it = relSearches.begin(); it != relSearches.end();) {
+            it = it->empty() ? relSearches.erase(it) : std::next(it);
+        }
+    }
+
+    // keep the searches of the subroutines that the indexes cover anyway
+    analysis::MinIndexSelectionStrategy solver;
+    std::map<std::string, analysis::SearchSet> scanned;
+    for (const auto& [name, sub] : subroutines) {
+        visit(*sub, [&](const IndexOperation& indexSearch) {
+            auto& relSearches = searches[indexSearch.getRelation()];
+            auto search = indexAnalysis.getSearchSignature(&indexSearch);
+            if (search.empty() || relSearches.count(search) > 0 ||
+                    scanned[indexSearch.getRelation()].count(search) > 0) {
+                return;
+            }
+            const std::size_t indexes = solver.solve(relSearches).getAllOrders().size();
+            relSearches.insert(search);
+            if (solver.solve(relSearches).getAllOrders().size() > indexes) {
+                relSearches.erase(search);
+                scanned[indexSearch.getRelation()].insert(search);
+            }
+        });
+    }
+
+    // the condition a tuple of a search satisfies
+    auto toSearchCondition = [&](const IndexOperation& indexSearch) {
+        const auto& types = relAnalysis.lookup(indexSearch.getRelation()).getAttributeTypes();
+        auto [lower, upper] = indexSearch.getRangePattern();
+        VecOwn<Condition> conditions;
+        for (std::size_t i = 0; i < lower.size(); i++) {
+            auto element = [&]() { return mk<TupleElement>(indexSearch.getTupleId(), i); };
+            if (isUndefValue(lower[i]) && isUndefValue(upper[i])) {
+                continue;
+            } else if (*lower[i] == *upper[i]) {
+                conditions.push_back(mk<Constraint>(getEqConstraint(types[i]), element(), clone(lower[i])));
+                continue;
+            }
+            if (!isUndefValue(lower[i])) {
+                conditions.push_back(
+                        mk<Constraint>(getGreaterEqualConstraint(types[i]), element(), clone(lower[i])));
+            }
+            if (!isUndefValue(upper[i])) {
+                conditions.push_back(
+                        mk<Constraint>(getLessEqualConstraint(types[i]), element(), clone(upper[i])));
+            }
+        }
+        return toCondition(conditions);
+    };
+
+    bool changed = false;
+    auto rewrite = nodeMapper<Node>([&](auto&& go, Own<Node> node) -> Own<Node> {
+        node->apply(go);
+        const auto* indexSearch = as<IndexOperation>(node);
+        if (indexSearch == nullptr) {
+            return node;
+        }
+        const auto& relScanned = scanned[indexSearch->getRelation()];
+        if (relScanned.count(indexAnalysis.getSearchSignature(indexSearch)) == 0) {
+            return node;
+        }
+        const std::string& rel = indexSearch->getRelation();
+        const std::size_t identifier = indexSearch->getTupleId();
+        if (const auto* indexScan = as<IndexScan>(node)) {
+            changed = true;
+            return mk<Scan>(rel, identifier,
+                    mk<Filter>(toSearchCondition(*indexScan), clone(indexScan->getOperation())),
+                    indexScan->getProfileText());
+        } else if (const auto* indexIfExists = as<IndexIfExists>(node)) {
+            changed = true;
+            return mk<IfExists>(rel, identifier,
+                    mk<Conjunction>(toSearchCondition(*indexIfExists), clone(indexIfExists->getCondition())),
+                    clone(indexIfExists->getOperation()), indexIfExists->getProfileText());
+        } else if (const auto* indexAggregate = as<IndexAggregate>(node)) {
+            changed = true;
+            const auto& aggregate = *indexAggregate;
+            auto condition = mk<Conjunction>(toSearchCondition(aggregate), clone(aggregate.getCondition()));
+            return mk<Aggregate>(clone(aggregate.getOperation()), clone(aggregate.getAggregator()), rel,
+                    clone(aggregate.getExpression()), std::move(condition), identifier);
+        }
+        return node;
+    });
+
+    // rewrite the subroutines only
+    std::set<const Node*> subroutineNodes;
+    for (const auto& [name, sub] : subroutines) {
+        subroutineNodes.insert(sub);
+    }
+    program.apply(nodeMapper<Node>([&](auto&&, Own<Node> node) -> Own<Node> {
+        if (subroutineNodes.count(node.get()) > 0) {
+            node->apply(rewrite);
+        }
+        return node;
+    }));
+    return changed;
+}
+
+}  // namespace souffle::ram::transform
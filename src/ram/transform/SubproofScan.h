@@ -0,0 +1,71 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file SubproofScan.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ram/TranslationUnit.h"
+#include "ram/transform/Transformer.h"
+#include <string>
+
+namespace souffle::ram::transform {
+
+/**
+ * @class SubproofScanTransformer
+ * @brief Scan relations in the subproof subroutines instead of adding indexes for them
+ *
+ * The subproof subroutines of provenance search the relations with other
+ * patterns than the evaluation does, and each of these patterns may need an
+ * index of its own. With provenance, every index stores the complete tuples
+ * including their annotations, but these indexes are only used if a tuple
+ * is explained.
+ *
+ * A search of a subroutine whose index would not be needed otherwise is
+ * turned into a scan filtered by the bounds of the search. For example,
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  FOR t0 IN edge ON INDEX t0.1 = argument(1)
+ *   ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * will be rewritten to
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  FOR t0 IN edge
+ *   IF (t0.1 = argument(1))
+ *    ...
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * if no index of edge has the second column first. Existence checks keep
+ * their indexes.
+ */
+class SubproofScanTransformer : public Transformer {
+public:
+    std::string getName() const override {
+        return "SubproofScanTransformer";
+    }
+
+    /**
+     * @brief Replace the searches of subroutines that need indexes of their own by scans
+     * @param translationUnit the RAM translation unit
+     * @result A flag indicating whether the program has been changed
+     */
+    bool scanSubproofs(TranslationUnit& translationUnit);
+
+protected:
+    bool transform(TranslationUnit& translationUnit) override {
+        return scanSubproofs(translationUnit);
+    }
+};
+
+}  // namespace souffle::ram::transform
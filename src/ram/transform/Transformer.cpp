@@ -45,6 +45,11 @@ bool Transformer::apply(TranslationUnit& translationUnit) {
         translationUnit.invalidateAnalyses();
     }
 
+    if (!isA<MetaTransformer>(this)) {
+        translationUnit.recordTransformer(
+                getName(), std::chrono::duration<double>(end - start).count(), changed);
+    }
+
     // print runtime & change info for transformer in verbose mode
     if (verbose && (!isA<MetaTransformer>(this))) {
         std::string changedString = changed ? "changed" : "unchanged";
@@ -149,6 +149,7 @@ enum class WarnType : std::size_t {
     DeprecatedTypeDecl,
     DeprecatedQualifier,
     DollarSign,
+    HashFallback,
     LatticeMissingOperator,
     NoRulesNorFacts,
     NoSubsumptiveRule,
@@ -29,9 +29,13 @@ if not JSON_DATA_TEXT:
     }"""
 
 import argparse
+import concurrent.futures
+import functools
+import hashlib
 import json
 import os
 import pathlib
+import re
 import shutil
 import subprocess
 import sys
@@ -74,6 +78,9 @@ parser.add_argument('-L', action='append', default=[], metavar='LIBDIR', dest='l
 parser.add_argument('-g', action='store_true', dest='debug', help="Debug build type")
 parser.add_argument('-s', metavar='LANG', dest='swiglang', choices=["java", "python"], help="use SWIG interface to generate into LANG language")
 parser.add_argument('-v', action='store_true', dest='verbose', help="Verbose output")
+parser.add_argument('-j', metavar='N', dest='jobs', type=int, default=os.cpu_count() or 1, help="Number of source files compiled in parallel")
+parser.add_argument('--pgo-train', metavar='DIR', dest='pgo_train', type=lambda p: pathlib.Path(p).absolute(), help="Build with profile-guided and link-time optimisation, training on the facts in DIR")
+parser.add_argument('--cache-dir', metavar='DIR', dest='cache_dir', type=lambda p: pathlib.Path(p).absolute(), help="Reuse the object files of unchanged source files from DIR")
 parser.add_argument('source', nargs='+', metavar='SOURCE', type=lambda p: pathlib.Path(p).absolute(), help="C++ source files")
 parser.add_argument('-o', metavar='BINARY', dest='output', type=lambda p: pathlib.Path(p).absolute(), help="Binary file name")
 
@@ -102,6 +109,192 @@ elif (scriptdir / ".." / "include" / "souffle").exists():
 elif SOURCE_INCLUDE_DIR and (pathlib.Path(SOURCE_INCLUDE_DIR) / "souffle").exists():
     souffle_include_dir = (pathlib.Path(SOURCE_INCLUDE_DIR) / "souffle")
 
+# directories searched for the headers a source file depends on
+header_dirs = [souffle_include_dir / ".."] if souffle_include_dir else []
+INCLUDE_RE = re.compile(r'^\s*#\s*include\s*[<"]([^>"]+)[>"]', re.MULTILINE)
+
+@functools.lru_cache(maxsize=None)
+def read_source(path):
+    text = path.read_bytes()
+    headers = []
+    for header in INCLUDE_RE.findall(text.decode(errors='replace')):
+        for dir in [path.parent] + header_dirs:
+            if (dir / header).is_file():
+                headers.append((dir / header).resolve())
+                break
+    return text, headers
+
+# digest of a source file and all headers it includes, except system headers
+def source_digest(source, digest, visited):
+    source = source.resolve()
+    if source in visited:
+        return
+    visited.add(source)
+    text, headers = read_source(source)
+    digest.update(str(len(text)).encode())
+    digest.update(text)
+    for header in headers:
+        source_digest(header, digest, visited)
+
+# return the object file of a source file, compiling it only if it is not in the object directory yet
+def cached_object(source, compile_flags, object_dir):
+    digest = hashlib.sha256()
+    digest.update(JSON_DATA_TEXT.encode())
+    digest.update(" ".join(compile_flags).encode())
+    source_digest(source, digest, set())
+    objext = ".obj" if conf['compiler_id'] == "MSVC" else ".o"
+    objpath = object_dir / "{}{}".format(digest.hexdigest(), objext)
+    if objpath.exists():
+        if args.verbose:
+            sys.stderr.write("Reusing {} for {}\n".format(objpath, source))
+        return objpath
+
+    partial = object_dir / "{}.{}.partial".format(objpath.name, os.getpid())
+    cmd = ['"{}"'.format(conf['compiler'])]
+    cmd.extend(compile_flags)
+    if conf['compiler_id'] == "MSVC":
+        cmd.append("/c")
+        cmd.append("/Fo:{}".format(partial))
+    else:
+        cmd.append("-c")
+        cmd.append("-o {}".format(partial))
+    cmd.append(str(source))
+    launch_command(" ".join(cmd), "Compilation of {}".format(source), verbose=args.verbose)
+    # publish the object file atomically, concurrent builds may share the object directory
+    os.replace(partial, objpath)
+    return objpath
+
+# precompile the prelude of the generated sources, return the flags using it and the files it takes
+def precompiled_prelude(prelude, compile_flags, object_dir):
+    if conf['compiler_id'] not in ("GNU", "Clang", "AppleClang") or not prelude.is_file():
+        return [], []
+    digest = hashlib.sha256()
+    digest.update(JSON_DATA_TEXT.encode())
+    digest.update(" ".join(compile_flags).encode())
+    source_digest(prelude, digest, set())
+    header = object_dir / "{}.hpp".format(digest.hexdigest())
+    pch = pathlib.Path("{}{}".format(header, ".gch" if conf['compiler_id'] == "GNU" else ".pch"))
+    if conf['compiler_id'] == "GNU":
+        use_pch = ["-include {}".format(header)]
+    else:
+        use_pch = ["-include-pch {}".format(pch)]
+    if pch.exists():
+        return use_pch, [header, pch]
+
+    shutil.copy(prelude, header)
+    partial = object_dir / "{}.{}.partial".format(pch.name, os.getpid())
+    cmd = ['"{}"'.format(conf['compiler'])]
+    cmd.extend(compile_flags)
+    cmd.append("-x c++-header")
+    cmd.append(str(header))
+    cmd.append("-o {}".format(partial))
+    try:
+        launch_command(" ".join(cmd), "Precompilation of {}".format(prelude), verbose=args.verbose)
+    except RuntimeError:
+        # the sources still compile without the precompiled header, only slower
+        return [], []
+    os.replace(partial, pch)
+    return use_pch, [header, pch]
+
+# compile and link the inputs, which may be sources or object files, into a binary
+def link_binary(inputs, flags, exepath):
+    cmd = []
+    cmd.append('"{}"'.format(conf['compiler']))
+    cmd.extend(flags)
+    cmd.append(OUTNAME_FMT.format(exepath))
+    for f in inputs:
+        cmd.append(str(f))
+
+    cmd.append(conf['link_options'])
+    cmd.extend(list(map(lambda rpath: RPATH_FMT.format(rpath), RPATHS)))
+    cmd.extend(list(map(lambda libdir: LIBDIR_FMT.format(libdir), args.lib_dirs)))
+    cmd.extend(list(map(lambda libname: LIBNAME_FMT.format(libname), args.lib_names)))
+
+    cmd = " ".join(cmd)
+
+    if args.verbose:
+        sys.stderr.write(cmd + "\n")
+
+    if exepath.exists():
+        exepath.unlink()
+
+    status = subprocess.run(cmd, capture_output=True, text=True, shell=True)
+    if status.returncode != 0:
+        sys.stdout.write(status.stdout)
+        sys.stderr.write(status.stderr)
+    return status
+
+# Build with profile-guided and link-time optimisation: build an instrumented binary, run it
+# on the training facts, then build again using the collected profile.
+def pgo_build(compile_flags, exepath):
+    if conf['compiler_id'] not in ("GNU", "Clang", "AppleClang"):
+        raise RuntimeError("Profile-guided optimisation requires GCC or Clang")
+    if not args.pgo_train.is_dir():
+        raise RuntimeError("Cannot open training fact directory: '{}'".format(args.pgo_train))
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        tmpdir = pathlib.Path(tmpdir)
+        profile_dir = tmpdir / "profile"
+        object_dir = tmpdir / "objects"
+        object_dir.mkdir()
+        if conf['compiler_id'] == "GNU":
+            # multi-threaded programs need atomic counters; the objects keep their names in both
+            # builds, as GCC finds the profile of an object by its name
+            generate_flags = ["-fprofile-generate={}".format(profile_dir), "-fprofile-update=atomic"]
+            use_flags = ["-fprofile-use={}".format(profile_dir), "-fprofile-correction",
+                         "-Wno-missing-profile", "-flto=auto"]
+        else:
+            profdata = tmpdir / "merged.profdata"
+            generate_flags = ["-fprofile-instr-generate={}".format(profile_dir / "%p.profraw")]
+            use_flags = ["-fprofile-instr-use={}".format(profdata), "-flto=thin"]
+
+        def build(flags):
+            def compile(indexed):
+                index, source = indexed
+                obj = object_dir / "{}-{}.o".format(index, source.stem)
+                cmd = ['"{}"'.format(conf['compiler'])]
+                cmd.extend(compile_flags + flags)
+                cmd.append("-c")
+                cmd.append("-o {}".format(obj))
+                cmd.append(str(source))
+                launch_command(" ".join(cmd), "Compilation of {}".format(source), verbose=args.verbose)
+                return obj
+            with concurrent.futures.ThreadPoolExecutor(max_workers=max(args.jobs, 1)) as pool:
+                objects = list(pool.map(compile, enumerate(args.source)))
+            return link_binary(objects, compile_flags + flags, exepath)
+
+        status = build(generate_flags)
+        if status.returncode != 0:
+            return status
+
+        # training run, writing its output into the scratch directory
+        env = dict(os.environ)
+        if args.lib_dirs:
+            libpath = PATH_DELIMITER.join(str(dir) for dir in args.lib_dirs)
+            for var in ("LD_LIBRARY_PATH", "DYLD_LIBRARY_PATH"):
+                env[var] = libpath + (PATH_DELIMITER + env[var] if env.get(var) else "")
+        output_dir = tmpdir / "output"
+        output_dir.mkdir()
+        cmd = [str(exepath), "-F", str(args.pgo_train), "-D", str(output_dir)]
+        if args.verbose:
+            sys.stderr.write(" ".join(cmd) + "\n")
+        training = subprocess.run(cmd, capture_output=True, text=True, env=env)
+        if training.returncode != 0:
+            sys.stdout.write(training.stdout)
+            sys.stderr.write(training.stderr)
+            raise RuntimeError("Error: training run of the instrumented binary failed")
+
+        if conf['compiler_id'] != "GNU":
+            compiler_dir = str(pathlib.Path(conf['compiler']).parent)
+            profdata_tool = shutil.which("llvm-profdata") or shutil.which("llvm-profdata", path=compiler_dir)
+            if not profdata_tool:
+                raise RuntimeError("Cannot find llvm-profdata to merge the training profile")
+            profiles = " ".join(str(f) for f in profile_dir.glob("*.profraw"))
+            cmd = '"{}" merge -output={} {}'.format(profdata_tool, profdata, profiles)
+            launch_command(cmd, "Merge of the training profile", verbose=args.verbose)
+
+        return build(use_flags)
+
 if args.swiglang:
     if not (souffle_include_dir and (souffle_include_dir / "swig").exists()):
         raise RuntimeError("Cannot find 'souffle/swig' include directory")
@@ -183,39 +376,39 @@ if args.swiglang:
 else:
     exepath = pathlib.Path("{}{}".format(args.output, exeext))
 
-    cmd = []
-    cmd.append('"{}"'.format(conf['compiler']))
-    cmd.append(conf['definitions'])
-    cmd.append(conf['compile_options'])
-    cmd.append(conf['includes'])
-    cmd.append(conf['std_flag'])
-    cmd.append(conf['cxx_flags'])
+    compile_flags = []
+    compile_flags.append(conf['definitions'])
+    compile_flags.append(conf['compile_options'])
+    compile_flags.append(conf['includes'])
+    compile_flags.append(conf['std_flag'])
+    compile_flags.append(conf['cxx_flags'])
 
     if args.debug:
-        cmd.append(conf['debug_cxx_flags'])
+        compile_flags.append(conf['debug_cxx_flags'])
     else:
-        cmd.append(conf['release_cxx_flags'])
-
-    cmd.append(OUTNAME_FMT.format(exepath))
-    for f in args.source:
-        cmd.append(str(f))
-
-    cmd.append(conf['link_options'])
-    cmd.extend(list(map(lambda rpath: RPATH_FMT.format(rpath), RPATHS)))
-    cmd.extend(list(map(lambda libdir: LIBDIR_FMT.format(libdir), args.lib_dirs)))
-    cmd.extend(list(map(lambda libname: LIBNAME_FMT.format(libname), args.lib_names)))
-
-    cmd = " ".join(cmd)
-
-    if args.verbose:
-        sys.stderr.write(cmd + "\n")
-
-    if exepath.exists():
-        exepath.unlink()
-
-    status = subprocess.run(cmd, capture_output=True, text=True, shell=True)
-    if status.returncode != 0:
-        sys.stdout.write(status.stdout)
-        sys.stderr.write(status.stderr)
-
+        compile_flags.append(conf['release_cxx_flags'])
+
+    # Several sources are compiled separately and in parallel. Object files are kept
+    # for reuse, next to the sources unless a shared cache directory is given.
+    inputs = args.source
+    if args.pgo_train:
+        status = pgo_build(compile_flags, exepath)
+        os.sys.exit(status.returncode)
+    elif len(args.source) > 1 or args.cache_dir:
+        object_dir = args.cache_dir or (args.source[0].parent / ".souffle-objects")
+        object_dir.mkdir(parents=True, exist_ok=True)
+        prelude = args.source[0].parent / "souffle_prelude.hpp"
+        prelude_flags, prelude_files = precompiled_prelude(prelude, compile_flags, object_dir)
+        object_flags = compile_flags + prelude_flags
+        with concurrent.futures.ThreadPoolExecutor(max_workers=max(args.jobs, 1)) as pool:
+            inputs = list(pool.map(lambda f: cached_object(f, object_flags, object_dir), args.source))
+
+        # objects of earlier versions of the sources are not needed anymore
+        if not args.cache_dir:
+            keep = set(inputs) | set(prelude_files)
+            for f in object_dir.glob("*"):
+                if f not in keep:
+                    f.unlink()
+
+    status = link_binary(inputs, compile_flags, exepath)
     os.sys.exit(status.returncode)
@@ -0,0 +1,105 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompileCache.cpp
+ *
+ ***********************************************************************/
+
+#include "synthesiser/CompileCache.h"
+#include "Global.h"
+#include "ram/Program.h"
+#include "souffle/utility/DigestUtil.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace souffle::synthesiser {
+
+CompileCache::CompileCache(fs::path dir, std::string key) : dir(std::move(dir)), key(std::move(key)) {
+    fs::create_directories(this->dir / "programs");
+    fs::create_directories(getObjectDir());
+}
+
+std::string CompileCache::computeKey(
+        const ram::Program& program, const MainConfig& config, const fs::path& compileScript) {
+    // options that only select what is done with the binary, or where it is put
+    static const std::set<std::string> ignoredOptions = {"", "compile", "compile-many", "compile-cache",
+            "dl-program", "generate", "generate-many", "verbose"};
+
+    Sha256 digest;
+    for (const auto& [option, values] : config.data()) {
+        if (ignoredOptions.count(option) > 0) {
+            continue;
+        }
+        digest.update(option);
+        for (const auto& value : values) {
+            digest.update(std::string_view("\0", 1)).update(value);
+        }
+        digest.update("\n");
+    }
+
+    std::ifstream script(compileScript, std::ios::binary);
+    std::stringstream scriptText;
+    scriptText << script.rdbuf();
+    digest.update(scriptText.str());
+
+    // a binary optimised for a profile depends on the training facts, which are told apart by
+    // their names, sizes and modification times
+    if (config.has("pgo-train")) {
+        std::vector<std::string> facts;
+        for (const auto& entry : fs::recursive_directory_iterator(config.get("pgo-train"))) {
+            if (entry.is_regular_file()) {
+                std::stringstream fact;
+                fact << entry.path().string() << "\t" << entry.file_size() << "\t"
+                     << entry.last_write_time().time_since_epoch().count();
+                facts.push_back(fact.str());
+            }
+        }
+        std::sort(facts.begin(), facts.end());
+        for (const auto& fact : facts) {
+            digest.update(fact).update("\n");
+        }
+    }
+
+    std::stringstream programText;
+    programText << program;
+    digest.update(programText.str());
+    return digest.hexDigest();
+}
+
+bool CompileCache::fetch(const fs::path& binary, bool& withSharedLibrary) const {
+    std::error_code error;
+    if (!fs::is_regular_file(programPath(), error)) {
+        return false;
+    }
+    fs::copy_file(programPath(), binary, fs::copy_options::overwrite_existing, error);
+    if (error) {
+        return false;
+    }
+    withSharedLibrary = fs::exists(fs::path(programPath()).concat(".functors"));
+    return true;
+}
+
+void CompileCache::store(const fs::path& binary, bool withSharedLibrary) const {
+    // copy under a unique name first, so that concurrent runs never see a partial binary
+    fs::path partial = fs::path(programPath()).concat("." + std::to_string(std::random_device()()));
+    fs::copy_file(binary, partial, fs::copy_options::overwrite_existing);
+    if (withSharedLibrary) {
+        std::ofstream marker(fs::path(programPath()).concat(".functors"));
+    }
+    fs::rename(partial, programPath());
+}
+
+}  // namespace souffle::synthesiser
@@ -0,0 +1,90 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file CompileCache.h
+ *
+ * A content-addressed cache of compiled programs, so that unchanged
+ * programs are neither synthesised nor compiled again.
+ ***********************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace souffle {
+class MainConfig;
+}
+
+namespace souffle::ram {
+class Program;
+}
+
+namespace souffle::synthesiser {
+
+/**
+ * @class CompileCache
+ * @brief Stores compiled programs in a directory, keyed by the digest of
+ * everything the binary depends on.
+ *
+ * The layout of the cache directory is
+ *  - programs/KEY: the binary of a program
+ *  - programs/KEY.functors: present if the program uses a functor library
+ *  - objects/: object files of single translation units, maintained by
+ *    souffle-compile.py
+ */
+class CompileCache {
+public:
+    /**
+     * @param dir - the cache directory, created if it does not exist
+     * @param key - the key of the program, see computeKey()
+     */
+    CompileCache(fs::path dir, std::string key);
+
+    /**
+     * Compute the key of a program from the transformed RAM program, the
+     * options it is compiled with, the version of Souffle, the compile
+     * script, which carries the C++ compiler and its flags, and the
+     * training facts of a profile-guided build.
+     */
+    static std::string computeKey(
+            const ram::Program& program, const MainConfig& config, const fs::path& compileScript);
+
+    /**
+     * Copy the cached binary to the given path.
+     *
+     * @return whether the program was found in the cache
+     */
+    bool fetch(const fs::path& binary, bool& withSharedLibrary) const;
+
+    /** Add a freshly compiled binary to the cache */
+    void store(const fs::path& binary, bool withSharedLibrary) const;
+
+    /** The directory for the object files of single translation units */
+    fs::path getObjectDir() const {
+        return dir / "objects";
+    }
+
+    const std::string& getKey() const {
+        return key;
+    }
+
+private:
+    fs::path programPath() const {
+        return dir / "programs" / key;
+    }
+
+    const fs::path dir;
+    const std::string key;
+};
+
+}  // namespace souffle::synthesiser
@@ -259,18 +259,18 @@ std::string GenDb::emitMultipleFilesInDir(fs::path dir, std::vector<fs::path>& t
     fs::path rootDir = dir;
     fs::create_directories(rootDir);
 
-    auto globalHeader = [&](std::ofstream& hpp) {
+    auto globalHeader = [&](std::ofstream& hpp, const std::set<std::string>& includes) {
         for (auto& def : globalDefines) {
             hpp << "#define " << def << "\n";
         }
-        for (auto& inc : globalIncludes) {
+        for (auto& inc : includes) {
             hpp << "#include " << inc << "\n";
         }
     };
 
     auto genHeader = [&](std::ofstream& hpp, std::ofstream& cpp, GenFile& gen) {
         hpp << "#pragma once\n";
-        globalHeader(hpp);
+        globalHeader(hpp, globalIncludes);
         for (const std::string& inc : gen.getSortedDeclIncludes()) {
             hpp << "#include " << inc << "\n";
         }
@@ -286,6 +286,23 @@ std::string GenDb::emitMultipleFilesInDir(fs::path dir, std::vector<fs::path>& t
         cpp << "#include " << gen.getHeader() << "\n";
     };
 
+    // The prelude holds the defines and the external headers of all files. No file includes it;
+    // the compile script may precompile it and force it into every translation unit.
+    std::set<std::string> preludeIncludes = globalIncludes;
+    for (auto& gen : datastructures) {
+        preludeIncludes.insert(gen->getDeclIncludes().begin(), gen->getDeclIncludes().end());
+        preludeIncludes.insert(gen->getIncludes().begin(), gen->getIncludes().end());
+    }
+    for (auto& gen : classes) {
+        preludeIncludes.insert(gen->getDeclIncludes().begin(), gen->getDeclIncludes().end());
+        preludeIncludes.insert(gen->getIncludes().begin(), gen->getIncludes().end());
+    }
+    std::ofstream prelude{rootDir / "souffle_prelude.hpp"};
+    prelude << "#ifndef SOUFFLE_PRELUDE_HPP\n#define SOUFFLE_PRELUDE_HPP\n";
+    globalHeader(prelude, preludeIncludes);
+    prelude << "#endif\n";
+    prelude.close();
+
     for (auto& ds : datastructures) {
         toCompile.push_back(rootDir / ds->fileBaseName().concat(".cpp"));
         std::ofstream hpp{rootDir / ds->fileBaseName().concat(".hpp")};
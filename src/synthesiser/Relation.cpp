@@ -10,12 +10,14 @@
 #include "RelationTag.h"
 #include "ram/analysis/Index.h"
 #include "souffle/SouffleInterface.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/MiscUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include "synthesiser/Utils.h"
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <set>
 #include <sstream>
@@ -48,7 +50,7 @@ Own<Relation> Relation::getSynthesiserRelation(
         const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection) {
     Relation* rel;
 
-    bool hasProvenance = ramRel.getArity() > 0 && ramRel.getAttributeNames().back() == "@level_number";
+    bool hasProvenance = ramRel.hasProvenance();
     // Handle the qualifier in souffle code
     if (ramRel.getAuxiliaryArity() > 0) {
         rel = new DirectRelation(ramRel, indexSelection, true, hasProvenance, false);
@@ -64,6 +66,8 @@ Own<Relation> Relation::getSynthesiserRelation(
         rel = new EqrelRelation(ramRel, indexSelection);
     } else if (ramRel.getRepresentation() == RelationRepresentation::INFO) {
         rel = new InfoRelation(ramRel, indexSelection);
+    } else if (indexSelection.isHashed()) {
+        rel = new HashRelation(ramRel, indexSelection);
     } else {
         // Handle the data structure command line flag
         if (ramRel.getArity() > 6) {
@@ -232,7 +236,15 @@ void DirectRelation::generateTypeStruct(GenDb& db) {
         decl << "struct updater {\n";
         decl << "bool update(t_tuple& old_t, const t_tuple& new_t) {\n";
         decl << "bool changed = false;\n";
-        if (hasProvenance) {
+        if (hasProvenance && relation.getAttributeNames().back() == provenance::compactAnnotationName) {
+            // a compact annotation holds the level number above the rule number
+            auto annotation = arity - 1;
+            decl << "if (ramBitCast<RamSigned>(new_t[" << annotation << "]) < ramBitCast<RamSigned>(old_t["
+                 << annotation << "])) {\n";
+            decl << "    old_t[" << annotation << "] = new_t[" << annotation << "];\n";
+            decl << "    changed = true;\n";
+            decl << "}\n";
+        } else if (hasProvenance) {
             assert(auxiliaryArity == 2);
             auto rule = arity - 2;
             auto level = arity - 1;
@@ -350,7 +362,7 @@ void DirectRelation::generateTypeStruct(GenDb& db) {
                 comparator_aux = comparator;
             }
             decl << "using t_ind_" << i << " = btree_set<t_tuple," << comparator
-                 << ",std::allocator<t_tuple>,256,typename "
+                 << ",ArenaAllocator<t_tuple>,256,typename "
                     "souffle::detail::default_strategy<t_tuple>::type,"
                  << comparator_aux << ",updater>;\n";
         } else {
@@ -359,11 +371,12 @@ void DirectRelation::generateTypeStruct(GenDb& db) {
                 btree_name = "btree_delete";
             }
             if (ind.size() == arity) {
-                decl << "using t_ind_" << i << " = " << btree_name << "_set<t_tuple," << comparator << ">;\n";
+                decl << "using t_ind_" << i << " = " << btree_name << "_set<t_tuple," << comparator
+                     << ",ArenaAllocator<t_tuple>>;\n";
             } else {
                 // without provenance, some indices may be not full, so we use btree_multiset for those
                 decl << "using t_ind_" << i << " = " << btree_name << "_multiset<t_tuple," << comparator
-                     << ">;\n";
+                     << ",ArenaAllocator<t_tuple>>;\n";
             }
         }
         decl << "t_ind_" << i << " ind_" << i << ";\n";
@@ -549,6 +562,62 @@ void DirectRelation::generateTypeStruct(GenDb& db) {
         def << "}\n";
     }
 
+    // forEachInRange method, visiting a superset of the tuples between the bounds through the index
+    // with the longest prefix of fixed attributes; the attributes that are not fixed are left open
+    std::vector<std::string> least;
+    std::vector<std::string> greatest;
+    for (const auto& type : types) {
+        switch (type[0]) {
+            case 'f':
+                least.push_back("ramBitCast<RamDomain>(-std::numeric_limits<RamFloat>::infinity())");
+                greatest.push_back("ramBitCast<RamDomain>(std::numeric_limits<RamFloat>::infinity())");
+                break;
+            case 'u':
+                least.push_back("ramBitCast<RamDomain>(MIN_RAM_UNSIGNED)");
+                greatest.push_back("ramBitCast<RamDomain>(MAX_RAM_UNSIGNED)");
+                break;
+            default: least.push_back("MIN_RAM_SIGNED"); greatest.push_back("MAX_RAM_SIGNED");
+        }
+    }
+    decl << "void forEachInRange(const t_tuple& lower, const t_tuple& upper, "
+            "const std::function<void(const t_tuple&)>& visitor) const;\n";
+    def << "void Type::forEachInRange(const t_tuple& lower, const t_tuple& upper, "
+           "const std::function<void(const t_tuple&)>& visitor) const {\n";
+    def << "static const std::vector<std::vector<std::size_t>> orders = {";
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        def << (i > 0 ? "," : "") << "{" << join(inds[i], ",") << "}";
+    }
+    def << "};\n";
+    def << "t_tuple low = {{" << join(least, ",") << "}};\n";
+    def << "t_tuple high = {{" << join(greatest, ",") << "}};\n";
+    def << "std::size_t best = 0;\n";
+    def << "std::size_t bestFixed = 0;\n";
+    def << "for (std::size_t i = 0; i < orders.size(); ++i) {\n";
+    def << "    std::size_t fixed = 0;\n";
+    def << "    while (fixed < orders[i].size() && lower[orders[i][fixed]] == upper[orders[i][fixed]]) {\n";
+    def << "        ++fixed;\n";
+    def << "    }\n";
+    def << "    if (fixed > bestFixed) {\n";
+    def << "        best = i;\n";
+    def << "        bestFixed = fixed;\n";
+    def << "    }\n";
+    def << "}\n";
+    def << "for (std::size_t i = 0; i < bestFixed; ++i) {\n";
+    def << "    low[orders[best][i]] = lower[orders[best][i]];\n";
+    def << "    high[orders[best][i]] = upper[orders[best][i]];\n";
+    def << "}\n";
+    def << "switch (best) {\n";
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        def << "case " << i << ":\n";
+        def << "    for (auto it = ind_" << i << ".lower_bound(low), end = ind_" << i
+            << ".upper_bound(high); it != end; ++it) {\n";
+        def << "        visitor(*it);\n";
+        def << "    }\n";
+        def << "    break;\n";
+    }
+    def << "}\n";
+    def << "}\n";
+
     // empty method
     decl << "bool empty() const;\n";
     def << "bool Type::empty() const {\n";
@@ -1318,6 +1387,238 @@ void BrieRelation::generateTypeStruct(GenDb& db) {
     decl << "};\n";
 }
 
+// -------- Hash Relation --------
+
+/** Generate index set for a hash relation: the key columns of each index */
+void HashRelation::computeIndices() {
+    // the master index hashes the full tuples
+    LexOrder full;
+    for (std::size_t i = 0; i < getArity(); i++) {
+        full.push_back(i);
+    }
+    computedIndices = {full};
+    masterIndex = 0;
+
+    for (auto& search : indexSelection.getSearches()) {
+        LexOrder key;
+        for (std::size_t i = 0; i < getArity(); i++) {
+            if (search[i] == analysis::AttributeConstraint::Equal) {
+                key.push_back(i);
+            }
+        }
+        if (std::find(computedIndices.begin(), computedIndices.end(), key) == computedIndices.end()) {
+            computedIndices.push_back(key);
+        }
+    }
+}
+
+std::size_t HashRelation::getIndexNumber(const SearchSignature& search) const {
+    LexOrder key;
+    for (std::size_t i = 0; i < getArity(); i++) {
+        if (search[i] == analysis::AttributeConstraint::Equal) {
+            key.push_back(i);
+        }
+    }
+    auto pos = std::find(computedIndices.begin(), computedIndices.end(), key);
+    assert(pos != computedIndices.end() && "no index for search");
+    return static_cast<std::size_t>(std::distance(computedIndices.begin(), pos));
+}
+
+/** Generate type name of a hash relation */
+std::string HashRelation::getTypeNamespace() {
+    std::unordered_set<std::size_t> attributesUsed;
+    for (std::size_t i = 0; i < getArity(); i++) {
+        attributesUsed.insert(i);
+    }
+
+    std::stringstream res;
+    res << "t_hash_" << getTypeAttributeString(relation.getAttributeTypes(), attributesUsed);
+
+    for (auto& ind : getIndices()) {
+        res << "__" << join(ind, "_");
+    }
+
+    return res.str();
+}
+
+std::string HashRelation::getTypeName() {
+    return getTypeNamespace() + "::Type";
+}
+
+/** Generate type struct of a hash relation */
+void HashRelation::generateTypeStruct(GenDb& db) {
+    std::size_t arity = getArity();
+    const auto& inds = getIndices();
+    std::size_t numIndexes = inds.size();
+
+    fs::path basename(uniqueCppIdent(getTypeNamespace(), 20));
+    GenDatastructure& cl = db.getDatastructure("Type", basename, std::make_optional(getTypeNamespace()));
+    std::ostream& decl = cl.decl();
+    std::ostream& def = cl.def();
+    cl.addInclude("\"souffle/SouffleInterface.h\"");
+    cl.addInclude("\"souffle/datastructure/HashIndex.h\"");
+
+    // struct definition
+    decl << "struct Type {\n";
+    decl << "static constexpr Relation::arity_type Arity = " << arity << ";\n";
+    decl << "using t_tuple = Tuple<RamDomain, " << arity << ">;\n";
+
+    // the master index is the set of the full tuples, the others group the new tuples by key columns
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        decl << "using t_ind_" << i << " = " << (i == masterIndex ? "HashIndex<" : "HashGroups<") << arity;
+        for (auto column : inds[i]) {
+            decl << "," << column;
+        }
+        decl << ">;\n";
+        decl << "t_ind_" << i << " ind_" << i << ";\n";
+        def << "using t_ind_" << i << " = Type::t_ind_" << i << ";\n";
+    }
+    decl << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
+    def << "using iterator = Type::iterator;\n";
+
+    // hash indexes need no hints
+    decl << "struct context {};\n";
+    def << "using context = Type::context;\n";
+    decl << "context createContext() { return context(); }\n";
+
+    // insert methods
+    decl << "bool insert(const t_tuple& t);\n";
+    def << "bool Type::insert(const t_tuple& t) {\n";
+    def << "context h;\n";
+    def << "return insert(t, h);\n";
+    def << "}\n";
+
+    decl << "bool insert(const t_tuple& t, context& h);\n";
+    def << "bool Type::insert(const t_tuple& t, context& /* h */) {\n";
+    def << "if (ind_" << masterIndex << ".insert(t)) {\n";
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        if (i != masterIndex) {
+            def << "ind_" << i << ".insert(t);\n";
+        }
+    }
+    def << "return true;\n";
+    def << "} else return false;\n";
+    def << "}\n";
+
+    decl << "bool insert(const RamDomain* ramDomain);\n";
+    def << "bool Type::insert(const RamDomain* ramDomain) {\n";
+    def << "RamDomain data[" << arity << "];\n";
+    def << "std::copy(ramDomain, ramDomain + " << arity << ", data);\n";
+    def << "const t_tuple& tuple = reinterpret_cast<const t_tuple&>(data);\n";
+    def << "context h;\n";
+    def << "return insert(tuple, h);\n";
+    def << "}\n";
+
+    std::vector<std::string> decls;
+    std::vector<std::string> params;
+    for (std::size_t i = 0; i < arity; i++) {
+        decls.push_back("RamDomain a" + std::to_string(i));
+        params.push_back("a" + std::to_string(i));
+    }
+    decl << "bool insert(" << join(decls, ",") << ");\n";
+    def << "bool Type::insert(" << join(decls, ",") << ") {\n";
+    def << "RamDomain data[" << arity << "] = {" << join(params, ",") << "};\n";
+    def << "return insert(data);\n";
+    def << "}\n";
+
+    // contains methods
+    decl << "bool contains(const t_tuple& t, context& h) const;\n";
+    def << "bool Type::contains(const t_tuple& t, context& /* h */) const {\n";
+    def << "return ind_" << masterIndex << ".contains(t);\n";
+    def << "}\n";
+
+    decl << "bool contains(const t_tuple& t) const;\n";
+    def << "bool Type::contains(const t_tuple& t) const {\n";
+    def << "context h;\n";
+    def << "return contains(t, h);\n";
+    def << "}\n";
+
+    // size method
+    decl << "std::size_t size() const;\n";
+    def << "std::size_t Type::size() const {\n";
+    def << "return ind_" << masterIndex << ".size();\n";
+    def << "}\n";
+
+    // empty lowerUpperRange method
+    decl << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+         << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const;\n";
+    def << "range<iterator> Type::lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */, context& /* h */) const {\n";
+    def << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    def << "}\n";
+
+    decl << "range<iterator> lowerUpperRange_" << SearchSignature(arity)
+         << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const;\n";
+    def << "range<iterator> Type::lowerUpperRange_" << SearchSignature(arity)
+        << "(const t_tuple& /* lower */, const t_tuple& /* upper */) const {\n";
+    def << "return range<iterator>(ind_" << masterIndex << ".begin(),ind_" << masterIndex << ".end());\n";
+    def << "}\n";
+
+    // lowerUpperRange methods, where lower and upper agree on the key columns
+    for (auto search : indexSelection.getSearches()) {
+        std::size_t indNum = getIndexNumber(search);
+
+        decl << "range<const t_tuple*> lowerUpperRange_" << search;
+        decl << "(const t_tuple& lower, const t_tuple& upper, context& h) const;\n";
+        def << "range<const t_tuple*> Type::lowerUpperRange_" << search;
+        def << "(const t_tuple& lower, const t_tuple& /* upper */, context& /* h */) const {\n";
+        def << "return ind_" << indNum << ".equalRange(lower);\n";
+        def << "}\n";
+
+        decl << "range<const t_tuple*> lowerUpperRange_" << search;
+        decl << "(const t_tuple& lower, const t_tuple& upper) const;\n";
+        def << "range<const t_tuple*> Type::lowerUpperRange_" << search;
+        def << "(const t_tuple& lower, const t_tuple& upper) const {\n";
+        def << "context h;\n";
+        def << "return lowerUpperRange_" << search << "(lower,upper,h);\n";
+        def << "}\n";
+    }
+
+    // empty method
+    decl << "bool empty() const;\n";
+    def << "bool Type::empty() const {\n";
+    def << "return ind_" << masterIndex << ".empty();\n";
+    def << "}\n";
+
+    // partition method for parallelism
+    decl << "std::vector<range<iterator>> partition() const;\n";
+    def << "std::vector<range<iterator>> Type::partition() const {\n";
+    def << "return ind_" << masterIndex << ".partition(400);\n";
+    def << "}\n";
+
+    // purge method
+    decl << "void purge();\n";
+    def << "void Type::purge() {\n";
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        def << "ind_" << i << ".clear();\n";
+    }
+    def << "}\n";
+
+    // begin and end iterators
+    decl << "iterator begin() const;\n";
+    def << "iterator Type::begin() const {\n";
+    def << "return ind_" << masterIndex << ".begin();\n";
+    def << "}\n";
+
+    decl << "iterator end() const;\n";
+    def << "iterator Type::end() const {\n";
+    def << "return ind_" << masterIndex << ".end();\n";
+    def << "}\n";
+
+    // printStatistics method
+    decl << "void printStatistics(std::ostream& o) const;\n";
+    def << "void Type::printStatistics(std::ostream& o) const {\n";
+    for (std::size_t i = 0; i < numIndexes; i++) {
+        def << "o << \" arity " << arity << " hash index " << i << " key columns " << inds[i]
+            << "\\n\";\n";
+        def << "ind_" << i << ".printStats(o);\n";
+    }
+    def << "}\n";
+
+    // end struct
+    decl << "};\n";
+}
+
 // -------- Eqrel Relation --------
 
 /** Generate index set for a eqrel relation, which should be empty */
@@ -152,6 +152,21 @@ public:
     void generateTypeStruct(GenDb& db) override;
 };
 
+class HashRelation : public Relation {
+public:
+    HashRelation(const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection)
+            : Relation(ramRel, indexSelection) {}
+
+    void computeIndices() override;
+    std::string getTypeNamespace();
+    std::string getTypeName() override;
+    void generateTypeStruct(GenDb& db) override;
+
+private:
+    /** The number of the index hashing the equality columns of a search */
+    std::size_t getIndexNumber(const ram::analysis::SearchSignature& search) const;
+};
+
 class EqrelRelation : public Relation {
 public:
     EqrelRelation(const ram::Relation& ramRel, const ram::analysis::IndexCluster& indexSelection)
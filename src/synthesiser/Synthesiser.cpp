@@ -21,6 +21,7 @@
 #include "Global.h"
 #include "RelationTag.h"
 #include "config.h"
+#include "ram/AbstractExistenceCheck.h"
 #include "ram/AbstractParallel.h"
 #include "ram/Aggregate.h"
 #include "ram/Aggregator.h"
@@ -40,6 +41,7 @@
 #include "ram/False.h"
 #include "ram/Filter.h"
 #include "ram/FloatConstant.h"
+#include "ram/GuardedInsert.h"
 #include "ram/IO.h"
 #include "ram/IfExists.h"
 #include "ram/IndexAggregate.h"
@@ -88,15 +90,19 @@
 #include "ram/UnsignedConstant.h"
 #include "ram/UserDefinedAggregator.h"
 #include "ram/UserDefinedOperator.h"
+#include "ram/Variable.h"
 #include "ram/analysis/Index.h"
 #include "ram/utility/Utils.h"
 #include "ram/utility/Visitor.h"
 #include "souffle/BinaryConstraintOps.h"
 #include "souffle/RamTypes.h"
 #include "souffle/TypeAttribute.h"
+#include "souffle/provenance/CompactAnnotation.h"
 #include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/DigestUtil.h"
 #include "souffle/utility/FileUtil.h"
 #include "souffle/utility/MiscUtil.h"
+#include "souffle/utility/RegexDfa.h"
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
 #include "souffle/utility/json11.h"
@@ -226,6 +232,11 @@ std::optional<std::size_t> Synthesiser::compileRegex(const std::string& pattern)
     }
 }
 
+std::string Synthesiser::addMemoSite(const ram::Node& site, std::size_t arity) {
+    memoSites.emplace_back(toString(site), arity);
+    return "memo_" + std::to_string(memoSites.size() - 1);
+}
+
 /// Return the C++ string raw literal sequence for the given string.
 std::string raw_str(const std::string& str) {
     if (str.find(")_\"") == std::string::npos) {
@@ -245,6 +256,17 @@ std::string raw_str(const std::string& str) {
     }
 }
 
+/// Return whether an IO statement can run in the background of the evaluation.
+bool isAsyncIO(const IO& io) {
+    const std::string& op = io.get("operation");
+    const std::string& type = io.get("IO");
+    if (op == "input") {
+        return type != "stdin";
+    }
+    // concurrent writes to a database or to the console would conflict
+    return op == "output" && (type == "file" || type == "jsonfile");
+}
+
 void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
     class CodeEmitter : public ram::Visitor<void, Node const, std::ostream&> {
         using ram::Visitor<void, Node const, std::ostream&>::visit_;
@@ -274,6 +296,30 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         std::ostringstream preamble;
         bool preambleIssued = false;
 
+        // the variables declared so far, restored when resuming a loop from a checkpoint
+        std::vector<const Variable*> declaredVariables;
+
+        /**
+         * The tuples of an insert with batch functors, which are collected before the functors
+         * are called once for the whole batch. Each row of the batch holds the tuple elements
+         * that the inserted values use.
+         */
+        struct InsertBatch {
+            std::string name;
+            std::vector<std::pair<std::size_t, std::size_t>> elements;
+            // the batch functors of the inserted values, callees before callers
+            std::vector<const UserDefinedOperator*> functors;
+        };
+
+        // the batched inserts of the current query
+        std::map<const Insert*, InsertBatch> insertBatches;
+
+        // the batch whose rows are being inserted, if any
+        const InsertBatch* currentBatch = nullptr;
+
+        // the number of rows after which a batch is inserted
+        const std::size_t batchSize = 256;
+
     public:
         CodeEmitter(Synthesiser& syn) : synthesiser(syn), glb(synthesiser.glb) {
             rec = [&](auto& out, const auto* value) {
@@ -372,10 +418,45 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
             const auto& directives = io.getDirectives();
             const std::string& op = io.get("operation");
+            const bool asyncIO = glb.config().has("async-io");
+            const bool inBackground = asyncIO && isAsyncIO(io);
+            const std::string relName = synthesiser.getRelationName(synthesiser.lookup(io.getRelation()));
+
+            // spilling is part of the evaluation and independent of the IO settings of a run
+            if (op == "spill" || op == "restore") {
+                out << "try {";
+                if (asyncIO) {
+                    // spilling purges the relation, which may still be stored in the background
+                    out << "ioScheduler.await(" << raw_str(io.getRelation()) << ");\n";
+                }
+                out << "std::map<std::string, std::string> directiveMap(";
+                printDirectives(directives);
+                out << ");\n";
+                if (op == "spill") {
+                    out << "IOSystem::getInstance().getWriter(directiveMap, symTable, recordTable)"
+                        << "->writeAll(*" << relName << ");\n";
+                    out << relName << "->purge();\n";
+                } else {
+                    out << "IOSystem::getInstance().getReader(directiveMap, symTable, recordTable)"
+                        << "->readAll(*" << relName << ");\n";
+                }
+                out << "} catch (std::exception& e) {std::cerr << \"Error "
+                    << (op == "spill" ? "spilling " : "restoring ") << io.getRelation()
+                    << ": \" << e.what() << '\\n';\nexit(1);\n}\n";
+                PRINT_END_COMMENT(out);
+                return;
+            }
+
             out << "if (performIO) {\n";
 
             // get some table details
-            if (op == "input") {
+            if (inBackground && op == "input") {
+                // the relation is loaded in the background since the start of the run
+                out << "try {";
+                out << "ioScheduler.await(" << raw_str(io.getRelation()) << ");\n";
+                out << "} catch (std::exception& e) {std::cerr << \"Error loading " << io.getRelation()
+                    << " data: \" << e.what() << '\\n';\nexit(1);\n}\n";
+            } else if (op == "input") {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 printDirectives(directives);
@@ -402,10 +483,24 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 out << R"_(else if (!outputDirectory.empty()) {)_";
                 out << R"_(directiveMap["output-dir"] = outputDirectory;)_";
                 out << "}\n";
+                if (inBackground) {
+                    // the relation is complete, so it is written while later strata are evaluated,
+                    // unless the output is redirected to the console
+                    out << "if (directiveMap[\"IO\"] != \"stdout\") {\n";
+                    out << "ioScheduler.submit(" << raw_str(io.getRelation())
+                        << ", [this, directiveMap]() {\n";
+                    out << "IOSystem::getInstance().getWriter(";
+                    out << "directiveMap, symTable, recordTable";
+                    out << ")->writeAll(*" << relName << ");\n";
+                    out << "});\n";
+                    out << "} else {\n";
+                }
                 out << "IOSystem::getInstance().getWriter(";
                 out << "directiveMap, symTable, recordTable";
-                out << ")->writeAll(*" << synthesiser.getRelationName(synthesiser.lookup(io.getRelation()))
-                    << ");\n";
+                out << ")->writeAll(*" << relName << ");\n";
+                if (inBackground) {
+                    out << "}\n";
+                }
                 out << "} catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
             } else {
                 assert("Wrong i/o operation");
@@ -467,16 +562,30 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 preamble << "->createContext());\n";
             }
 
+            // the batches of a parallel query are local to each thread
+            planInsertBatches(query);
+            for (const auto& [insert, batch] : insertBatches) {
+                emitInsertBatch(*insert, batch, preamble);
+            }
+
+            // run the loop nest, and insert the last rows of the batches
+            auto dispatchNext = [&]() {
+                dispatch(*next, out);
+                for (const auto& batch : insertBatches) {
+                    out << "flush_" << batch.second.name << "();\n";
+                }
+            };
+
             // discharge conditions that require a context
             if (isParallel) {
                 if (requireCtx.size() > 0) {
                     preamble << "if(";
                     dispatch(*toCondition(requireCtx), preamble);
                     preamble << ") {\n";
-                    dispatch(*next, out);
+                    dispatchNext();
                     out << "}\n";
                 } else {
-                    dispatch(*next, out);
+                    dispatchNext();
                 }
             } else {
                 out << preamble.str();
@@ -484,12 +593,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                     out << "if(";
                     dispatch(*toCondition(requireCtx), out);
                     out << ") {\n";
-                    dispatch(*next, out);
+                    dispatchNext();
                     out << "}\n";
                 } else {
-                    dispatch(*next, out);
+                    dispatchNext();
                 }
             }
+            insertBatches.clear();
 
             if (isParallel) {
                 out << "PARALLEL_END\n";  // end parallel
@@ -505,6 +615,117 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        /**
+         * Find the inserts of a query whose values call batch functors. Their tuples are
+         * inserted a batch at a time, unless the query reads the inserted relation or the
+         * values use variables of the loop nest.
+         */
+        void planInsertBatches(const Query& query) {
+            insertBatches.clear();
+            visit(query, [&](const Insert& insert) {
+                if (isA<GuardedInsert>(insert)) {
+                    return;
+                }
+                InsertBatch batch;
+                bool hasVariables = false;
+                std::function<void(const Node&)> addLeaves = [&](const Node& node) {
+                    for (const Node& child : node.getChildNodes()) {
+                        addLeaves(child);
+                    }
+                    if (const auto* element = as<TupleElement>(node)) {
+                        auto key = std::make_pair(element->getTupleId(), element->getElement());
+                        if (!contains(batch.elements, key)) {
+                            batch.elements.push_back(key);
+                        }
+                    } else if (const auto* udf = as<UserDefinedOperator>(node)) {
+                        if (udf->isBatch()) {
+                            batch.functors.push_back(udf);
+                        }
+                    } else if (isA<Variable>(node)) {
+                        hasVariables = true;
+                    }
+                };
+                for (const auto* value : insert.getValues()) {
+                    addLeaves(*value);
+                }
+                if (batch.functors.empty() || hasVariables) {
+                    return;
+                }
+                bool readsInserted = false;
+                visit(query, [&](const Node& node) {
+                    if (const auto* search = as<RelationOperation>(node)) {
+                        readsInserted |= search->getRelation() == insert.getRelation();
+                    } else if (const auto* exists = as<AbstractExistenceCheck>(node)) {
+                        readsInserted |= exists->getRelation() == insert.getRelation();
+                    } else if (const auto* emptiness = as<EmptinessCheck>(node)) {
+                        readsInserted |= emptiness->getRelation() == insert.getRelation();
+                    } else if (const auto* size = as<RelationSize>(node)) {
+                        readsInserted |= size->getRelation() == insert.getRelation();
+                    }
+                });
+                if (readsInserted) {
+                    return;
+                }
+                batch.name = "batch" + std::to_string(insertBatches.size());
+                insertBatches.emplace(&insert, std::move(batch));
+            });
+        }
+
+        /**
+         * Declare the rows of a batch of an insert, and the function inserting them,
+         * which calls each batch functor once for all rows
+         */
+        void emitInsertBatch(const Insert& insert, const InsertBatch& batch, std::ostream& out) {
+            const auto* rel = synthesiser.lookup(insert.getRelation());
+            const std::string& name = batch.name;
+            const std::size_t width = batch.elements.size();
+
+            out << "std::vector<RamDomain> " << name << ";\n";
+            out << "std::size_t " << name << "Count = 0;\n";
+            out << "auto flush_" << name << " = [&]() {\n";
+            out << "if (" << name << "Count == 0) return;\n";
+
+            auto emitRows = [&](auto&& emitRow) {
+                out << "for (std::size_t batchIndex = 0; batchIndex < " << name
+                    << "Count; ++batchIndex) {\n";
+                out << "[[maybe_unused]] const RamDomain* batchRow = " << name << ".data() + batchIndex * "
+                    << width << ";\n";
+                emitRow();
+                out << "}\n";
+            };
+
+            currentBatch = &batch;
+            for (std::size_t k = 0; k < batch.functors.size(); ++k) {
+                const UserDefinedOperator& op = *batch.functors[k];
+                const auto args = op.getArguments();
+                out << "std::vector<RamDomain> " << name << "Args" << k << "(" << name << "Count * "
+                    << args.size() << ");\n";
+                out << "std::vector<RamDomain> " << name << "Results" << k << "(" << name << "Count);\n";
+                emitRows([&]() {
+                    for (std::size_t i = 0; i < args.size(); ++i) {
+                        out << name << "Args" << k << "[batchIndex * " << args.size() << " + " << i
+                            << "] = ";
+                        rec(out, args[i]);
+                        out << ";\n";
+                    }
+                });
+                out << op.getName() << "(" << (op.isStateful() ? "&symTable, &recordTable, " : "") << name
+                    << "Count, " << name << "Args" << k << ".data(), " << name << "Results" << k
+                    << ".data());\n";
+            }
+            emitRows([&]() {
+                out << "Tuple<RamDomain," << rel->getArity() << "> tuple{{"
+                    << join(insert.getValues(), ",", rec) << "}};\n";
+                out << synthesiser.getRelationName(rel) << "->insert(tuple,READ_OP_CONTEXT("
+                    << synthesiser.getOpContextName(*rel) << "));\n";
+            });
+            currentBatch = nullptr;
+
+            out << name << ".clear();\n";
+            out << name << "Count = 0;\n";
+            out << "};\n";
+        }
+
         void visit_(type_identity<Clear>, const Clear& clear, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
 
@@ -534,8 +755,21 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<Sequence>, const Sequence& seq, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
+            auto containsLoop = [](const Node& node) {
+                bool found = false;
+                visit(node, [&](const Loop&) { found = true; });
+                return found;
+            };
+            // resuming in a loop skips the statements before it, but declares the variables
+            const bool resumable = glb.config().has("checkpoint") && containsLoop(seq);
             for (const auto& cur : seq.getStatements()) {
-                dispatch(*cur, out);
+                if (resumable && !containsLoop(*cur) && !isA<Assign>(cur)) {
+                    out << "if (!checkpoint.isResuming()) {\n";
+                    dispatch(*cur, out);
+                    out << "}\n";
+                } else {
+                    dispatch(*cur, out);
+                }
             }
             PRINT_END_COMMENT(out);
         }
@@ -576,11 +810,45 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<Loop>, const Loop& loop, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
+            const bool checkpoints = glb.config().has("checkpoint");
             out << "iter = 0;\n";
+            if (checkpoints) {
+                out << "if (checkpoint.enterLoop()) {\n";
+                out << "if (checkpoint.isResumedLoop()) {\n";
+                out << "iter = checkpoint.getIteration();\n";
+                for (const auto* var : declaredVariables) {
+                    dispatch(*var, out);
+                    out << " = checkpoint.getVariable(" << raw_str(var->getName()) << ");\n";
+                }
+                out << "checkpoint.resume();\n";
+                out << "}\n";
+            }
             out << "for(;;) {\n";
             dispatch(loop.getBody(), out);
             out << "iter++;\n";
+            if (checkpoints) {
+                // the relations of the loop are written through the pointers of the stratum, which swaps;
+                // an evaluation stopping at the checkpoint leaves the rest of the stratum
+                out << "if (checkpoint.isDue(iter)) {\n";
+                out << "if (checkpoint.save(iter, {";
+                out << join(declaredVariables, ",", [&](auto& os, const Variable* var) {
+                    os << "{" << raw_str(var->getName()) << ",";
+                    dispatch(*var, os);
+                    os << "}";
+                });
+                out << "}, [&](Checkpoint::Writer& writer) {\n";
+                for (const auto& name : synthesiser.accessedRelations(loop)) {
+                    const auto* rel = synthesiser.lookup(name);
+                    out << "writer.writeRelation(" << raw_str(name) << "," << rel->getArity() << ",*"
+                        << synthesiser.getRelationName(rel) << ");\n";
+                }
+                out << "})) {return;}\n";
+                out << "}\n";
+            }
             out << "}\n";
+            if (checkpoints) {
+                out << "}\n";
+            }
             out << "iter = 0;\n";
             PRINT_END_COMMENT(out);
         }
@@ -588,6 +856,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
         void visit_(type_identity<Assign>, const Assign& assign, std::ostream& out) override {
             if (assign.isInit()) {
                 out << "auto ";
+                declaredVariables.push_back(&assign.getVariable());
             }
             dispatch(assign.getVariable(), out);
             out << " = ";
@@ -626,9 +895,23 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<Call>, const Call& call, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "{\n";
+            if (glb.config().has("checkpoint")) {
+                // the strata before a checkpoint are skipped
+                out << "if (checkpoint.enterStratum()) {\n";
+            } else {
+                out << "{\n";
+            }
             out << " std::vector<RamDomain> args, ret;\n";
+            if (glb.config().has("profile-trace")) {
+                out << "SpanLogger span(" << raw_str("@stratum;" + call.getName()) << ", iter);\n";
+            }
             out << synthesiser.convertStratumIdent(call.getName()) << ".run(args, ret);\n";
+            if (glb.config().has("compact-tables")) {
+                out << "compactTables();\n";
+            }
+            if (glb.config().has("checkpoint")) {
+                out << "checkpoint.leaveStratum();\n";
+            }
             out << "}\n";
             PRINT_END_COMMENT(out);
         }
@@ -689,7 +972,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             dispatch(nested.getOperation(), out);
             if (glb.config().has("profile") && glb.config().has("profile-frequency") &&
                     !nested.getProfileText().empty()) {
-                out << "freqs[" << synthesiser.lookupFreqIdx(nested.getProfileText()) << "]++;\n";
+                out << "freqs.increment(" << synthesiser.lookupFreqIdx(nested.getProfileText()) << ");\n";
             }
         }
 
@@ -915,6 +1198,15 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             constantsStream << "}";
             std::string constants = stringify(constantsStream.str());
 
+            // partitions of brie and eqrel indexes are aligned with key values, which would bias a block
+            // sample, hence they are always scanned completely
+            const bool blockSampling = rel->getRepresentation() != RelationRepresentation::BRIE &&
+                                       rel->getRepresentation() != RelationRepresentation::EQREL;
+            const std::size_t statisticsSampleSize =
+                    (blockSampling && glb.config().has("statistics-sample"))
+                            ? std::stoul(glb.config().get("statistics-sample"))
+                            : 0;
+
             std::string profilerText =
                     (estimateJoinSize.isRecursiveRelation() ? stringify("@recursive-estimate-join-size;" +
                                                                         estimateJoinSize.getRelation() + ";" +
@@ -926,13 +1218,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_BEGIN_COMMENT(out);
             auto ctxName = "READ_OP_CONTEXT(" + synthesiser.getOpContextName(*rel) + ")";
             out << "{\n";
-            out << "double total = 0;\n";
-            out << "double duplicates = 0;\n";
-
-            out << "if (!" << indexName << ".empty()) {\n";
-            out << "bool first = true;\n";
-            out << "auto prev = *" << indexName << ".begin();\n";
-            out << "for(const auto& tup : " << indexName << ") {\n";
+            out << "auto sample = souffle::evaluator::sampleJoinSize(" << indexName << ", "
+                << statisticsSampleSize << ",\n";
+            out << "[&](const auto& tup) {\n";
             out << "    bool matchesConstants = true;\n";
             for (auto& [k, constant] : keyConstants) {
                 if (rel->getArity() > 6) {
@@ -941,11 +1229,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                     out << "matchesConstants &= (tup[" << k << "] == " << constant << ");\n";
                 }
             }
-            out << "if (!matchesConstants) {\n";
-            out << "    continue;\n";
-            out << "}\n";
-            out << "if (first) { first = false; }\n";
-            out << "else {\n";
+            out << "    return matchesConstants;\n";
+            out << "},\n";
+            out << "[&](const auto& prev, const auto& tup) {\n";
             out << "    bool matchesPrev = true;\n";
             for (auto k : estimateJoinSize.getKeyColumns()) {
                 if (rel->getArity() > 6) {
@@ -954,14 +1240,10 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                     out << "matchesPrev &= (tup[" << k << "] == prev[" << k << "]);\n";
                 }
             }
-            out << "if (matchesPrev) { ++duplicates; }\n";
-            out << "}\n";
-            out << "prev = tup; ++total;\n";
-            out << "\n";
-            out << "}\n";
-            out << "}\n";
-            out << "double joinSize = ("
-                << (onlyConstants ? "total" : "total / std::max(1.0, (total - duplicates))") << ");\n";
+            out << "    return matchesPrev;\n";
+            out << "});\n";
+            out << "double joinSize = souffle::evaluator::estimateJoinSize(sample, " << indexName
+                << ".size(), " << (onlyConstants ? "true" : "false") << ");\n";
             if (estimateJoinSize.isRecursiveRelation()) {
                 out << "ProfileEventSingleton::instance().makeRecursiveCountEvent(\"" << profilerText
                     << "\", joinSize, iter);\n";
@@ -1782,6 +2064,24 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<Insert>, const Insert& insert, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
+            if (auto batch = insertBatches.find(&insert); batch != insertBatches.end()) {
+                // collect the tuple elements of the inserted values
+                const std::string& name = batch->second.name;
+                const auto& elements = batch->second.elements;
+                if (!elements.empty()) {
+                    out << name << ".insert(" << name << ".end(),{"
+                        << join(elements, ",",
+                                   [](auto& os, const auto& element) {
+                                       os << "env" << element.first << "[" << element.second << "]";
+                                   })
+                        << "});\n";
+                }
+                out << "if (++" << name << "Count == " << batchSize << ") {\n";
+                out << "flush_" << name << "();\n";
+                out << "}\n";
+                PRINT_END_COMMENT(out);
+                return;
+            }
             const auto* rel = synthesiser.lookup(insert.getRelation());
             auto arity = rel->getArity();
             auto relName = synthesiser.getRelationName(rel);
@@ -1841,6 +2141,75 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        /**
+         * Emit a match or contains constraint, where arg(expression, i) emits the
+         * i-th argument of the constraint. If given, the flag named by valid is cleared
+         * when a pattern computed at run time does not compile.
+         */
+        void emitStringConstraint(const Constraint& rel,
+                const std::function<void(const Expression&, std::size_t)>& arg, std::ostream& out,
+                const std::string& valid = "") {
+            switch (rel.getOperator()) {
+                case BinaryConstraintOp::MATCH: {
+                    if (const StringConstant* str = as<StringConstant>(&rel.getLHS()); str) {
+                        const auto& regex = synthesiser.compileRegex(str->getConstant());
+                        if (regex) {
+                            out << "regexes.at(" << *regex << ").match(symTable.decode(";
+                            arg(rel.getRHS(), 1);
+                            out << "))";
+                        } else {
+                            out << "false";
+                        }
+                    } else {
+                        synthesiser.SubroutineUsingStdRegex = true;
+                        out << "regex_wrapper(";
+                        arg(rel.getLHS(), 0);
+                        out << ",symTable.decode(";
+                        arg(rel.getRHS(), 1);
+                        out << ")" << (valid.empty() ? "" : ",&" + valid) << ")";
+                    }
+                    break;
+                }
+                case BinaryConstraintOp::NOT_MATCH: {
+                    if (const StringConstant* str = as<StringConstant>(&rel.getLHS()); str) {
+                        const auto& regex = synthesiser.compileRegex(str->getConstant());
+                        if (regex) {
+                            out << "!regexes.at(" << *regex << ").match(symTable.decode(";
+                            arg(rel.getRHS(), 1);
+                            out << "))";
+                        } else {
+                            out << "false";
+                        }
+                    } else {
+                        synthesiser.SubroutineUsingStdRegex = true;
+                        out << "!regex_wrapper(";
+                        arg(rel.getLHS(), 0);
+                        out << ",symTable.decode(";
+                        arg(rel.getRHS(), 1);
+                        out << ")" << (valid.empty() ? "" : ",&" + valid) << ")";
+                    }
+                    break;
+                }
+                case BinaryConstraintOp::CONTAINS: {
+                    out << "(symTable.decode(";
+                    arg(rel.getRHS(), 1);
+                    out << ").find(symTable.decode(";
+                    arg(rel.getLHS(), 0);
+                    out << ")) != std::string::npos)";
+                    break;
+                }
+                case BinaryConstraintOp::NOT_CONTAINS: {
+                    out << "(symTable.decode(";
+                    arg(rel.getRHS(), 1);
+                    out << ").find(symTable.decode(";
+                    arg(rel.getLHS(), 0);
+                    out << ")) == std::string::npos)";
+                    break;
+                }
+                default: fatal("unsupported string constraint");
+            }
+        }
+
         void visit_(type_identity<Constraint>, const Constraint& rel, std::ostream& out) override {
             // clang-format off
 #define EVAL_CHILD(ty, idx)        \
@@ -1883,60 +2252,50 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 COMPARE(GE, >=)
 
                 // strings
-                case BinaryConstraintOp::MATCH: {
-                    if (const StringConstant* str = as<StringConstant>(&rel.getLHS()); str) {
-                        const auto& regex = synthesiser.compileRegex(str->getConstant());
-                        if (regex) {
-                            out << "std::regex_match(symTable.decode(";
-                            dispatch(rel.getRHS(), out);
-                            out << "), regexes.at(" << *regex << "))";
-                        } else {
-                            out << "false";
-                        }
-                    } else {
-                        synthesiser.SubroutineUsingStdRegex = true;
-                        out << "regex_wrapper(symTable.decode(";
-                        dispatch(rel.getLHS(), out);
-                        out << "),symTable.decode(";
-                        dispatch(rel.getRHS(), out);
-                        out << "))";
+                case BinaryConstraintOp::MATCH:
+                case BinaryConstraintOp::NOT_MATCH:
+                case BinaryConstraintOp::CONTAINS:
+                case BinaryConstraintOp::NOT_CONTAINS: {
+                    if (!glb.config().has("memoise")) {
+                        emitStringConstraint(
+                                rel, [&](const Expression& arg, std::size_t) { dispatch(arg, out); }, out);
+                        break;
                     }
-                    break;
-                }
-                case BinaryConstraintOp::NOT_MATCH: {
-                    if (const StringConstant* str = as<StringConstant>(&rel.getLHS()); str) {
-                        const auto& regex = synthesiser.compileRegex(str->getConstant());
-                        if (regex) {
-                            out << "!std::regex_match(symTable.decode(";
-                            dispatch(rel.getRHS(), out);
-                            out << "), regexes.at(" << *regex << "))";
-                        } else {
-                            out << "false";
-                        }
-                    } else {
-                        synthesiser.SubroutineUsingStdRegex = true;
-                        out << "!regex_wrapper(symTable.decode(";
+                    const bool isMatch = rel.getOperator() == BinaryConstraintOp::MATCH ||
+                                         rel.getOperator() == BinaryConstraintOp::NOT_MATCH;
+                    if (isMatch && !isA<StringConstant>(rel.getLHS())) {
+                        // failures of invalid patterns are not memoised, so that each one is reported
+                        const std::string memo = synthesiser.addMemoSite(rel, 2);
+                        out << "[&]() -> bool {\n"
+                            << "const RamDomain memoArgs[2] = {";
                         dispatch(rel.getLHS(), out);
-                        out << "),symTable.decode(";
+                        out << ",";
                         dispatch(rel.getRHS(), out);
-                        out << "))";
+                        out << "};\n"
+                            << "RamDomain memoResult;\n"
+                            << "if (" << memo << ".lookup(memoArgs, memoResult)) return memoResult != 0;\n"
+                            << "bool valid = true;\n"
+                            << "memoResult = ";
+                        emitStringConstraint(
+                                rel,
+                                [&](const Expression&, std::size_t i) { out << "memoArgs[" << i << "]"; },
+                                out, "valid");
+                        out << ";\n"
+                            << "if (valid) " << memo << ".insert(memoArgs, memoResult);\n"
+                            << "return memoResult != 0;\n"
+                            << "}()";
+                        break;
                     }
-                    break;
-                }
-                case BinaryConstraintOp::CONTAINS: {
-                    out << "(symTable.decode(";
-                    dispatch(rel.getRHS(), out);
-                    out << ").find(symTable.decode(";
+                    // look up the result for the symbols of both arguments first
+                    out << "(" << synthesiser.addMemoSite(rel, 2)
+                        << ".getOrCompute(std::array<RamDomain,2>{{";
                     dispatch(rel.getLHS(), out);
-                    out << ")) != std::string::npos)";
-                    break;
-                }
-                case BinaryConstraintOp::NOT_CONTAINS: {
-                    out << "(symTable.decode(";
+                    out << ",";
                     dispatch(rel.getRHS(), out);
-                    out << ").find(symTable.decode(";
-                    dispatch(rel.getLHS(), out);
-                    out << ")) == std::string::npos)";
+                    out << "}}.data(),[&](const RamDomain* memoArgs) -> RamDomain {\nreturn ";
+                    emitStringConstraint(rel,
+                            [&](const Expression&, std::size_t i) { out << "memoArgs[" << i << "]"; }, out);
+                    out << ";}) != 0)";
                     break;
                 }
             }
@@ -1977,7 +2336,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             std::string after;
             if (glb.config().has("profile") && glb.config().has("profile-frequency") &&
                     !synthesiser.lookup(exists.getRelation())->isTemp()) {
-                out << R"_((reads[)_" << synthesiser.lookupReadIdx(rel->getName()) << R"_(]++,)_";
+                out << R"_((reads.increment()_" << synthesiser.lookupReadIdx(rel->getName()) << R"_(),)_";
                 after = ")";
             }
 
@@ -2019,8 +2378,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 << "lowerUpperRange";
             out << "_" << isa->getSearchSignature(&provExists);
 
-            // parts refers to payload + rule number
-            std::size_t parts = arity - auxiliaryArity + 1;
+            // parts refers to payload + rule number, which compact annotations do not have apart
+            const bool compact = rel->getAttributeNames().back() == provenance::compactAnnotationName;
+            std::size_t parts = arity - auxiliaryArity + (compact ? 0 : 1);
 
             // make a copy of provExists.getValues() so we can be sure that vals is always the same vector
             // since provExists.getValues() creates a new vector on the stack each time
@@ -2040,7 +2400,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             rangeBounds.second.seekp(-2, std::ios_base::end);
 
             // extra bounds for provenance height annotations
-            for (std::size_t i = 0; i < auxiliaryArity - 2; i++) {
+            for (std::size_t i = parts; i + 1 < arity; i++) {
                 rangeBounds.first << ",ramBitCast<RamDomain, RamSigned>(MIN_RAM_SIGNED)";
                 rangeBounds.second << ",ramBitCast<RamDomain, RamSigned>(MAX_RAM_SIGNED)";
             }
@@ -2050,9 +2410,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             out << "(" << rangeBounds.first.str() << "," << rangeBounds.second.str() << "," << ctxName
                 << ");\n";
             out << "if (existenceCheck.empty()) return false; else return ((*existenceCheck.begin())["
-                << arity - auxiliaryArity + 1 << "] <= ";
+                << arity - 1 << "] <= ";
 
-            dispatch(*(provExists.getValues()[arity - auxiliaryArity + 1]), out);
+            dispatch(*(provExists.getValues()[arity - 1]), out);
             out << ")";
             out << ";}()\n";
             PRINT_END_COMMENT(out);
@@ -2092,7 +2452,16 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
 
         void visit_(type_identity<TupleElement>, const TupleElement& access, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
-            out << "env" << access.getTupleId() << "[" << access.getElement() << "]";
+            if (currentBatch != nullptr) {
+                // the element collected in the current row of the batch
+                const auto& elements = currentBatch->elements;
+                const auto pos = std::find(elements.begin(), elements.end(),
+                        std::make_pair(access.getTupleId(), access.getElement()));
+                assert(pos != elements.end() && "tuple element not collected in batch");
+                out << "batchRow[" << std::distance(elements.begin(), pos) << "]";
+            } else {
+                out << "env" << access.getTupleId() << "[" << access.getElement() << "]";
+            }
             PRINT_END_COMMENT(out);
         }
 
@@ -2216,9 +2585,9 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 }
                 // TODO: change the signature of `STRLEN` to return an unsigned?
                 case FunctorOp::STRLEN: {
-                    out << "static_cast<RamSigned>(symTable.decode(";
-                    dispatch(*args[0], out);
-                    out << ").size())";
+                    out << "static_cast<RamSigned>(";
+                    emitString(*args[0], out);
+                    out << ".size())";
                     break;
                 }
 
@@ -2300,32 +2669,13 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 case FunctorOp::SMIN: MINMAX_SYMBOL(std::min)
 
                 // strings
-                case FunctorOp::CAT: {
-                    out << "symTable.encode(";
-                    std::size_t i = 0;
-                    while (i < args.size() - 1) {
-                        out << "symTable.decode(";
-                        dispatch(*args[i], out);
-                        out << ") + ";
-                        i++;
-                    }
-                    out << "symTable.decode(";
-                    dispatch(*args[i], out);
-                    out << "))";
-                    break;
-                }
-
+                case FunctorOp::CAT:
                 /** Ternary Functor Operators */
                 case FunctorOp::SUBSTR: {
-                    synthesiser.SubroutineUsingSubstr = true;
+                    // only the outermost string built is interned
                     out << "symTable.encode(";
-                    out << "substr_wrapper(symTable.decode(";
-                    dispatch(*args[0], out);
-                    out << "),(";
-                    dispatch(*args[1], out);
-                    out << "),(";
-                    dispatch(*args[2], out);
-                    out << ")))";
+                    emitString(op, out);
+                    out << ")";
                     break;
                 }
 
@@ -2401,7 +2751,24 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             const std::string& name = op.getName();
 
             auto args = op.getArguments();
-            if (op.isStateful()) {
+            if (op.isBatch() && currentBatch != nullptr) {
+                // the result of the current row of the batch
+                const auto& functors = currentBatch->functors;
+                const auto pos = std::find(functors.begin(), functors.end(), &op);
+                assert(pos != functors.end() && "batch functor not called for batch");
+                out << "ramBitCast<" << ramTypeName(op.getReturnType()) << ">(" << currentBatch->name
+                    << "Results" << std::distance(functors.begin(), pos) << "[batchIndex])";
+            } else if (op.isBatch()) {
+                // outside of batched inserts, the batches have a single row
+                out << "[&]() -> " << ramTypeName(op.getReturnType()) << " {\n"
+                    << "std::array<RamDomain," << args.size() << "> batchArgs{{" << join(args, ",", rec)
+                    << "}};\n"
+                    << "RamDomain batchResult;\n"
+                    << name << "(" << (op.isStateful() ? "&symTable, &recordTable, " : "")
+                    << "1, batchArgs.data(), &batchResult);\n"
+                    << "return ramBitCast<" << ramTypeName(op.getReturnType()) << ">(batchResult);\n"
+                    << "}()";
+            } else if (op.isStateful()) {
                 out << name << "(&symTable, &recordTable";
                 for (auto& arg : args) {
                     out << ",";
@@ -2411,6 +2778,20 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
             } else {
                 const std::vector<TypeAttribute>& argTypes = op.getArgsTypes();
 
+                std::function<void(std::size_t)> emitArg = [&](std::size_t i) { dispatch(*args[i], out); };
+                const bool memoise = glb.config().has("memoise");
+                if (memoise) {
+                    // look up the result for the arguments first
+                    out << "ramBitCast<" << ramTypeName(op.getReturnType()) << ">("
+                        << synthesiser.addMemoSite(op, args.size()) << ".getOrCompute(std::array<RamDomain,"
+                        << args.size() << ">{{" << join(args, ",", rec)
+                        << "}}.data(),[&]([[maybe_unused]] const RamDomain* memoArgs) -> RamDomain {\n"
+                        << "return ramBitCast(";
+                    emitArg = [&](std::size_t i) {
+                        out << "ramBitCast<" << ramTypeName(argTypes[i]) << ">(memoArgs[" << i << "])";
+                    };
+                }
+
                 if (op.getReturnType() == TypeAttribute::Symbol) {
                     out << "symTable.encode(";
                 }
@@ -2423,22 +2804,22 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                     switch (argTypes[i]) {
                         case TypeAttribute::Signed:
                             out << "((RamSigned)";
-                            dispatch(*args[i], out);
+                            emitArg(i);
                             out << ")";
                             break;
                         case TypeAttribute::Unsigned:
                             out << "((RamUnsigned)";
-                            dispatch(*args[i], out);
+                            emitArg(i);
                             out << ")";
                             break;
                         case TypeAttribute::Float:
                             out << "((RamFloat)";
-                            dispatch(*args[i], out);
+                            emitArg(i);
                             out << ")";
                             break;
                         case TypeAttribute::Symbol:
                             out << "symTable.decode(";
-                            dispatch(*args[i], out);
+                            emitArg(i);
                             out << ").c_str()";
                             break;
                         case TypeAttribute::ADT:
@@ -2449,6 +2830,51 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
                 if (op.getReturnType() == TypeAttribute::Symbol) {
                     out << ")";
                 }
+                if (memoise) {
+                    out << ");}))";
+                }
+            }
+        }
+
+        /**
+         * Emit the string of a symbol expression. The strings built by nested cat and
+         * substr functors are passed on without interning them.
+         */
+        void emitString(const Expression& expr, std::ostream& out) {
+            const auto* op = as<IntrinsicOperator>(expr);
+            if (op != nullptr && op->getOperator() == FunctorOp::CAT) {
+                out << "souffle::concatenate({";
+                bool first = true;
+                for (const auto* arg : op->getArguments()) {
+                    out << (first ? "" : ",");
+                    emitString(*arg, out);
+                    first = false;
+                }
+                out << "})";
+            } else if (op != nullptr && op->getOperator() == FunctorOp::SUBSTR) {
+                const auto args = op->getArguments();
+                synthesiser.SubroutineUsingSubstr = true;
+                out << "substr_wrapper(";
+                emitString(*args[0], out);
+                out << ",(";
+                dispatch(*args[1], out);
+                out << "),(";
+                dispatch(*args[2], out);
+                out << "))";
+            } else {
+                out << "symTable.decode(";
+                dispatch(expr, out);
+                out << ")";
+            }
+        }
+
+        /** The type of values of the given kind in generated code */
+        static std::string ramTypeName(TypeAttribute type) {
+            switch (type) {
+                case TypeAttribute::Unsigned: return "RamUnsigned";
+                case TypeAttribute::Float: return "RamFloat";
+                case TypeAttribute::Signed: return "RamSigned";
+                default: return "RamDomain";
             }
         }
 
@@ -2512,7 +2938,7 @@ void Synthesiser::emitCode(std::ostream& out, const Statement& stmt) {
     CodeEmitter(*this).dispatch(stmt, out);
 }
 
-std::set<std::string> Synthesiser::accessedRelations(Statement& stmt) {
+std::set<std::string> Synthesiser::accessedRelations(const Statement& stmt) {
     std::set<std::string> accessed;
     visit(stmt, [&](const Insert& node) { accessed.insert(node.getRelation()); });
     visit(stmt, [&](const RelationOperation& node) { accessed.insert(node.getRelation()); });
@@ -2592,10 +3018,11 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     }
 
     // produce external definitions for user-defined functors
-    std::map<std::string, std::tuple<TypeAttribute, std::vector<TypeAttribute>, bool>> functors;
+    std::map<std::string, std::tuple<TypeAttribute, std::vector<TypeAttribute>, bool, bool>> functors;
     visit(prog, [&](const UserDefinedOperator& op) {
         if (functors.find(op.getName()) == functors.end()) {
-            functors[op.getName()] = std::make_tuple(op.getReturnType(), op.getArgsTypes(), op.isStateful());
+            functors[op.getName()] =
+                    std::make_tuple(op.getReturnType(), op.getArgsTypes(), op.isStateful(), op.isBatch());
         }
         withSharedLibrary = true;
     });
@@ -2603,7 +3030,7 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         const Aggregator& aggregator = op.getAggregator();
         if (const auto* uda = as<UserDefinedAggregator>(aggregator)) {
             functors[uda->getName()] =
-                    std::make_tuple(uda->getReturnType(), uda->getArgsTypes(), uda->isStateful());
+                    std::make_tuple(uda->getReturnType(), uda->getArgsTypes(), uda->isStateful(), false);
             withSharedLibrary = true;
         }
     };
@@ -2617,6 +3044,7 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         const auto& returnType = std::get<0>(functorTypes);
         const auto& argsTypes = std::get<1>(functorTypes);
         const auto& stateful = std::get<2>(functorTypes);
+        const auto& batch = std::get<3>(functorTypes);
 
         auto cppTypeDecl = [](TypeAttribute ty) -> char const* {
             switch (ty) {
@@ -2633,7 +3061,17 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
 
         std::vector<std::string> argsTy;
         std::string retTy;
-        if (stateful) {
+        if (batch) {
+            // rows of arguments in, a result per row out
+            retTy = "void";
+            if (stateful) {
+                argsTy.push_back("souffle::SymbolTable*");
+                argsTy.push_back("souffle::RecordTable*");
+            }
+            argsTy.push_back("std::size_t");
+            argsTy.push_back("const souffle::RamDomain*");
+            argsTy.push_back("souffle::RamDomain*");
+        } else if (stateful) {
             retTy = "souffle::RamDomain";
             argsTy.push_back("souffle::SymbolTable*");
             argsTy.push_back("souffle::RecordTable*");
@@ -2729,7 +3167,7 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         std::vector<std::tuple<Mode, std::string /*name*/, std::string /*type*/>> args;
         args.push_back(std::make_tuple(Reference, "symTable", "SymbolTable"));
         args.push_back(std::make_tuple(Reference, "recordTable", "RecordTable"));
-        args.push_back(std::make_tuple(Reference, "regexCache", "ConcurrentCache<std::string,std::regex>"));
+        args.push_back(std::make_tuple(Reference, "regexCache", "ConcurrentCache<RamDomain,RegexMatcher>"));
         args.push_back(std::make_tuple(Reference, "pruneImdtRels", "bool"));
         args.push_back(std::make_tuple(Reference, "performIO", "bool"));
         args.push_back(std::make_tuple(Reference, "signalHandler", "SignalHandler*"));
@@ -2737,6 +3175,14 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         args.push_back(std::make_tuple(Reference, "ctr", "std::atomic<RamDomain>"));
         args.push_back(std::make_tuple(Reference, "inputDirectory", "std::string"));
         args.push_back(std::make_tuple(Reference, "outputDirectory", "std::string"));
+        if (glb.config().has("async-io")) {
+            gen.addInclude("\"souffle/io/IOScheduler.h\"");
+            args.push_back(std::make_tuple(Reference, "ioScheduler", "IOScheduler"));
+        }
+        if (glb.config().has("checkpoint")) {
+            gen.addInclude("\"souffle/io/Checkpoint.h\"");
+            args.push_back(std::make_tuple(Reference, "checkpoint", "Checkpoint"));
+        }
         for (std::string rel : accessedRels) {
             std::string name = getRelationName(lookup(rel));
             std::string tyname = relationTypes[name];
@@ -2779,6 +3225,7 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         }
         SubroutineUsingStdRegex = false;
         SubroutineUsingSubstr = false;
+        memoSites.clear();
         // emit code for subroutine
         currentClass = &gen;
         emitCode(run.body(), *sub.second);
@@ -2789,21 +3236,24 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
             // regex wrapper
             GenFunction& wrapper = gen.addFunction("regex_wrapper", Visibility::Private);
             wrapper.setRetType("inline bool");
-            wrapper.setNextArg("const std::string&", "pattern");
+            wrapper.setNextArg("RamDomain", "pattern");
             wrapper.setNextArg("const std::string&", "text");
+            wrapper.setNextArg("bool*", "valid", "nullptr");
             wrapper.body()
                     << "   bool result = false; \n"
-                    << "   try { result = std::regex_match(text, regexCache.getOrCreate(pattern)); } "
+                    << "   try { result = regexCache.getOrCreate(pattern, [&](RamDomain p) {\n"
+                       "       return RegexMatcher(symTable.decode(p)); }).match(text); } "
                        "catch(...) { "
                        "\n"
-                    << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << pattern << "
-                       "\"\\\",\\\"\" "
-                       "<< text << \"\\\").\\n\";\n}\n"
+                    << "     std::cerr << \"warning: wrong pattern provided for match(\\\"\" << "
+                       "symTable.decode(pattern) << \"\\\",\\\"\" "
+                       "<< text << \"\\\").\\n\";\n"
+                    << "     if (valid != nullptr) *valid = false;\n}\n"
                     << "   return result;\n";
         }
 
         if (!regexes.empty()) {
-            gen.addField("std::vector<std::regex>", "regexes", Visibility::Private);
+            gen.addField("std::vector<RegexMatcher>", "regexes", Visibility::Private);
             std::stringstream rst;
             // we need to collect the patterns first and place each
             // one into the correct slot
@@ -2814,7 +3264,18 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
             }
             rst << "{\n";
             for (const auto& p : patterns) {
-                rst << "  std::regex(" << raw_str(p) << "),\n";
+                // emit the tables of the automaton, unless they are larger than the pattern is worth
+                auto dfa = RegexDfa::compile(p);
+                if (!dfa || dfa->getTransitions().size() > (1u << 16)) {
+                    rst << "  RegexMatcher(" << raw_str(p) << "),\n";
+                    continue;
+                }
+                rst << "  RegexMatcher(RegexDfa({" << join(dfa->getClasses(), ",", [](auto& out, uint8_t c) {
+                    out << static_cast<unsigned>(c);
+                }) << "},\n    {" << join(dfa->getTransitions()) << "},\n    {";
+                rst << join(dfa->getAccepting(), ",", [](auto& out, bool accepting) {
+                    out << (accepting ? "true" : "false");
+                }) << "})),\n";
             }
             rst << "}";
 
@@ -2822,6 +3283,34 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
             regexes.clear();
         }
 
+        // caches of the call sites of --memoise
+        for (std::size_t i = 0; i < memoSites.size(); ++i) {
+            const std::string memo = "memo_" + std::to_string(i);
+            gen.addField("MemoTable", memo, Visibility::Private);
+            constructor.setNextInitializer(memo, std::to_string(memoSites[i].second) + ",4096," +
+                                                         (glb.config().has("profile") ? "true" : "false"));
+        }
+        if (!memoSites.empty()) {
+            memoisedStrata.push_back(convertStratumIdent("stratum_" + sub.first));
+        }
+        if (!memoSites.empty() && glb.config().has("profile")) {
+            GenFunction& dumpMemo = gen.addFunction("dumpMemo", Visibility::Public);
+            dumpMemo.setRetType("void");
+            for (std::size_t i = 0; i < memoSites.size(); ++i) {
+                const std::string memo = "memo_" + std::to_string(i);
+                dumpMemo.body() << "ProfileEventSingleton::instance().makeMemoEvent("
+                                << raw_str("@memo;" + stringify(memoSites[i].first)) << "," << memo
+                                << ".getHits()," << memo << ".getCalls());\n";
+            }
+        }
+        if (!memoSites.empty() && glb.config().has("compact-tables")) {
+            GenFunction& clearMemo = gen.addFunction("clearMemo", Visibility::Public);
+            clearMemo.setRetType("void");
+            for (std::size_t i = 0; i < memoSites.size(); ++i) {
+                clearMemo.body() << "memo_" << i << ".clear();\n";
+            }
+        }
+
         // substring wrapper
         if (SubroutineUsingSubstr) {
             GenFunction& wrapper = gen.addFunction("substr_wrapper", Visibility::Private);
@@ -2872,22 +3361,24 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     mainClass.addField(rt.str(), "recordTable", Visibility::Private);
     constructor.setNextInitializer("recordTable", "");
 
-    mainClass.addField("ConcurrentCache<std::string,std::regex>", "regexCache", Visibility::Private);
+    mainClass.addField("ConcurrentCache<RamDomain,RegexMatcher>", "regexCache", Visibility::Private);
     constructor.setNextInitializer("regexCache", "");
 
     if (glb.config().has("profile")) {
         std::size_t numFreq = 0;
         visit(prog, [&](const Statement&) { numFreq++; });
-        mainClass.addField("std::size_t", "freqs[" + std::to_string(numFreq) + "]", Visibility::Private);
-        constructor.setNextInitializer("freqs", "");
+        // counters are sharded per thread and only summed up when the profile is dumped
+        mainClass.addInclude("\"souffle/datastructure/ShardedCounters.h\"");
+        mainClass.addField("ShardedCounters", "freqs", Visibility::Private);
+        constructor.setNextInitializer("freqs", std::to_string(numFreq));
         std::size_t numRead = 0;
         for (auto rel : prog.getRelations()) {
             if (!rel->isTemp()) {
                 numRead++;
             }
         }
-        mainClass.addField("std::size_t", "reads[" + std::to_string(numRead) + "]", Visibility::Private);
-        constructor.setNextInitializer("reads", "");
+        mainClass.addField("ShardedCounters", "reads", Visibility::Private);
+        constructor.setNextInitializer("reads", std::to_string(numRead));
     }
 
     for (const auto& f : functors) {
@@ -2942,6 +3433,10 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
 
     if (glb.config().has("profile")) {
         constructor.body() << "ProfileEventSingleton::instance().setOutputFile(profiling_fname);\n";
+        if (glb.config().has("profile-trace")) {
+            constructor.body() << "ProfileEventSingleton::instance().setTraceFile("
+                               << raw_str(glb.config().get("profile-trace")) << ");\n";
+        }
     }
 
     for (const auto& f : functors) {
@@ -2952,6 +3447,11 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     // -- destructor --
     GenFunction& destructor = mainClass.addFunction("~" + classname, Visibility::Public);
     destructor.setIsConstructor();
+    if (glb.config().has("spill-dir")) {
+        // relations spilled by an aborted evaluation are never restored
+        mainClass.addInclude("\"souffle/io/SpillStream.h\"", true);
+        destructor.body() << "SpillStore::getInstance().release(&symTable);\n";
+    }
 
     // issue state variables for the evaluation
     //
@@ -2963,6 +3463,67 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     mainClass.addField("SignalHandler*", "signalHandler", Visibility::Private, "{SignalHandler::instance()}");
     mainClass.addField("std::atomic<RamDomain>", "ctr", Visibility::Private, "{}");
     mainClass.addField("std::atomic<std::size_t>", "iter", Visibility::Private, "{}");
+    if (glb.config().has("async-io")) {
+        // declared after the relations, so that pending tasks finish before the relations are destroyed
+        mainClass.addInclude("\"souffle/io/IOScheduler.h\"");
+        mainClass.addField("IOScheduler", "ioScheduler", Visibility::Private);
+    }
+    if (glb.config().has("compact-tables")) {
+        mainClass.addInclude("\"souffle/datastructure/TableCompactor.h\"");
+        mainClass.addField("std::unique_ptr<TableCompactor>", "compactor", Visibility::Private);
+    }
+    if (glb.config().has("checkpoint")) {
+        // a checkpoint of another program is not restored
+        std::size_t strata = 0;
+        visit(prog.getMain(), [&](const Call&) { strata++; });
+        auto getCount = [&](const std::string& option, const std::string& byDefault) {
+            return glb.config().has(option) ? glb.config().get(option) : byDefault;
+        };
+        mainClass.addInclude("\"souffle/io/Checkpoint.h\"");
+        mainClass.addField("Checkpoint", "checkpoint", Visibility::Private,
+                "{symTable, recordTable, ctr, " + raw_str(sha256Hex(toString(prog))) + ", " +
+                        std::to_string(strata) + ", " + raw_str(glb.config().get("checkpoint")) + ", " +
+                        getCount("checkpoint-iterations", "0") + ", " + getCount("checkpoint-strata", "1") +
+                        ", " + getCount("checkpoint-stop", "0") + "}");
+        constructor.body() << "checkpoint.setRelations([this](Checkpoint::Writer& writer) "
+                           << "{writeCheckpoint(writer);});\n";
+
+        GenFunction& setCheckpointDirectory =
+                mainClass.addFunction("setCheckpointDirectory", Visibility::Public);
+        setCheckpointDirectory.setRetType("void");
+        setCheckpointDirectory.setNextArg("std::string", "dir");
+        setCheckpointDirectory.body() << "checkpoint.setDirectory(std::move(dir));\n";
+
+        GenFunction& stoppedAtCheckpoint = mainClass.addFunction("stoppedAtCheckpoint", Visibility::Public);
+        stoppedAtCheckpoint.setRetType("bool");
+        stoppedAtCheckpoint.body() << "return checkpoint.isStopped();\n";
+
+        GenFunction& writeCheckpoint = mainClass.addFunction("writeCheckpoint", Visibility::Private);
+        writeCheckpoint.setRetType("void");
+        writeCheckpoint.setNextArg("Checkpoint::Writer&", "writer");
+        if (glb.config().has("async-io")) {
+            // pending loads and stores use the relations and tables
+            writeCheckpoint.body() << "try {ioScheduler.awaitAll();} "
+                                   << "catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        }
+        for (auto rel : prog.getRelations()) {
+            writeCheckpoint.body() << "writer.writeRelation(" << raw_str(rel->getName()) << ","
+                                   << rel->getArity() << ",*" << getRelationName(rel) << ");\n";
+        }
+    }
+
+    auto printDirectives = [&](std::ostream& o, const std::map<std::string, std::string>& registry) {
+        auto cur = registry.begin();
+        if (cur == registry.end()) {
+            return;
+        }
+        o << "{{" << raw_str(cur->first) << "," << raw_str(cur->second) << "}";
+        ++cur;
+        for (; cur != registry.end(); ++cur) {
+            o << ",{" << raw_str(cur->first) << "," << raw_str(cur->second) << "}";
+        }
+        o << '}';
+    };
 
     GenFunction& runFunction = mainClass.addFunction("runFunction", Visibility::Private);
     runFunction.setRetType("void");
@@ -2988,11 +3549,62 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     if (glb.config().has("verbose")) {
         runFunction.body() << "signalHandler->enableLogging();\n";
     }
+    if (glb.config().has("compact-tables")) {
+        // the symbols of the program's constants exist by now, and are kept
+        runFunction.body() << "compactor = std::make_unique<TableCompactor>(symTable, recordTable);\n";
+    }
+    if (glb.config().has("checkpoint")) {
+        // the relations are restored before any input is loaded
+        runFunction.body() << "const bool restored = checkpoint.restore();\n";
+        runFunction.body() << "if (restored) {\n";
+        for (auto rel : prog.getRelations()) {
+            runFunction.body() << "checkpoint.readRelation(" << raw_str(rel->getName()) << ","
+                               << rel->getArity() << ",[&](const RamDomain* tuple) {"
+                               << getRelationName(rel) << "->insert(tuple);});\n";
+        }
+        runFunction.body() << "}\n";
+    }
+
+    // start loading all inputs, the stratum of an input waits for it
+    if (glb.config().has("async-io")) {
+        runFunction.body() << "if (performIO) {\n";
+        visit(prog, [&](const IO& load) {
+            if (!isAsyncIO(load) || load.get("operation") != "input") {
+                return;
+            }
+            runFunction.body() << "{\n";
+            runFunction.body() << "std::map<std::string, std::string> directiveMap(";
+            printDirectives(runFunction.body(), load.getDirectives());
+            runFunction.body() << ");\n";
+            runFunction.body() << R"_(if (!inputDirectory.empty()) {)_";
+            runFunction.body() << R"_(directiveMap["fact-dir"] = inputDirectory;)_";
+            runFunction.body() << "}\n";
+            runFunction.body() << "ioScheduler.submit(" << raw_str(load.getRelation())
+                               << ", [this, directiveMap]() {\n";
+            runFunction.body() << "IOSystem::getInstance().getReader(";
+            runFunction.body() << "directiveMap, symTable, recordTable";
+            runFunction.body() << ")->readAll(*" << getRelationName(lookup(load.getRelation())) << ");\n";
+            runFunction.body() << "});\n";
+            runFunction.body() << "}\n";
+        });
+        runFunction.body() << "}\n";
+        if (glb.config().has("checkpoint")) {
+            // the strata that await the inputs of skipped strata do not run
+            runFunction.body() << "if (restored) {\n";
+            runFunction.body() << "try {ioScheduler.awaitAll();} "
+                               << "catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+            runFunction.body() << "}\n";
+        }
+    }
 
     // add actual program body
     runFunction.body() << "// -- query evaluation --\n";
     if (glb.config().has("profile")) {
-        runFunction.body() << "ProfileEventSingleton::instance().startTimer();\n"
+        runFunction.body() << "if (freqs.getNumShards() < MAX_THREADS) {\n"
+                           << "freqs.resize(freqs.size(), MAX_THREADS);\n"
+                           << "reads.resize(reads.size(), MAX_THREADS);\n"
+                           << "}\n"
+                           << "ProfileEventSingleton::instance().startTimer();\n"
                            << R"_(ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");)_"
                            << '\n'
                            << "{\n"
@@ -3012,7 +3624,66 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
 
     // emit code
     currentClass = &mainClass;
+    memoSites.clear();
     emitCode(runFunction.body(), prog.getMain());
+    for (std::size_t i = 0; i < memoSites.size(); ++i) {
+        const std::string memo = "memo_" + std::to_string(i);
+        mainClass.addField("MemoTable", memo, Visibility::Private);
+        constructor.setNextInitializer(memo, std::to_string(memoSites[i].second) + ",4096");
+    }
+
+    // free the symbols and records that the relations no longer reach after each stratum
+    if (glb.config().has("compact-tables")) {
+        GenFunction& compactTables = mainClass.addFunction("compactTables", Visibility::Private);
+        compactTables.setRetType("void");
+        if (glb.config().has("async-io")) {
+            // pending loads and stores use the tables
+            compactTables.body() << "try {ioScheduler.awaitAll();} "
+                                 << "catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+        }
+        // the relations expired by the stratum are empty by now
+        compactTables.body() << "compactor->compact([&](auto&& markTuple) {\n";
+        std::map<std::string, std::string> spilledKinds;
+        for (auto rel : prog.getRelations()) {
+            std::string kinds;
+            for (const auto& type : rel->getAttributeTypes()) {
+                kinds.push_back(type[0]);
+            }
+            if (kinds.find_first_of("sr+") == std::string::npos) {
+                continue;
+            }
+            compactTables.body() << "for (const auto& tuple : *" << getRelationName(rel)
+                                 << ") {markTuple(tuple.data(), " << raw_str(kinds) << ");}\n";
+            spilledKinds[rel->getName()] = kinds;
+        }
+        // spilled relations are purged, but their rows still hold symbols and records
+        if (glb.config().has("spill-dir") && !spilledKinds.empty()) {
+            mainClass.addInclude("\"souffle/io/SpillStream.h\"", true);
+            compactTables.body() << "static const std::map<std::string, std::string> spilledKinds = {";
+            for (auto cur = spilledKinds.begin(); cur != spilledKinds.end(); ++cur) {
+                compactTables.body() << (cur == spilledKinds.begin() ? "{" : ",{") << raw_str(cur->first)
+                                     << "," << raw_str(cur->second) << "}";
+            }
+            compactTables.body() << "};\n";
+            compactTables.body()
+                    << "try {SpillStore::getInstance().enumerate(&symTable, [&](const std::string& name, "
+                    << "std::size_t width, const std::vector<RamDomain>& rows, const std::string&) {\n"
+                    << "auto kinds = spilledKinds.find(name);\n"
+                    << "if (kinds == spilledKinds.end() || width == 0) {return;}\n"
+                    << "for (std::size_t i = 0; i < rows.size(); i += width) "
+                    << "{markTuple(&rows[i], kinds->second);}\n"
+                    << "});} catch (std::exception& e) {std::cerr << \"Error compacting tables: \" "
+                    << "<< e.what() << '\\n';\nexit(1);\n}\n";
+        }
+        compactTables.body() << "});\n";
+        // cached results may be freed symbols or records
+        for (std::size_t i = 0; i < memoSites.size(); ++i) {
+            compactTables.body() << "memo_" << i << ".clear();\n";
+        }
+        for (auto const& stratum : memoisedStrata) {
+            compactTables.body() << stratum << ".clearMemo();\n";
+        }
+    }
 
     if (glb.config().has("profile")) {
         runFunction.body() << "}\n"
@@ -3020,6 +3691,12 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
                            << "dumpFreqs();\n";
     }
 
+    // finish writing the outputs
+    if (glb.config().has("async-io")) {
+        runFunction.body() << "try {ioScheduler.awaitAll();} "
+                           << "catch (std::exception& e) {std::cerr << e.what();exit(1);}\n";
+    }
+
     // add code printing hint statistics
     runFunction.body() << "\n// -- relation hint statistics --\n";
 
@@ -3032,6 +3709,9 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         }
     }
 
+    if (glb.config().has("checkpoint")) {
+        runFunction.body() << "checkpoint.finish();\n";
+    }
     runFunction.body() << "signalHandler->reset();\n";
 
     // add methods to run with and without performing IO (mainly for the interface)
@@ -3062,19 +3742,6 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     printAll.setNextArg("[[maybe_unused]] std::string", "outputDirectoryArg", std::make_optional("\"\""));
 
     // print directives as C++ initializers
-    auto printDirectives = [&](std::ostream& o, const std::map<std::string, std::string>& registry) {
-        auto cur = registry.begin();
-        if (cur == registry.end()) {
-            return;
-        }
-        o << "{{" << raw_str(cur->first) << "," << raw_str(cur->second) << "}";
-        ++cur;
-        for (; cur != registry.end(); ++cur) {
-            o << ",{" << raw_str(cur->first) << "," << raw_str(cur->second) << "}";
-        }
-        o << '}';
-    };
-
     for (auto store : storeIOs) {
         auto const& directive = store->getDirectives();
         printAll.body() << "try {";
@@ -3201,12 +3868,15 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
 
         for (auto const& cur : idxMap) {
             dumpFreqs.body() << "  ProfileEventSingleton::instance().makeQuantityEvent(" << raw_str(cur.first)
-                             << ", freqs[" << cur.second << "],0);\n";
+                             << ", freqs.get(" << cur.second << "),0);\n";
         }
         for (auto const& cur : neIdxMap) {
             dumpFreqs.body() << "  ProfileEventSingleton::instance().makeQuantityEvent("
-                             << raw_str("@relation-reads;" + cur.first) << ", reads[" << cur.second
-                             << "],0);\n";
+                             << raw_str("@relation-reads;" + cur.first) << ", reads.get(" << cur.second
+                             << "),0);\n";
+        }
+        for (auto const& stratum : memoisedStrata) {
+            dumpFreqs.body() << "  " << stratum << ".dumpMemo();\n";
         }
     }
 
@@ -3243,6 +3913,7 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
 
     hook << "\n#ifndef __EMBEDDED_SOUFFLE__\n";
     hook << "#include \"souffle/CompiledOptions.h\"\n";
+    hook << "#include \"souffle/QueryServer.h\"\n";
 
     hook << "int main(int argc, char** argv)\n{\n";
     hook << "try{\n";
@@ -3260,6 +3931,10 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
         hook << raw_str("") << ",\n";
     }
     hook << std::stoi(glb.config().get("jobs"));
+    if (glb.config().has("checkpoint")) {
+        hook << ",\ntrue,\n";
+        hook << raw_str(glb.config().get("checkpoint"));
+    }
     hook << ");\n";
 
     hook << "if (!opt.parse(argc,argv)) return 1;\n";
@@ -3276,6 +3951,9 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
     hook << "#if defined(_OPENMP) \n";
     hook << "obj.setNumThreads(opt.getNumJobs());\n";
     hook << "\n#endif\n";
+    if (glb.config().has("checkpoint")) {
+        hook << "obj.setCheckpointDirectory(opt.getCheckpointDir());\n";
+    }
 
     if (glb.config().has("profile")) {
         hook << R"_(souffle::ProfileEventSingleton::instance().makeConfigRecord("", opt.getSourceFileName());)_"
@@ -3290,12 +3968,19 @@ void Synthesiser::generateCode(GenDb& db, const std::string& id, bool& withShare
              << glb.config().get("version") << R"_(");)_" << '\n';
     }
     hook << "obj.runAll(opt.getInputFileDir(), opt.getOutputFileDir());\n";
+    if (glb.config().has("checkpoint")) {
+        // an evaluation stopped at a checkpoint is resumed by a later run
+        hook << "if (obj.stoppedAtCheckpoint()) return 0;\n";
+    }
 
     if (glb.config().get("provenance") == "explain") {
         hook << "explain(obj, false);\n";
     } else if (glb.config().get("provenance") == "explore") {
         hook << "explain(obj, true);\n";
     }
+    hook << "if (!opt.getServeEndpoint().empty()) {\n";
+    hook << "souffle::QueryServer(obj).serve(opt.getServeEndpoint());\n";
+    hook << "}\n";
     hook << "return 0;\n";
     hook << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
     hook << "}\n";
@@ -82,6 +82,12 @@ private:
      */
     std::map<std::string, std::size_t> regexes;
 
+    /** The call sites of the current subroutine whose results are cached, with their arity */
+    std::vector<std::pair<std::string, std::size_t>> memoSites;
+
+    /** The strata with caches of call sites */
+    std::vector<std::string> memoisedStrata;
+
     /** Pointer to the subroutine class currently being built */
     GenClass* currentClass = nullptr;
 
@@ -117,6 +123,9 @@ protected:
     /** Compile a regular expression and return a unique name for it */
     std::optional<std::size_t> compileRegex(const std::string& pattern);
 
+    /** Add a call site whose results are cached with --memoise, and return the name of its cache */
+    std::string addMemoSite(const ram::Node& site, std::size_t arity);
+
     /** Generate code */
     void emitCode(std::ostream& out, const ram::Statement& stmt);
 
@@ -149,7 +158,7 @@ protected:
     std::string convertSymbolToIdentifier(const std::string& symbol) const;
 
     /** return the set of relation names accessed/used in the statement */
-    std::set<std::string> accessedRelations(ram::Statement& stmt);
+    std::set<std::string> accessedRelations(const ram::Statement& stmt);
 
     /** return the set of User-defined functor names used in the statement */
     std::set<std::string> accessedUserDefinedFunctors(ram::Statement& stmt);
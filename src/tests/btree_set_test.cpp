@@ -17,6 +17,7 @@
 #include "tests/test.h"
 
 #include "souffle/datastructure/BTree.h"
+#include "souffle/datastructure/NodeArena.h"
 #include "souffle/utility/ContainerUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include <algorithm>
@@ -501,6 +502,73 @@ TEST(BTreeSet, Clear) {
     EXPECT_TRUE(t.empty());
 }
 
+TEST(BTreeSet, ArenaAllocator) {
+    using test_set = btree_set<int, detail::comparator<int>, ArenaAllocator<int>, 16>;
+
+    const int N = 10000;
+
+    test_set t;
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+    }
+    EXPECT_EQ(N, t.size());
+
+    // a copy owns a separate arena and survives clearing the original
+    test_set c(t);
+    t.clear();
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(N, c.size());
+    EXPECT_TRUE(c.contains(N - 1));
+
+    // a cleared tree can be refilled
+    t.insert(5);
+    EXPECT_EQ(1, t.size());
+
+    // the arenas follow their nodes on swap and move
+    t.swap(c);
+    EXPECT_EQ(N, t.size());
+    c.clear();
+    test_set m(std::move(t));
+    EXPECT_EQ(N, m.size());
+    EXPECT_TRUE(t.empty());
+    t.insert(7);
+    EXPECT_EQ(1, t.size());
+    EXPECT_EQ(N, m.size());
+}
+
+TEST(BTreeSet, ArenaLaziness) {
+    // an arena reserves nothing before its first allocation, and then a slab of that block only
+    NodeArena arena(8);
+    EXPECT_EQ(0, arena.getMemoryUsage());
+    void* block = arena.allocate(1000);
+    EXPECT_LT(arena.getMemoryUsage(), 2000);
+    arena.deallocate(block, 1000);
+    arena.release();
+    EXPECT_EQ(0, arena.getMemoryUsage());
+
+    // an allocator creates its arena with its first allocation; copies made afterwards share it
+    ArenaAllocator<int> alloc;
+    EXPECT_FALSE(alloc.hasArena());
+    EXPECT_EQ(0, alloc.getMemoryUsage());
+    int* value = alloc.allocate(1);
+    EXPECT_TRUE(alloc.hasArena());
+    ArenaAllocator<long> rebound(alloc);
+    EXPECT_TRUE(rebound == alloc);
+    alloc.deallocate(value, 1);
+
+    // trees without nodes own no arena, whether empty or moved from
+    using test_set = btree_set<int, detail::comparator<int>, ArenaAllocator<int>, 16>;
+    test_set t;
+    for (int i = 0; i < 1000; i++) {
+        t.insert(i);
+    }
+    test_set m(std::move(t));
+    EXPECT_EQ(1000, m.size());
+    EXPECT_TRUE(t.empty());
+    t.insert(1);
+    EXPECT_EQ(1, t.size());
+}
+
 TEST(BTreeSet, ChunkSplit) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -0,0 +1,172 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file hash_index_test.cpp
+ *
+ * Test cases for the hash index data structure.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/HashIndex.h"
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+using Entry = Tuple<RamDomain, 2>;
+
+template <typename Range>
+std::size_t count(const Range& tuples) {
+    return static_cast<std::size_t>(std::distance(tuples.begin(), tuples.end()));
+}
+
+TEST(HashIndex, Basic) {
+    HashIndex<2, 0, 1> index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(index.begin() == index.end());
+
+    EXPECT_TRUE(index.insert(Entry{{1, 2}}));
+    EXPECT_FALSE(index.insert(Entry{{1, 2}}));
+    EXPECT_TRUE(index.insert(Entry{{2, 1}}));
+
+    EXPECT_EQ(2, index.size());
+    EXPECT_TRUE(index.contains(Entry{{1, 2}}));
+    EXPECT_TRUE(index.contains(Entry{{2, 1}}));
+    EXPECT_FALSE(index.contains(Entry{{1, 1}}));
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.contains(Entry{{1, 2}}));
+}
+
+TEST(HashIndex, EqualRange) {
+    HashIndex<2, 0> index;
+    for (RamDomain i = 0; i < 100; ++i) {
+        for (RamDomain j = 0; j < 10; ++j) {
+            index.insert(Entry{{i, j}});
+        }
+    }
+    EXPECT_EQ(1000, index.size());
+
+    for (RamDomain i = 0; i < 100; ++i) {
+        std::set<RamDomain> found;
+        for (const auto& tuple : index.equalRange(Entry{{i, 0}})) {
+            EXPECT_EQ(i, tuple[0]);
+            found.insert(tuple[1]);
+        }
+        EXPECT_EQ(10, found.size());
+    }
+    EXPECT_TRUE(index.equalRange(Entry{{100, 0}}).empty());
+}
+
+TEST(HashIndex, Partition) {
+    HashIndex<2, 0, 1> index;
+    for (RamDomain i = 0; i < 1000; ++i) {
+        index.insert(Entry{{i, -i}});
+    }
+
+    std::set<Entry> all;
+    for (const auto& tuple : index) {
+        all.insert(tuple);
+    }
+    EXPECT_EQ(1000, all.size());
+
+    std::set<Entry> partitioned;
+    std::size_t count = 0;
+    for (const auto& chunk : index.partition(16)) {
+        for (const auto& tuple : chunk) {
+            partitioned.insert(tuple);
+            ++count;
+        }
+    }
+    EXPECT_EQ(1000, count);
+    EXPECT_TRUE(all == partitioned);
+}
+
+TEST(HashIndex, KeySkew) {
+    // all tuples share one of two keys; each insert only compares tuples of the same full hash
+    HashIndex<2, 0> index;
+    const RamDomain n = 200000;
+    for (RamDomain i = 0; i < n; ++i) {
+        EXPECT_TRUE(index.insert(Entry{{i % 2, i}}));
+    }
+    for (RamDomain i = 0; i < n; i += 1000) {
+        EXPECT_FALSE(index.insert(Entry{{i % 2, i}}));
+    }
+    EXPECT_EQ(n, index.size());
+    EXPECT_EQ(n / 2, count(index.equalRange(Entry{{0, 0}})));
+    EXPECT_EQ(n / 2, count(index.equalRange(Entry{{1, 0}})));
+    for (const auto& tuple : index.equalRange(Entry{{1, 0}})) {
+        EXPECT_EQ(1, tuple[1] % 2);
+    }
+
+    // clearing returns to the initial buckets, and the index can be refilled
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(index.equalRange(Entry{{0, 0}}).empty());
+    EXPECT_TRUE(index.insert(Entry{{0, 0}}));
+    EXPECT_EQ(1, count(index.equalRange(Entry{{0, 0}})));
+}
+
+TEST(HashIndex, FullKey) {
+    HashIndex<2, 0, 1> index;
+    index.insert(Entry{{1, 2}});
+    EXPECT_EQ(1, count(index.equalRange(Entry{{1, 2}})));
+    EXPECT_TRUE(index.equalRange(Entry{{1, 3}}).empty());
+}
+
+TEST(HashGroups, Basic) {
+    HashGroups<2, 1> groups;
+    for (RamDomain i = 0; i < 1000; ++i) {
+        groups.insert(Entry{{i, i % 10}});
+    }
+    EXPECT_EQ(1000, groups.size());
+    for (RamDomain k = 0; k < 10; ++k) {
+        std::set<RamDomain> found;
+        for (const auto& tuple : groups.equalRange(Entry{{0, k}})) {
+            EXPECT_EQ(k, tuple[1]);
+            found.insert(tuple[0]);
+        }
+        EXPECT_EQ(100, found.size());
+    }
+    EXPECT_TRUE(groups.equalRange(Entry{{0, 10}}).empty());
+    groups.clear();
+    EXPECT_TRUE(groups.empty());
+    EXPECT_TRUE(groups.equalRange(Entry{{0, 1}}).empty());
+}
+
+#ifdef _OPENMP
+TEST(HashIndex, ParallelInsert) {
+    HashIndex<2, 0> index;
+#pragma omp parallel for
+    for (RamDomain i = 0; i < 10000; ++i) {
+        index.insert(Entry{{i % 100, i}});
+        index.insert(Entry{{i % 100, i}});
+    }
+    EXPECT_EQ(10000, index.size());
+
+    std::size_t count = 0;
+    for (const auto& tuple : index.equalRange(Entry{{7, 0}})) {
+        EXPECT_EQ(7, tuple[0]);
+        ++count;
+    }
+    EXPECT_EQ(100, count);
+}
+#endif
+
+}  // namespace test
+}  // namespace souffle
@@ -0,0 +1,110 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file memo_table_test.cpp
+ *
+ * Test cases for the caches of pure functions.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/MemoTable.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(MemoTable, LookupInsert) {
+    MemoTable memo(2, 16);
+    RamDomain result = 0;
+    std::array<RamDomain, 2> args{{1, 2}};
+    EXPECT_FALSE(memo.lookup(args.data(), result));
+    memo.insert(args.data(), 3);
+    EXPECT_TRUE(memo.lookup(args.data(), result));
+    EXPECT_EQ(3, result);
+
+    // other arguments do not match the slot
+    std::array<RamDomain, 2> swapped{{2, 1}};
+    EXPECT_FALSE(memo.lookup(swapped.data(), result) && result == 3);
+}
+
+TEST(MemoTable, Zero) {
+    // arguments and results of zero are not confused with empty slots
+    MemoTable memo(1, 4);
+    RamDomain result = 1;
+    RamDomain arg = 0;
+    EXPECT_FALSE(memo.lookup(&arg, result));
+    memo.insert(&arg, 0);
+    EXPECT_TRUE(memo.lookup(&arg, result));
+    EXPECT_EQ(0, result);
+}
+
+TEST(MemoTable, GetOrCompute) {
+    MemoTable memo(1, 1024, true);
+    std::size_t computed = 0;
+    auto square = [&](const RamDomain* args) {
+        ++computed;
+        return args[0] * args[0];
+    };
+    for (int round = 0; round < 3; ++round) {
+        for (RamDomain i = 0; i < 10; ++i) {
+            EXPECT_EQ(i * i, memo.getOrCompute(&i, square));
+        }
+    }
+    EXPECT_EQ(30, memo.getCalls());
+    EXPECT_EQ(30 - computed, memo.getHits());
+    EXPECT_TRUE(computed >= 10);
+    EXPECT_TRUE(computed < 30);
+}
+
+TEST(MemoTable, Eviction) {
+    // a table of one slot keeps the last result only
+    MemoTable memo(1, 1);
+    RamDomain result = 0;
+    for (RamDomain i = 0; i < 100; ++i) {
+        memo.insert(&i, i + 1);
+        EXPECT_TRUE(memo.lookup(&i, result));
+        EXPECT_EQ(i + 1, result);
+    }
+    RamDomain first = 0;
+    EXPECT_FALSE(memo.lookup(&first, result));
+}
+
+TEST(MemoTable, Parallel) {
+    MemoTable memo(2, 64);
+    std::atomic<std::size_t> wrong{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (RamDomain i = 0; i < 100000; ++i) {
+                std::array<RamDomain, 2> args{{i % 300, i % 7}};
+                const RamDomain result = memo.getOrCompute(
+                        args.data(), [](const RamDomain* args) { return args[0] * 7 + args[1]; });
+                if (result != args[0] * 7 + args[1]) {
+                    ++wrong;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, wrong.load());
+}
+
+}  // namespace test
+}  // namespace souffle
@@ -16,8 +16,12 @@
 
 #include "tests/test.h"
 
+#include "souffle/datastructure/ShardedCounters.h"
+#include "souffle/io/IOScheduler.h"
 #include "souffle/utility/ParallelUtil.h"
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace souffle {
 
@@ -99,5 +103,69 @@ TEST(ParallelUtils, OptimisticReadWriteLock) {
 
     EXPECT_EQ(2 * (N / K), c);
 }
+
+TEST(ParallelUtils, ShardedCounters) {
+    const int N = 1000000;
+    const std::size_t K = 10;
+
+    ShardedCounters counters(K, 4);
+    EXPECT_EQ(K, counters.size());
+    EXPECT_EQ(4, counters.getNumShards());
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(4)
+#endif
+    for (int i = 0; i < N; i++) {
+        counters.increment(static_cast<std::size_t>(i) % K);
+    }
+
+    for (std::size_t i = 0; i < K; i++) {
+        EXPECT_EQ(N / K, counters.get(i));
+    }
+
+    // draining hands out the totals and resets all shards
+    counters.increment(3, 7, 5);
+    std::vector<std::size_t> totals(K, 0);
+    counters.drain([&](std::size_t counter, std::size_t total) { totals[counter] += total; });
+    EXPECT_EQ(N / K, totals[0]);
+    EXPECT_EQ(N / K + 5, totals[7]);
+    for (std::size_t i = 0; i < K; i++) {
+        EXPECT_EQ(0, counters.get(i));
+    }
+}
+
+TEST(ParallelUtils, IOScheduler) {
+    IOScheduler scheduler;
+
+    // tasks of a relation run in order, tasks of different relations independently
+    std::vector<int> a, b;
+    for (int i = 0; i < 100; ++i) {
+        scheduler.submit("a", [&a, i]() { a.push_back(i); });
+        scheduler.submit("b", [&b, i]() { b.push_back(i); });
+    }
+    scheduler.await("a");
+    EXPECT_EQ(100, a.size());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i, a[i]);
+    }
+    scheduler.awaitAll();
+    EXPECT_EQ(100, b.size());
+
+    // errors are reported when the relation is awaited, and later tasks do not run
+    bool ran = false;
+    scheduler.submit("c", []() { throw std::runtime_error("failed"); });
+    scheduler.submit("c", [&ran]() { ran = true; });
+    bool failed = false;
+    try {
+        scheduler.await("c");
+    } catch (const std::runtime_error&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+    EXPECT_FALSE(ran);
+
+    // awaiting a relation without tasks returns immediately
+    scheduler.await("d");
+}
 }  // namespace test
 }  // end namespace souffle
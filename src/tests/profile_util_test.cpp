@@ -17,10 +17,12 @@
 #include "tests/test.h"
 
 #include "souffle/profile/CellInterface.h"
+#include "souffle/profile/ProfileTrace.h"
 #include "souffle/profile/StringUtils.h"
 #include <chrono>
 #include <cmath>
 #include <iosfwd>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -138,3 +140,63 @@ TEST(StringUtil, cleanJsonOutDouble) {
     EXPECT_EQ("NaN", Tools::cleanJsonOut(NAN));
     EXPECT_EQ("1.234567e+02", Tools::cleanJsonOut(123.4567));
 }
+
+TEST(ProfileTrace, spanFromLabel) {
+    microseconds start(10);
+    microseconds end(20);
+    auto rule = TraceSpan::fromLabel(
+            "@t-recursive-rule;path;1;a.dl [3:1-3:20];path(x,z) :- edge(x,y), path(y,z).;", start, end, 2, 0);
+    EXPECT_EQ("rule", rule.category);
+    EXPECT_EQ("path(x,z) :- edge(x,y), path(y,z).", rule.name);
+    EXPECT_EQ("a.dl [3:1-3:20]", rule.location);
+    EXPECT_EQ(2, rule.iteration);
+
+    auto iteration = TraceSpan::fromLabel("@t-recursive-relation;path;a.dl [2:7-2:11];", start, end, 4, 0);
+    EXPECT_EQ("iteration", iteration.category);
+    EXPECT_EQ("path #4", iteration.name);
+
+    auto load = TraceSpan::fromLabel("@t-relation-loadtime;edge;a.dl [1:7-1:11];loadtime;", start, end, 0, 0);
+    EXPECT_EQ("io", load.category);
+    EXPECT_EQ("load edge", load.name);
+
+    auto stratum = TraceSpan::fromLabel("@stratum;stratum_1", start, end, 0, 0);
+    EXPECT_EQ("stratum", stratum.category);
+    EXPECT_EQ("stratum_1", stratum.name);
+}
+
+TEST(ProfileTrace, export) {
+    ProfileTrace trace;
+    time_point origin = now();
+    auto at = [&](int us) { return origin + std::chrono::microseconds(us); };
+    trace.record("@runtime;", at(0), at(100), 0);
+    trace.record("@stratum;stratum_0", at(10), at(60), 0);
+    trace.record("@t-nonrecursive-rule;edge;a.dl [1:1-1:9];edge(1,2).;", at(20), at(50), 0);
+    EXPECT_EQ(1, trace.getNumThreads());
+
+    auto spans = trace.getSpans();
+    EXPECT_EQ(3, spans.size());
+    EXPECT_EQ("runtime", spans[0].category);
+    EXPECT_EQ("stratum", spans[1].category);
+    EXPECT_EQ("rule", spans[2].category);
+
+    std::stringstream folded;
+    trace.printFoldedStacks(folded);
+    EXPECT_EQ(
+            "thread 0;runtime runtime 50\n"
+            "thread 0;runtime runtime;stratum stratum_0 20\n"
+            "thread 0;runtime runtime;stratum stratum_0;rule edge(1,2). 30\n",
+            folded.str());
+
+    std::stringstream chrome;
+    trace.printChromeTrace(chrome);
+    std::string error;
+    json11::Json json = json11::Json::parse(chrome.str(), error);
+    EXPECT_TRUE(error.empty());
+    const auto& events = json["traceEvents"].array_items();
+    EXPECT_EQ(4, events.size());
+    EXPECT_EQ("thread_name", events[0]["name"].string_value());
+    EXPECT_EQ("edge(1,2).", events[3]["name"].string_value());
+    EXPECT_EQ("X", events[3]["ph"].string_value());
+    EXPECT_EQ(30, events[3]["dur"].int_value());
+    EXPECT_EQ("a.dl [1:1-1:9]", events[3]["args"]["location"].string_value());
+}
@@ -19,7 +19,10 @@
 #include "souffle/RamTypes.h"
 #include "souffle/RecordTable.h"
 #include "souffle/datastructure/RecordTableImpl.h"
+#include "souffle/datastructure/SymbolTableImpl.h"
+#include "souffle/datastructure/TableCompactor.h"
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -209,4 +212,50 @@ INSTANTIATE_TEMPLATE_TEST(PackUnpack, Vector, 11);
 INSTANTIATE_TEMPLATE_TEST(PackUnpack, Vector, 23);
 INSTANTIATE_TEMPLATE_TEST(PackUnpack, Vector, 59);
 
+TEST(TableCompactor, NestedRecords) {
+    SymbolTableImpl symbolTable;
+    SpecializedRecordTable<0, 1, 2, 3> recordTable;
+    for (int i = 0; i < 100; ++i) {
+        symbolTable.encode("constant" + std::to_string(i));
+    }
+    TableCompactor compactor(symbolTable, recordTable);
+
+    const RamDomain a = symbolTable.encode("a");
+    const RamDomain b = symbolTable.encode("b");
+    const RamDomain c = symbolTable.encode("c");
+    const RamDomain d = symbolTable.encode("d");
+
+    // [a, [b]] is reached, and so is [a, 5, 6], which has the same reference in
+    // another arity; [c] and [d, 7, 8] are not
+    const RamDomain inner = recordTable.pack({b});
+    const RamDomain outer = recordTable.pack({a, inner});
+    const RamDomain lost = recordTable.pack({c});
+    recordTable.pack({a, 5, 6});
+    recordTable.pack({d, 7, 8});
+    const std::vector<std::array<RamDomain, 2>> tuples = {{outer, 5}};
+
+    const auto freed = compactor.compact([&](auto&& markTuple) {
+        for (const auto& tuple : tuples) {
+            markTuple(tuple.data(), "ri");
+        }
+    });
+    EXPECT_EQ(freed.first, 2);
+    EXPECT_EQ(freed.second, 2);
+
+    EXPECT_EQ(symbolTable.decode(0), "constant0");
+    EXPECT_EQ(symbolTable.decode(a), "a");
+    EXPECT_EQ(symbolTable.decode(b), "b");
+    EXPECT_FALSE(symbolTable.weakContains("c"));
+    EXPECT_FALSE(symbolTable.weakContains("d"));
+    EXPECT_EQ(recordTable.unpack(outer, 2)[1], inner);
+    EXPECT_EQ(recordTable.unpack(inner, 1)[0], b);
+
+    std::size_t records = 0;
+    recordTable.enumerate([&](const RamDomain*, std::size_t, RamDomain) { ++records; });
+    EXPECT_EQ(records, 3);
+
+    // a freed record is packed again under a fresh reference
+    EXPECT_NE(recordTable.pack({c}), lost);
+}
+
 }  // namespace souffle::test
@@ -0,0 +1,156 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file regex_dfa_test.cpp
+ *
+ * Test cases for matching regular expressions with automata.
+ *
+ ***********************************************************************/
+
+#include "tests/test.h"
+
+#include "souffle/utility/RegexDfa.h"
+#include <cstddef>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+const std::vector<std::string> texts = {"", "a", "b", "ab", "aab", "abab", "abc", "abcabc", "aaaa", "ba",
+        "A1_", "hello world", "x.y", "\n", "a\nb", "a-z", "0123", "12ab", "[a]", "a]", "tab\there", "ERROR",
+        "error: 42", "2026-10-19", "a*b", "-", "^a$", "\\", "aaaaaaaa!"};
+
+/** The number of texts on which the automaton of a pattern disagrees with std::regex */
+std::size_t disagreements(const std::string& pattern) {
+    auto dfa = RegexDfa::compile(pattern);
+    if (!dfa) {
+        std::cerr << "pattern not compiled: " << pattern << "\n";
+        return texts.size();
+    }
+    const std::regex regex(pattern);
+    std::size_t count = 0;
+    for (const auto& text : texts) {
+        if (dfa->match(text) != std::regex_match(text, regex)) {
+            std::cerr << "pattern " << pattern << " disagrees on " << text << "\n";
+            ++count;
+        }
+    }
+    return count;
+}
+
+TEST(RegexDfa, Literals) {
+    EXPECT_EQ(0, disagreements(""));
+    EXPECT_EQ(0, disagreements("a"));
+    EXPECT_EQ(0, disagreements("abc"));
+    EXPECT_EQ(0, disagreements("hello world"));
+    EXPECT_EQ(0, disagreements("x\\.y"));
+    EXPECT_EQ(0, disagreements("a\\*b"));
+    EXPECT_EQ(0, disagreements("\\\\"));
+    EXPECT_EQ(0, disagreements("\\[a\\]"));
+    EXPECT_EQ(0, disagreements("tab\\there"));
+    EXPECT_EQ(0, disagreements("\\x41\\d_"));
+}
+
+TEST(RegexDfa, Operators) {
+    EXPECT_EQ(0, disagreements("a*"));
+    EXPECT_EQ(0, disagreements("a+b"));
+    EXPECT_EQ(0, disagreements("a?b?c?"));
+    EXPECT_EQ(0, disagreements("(ab)*"));
+    EXPECT_EQ(0, disagreements("(?:ab)+c?"));
+    EXPECT_EQ(0, disagreements("a|b|ab"));
+    EXPECT_EQ(0, disagreements("(a|b)*abc"));
+    EXPECT_EQ(0, disagreements("a{2}b"));
+    EXPECT_EQ(0, disagreements("a{2,}"));
+    EXPECT_EQ(0, disagreements("a{1,3}b?"));
+    EXPECT_EQ(0, disagreements("(ab){0,2}"));
+    EXPECT_EQ(0, disagreements("a*?b"));
+    EXPECT_EQ(0, disagreements("(a*)*"));
+    EXPECT_EQ(0, disagreements("a|"));
+    EXPECT_EQ(0, disagreements("^a*$"));
+    EXPECT_EQ(0, disagreements("^(ab)+"));
+    EXPECT_EQ(0, disagreements("\\^a\\$"));
+}
+
+TEST(RegexDfa, Classes) {
+    EXPECT_EQ(0, disagreements(".*"));
+    EXPECT_EQ(0, disagreements("a.b"));
+    EXPECT_EQ(0, disagreements("[abc]+"));
+    EXPECT_EQ(0, disagreements("[^abc]*"));
+    EXPECT_EQ(0, disagreements("[a-z]+"));
+    EXPECT_EQ(0, disagreements("[a\\-z]+"));
+    EXPECT_EQ(0, disagreements("[-a]+"));
+    EXPECT_EQ(0, disagreements("[a-]+"));
+    EXPECT_EQ(0, disagreements("[\\]a]+"));
+    EXPECT_EQ(0, disagreements("\\d+"));
+    EXPECT_EQ(0, disagreements("\\D+"));
+    EXPECT_EQ(0, disagreements("\\w+"));
+    EXPECT_EQ(0, disagreements("\\W"));
+    EXPECT_EQ(0, disagreements("\\s"));
+    EXPECT_EQ(0, disagreements("\\S+\\s\\S+"));
+    EXPECT_EQ(0, disagreements("[\\d\\s]+"));
+    EXPECT_EQ(0, disagreements("[^\\w]"));
+    EXPECT_EQ(0, disagreements("\\d{4}-\\d{2}-\\d{2}"));
+    EXPECT_EQ(0, disagreements("(error|ERROR)(: \\d+)?"));
+    EXPECT_EQ(0, disagreements("[A-Z][0-9a-z_]*"));
+}
+
+TEST(RegexDfa, Unsupported) {
+    // assertions and back references are left to std::regex
+    EXPECT_FALSE(RegexDfa::compile("a\\bb").has_value());
+    EXPECT_FALSE(RegexDfa::compile("(a)\\1").has_value());
+    EXPECT_FALSE(RegexDfa::compile("a(?=b)").has_value());
+    EXPECT_FALSE(RegexDfa::compile("a|^b").has_value());
+    EXPECT_FALSE(RegexDfa::compile("[[:alpha:]]").has_value());
+
+    // as are invalid patterns
+    EXPECT_FALSE(RegexDfa::compile("(a").has_value());
+    EXPECT_FALSE(RegexDfa::compile("a)").has_value());
+    EXPECT_FALSE(RegexDfa::compile("*").has_value());
+    EXPECT_FALSE(RegexDfa::compile("[a").has_value());
+    EXPECT_FALSE(RegexDfa::compile("a{2,1}").has_value());
+    EXPECT_FALSE(RegexDfa::compile("[z-a]").has_value());
+}
+
+TEST(RegexDfa, Matcher) {
+    RegexMatcher automaton("(a|b)*c");
+    EXPECT_TRUE(automaton.isAutomaton());
+    EXPECT_TRUE(automaton.match("ababc"));
+    EXPECT_FALSE(automaton.match("abab"));
+
+    RegexMatcher backtracking("(a+)\\1");
+    EXPECT_FALSE(backtracking.isAutomaton());
+    EXPECT_TRUE(backtracking.match("aaaa"));
+    EXPECT_FALSE(backtracking.match("aaa"));
+
+    bool thrown = false;
+    try {
+        RegexMatcher invalid("(a");
+    } catch (const std::regex_error&) {
+        thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+}
+
+TEST(RegexDfa, Tables) {
+    auto dfa = RegexDfa::compile("[0-9]+(\\.[0-9]+)?");
+    EXPECT_TRUE(dfa.has_value());
+    RegexDfa copy(dfa->getClasses(), dfa->getTransitions(), dfa->getAccepting());
+    EXPECT_TRUE(copy.match("3.14"));
+    EXPECT_TRUE(copy.match("42"));
+    EXPECT_FALSE(copy.match("3."));
+    EXPECT_FALSE(copy.match(".5"));
+}
+
+}  // namespace test
+}  // namespace souffle
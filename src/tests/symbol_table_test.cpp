@@ -111,4 +111,30 @@ TEST(SymbolTable, Inserts) {
     }
 }
 
+TEST(SymbolTable, Retain) {
+    SymbolTableImpl X;
+    std::vector<RamDomain> indices;
+    for (int i = 0; i < 100; ++i) {
+        indices.push_back(X.encode("s" + std::to_string(i)));
+    }
+    EXPECT_EQ(X.retain([](RamDomain index) { return index % 3 == 0; }), 66);
+
+    // the kept symbols keep their index
+    std::size_t kept = 0;
+    for (const auto& It : X) {
+        EXPECT_EQ(It.second % 3, 0);
+        EXPECT_EQ(X.decode(static_cast<RamDomain>(It.second)), It.first);
+        ++kept;
+    }
+    EXPECT_EQ(kept, 34);
+    EXPECT_TRUE(X.weakContains("s3"));
+    EXPECT_FALSE(X.weakContains("s4"));
+    EXPECT_EQ(X.encode("s3"), indices[3]);
+
+    // a removed symbol gets a fresh index
+    const RamDomain fresh = X.encode("s4");
+    EXPECT_NE(fresh, indices[4]);
+    EXPECT_EQ(X.decode(fresh), "s4");
+}
+
 }  // namespace souffle::test
@@ -16,8 +16,12 @@
 
 #include "tests/test.h"
 
+#include "souffle/RamTypes.h"
+#include "souffle/datastructure/BTree.h"
 #include "souffle/utility/CacheUtil.h"
 #include "souffle/utility/ContainerUtil.h"
+#include "souffle/utility/DigestUtil.h"
+#include "souffle/utility/EvaluatorUtil.h"
 #include "souffle/utility/FunctionalUtil.h"
 #include "souffle/utility/StreamUtil.h"
 #include "souffle/utility/StringUtil.h"
@@ -257,3 +261,60 @@ TEST(Util, Range) {
         EXPECT_EQ(last, 8);
     }
 }
+
+TEST(Util, JoinSizeSample) {
+    using tuple = Tuple<RamDomain, 2>;
+    btree_set<tuple> index;
+    // 1000 keys with 100 tuples each
+    for (RamDomain i = 0; i < 100000; i++) {
+        index.insert(tuple{i % 1000, i});
+    }
+
+    auto all = [](const tuple&) { return true; };
+    auto sameKey = [](const tuple& a, const tuple& b) { return a[0] == b[0]; };
+
+    // a full scan is exact
+    auto exact = evaluator::sampleJoinSize(index, 0, all, sameKey);
+    EXPECT_TRUE(exact.exact);
+    EXPECT_EQ(100000, exact.visited);
+    EXPECT_EQ(100, evaluator::estimateJoinSize(exact, index.size(), false));
+
+    // small relations are scanned completely despite sampling
+    auto small = evaluator::sampleJoinSize(index, 200000, all, sameKey);
+    EXPECT_TRUE(small.exact);
+
+    // a block sample visits a fraction of the index but approximates the estimate
+    auto sampled = evaluator::sampleJoinSize(index, 20000, all, sameKey);
+    EXPECT_FALSE(sampled.exact);
+    EXPECT_LT(sampled.visited, 40000);
+    double estimate = evaluator::estimateJoinSize(sampled, index.size(), false);
+    EXPECT_TRUE(80 <= estimate && estimate <= 120);
+
+    // selections on constants are extrapolated to the size of the relation
+    auto selected = evaluator::sampleJoinSize(
+            index, 20000, [](const tuple& t) { return t[0] < 500; }, sameKey);
+    double total = evaluator::estimateJoinSize(selected, index.size(), true);
+    EXPECT_TRUE(40000 <= total && total <= 60000);
+}
+
+TEST(Util, Sha256) {
+    EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", sha256Hex(""));
+    EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", sha256Hex("abc"));
+    EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+            sha256Hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+
+    // the digest does not depend on how the message is split into updates
+    std::string message(1000, 'x');
+    Sha256 digest;
+    for (std::size_t i = 0; i < message.size(); i += 7) {
+        digest.update(std::string_view(message).substr(i, 7));
+    }
+    EXPECT_EQ(sha256Hex(message), digest.hexDigest());
+}
+
+TEST(Util, Concatenate) {
+    EXPECT_EQ("", concatenate({}));
+    EXPECT_EQ("abc", concatenate({"abc"}));
+    const std::string path = "a/b";
+    EXPECT_EQ("a/b/c.dl", concatenate({path, "/", std::string("c"), std::string_view(".dl")}));
+}
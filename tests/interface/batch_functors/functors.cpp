@@ -0,0 +1,59 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file functors.cpp
+ *
+ * Batch functors, which record the greatest batch they were called with
+ *
+ ***********************************************************************/
+#include "souffle/SouffleFunctor.h"
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace {
+std::atomic<std::size_t> maxCount{0};
+
+void recordCount(std::size_t count) {
+    std::size_t seen = maxCount.load();
+    while (seen < count && !maxCount.compare_exchange_weak(seen, count)) {
+    }
+}
+}  // namespace
+
+extern "C" {
+
+void batch_add(std::size_t count, const souffle::RamDomain* args, souffle::RamDomain* results) {
+    recordCount(count);
+    for (std::size_t i = 0; i < count; i++) {
+        results[i] = args[2 * i] + args[2 * i + 1];
+    }
+}
+
+void batch_mul(std::size_t count, const souffle::RamDomain* args, souffle::RamDomain* results) {
+    recordCount(count);
+    for (std::size_t i = 0; i < count; i++) {
+        results[i] = args[2 * i] * args[2 * i + 1];
+    }
+}
+
+void batch_tag(souffle::SymbolTable* symbolTable, souffle::RecordTable*, std::size_t count,
+        const souffle::RamDomain* args, souffle::RamDomain* results) {
+    recordCount(count);
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string tag = symbolTable->decode(args[2 * i]) + "#" + std::to_string(args[2 * i + 1]);
+        results[i] = symbolTable->encode(tag);
+    }
+}
+
+souffle::RamDomain max_batch() {
+    return static_cast<souffle::RamDomain>(maxCount.load());
+}
+}  // end of extern "C"
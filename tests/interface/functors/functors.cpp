@@ -147,4 +147,18 @@ souffle::RamDomain my_to_number_fun(
 souffle::RamDomain my_identity(souffle::SymbolTable*, souffle::RecordTable*, souffle::RamDomain arg) {
     return arg;
 }
+
+void batch_add(std::size_t count, const souffle::RamDomain* args, souffle::RamDomain* results) {
+    for (std::size_t i = 0; i < count; i++) {
+        results[i] = args[2 * i] + args[2 * i + 1];
+    }
+}
+
+void batch_strlen(souffle::SymbolTable* symbolTable, souffle::RecordTable*, std::size_t count,
+        const souffle::RamDomain* args, souffle::RamDomain* results) {
+    assert(symbolTable && "NULL symbol table");
+    for (std::size_t i = 0; i < count; i++) {
+        results[i] = static_cast<souffle::RamDomain>(symbolTable->decode(args[i]).size());
+    }
+}
 }  // end of extern "C"
@@ -0,0 +1,94 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for the row-based bulk insertion and retrieval interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    // create an instance of program "insert_rows"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("insert_rows")) {
+        Relation* edge = prog->getRelation("edge");
+        Relation* label = prog->getRelation("label");
+        Relation* namedPath = prog->getRelation("named_path");
+        Relation* done = prog->getRelation("done");
+        if (edge == nullptr || label == nullptr || namedPath == nullptr || done == nullptr) {
+            error("cannot find relations");
+        }
+
+        // a nullary relation has no row data; an empty block inserts nothing and any data is rejected
+        std::vector<RamDomain> noRows;
+        done->insertRows(noRows);
+        try {
+            std::vector<RamDomain> someRows = {1};
+            done->insertRows(someRows);
+            error("row data accepted by a nullary relation");
+        } catch (std::invalid_argument&) {
+        }
+        if (done->size() != 0) {
+            error("nullary relation not empty");
+        }
+
+        // insert edges as a single block of rows, concurrently
+        std::vector<RamDomain> edges = {1, 2, 2, 3, 3, 4};
+        edge->insertRows(edges, true);
+
+        // encode the symbol column in one batch and insert the labels
+        std::vector<std::string> names = {"a", "b", "c", "d"};
+        std::vector<RamDomain> ids(names.size());
+        prog->getSymbolTable().encodeMany(names, ids);
+        std::vector<RamDomain> labels;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            labels.push_back(RamDomain(i + 1));
+            labels.push_back(ids[i]);
+        }
+        label->insertRows(labels);
+
+        // run program
+        prog->run();
+
+        // read the result as contiguous rows and decode them in one batch
+        std::vector<RamDomain> rows;
+        namedPath->readRows(rows);
+        if (rows.size() != namedPath->size() * namedPath->getArity()) {
+            error("wrong number of elements");
+        }
+        std::vector<std::string> symbols(rows.size());
+        prog->getSymbolTable().decodeMany(rows, symbols);
+        for (std::size_t i = 0; i < symbols.size(); i += 2) {
+            std::cout << symbols[i] << "-" << symbols[i + 1] << "\n";
+        }
+
+        // free program analysis
+        delete prog;
+    } else {
+        error("cannot find program insert_rows");
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file functors.cpp
+ *
+ * Functors counting their calls, to observe memoisation
+ *
+ ***********************************************************************/
+#include "souffle/SouffleFunctor.h"
+#include <atomic>
+
+#if RAM_DOMAIN_SIZE == 64
+using FF_int = int64_t;
+#else
+using FF_int = int32_t;
+#endif
+
+namespace {
+std::atomic<FF_int> squareCalls{0};
+std::atomic<souffle::RamDomain> nextId{0};
+}  // namespace
+
+extern "C" {
+
+FF_int square(FF_int x) {
+    ++squareCalls;
+    return x * x;
+}
+
+FF_int square_calls() {
+    return squareCalls.load();
+}
+
+souffle::RamDomain fresh(souffle::SymbolTable*, souffle::RecordTable*, souffle::RamDomain) {
+    return nextId++;
+}
+}  // end of extern "C"
@@ -0,0 +1,60 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for answering queries with the query server
+ *
+ ***********************************************************************/
+
+#include "souffle/QueryServer.h"
+#include "souffle/SouffleInterface.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int /* argc */, char** /* argv */) {
+    // create an instance of program "query_server"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("query_server")) {
+        // run program
+        prog->run();
+
+        // answer requests against the computed relations
+        QueryServer server(*prog);
+        std::vector<std::string> requests = {"size\tpath", "contains\tpath\t1\t4", "contains\tpath\t4\t1",
+                "query\tpath\t1\t_", "query\tpath\t_\t3..4", "query\tnamed\t_\tb\t_",
+                "query\tnamed\t_\t_\t1..", "query\tnamed\t_\tz\t_", "query\tpath\t1", "size\tnothing",
+                "quit"};
+        for (const auto& request : requests) {
+            std::cout << "> " << request << "\n";
+            if (!server.handle(request, std::cout)) {
+                break;
+            }
+        }
+
+        // free program analysis
+        delete prog;
+    } else {
+        error("cannot find program query_server");
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2026, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+public class driver {
+  static {
+    try {
+      System.loadLibrary("SwigInterface");
+    } catch (UnsatisfiedLinkError e) {
+      System.load(System.getProperty("java.library.path") + "/" + "libSwigInterface.so");
+    }
+
+  }
+
+  public static void main(String argv[]) {
+    SWIGSouffleProgram p = SwigInterface.newInstance("columns");
+
+    SWIGRelationColumns edges = new SWIGRelationColumns();
+    edges.setNumRows(3);
+    edges.setColumnTypes(p.getColumnTypes("edge"));
+    vector_string dictionary = new vector_string();
+    for (String symbol : new String[] {"a", "b", "c", "d"}) {
+      dictionary.add(symbol);
+    }
+    edges.setDictionary(dictionary);
+    vector_int64 symbols = new vector_int64();
+    for (long symbol : new long[] {0, 1, 2, 1, 2, 3}) {
+      symbols.add(symbol);
+    }
+    edges.setSymbolColumns(symbols);
+    vector_double costs = new vector_double();
+    for (double cost : new double[] {1.5, 2.25, 0.5}) {
+      costs.add(cost);
+    }
+    edges.setFloatColumns(costs);
+    p.insertColumns("edge", edges);
+
+    p.run();
+
+    SWIGRelationColumns reach = p.getColumns("reach");
+    vector_int64 reachSymbols = reach.getSymbolColumns();
+    vector_double reachCosts = reach.getFloatColumns();
+    vector_string reachDictionary = reach.getDictionary();
+    long src = reach.getColumnOffset(0);
+    long dst = reach.getColumnOffset(1);
+    long cost = reach.getColumnOffset(2);
+    for (long row = 0; row < reach.getNumRows(); row++) {
+      System.out.println(reachDictionary.get((int)(long)reachSymbols.get((int)(src + row))) + "\t"
+          + reachDictionary.get((int)(long)reachSymbols.get((int)(dst + row))) + "\t"
+          + reachCosts.get((int)(cost + row)));
+    }
+    p.finalize();
+  }
+}
@@ -0,0 +1,33 @@
+"""
+Souffle - A Datalog Compiler
+Copyright (c) 2026, The Souffle Developers. All rights reserved
+Licensed under the Universal Permissive License v 1.0 as shown at:
+- https://opensource.org/licenses/UPL
+- <souffle root>/licenses/SOUFFLE-UPL.txt
+"""
+
+import SwigInterface
+p = SwigInterface.newInstance('columns')
+
+edges = SwigInterface.SWIGRelationColumns()
+edges.numRows = 3
+edges.columnTypes = p.getColumnTypes('edge')
+edges.dictionary = ['a', 'b', 'c', 'd']
+edges.symbolColumns = [0, 1, 2, 1, 2, 3]
+edges.floatColumns = [1.5, 2.25, 0.5]
+p.insertColumns('edge', edges)
+
+p.run()
+
+reach = p.getColumns('reach')
+symbols = reach.symbolColumns
+costs = reach.floatColumns
+src = reach.getColumnOffset(0)
+dst = reach.getColumnOffset(1)
+cost = reach.getColumnOffset(2)
+for row in range(reach.numRows):
+    print('{}\t{}\t{}'.format(reach.dictionary[symbols[src + row]],
+                              reach.dictionary[symbols[dst + row]],
+                              costs[cost + row]))
+p.thisown = 1
+del p